@@ -0,0 +1,521 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "cyber/common/log.h"
+
+#include "modules/common/math/math_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+// Thin wrappers around the double-precision vector registers. Every kernel
+// below is written once against this interface; kLanes is 4 with AVX2, 2 with
+// SSE2 and 1 for the portable fallback. Masks are reported as bit fields
+// where bit k corresponds to lane k.
+#if defined(__AVX2__)
+using Pack = __m256d;
+constexpr size_t kLanes = 4;
+inline Pack Load(const double *p) { return _mm256_loadu_pd(p); }
+inline Pack Set1(const double v) { return _mm256_set1_pd(v); }
+inline Pack Add(const Pack a, const Pack b) { return _mm256_add_pd(a, b); }
+inline Pack Sub(const Pack a, const Pack b) { return _mm256_sub_pd(a, b); }
+inline Pack Mul(const Pack a, const Pack b) { return _mm256_mul_pd(a, b); }
+inline Pack Min(const Pack a, const Pack b) { return _mm256_min_pd(a, b); }
+inline Pack Max(const Pack a, const Pack b) { return _mm256_max_pd(a, b); }
+inline Pack Abs(const Pack a) {
+  return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+}
+inline Pack Neg(const Pack a) {
+  return _mm256_xor_pd(_mm256_set1_pd(-0.0), a);
+}
+inline Pack Lt(const Pack a, const Pack b) {
+  return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+}
+inline Pack Le(const Pack a, const Pack b) {
+  return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+}
+inline Pack And(const Pack a, const Pack b) { return _mm256_and_pd(a, b); }
+inline Pack Or(const Pack a, const Pack b) { return _mm256_or_pd(a, b); }
+inline int ToMask(const Pack a) { return _mm256_movemask_pd(a); }
+#elif defined(__SSE2__)
+using Pack = __m128d;
+constexpr size_t kLanes = 2;
+inline Pack Load(const double *p) { return _mm_loadu_pd(p); }
+inline Pack Set1(const double v) { return _mm_set1_pd(v); }
+inline Pack Add(const Pack a, const Pack b) { return _mm_add_pd(a, b); }
+inline Pack Sub(const Pack a, const Pack b) { return _mm_sub_pd(a, b); }
+inline Pack Mul(const Pack a, const Pack b) { return _mm_mul_pd(a, b); }
+inline Pack Min(const Pack a, const Pack b) { return _mm_min_pd(a, b); }
+inline Pack Max(const Pack a, const Pack b) { return _mm_max_pd(a, b); }
+inline Pack Abs(const Pack a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+inline Pack Neg(const Pack a) { return _mm_xor_pd(_mm_set1_pd(-0.0), a); }
+inline Pack Lt(const Pack a, const Pack b) { return _mm_cmplt_pd(a, b); }
+inline Pack Le(const Pack a, const Pack b) { return _mm_cmple_pd(a, b); }
+inline Pack And(const Pack a, const Pack b) { return _mm_and_pd(a, b); }
+inline Pack Or(const Pack a, const Pack b) { return _mm_or_pd(a, b); }
+inline int ToMask(const Pack a) { return _mm_movemask_pd(a); }
+#else
+// Scalar fallback: a "mask" is 0.0 or 1.0.
+using Pack = double;
+constexpr size_t kLanes = 1;
+inline Pack Load(const double *p) { return *p; }
+inline Pack Set1(const double v) { return v; }
+inline Pack Add(const Pack a, const Pack b) { return a + b; }
+inline Pack Sub(const Pack a, const Pack b) { return a - b; }
+inline Pack Mul(const Pack a, const Pack b) { return a * b; }
+inline Pack Min(const Pack a, const Pack b) { return std::fmin(a, b); }
+inline Pack Max(const Pack a, const Pack b) { return std::fmax(a, b); }
+inline Pack Abs(const Pack a) { return std::abs(a); }
+inline Pack Neg(const Pack a) { return -a; }
+inline Pack Lt(const Pack a, const Pack b) { return a < b ? 1.0 : 0.0; }
+inline Pack Le(const Pack a, const Pack b) { return a <= b ? 1.0 : 0.0; }
+inline Pack And(const Pack a, const Pack b) {
+  return (a != 0.0 && b != 0.0) ? 1.0 : 0.0;
+}
+inline Pack Or(const Pack a, const Pack b) {
+  return (a != 0.0 || b != 0.0) ? 1.0 : 0.0;
+}
+inline int ToMask(const Pack a) { return a != 0.0 ? 1 : 0; }
+#endif
+
+constexpr int kFullMask = (1 << kLanes) - 1;
+
+// Separating-axis test of Box2d::HasOverlap(const Box2d &), evaluated for
+// kLanes boxes starting at index i. The operations mirror the scalar code one
+// to one so that each lane rounds identically.
+int BoxOverlapMask(const Box2d &box, const Box2dBatch &boxes, const size_t i) {
+  const Pack b_min_x = Load(boxes.min_x() + i);
+  const Pack b_max_x = Load(boxes.max_x() + i);
+  const Pack b_min_y = Load(boxes.min_y() + i);
+  const Pack b_max_y = Load(boxes.max_y() + i);
+  const Pack separated =
+      Or(Or(Lt(b_max_x, Set1(box.min_x())), Lt(Set1(box.max_x()), b_min_x)),
+         Or(Lt(b_max_y, Set1(box.min_y())), Lt(Set1(box.max_y()), b_min_y)));
+  if (ToMask(separated) == kFullMask) {
+    return 0;
+  }
+
+  const Pack cos_heading = Set1(box.cos_heading());
+  const Pack sin_heading = Set1(box.sin_heading());
+  const Pack half_length = Set1(box.half_length());
+  const Pack half_width = Set1(box.half_width());
+
+  const Pack shift_x = Sub(Load(boxes.center_x() + i), Set1(box.center_x()));
+  const Pack shift_y = Sub(Load(boxes.center_y() + i), Set1(box.center_y()));
+
+  const Pack dx1 = Mul(cos_heading, half_length);
+  const Pack dy1 = Mul(sin_heading, half_length);
+  const Pack dx2 = Mul(sin_heading, half_width);
+  const Pack dy2 = Mul(Neg(cos_heading), half_width);
+
+  const Pack b_cos = Load(boxes.cos_heading() + i);
+  const Pack b_sin = Load(boxes.sin_heading() + i);
+  const Pack b_half_length = Load(boxes.half_length() + i);
+  const Pack b_half_width = Load(boxes.half_width() + i);
+  const Pack dx3 = Mul(b_cos, b_half_length);
+  const Pack dy3 = Mul(b_sin, b_half_length);
+  const Pack dx4 = Mul(b_sin, b_half_width);
+  const Pack dy4 = Mul(Neg(b_cos), b_half_width);
+
+  const Pack c1 =
+      Le(Abs(Add(Mul(shift_x, cos_heading), Mul(shift_y, sin_heading))),
+         Add(Add(Abs(Add(Mul(dx3, cos_heading), Mul(dy3, sin_heading))),
+                 Abs(Add(Mul(dx4, cos_heading), Mul(dy4, sin_heading)))),
+             half_length));
+  const Pack c2 =
+      Le(Abs(Sub(Mul(shift_x, sin_heading), Mul(shift_y, cos_heading))),
+         Add(Add(Abs(Sub(Mul(dx3, sin_heading), Mul(dy3, cos_heading))),
+                 Abs(Sub(Mul(dx4, sin_heading), Mul(dy4, cos_heading)))),
+             half_width));
+  const Pack c3 =
+      Le(Abs(Add(Mul(shift_x, b_cos), Mul(shift_y, b_sin))),
+         Add(Add(Abs(Add(Mul(dx1, b_cos), Mul(dy1, b_sin))),
+                 Abs(Add(Mul(dx2, b_cos), Mul(dy2, b_sin)))),
+             b_half_length));
+  const Pack c4 =
+      Le(Abs(Sub(Mul(shift_x, b_sin), Mul(shift_y, b_cos))),
+         Add(Add(Abs(Sub(Mul(dx1, b_sin), Mul(dy1, b_cos))),
+                 Abs(Sub(Mul(dx2, b_sin), Mul(dy2, b_cos)))),
+             b_half_width));
+  return ToMask(And(And(c1, c2), And(c3, c4))) & ~ToMask(separated) &
+         kFullMask;
+}
+
+// Lanes whose segment is certainly disjoint from the box because of the
+// bounding-box test in Box2d::HasOverlap(const LineSegment2d &). Degenerate
+// segments are never rejected here because the scalar code checks them with
+// a tolerance.
+int BoxSegmentRejectMask(const Box2d &box, const LineSegment2dBatch &segments,
+                         const size_t i) {
+  const Pack start_x = Load(segments.start_x() + i);
+  const Pack start_y = Load(segments.start_y() + i);
+  const Pack end_x = Load(segments.end_x() + i);
+  const Pack end_y = Load(segments.end_y() + i);
+  const Pack separated = Or(
+      Or(Lt(Max(start_x, end_x), Set1(box.min_x())),
+         Lt(Set1(box.max_x()), Min(start_x, end_x))),
+      Or(Lt(Max(start_y, end_y), Set1(box.min_y())),
+         Lt(Set1(box.max_y()), Min(start_y, end_y))));
+  const Pack degenerate =
+      Le(Load(segments.length() + i), Set1(kMathEpsilon));
+  return ToMask(separated) & ~ToMask(degenerate) & kFullMask;
+}
+
+// Lanes where one end of the segment lies strictly inside the box, for which
+// Box2d::DistanceTo(const LineSegment2d &) returns 0.0 right away.
+int BoxSegmentContainedMask(const Box2d &box,
+                            const LineSegment2dBatch &segments,
+                            const size_t i) {
+  const Pack center_x = Set1(box.center_x());
+  const Pack center_y = Set1(box.center_y());
+  const Pack cos_heading = Set1(box.cos_heading());
+  const Pack sin_heading = Set1(box.sin_heading());
+  const Pack box_x = Set1(box.half_length());
+  const Pack box_y = Set1(box.half_width());
+  const Pack neg_box_x = Neg(box_x);
+  const Pack neg_box_y = Neg(box_y);
+
+  const Pack ref_x1 = Sub(Load(segments.start_x() + i), center_x);
+  const Pack ref_y1 = Sub(Load(segments.start_y() + i), center_y);
+  const Pack x1 = Add(Mul(ref_x1, cos_heading), Mul(ref_y1, sin_heading));
+  const Pack y1 = Sub(Mul(ref_x1, sin_heading), Mul(ref_y1, cos_heading));
+  const Pack start_in = And(And(Lt(x1, box_x), Lt(neg_box_x, x1)),
+                            And(Lt(y1, box_y), Lt(neg_box_y, y1)));
+
+  const Pack ref_x2 = Sub(Load(segments.end_x() + i), center_x);
+  const Pack ref_y2 = Sub(Load(segments.end_y() + i), center_y);
+  const Pack x2 = Add(Mul(ref_x2, cos_heading), Mul(ref_y2, sin_heading));
+  const Pack y2 = Sub(Mul(ref_x2, sin_heading), Mul(ref_y2, cos_heading));
+  const Pack end_in = And(And(Lt(x2, box_x), Lt(neg_box_x, x2)),
+                          And(Lt(y2, box_y), Lt(neg_box_y, y2)));
+
+  const Pack degenerate =
+      Le(Load(segments.length() + i), Set1(kMathEpsilon));
+  return ToMask(Or(start_in, end_in)) & ~ToMask(degenerate) & kFullMask;
+}
+
+// Lanes rejected by the bounding-box test in
+// Polygon2d::HasOverlap(const LineSegment2d &).
+int PolygonSegmentRejectMask(const Polygon2d &polygon,
+                             const LineSegment2dBatch &segments,
+                             const size_t i) {
+  const Pack min_x = Set1(polygon.min_x());
+  const Pack max_x = Set1(polygon.max_x());
+  const Pack min_y = Set1(polygon.min_y());
+  const Pack max_y = Set1(polygon.max_y());
+  const Pack start_x = Load(segments.start_x() + i);
+  const Pack start_y = Load(segments.start_y() + i);
+  const Pack end_x = Load(segments.end_x() + i);
+  const Pack end_y = Load(segments.end_y() + i);
+  return ToMask(Or(Or(And(Lt(start_x, min_x), Lt(end_x, min_x)),
+                      And(Lt(max_x, start_x), Lt(max_x, end_x))),
+                   Or(And(Lt(start_y, min_y), Lt(end_y, min_y)),
+                      And(Lt(max_y, start_y), Lt(max_y, end_y)))));
+}
+
+// Lanes rejected by the bounding-box test in
+// Polygon2d::HasOverlap(const Polygon2d &).
+int PolygonBoxRejectMask(const Polygon2d &polygon, const Box2dBatch &boxes,
+                         const size_t i) {
+  return ToMask(Or(Or(Lt(Load(boxes.max_x() + i), Set1(polygon.min_x())),
+                      Lt(Set1(polygon.max_x()), Load(boxes.min_x() + i))),
+                   Or(Lt(Load(boxes.max_y() + i), Set1(polygon.min_y())),
+                      Lt(Set1(polygon.max_y()), Load(boxes.min_y() + i)))));
+}
+
+}  // namespace
+
+Box2dBatch::Box2dBatch(const std::vector<Box2d> &boxes) {
+  Reserve(boxes.size());
+  for (const auto &box : boxes) {
+    Add(box);
+  }
+}
+
+void Box2dBatch::Reserve(const size_t capacity) {
+  boxes_.reserve(capacity);
+  center_x_.reserve(capacity);
+  center_y_.reserve(capacity);
+  cos_heading_.reserve(capacity);
+  sin_heading_.reserve(capacity);
+  half_length_.reserve(capacity);
+  half_width_.reserve(capacity);
+  min_x_.reserve(capacity);
+  max_x_.reserve(capacity);
+  min_y_.reserve(capacity);
+  max_y_.reserve(capacity);
+}
+
+void Box2dBatch::Add(const Box2d &box) {
+  boxes_.push_back(box);
+  center_x_.push_back(box.center_x());
+  center_y_.push_back(box.center_y());
+  cos_heading_.push_back(box.cos_heading());
+  sin_heading_.push_back(box.sin_heading());
+  half_length_.push_back(box.half_length());
+  half_width_.push_back(box.half_width());
+  min_x_.push_back(box.min_x());
+  max_x_.push_back(box.max_x());
+  min_y_.push_back(box.min_y());
+  max_y_.push_back(box.max_y());
+}
+
+void Box2dBatch::Clear() {
+  boxes_.clear();
+  center_x_.clear();
+  center_y_.clear();
+  cos_heading_.clear();
+  sin_heading_.clear();
+  half_length_.clear();
+  half_width_.clear();
+  min_x_.clear();
+  max_x_.clear();
+  min_y_.clear();
+  max_y_.clear();
+}
+
+LineSegment2dBatch::LineSegment2dBatch(
+    const std::vector<LineSegment2d> &segments) {
+  Reserve(segments.size());
+  for (const auto &segment : segments) {
+    Add(segment);
+  }
+}
+
+void LineSegment2dBatch::Reserve(const size_t capacity) {
+  segments_.reserve(capacity);
+  start_x_.reserve(capacity);
+  start_y_.reserve(capacity);
+  end_x_.reserve(capacity);
+  end_y_.reserve(capacity);
+  length_.reserve(capacity);
+}
+
+void LineSegment2dBatch::Add(const LineSegment2d &segment) {
+  segments_.push_back(segment);
+  start_x_.push_back(segment.start().x());
+  start_y_.push_back(segment.start().y());
+  end_x_.push_back(segment.end().x());
+  end_y_.push_back(segment.end().y());
+  length_.push_back(segment.length());
+}
+
+void LineSegment2dBatch::Clear() {
+  segments_.clear();
+  start_x_.clear();
+  start_y_.clear();
+  end_x_.clear();
+  end_y_.clear();
+  length_.clear();
+}
+
+void BatchHasOverlap(const Box2d &box, const Box2dBatch &boxes,
+                     std::vector<bool> *const overlaps) {
+  CHECK_NOTNULL(overlaps);
+  const size_t size = boxes.size();
+  overlaps->assign(size, false);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int mask = BoxOverlapMask(box, boxes, i);
+    if (mask == 0) {
+      continue;
+    }
+    for (size_t k = 0; k < kLanes; ++k) {
+      (*overlaps)[i + k] = (mask >> k) & 1;
+    }
+  }
+  for (; i < size; ++i) {
+    (*overlaps)[i] = box.HasOverlap(boxes.boxes()[i]);
+  }
+}
+
+bool HasOverlapWithAny(const Box2d &box, const Box2dBatch &boxes) {
+  const size_t size = boxes.size();
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    if (BoxOverlapMask(box, boxes, i) != 0) {
+      return true;
+    }
+  }
+  for (; i < size; ++i) {
+    if (box.HasOverlap(boxes.boxes()[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BatchHasOverlap(const Box2d &box, const LineSegment2dBatch &segments,
+                     std::vector<bool> *const overlaps) {
+  CHECK_NOTNULL(overlaps);
+  const auto &candidates = segments.segments();
+  const size_t size = segments.size();
+  overlaps->assign(size, false);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int rejected = BoxSegmentRejectMask(box, segments, i);
+    if (rejected == kFullMask) {
+      continue;
+    }
+    const int contained = BoxSegmentContainedMask(box, segments, i);
+    for (size_t k = 0; k < kLanes; ++k) {
+      if ((rejected >> k) & 1) {
+        continue;
+      }
+      (*overlaps)[i + k] =
+          ((contained >> k) & 1) || box.HasOverlap(candidates[i + k]);
+    }
+  }
+  for (; i < size; ++i) {
+    (*overlaps)[i] = box.HasOverlap(candidates[i]);
+  }
+}
+
+bool HasOverlapWithAny(const Box2d &box, const LineSegment2dBatch &segments) {
+  const auto &candidates = segments.segments();
+  const size_t size = segments.size();
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int rejected = BoxSegmentRejectMask(box, segments, i);
+    if (rejected == kFullMask) {
+      continue;
+    }
+    if ((BoxSegmentContainedMask(box, segments, i) & ~rejected) != 0) {
+      return true;
+    }
+    for (size_t k = 0; k < kLanes; ++k) {
+      if (!((rejected >> k) & 1) && box.HasOverlap(candidates[i + k])) {
+        return true;
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    if (box.HasOverlap(candidates[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BatchDistanceTo(const Box2d &box, const LineSegment2dBatch &segments,
+                     std::vector<double> *const distances) {
+  CHECK_NOTNULL(distances);
+  const auto &candidates = segments.segments();
+  const size_t size = segments.size();
+  distances->resize(size);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int contained = BoxSegmentContainedMask(box, segments, i);
+    for (size_t k = 0; k < kLanes; ++k) {
+      (*distances)[i + k] = ((contained >> k) & 1)
+                                ? 0.0
+                                : box.DistanceTo(candidates[i + k]);
+    }
+  }
+  for (; i < size; ++i) {
+    (*distances)[i] = box.DistanceTo(candidates[i]);
+  }
+}
+
+void BatchDistanceTo(const Box2d &box, const Box2dBatch &boxes,
+                     std::vector<double> *const distances) {
+  CHECK_NOTNULL(distances);
+  // Box2d::DistanceTo(const Box2d &) converts both boxes to polygons; the
+  // query polygon only needs to be built once for the whole batch.
+  const Polygon2d polygon(box);
+  distances->resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    (*distances)[i] = Polygon2d(boxes.boxes()[i]).DistanceTo(polygon);
+  }
+}
+
+void BatchHasOverlap(const Polygon2d &polygon,
+                     const LineSegment2dBatch &segments,
+                     std::vector<bool> *const overlaps) {
+  CHECK_NOTNULL(overlaps);
+  const auto &candidates = segments.segments();
+  const size_t size = segments.size();
+  overlaps->assign(size, false);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int rejected = PolygonSegmentRejectMask(polygon, segments, i);
+    for (size_t k = 0; k < kLanes; ++k) {
+      if (!((rejected >> k) & 1)) {
+        (*overlaps)[i + k] = polygon.HasOverlap(candidates[i + k]);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    (*overlaps)[i] = polygon.HasOverlap(candidates[i]);
+  }
+}
+
+void BatchHasOverlap(const Polygon2d &polygon, const Box2dBatch &boxes,
+                     std::vector<bool> *const overlaps) {
+  CHECK_NOTNULL(overlaps);
+  const auto &candidates = boxes.boxes();
+  const size_t size = boxes.size();
+  overlaps->assign(size, false);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    const int rejected = PolygonBoxRejectMask(polygon, boxes, i);
+    for (size_t k = 0; k < kLanes; ++k) {
+      if (!((rejected >> k) & 1)) {
+        (*overlaps)[i + k] = polygon.HasOverlap(Polygon2d(candidates[i + k]));
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    (*overlaps)[i] = polygon.HasOverlap(Polygon2d(candidates[i]));
+  }
+}
+
+void BatchDistanceTo(const Polygon2d &polygon,
+                     const LineSegment2dBatch &segments,
+                     std::vector<double> *const distances) {
+  CHECK_NOTNULL(distances);
+  const auto &candidates = segments.segments();
+  distances->resize(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    (*distances)[i] = polygon.DistanceTo(candidates[i]);
+  }
+}
+
+void BatchDistanceTo(const Polygon2d &polygon, const Box2dBatch &boxes,
+                     std::vector<double> *const distances) {
+  CHECK_NOTNULL(distances);
+  const auto &candidates = boxes.boxes();
+  distances->resize(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    (*distances)[i] = polygon.DistanceTo(candidates[i]);
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Batched (structure-of-arrays) collision kernels for Box2d and
+ *        Polygon2d. One query shape is tested against many boxes or line
+ *        segments at once. The results are identical to the scalar member
+ *        functions of Box2d and Polygon2d.
+ *
+ * The vectorized code path is selected at compile time: AVX2 when the
+ * translation unit is built with -mavx2 (or -march=native), SSE2 on any
+ * other x86-64 target and a plain scalar loop elsewhere. Products and sums
+ * are kept as separate instructions (no fused multiply-add) so that every
+ * lane rounds exactly like the scalar code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/polygon2d.h"
+
+/**
+ * @namespace apollo::common::math
+ * @brief apollo::common::math
+ */
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @class Box2dBatch
+ * @brief A set of Box2d stored as structure-of-arrays for batched tests.
+ *
+ * The original boxes are kept alongside the lanes so that candidates which
+ * survive the vectorized tests can be refined with the exact scalar code.
+ */
+class Box2dBatch {
+ public:
+  Box2dBatch() = default;
+
+  /**
+   * @brief Constructor which takes a list of boxes.
+   * @param boxes The boxes to store.
+   */
+  explicit Box2dBatch(const std::vector<Box2d> &boxes);
+
+  /**
+   * @brief Reserves memory for a given number of boxes.
+   * @param capacity The number of boxes.
+   */
+  void Reserve(const size_t capacity);
+
+  /**
+   * @brief Appends a box to the batch.
+   * @param box The box to append.
+   */
+  void Add(const Box2d &box);
+
+  /**
+   * @brief Removes all the boxes, keeping the allocated memory.
+   */
+  void Clear();
+
+  /**
+   * @brief Getter of the number of boxes.
+   * @return The number of boxes in the batch.
+   */
+  size_t size() const { return boxes_.size(); }
+
+  /**
+   * @brief Checks whether the batch is empty.
+   * @return True iff there is no box in the batch.
+   */
+  bool empty() const { return boxes_.empty(); }
+
+  /**
+   * @brief Getter of the boxes in their original form.
+   * @return The list of boxes.
+   */
+  const std::vector<Box2d> &boxes() const { return boxes_; }
+
+  const double *center_x() const { return center_x_.data(); }
+  const double *center_y() const { return center_y_.data(); }
+  const double *cos_heading() const { return cos_heading_.data(); }
+  const double *sin_heading() const { return sin_heading_.data(); }
+  const double *half_length() const { return half_length_.data(); }
+  const double *half_width() const { return half_width_.data(); }
+  const double *min_x() const { return min_x_.data(); }
+  const double *max_x() const { return max_x_.data(); }
+  const double *min_y() const { return min_y_.data(); }
+  const double *max_y() const { return max_y_.data(); }
+
+ private:
+  std::vector<Box2d> boxes_;
+
+  std::vector<double> center_x_;
+  std::vector<double> center_y_;
+  std::vector<double> cos_heading_;
+  std::vector<double> sin_heading_;
+  std::vector<double> half_length_;
+  std::vector<double> half_width_;
+  std::vector<double> min_x_;
+  std::vector<double> max_x_;
+  std::vector<double> min_y_;
+  std::vector<double> max_y_;
+};
+
+/**
+ * @class LineSegment2dBatch
+ * @brief A set of LineSegment2d stored as structure-of-arrays for batched
+ *        tests.
+ */
+class LineSegment2dBatch {
+ public:
+  LineSegment2dBatch() = default;
+
+  /**
+   * @brief Constructor which takes a list of line segments.
+   * @param segments The line segments to store.
+   */
+  explicit LineSegment2dBatch(const std::vector<LineSegment2d> &segments);
+
+  /**
+   * @brief Reserves memory for a given number of line segments.
+   * @param capacity The number of line segments.
+   */
+  void Reserve(const size_t capacity);
+
+  /**
+   * @brief Appends a line segment to the batch.
+   * @param segment The line segment to append.
+   */
+  void Add(const LineSegment2d &segment);
+
+  /**
+   * @brief Removes all the line segments, keeping the allocated memory.
+   */
+  void Clear();
+
+  /**
+   * @brief Getter of the number of line segments.
+   * @return The number of line segments in the batch.
+   */
+  size_t size() const { return segments_.size(); }
+
+  /**
+   * @brief Checks whether the batch is empty.
+   * @return True iff there is no line segment in the batch.
+   */
+  bool empty() const { return segments_.empty(); }
+
+  /**
+   * @brief Getter of the line segments in their original form.
+   * @return The list of line segments.
+   */
+  const std::vector<LineSegment2d> &segments() const { return segments_; }
+
+  const double *start_x() const { return start_x_.data(); }
+  const double *start_y() const { return start_y_.data(); }
+  const double *end_x() const { return end_x_.data(); }
+  const double *end_y() const { return end_y_.data(); }
+  const double *length() const { return length_.data(); }
+
+ private:
+  std::vector<LineSegment2d> segments_;
+
+  std::vector<double> start_x_;
+  std::vector<double> start_y_;
+  std::vector<double> end_x_;
+  std::vector<double> end_y_;
+  std::vector<double> length_;
+};
+
+/**
+ * @brief Determines whether a box overlaps each box of a batch.
+ *        overlaps[i] equals box.HasOverlap(boxes.boxes()[i]).
+ * @param box The query box.
+ * @param boxes The boxes to test against.
+ * @param overlaps The per-box results, resized to boxes.size().
+ */
+void BatchHasOverlap(const Box2d &box, const Box2dBatch &boxes,
+                     std::vector<bool> *const overlaps);
+
+/**
+ * @brief Determines whether a box overlaps any box of a batch.
+ * @param box The query box.
+ * @param boxes The boxes to test against.
+ * @return True if at least one box of the batch overlaps the query box.
+ */
+bool HasOverlapWithAny(const Box2d &box, const Box2dBatch &boxes);
+
+/**
+ * @brief Determines whether a box overlaps each line segment of a batch.
+ *        overlaps[i] equals box.HasOverlap(segments.segments()[i]).
+ * @param box The query box.
+ * @param segments The line segments to test against.
+ * @param overlaps The per-segment results, resized to segments.size().
+ */
+void BatchHasOverlap(const Box2d &box, const LineSegment2dBatch &segments,
+                     std::vector<bool> *const overlaps);
+
+/**
+ * @brief Determines whether a box overlaps any line segment of a batch.
+ * @param box The query box.
+ * @param segments The line segments to test against.
+ * @return True if at least one segment of the batch overlaps the query box.
+ */
+bool HasOverlapWithAny(const Box2d &box, const LineSegment2dBatch &segments);
+
+/**
+ * @brief Determines the distance between a box and each line segment of a
+ *        batch. distances[i] equals box.DistanceTo(segments.segments()[i]).
+ * @param box The query box.
+ * @param segments The line segments.
+ * @param distances The per-segment distances, resized to segments.size().
+ */
+void BatchDistanceTo(const Box2d &box, const LineSegment2dBatch &segments,
+                     std::vector<double> *const distances);
+
+/**
+ * @brief Determines the distance between a box and each box of a batch.
+ *        distances[i] equals box.DistanceTo(boxes.boxes()[i]).
+ * @param box The query box.
+ * @param boxes The boxes.
+ * @param distances The per-box distances, resized to boxes.size().
+ */
+void BatchDistanceTo(const Box2d &box, const Box2dBatch &boxes,
+                     std::vector<double> *const distances);
+
+/**
+ * @brief Determines whether a polygon overlaps each line segment of a batch.
+ *        overlaps[i] equals polygon.HasOverlap(segments.segments()[i]).
+ * @param polygon The query polygon.
+ * @param segments The line segments to test against.
+ * @param overlaps The per-segment results, resized to segments.size().
+ */
+void BatchHasOverlap(const Polygon2d &polygon,
+                     const LineSegment2dBatch &segments,
+                     std::vector<bool> *const overlaps);
+
+/**
+ * @brief Determines whether a polygon overlaps each box of a batch.
+ *        overlaps[i] equals polygon.HasOverlap(Polygon2d(boxes.boxes()[i])).
+ * @param polygon The query polygon.
+ * @param boxes The boxes to test against.
+ * @param overlaps The per-box results, resized to boxes.size().
+ */
+void BatchHasOverlap(const Polygon2d &polygon, const Box2dBatch &boxes,
+                     std::vector<bool> *const overlaps);
+
+/**
+ * @brief Determines the distance between a polygon and each line segment of
+ *        a batch. distances[i] equals polygon.DistanceTo(
+ *        segments.segments()[i]). The distances are computed with the scalar
+ *        code, there is no cheap vectorized test deciding them exactly.
+ * @param polygon The query polygon.
+ * @param segments The line segments.
+ * @param distances The per-segment distances, resized to segments.size().
+ */
+void BatchDistanceTo(const Polygon2d &polygon,
+                     const LineSegment2dBatch &segments,
+                     std::vector<double> *const distances);
+
+/**
+ * @brief Determines the distance between a polygon and each box of a batch.
+ *        distances[i] equals polygon.DistanceTo(boxes.boxes()[i]). The
+ *        distances are computed with the scalar code.
+ * @param polygon The query polygon.
+ * @param boxes The boxes.
+ * @param distances The per-box distances, resized to boxes.size().
+ */
+void BatchDistanceTo(const Polygon2d &polygon, const Box2dBatch &boxes,
+                     std::vector<double> *const distances);
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,202 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Compares the scalar Box2d/Polygon2d routines with their batched
+ *        counterparts. The argument of every benchmark is the number of
+ *        obstacles, spanning a quiet road (16) to a crowded parking lot
+ *        (1024). Run with
+ *        bazel run -c opt --copt=-mavx2 //modules/common/math:box2d_batch_benchmark
+ */
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/box2d_batch.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+// Obstacles are scattered around the ego box so that only a fraction of them
+// overlap it, as in typical collision checks.
+std::vector<Box2d> MakeObstacleBoxes(const int num_boxes) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> position(-30.0, 30.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> length(0.5, 5.0);
+  std::vector<Box2d> boxes;
+  boxes.reserve(num_boxes);
+  for (int i = 0; i < num_boxes; ++i) {
+    boxes.emplace_back(Vec2d(position(rng), position(rng)), heading(rng),
+                       length(rng), length(rng) * 0.5);
+  }
+  return boxes;
+}
+
+std::vector<LineSegment2d> MakeObstacleSegments(const int num_segments) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> position(-30.0, 30.0);
+  std::uniform_real_distribution<double> offset(-2.0, 2.0);
+  std::vector<LineSegment2d> segments;
+  segments.reserve(num_segments);
+  for (int i = 0; i < num_segments; ++i) {
+    const Vec2d start(position(rng), position(rng));
+    segments.emplace_back(start, start + Vec2d(offset(rng), offset(rng)));
+  }
+  return segments;
+}
+
+const Box2d kEgoBox({1.0, 0.5}, 0.3, 4.9, 2.1);
+
+void BM_BoxHasOverlapBoxesScalar(benchmark::State &state) {
+  const auto boxes = MakeObstacleBoxes(static_cast<int>(state.range(0)));
+  std::vector<bool> overlaps(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      overlaps[i] = kEgoBox.HasOverlap(boxes[i]);
+    }
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxHasOverlapBoxesBatch(benchmark::State &state) {
+  const Box2dBatch batch(MakeObstacleBoxes(static_cast<int>(state.range(0))));
+  std::vector<bool> overlaps;
+  for (auto _ : state) {
+    BatchHasOverlap(kEgoBox, batch, &overlaps);
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxHasOverlapSegmentsScalar(benchmark::State &state) {
+  const auto segments =
+      MakeObstacleSegments(static_cast<int>(state.range(0)));
+  std::vector<bool> overlaps(segments.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < segments.size(); ++i) {
+      overlaps[i] = kEgoBox.HasOverlap(segments[i]);
+    }
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxHasOverlapSegmentsBatch(benchmark::State &state) {
+  const LineSegment2dBatch batch(
+      MakeObstacleSegments(static_cast<int>(state.range(0))));
+  std::vector<bool> overlaps;
+  for (auto _ : state) {
+    BatchHasOverlap(kEgoBox, batch, &overlaps);
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxDistanceToSegmentsScalar(benchmark::State &state) {
+  const auto segments =
+      MakeObstacleSegments(static_cast<int>(state.range(0)));
+  std::vector<double> distances(segments.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < segments.size(); ++i) {
+      distances[i] = kEgoBox.DistanceTo(segments[i]);
+    }
+    benchmark::DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxDistanceToSegmentsBatch(benchmark::State &state) {
+  const LineSegment2dBatch batch(
+      MakeObstacleSegments(static_cast<int>(state.range(0))));
+  std::vector<double> distances;
+  for (auto _ : state) {
+    BatchDistanceTo(kEgoBox, batch, &distances);
+    benchmark::DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxDistanceToBoxesScalar(benchmark::State &state) {
+  const auto boxes = MakeObstacleBoxes(static_cast<int>(state.range(0)));
+  std::vector<double> distances(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      distances[i] = kEgoBox.DistanceTo(boxes[i]);
+    }
+    benchmark::DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoxDistanceToBoxesBatch(benchmark::State &state) {
+  const Box2dBatch batch(MakeObstacleBoxes(static_cast<int>(state.range(0))));
+  std::vector<double> distances;
+  for (auto _ : state) {
+    BatchDistanceTo(kEgoBox, batch, &distances);
+    benchmark::DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PolygonHasOverlapBoxesScalar(benchmark::State &state) {
+  const Polygon2d polygon(kEgoBox);
+  const auto boxes = MakeObstacleBoxes(static_cast<int>(state.range(0)));
+  std::vector<bool> overlaps(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      overlaps[i] = polygon.HasOverlap(Polygon2d(boxes[i]));
+    }
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PolygonHasOverlapBoxesBatch(benchmark::State &state) {
+  const Polygon2d polygon(kEgoBox);
+  const Box2dBatch batch(MakeObstacleBoxes(static_cast<int>(state.range(0))));
+  std::vector<bool> overlaps;
+  for (auto _ : state) {
+    BatchHasOverlap(polygon, batch, &overlaps);
+    benchmark::DoNotOptimize(overlaps);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_BoxHasOverlapBoxesScalar)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxHasOverlapBoxesBatch)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxHasOverlapSegmentsScalar)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxHasOverlapSegmentsBatch)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxDistanceToSegmentsScalar)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxDistanceToSegmentsBatch)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxDistanceToBoxesScalar)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_BoxDistanceToBoxesBatch)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_PolygonHasOverlapBoxesScalar)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_PolygonHasOverlapBoxesBatch)->RangeMultiplier(4)->Range(16, 1024);
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,189 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+std::vector<Box2d> RandomBoxes(const int num_boxes, std::mt19937 *rng) {
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size(0.0, 6.0);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < num_boxes; ++i) {
+    boxes.emplace_back(Vec2d(position(*rng), position(*rng)), heading(*rng),
+                       size(*rng), size(*rng));
+  }
+  return boxes;
+}
+
+std::vector<LineSegment2d> RandomSegments(const int num_segments,
+                                          std::mt19937 *rng) {
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> offset(-4.0, 4.0);
+  std::vector<LineSegment2d> segments;
+  for (int i = 0; i < num_segments; ++i) {
+    const Vec2d start(position(*rng), position(*rng));
+    segments.emplace_back(start, start + Vec2d(offset(*rng), offset(*rng)));
+  }
+  // Degenerate segments exercise the point-in-box tolerance.
+  segments.emplace_back(Vec2d(1.0, 1.0), Vec2d(1.0, 1.0));
+  segments.emplace_back(Vec2d(100.0, 1.0), Vec2d(100.0, 1.0));
+  return segments;
+}
+
+}  // namespace
+
+TEST(Box2dBatchTest, Storage) {
+  Box2dBatch batch;
+  EXPECT_TRUE(batch.empty());
+  batch.Add(Box2d({1, 2}, M_PI_4, 4, 2));
+  batch.Add(Box2d(LineSegment2d({2, 3}, {6, 3}), 2));
+  EXPECT_EQ(2, batch.size());
+  EXPECT_DOUBLE_EQ(1.0, batch.center_x()[0]);
+  EXPECT_DOUBLE_EQ(2.0, batch.center_y()[0]);
+  EXPECT_DOUBLE_EQ(2.0, batch.half_length()[1]);
+  EXPECT_DOUBLE_EQ(1.0, batch.half_width()[1]);
+  EXPECT_DOUBLE_EQ(2.0, batch.min_y()[1]);
+  batch.Clear();
+  EXPECT_TRUE(batch.empty());
+
+  LineSegment2dBatch segments({LineSegment2d({0, 0}, {3, 4})});
+  EXPECT_EQ(1, segments.size());
+  EXPECT_DOUBLE_EQ(3.0, segments.end_x()[0]);
+  EXPECT_DOUBLE_EQ(5.0, segments.length()[0]);
+}
+
+TEST(Box2dBatchTest, HasOverlapWithBoxes) {
+  std::mt19937 rng(12345);
+  const std::vector<Box2d> boxes = RandomBoxes(203, &rng);
+  const Box2dBatch batch(boxes);
+  std::vector<bool> overlaps;
+  int num_overlaps = 0;
+  for (const auto &query : RandomBoxes(50, &rng)) {
+    BatchHasOverlap(query, batch, &overlaps);
+    ASSERT_EQ(boxes.size(), overlaps.size());
+    bool any = false;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(query.HasOverlap(boxes[i]), overlaps[i]);
+      any = any || overlaps[i];
+      num_overlaps += overlaps[i];
+    }
+    EXPECT_EQ(any, HasOverlapWithAny(query, batch));
+  }
+  EXPECT_GT(num_overlaps, 0);
+}
+
+TEST(Box2dBatchTest, HasOverlapWithSegments) {
+  std::mt19937 rng(23456);
+  const std::vector<LineSegment2d> segments = RandomSegments(301, &rng);
+  const LineSegment2dBatch batch(segments);
+  std::vector<bool> overlaps;
+  for (const auto &query : RandomBoxes(50, &rng)) {
+    BatchHasOverlap(query, batch, &overlaps);
+    ASSERT_EQ(segments.size(), overlaps.size());
+    bool any = false;
+    for (size_t i = 0; i < segments.size(); ++i) {
+      EXPECT_EQ(query.HasOverlap(segments[i]), overlaps[i]);
+      any = any || overlaps[i];
+    }
+    EXPECT_EQ(any, HasOverlapWithAny(query, batch));
+  }
+}
+
+TEST(Box2dBatchTest, DistanceToSegments) {
+  std::mt19937 rng(34567);
+  const std::vector<LineSegment2d> segments = RandomSegments(301, &rng);
+  const LineSegment2dBatch batch(segments);
+  std::vector<double> distances;
+  for (const auto &query : RandomBoxes(50, &rng)) {
+    BatchDistanceTo(query, batch, &distances);
+    ASSERT_EQ(segments.size(), distances.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+      EXPECT_EQ(query.DistanceTo(segments[i]), distances[i]);
+    }
+  }
+}
+
+TEST(Box2dBatchTest, DistanceToBoxes) {
+  std::mt19937 rng(45678);
+  const std::vector<Box2d> boxes = RandomBoxes(101, &rng);
+  const Box2dBatch batch(boxes);
+  std::vector<double> distances;
+  for (const auto &query : RandomBoxes(20, &rng)) {
+    BatchDistanceTo(query, batch, &distances);
+    ASSERT_EQ(boxes.size(), distances.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(query.DistanceTo(boxes[i]), distances[i]);
+    }
+  }
+}
+
+TEST(Box2dBatchTest, PolygonHasOverlap) {
+  std::mt19937 rng(56789);
+  const std::vector<Box2d> boxes = RandomBoxes(101, &rng);
+  const std::vector<LineSegment2d> segments = RandomSegments(101, &rng);
+  const Box2dBatch box_batch(boxes);
+  const LineSegment2dBatch segment_batch(segments);
+  std::vector<bool> overlaps;
+  for (const auto &box : RandomBoxes(20, &rng)) {
+    const Polygon2d polygon(box);
+    BatchHasOverlap(polygon, segment_batch, &overlaps);
+    ASSERT_EQ(segments.size(), overlaps.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+      EXPECT_EQ(polygon.HasOverlap(segments[i]), overlaps[i]);
+    }
+    BatchHasOverlap(polygon, box_batch, &overlaps);
+    ASSERT_EQ(boxes.size(), overlaps.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(polygon.HasOverlap(Polygon2d(boxes[i])), overlaps[i]);
+    }
+  }
+}
+
+TEST(Box2dBatchTest, PolygonDistanceTo) {
+  std::mt19937 rng(67890);
+  const std::vector<Box2d> boxes = RandomBoxes(101, &rng);
+  const std::vector<LineSegment2d> segments = RandomSegments(101, &rng);
+  const Box2dBatch box_batch(boxes);
+  const LineSegment2dBatch segment_batch(segments);
+  std::vector<double> distances;
+  for (const auto &box : RandomBoxes(20, &rng)) {
+    const Polygon2d polygon(box);
+    BatchDistanceTo(polygon, segment_batch, &distances);
+    ASSERT_EQ(segments.size(), distances.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+      EXPECT_EQ(polygon.DistanceTo(segments[i]), distances[i]);
+    }
+    BatchDistanceTo(polygon, box_batch, &distances);
+    ASSERT_EQ(boxes.size(), distances.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(polygon.DistanceTo(boxes[i]), distances[i]);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
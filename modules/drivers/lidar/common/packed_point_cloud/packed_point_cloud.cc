@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/common/packed_point_cloud/packed_point_cloud.h"
+
+#include <cstring>
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+PackedPointCloudWriter::PackedPointCloudWriter(const uint64_t base_timestamp,
+                                               const size_t capacity,
+                                               PointCloud* cloud)
+    : base_timestamp_(base_timestamp) {
+  cloud->clear_point();
+  cloud->set_packed_base_timestamp(base_timestamp);
+  packed_point_ = cloud->mutable_packed_point();
+  packed_point_->resize(capacity * kPackedPointBytes);
+}
+
+void PackedPointCloudWriter::AddPoint(const float x, const float y,
+                                      const float z, const uint32_t intensity,
+                                      const uint64_t timestamp) {
+  if ((size_ + 1) * kPackedPointBytes > packed_point_->size()) {
+    packed_point_->resize(2 * packed_point_->size() + kPackedPointBytes);
+  }
+  // signed, as the points may precede the base timestamp
+  const int64_t time_diff = static_cast<int64_t>(timestamp - base_timestamp_);
+  const float record[kPackedPointFields] = {
+      x, y, z, static_cast<float>(intensity),
+      static_cast<float>(static_cast<double>(time_diff) * 1e-9)};
+  std::memcpy(&(*packed_point_)[size_ * kPackedPointBytes], record,
+              kPackedPointBytes);
+  ++size_;
+}
+
+void PackedPointCloudWriter::Finish() {
+  packed_point_->resize(size_ * kPackedPointBytes);
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
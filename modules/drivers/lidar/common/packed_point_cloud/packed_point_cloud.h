@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Writer of the packed points of PointCloud, i.e. fixed stride
+ *        float32 records in PointCloud.packed_point, which consumers can
+ *        convert in bulk instead of walking the repeated point field.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+// float32 fields of a packed point: x, y, z, intensity and time
+constexpr size_t kPackedPointFields = 5;
+constexpr size_t kPackedPointBytes = kPackedPointFields * sizeof(float);
+
+class PackedPointCloudWriter {
+ public:
+  /**
+   * @brief Start packing the points of cloud, replacing its points.
+   * @param base_timestamp Timestamp in nanoseconds the time of the points is
+   *        relative to, usually the earliest point of the sweep.
+   * @param capacity Expected number of points, to size the buffer once.
+   */
+  PackedPointCloudWriter(const uint64_t base_timestamp, const size_t capacity,
+                         PointCloud* cloud);
+
+  void AddPoint(const float x, const float y, const float z,
+                const uint32_t intensity, const uint64_t timestamp);
+
+  void AddPoint(const PointXYZIT& point) {
+    AddPoint(point.x(), point.y(), point.z(), point.intensity(),
+             point.timestamp());
+  }
+
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Trim the packed bytes to the points added.
+   */
+  void Finish();
+
+ private:
+  uint64_t base_timestamp_ = 0;
+  size_t size_ = 0;
+  std::string* packed_point_ = nullptr;
+};
+
+// number of packed points of the cloud
+inline size_t PackedPointSize(const PointCloud& cloud) {
+  return cloud.packed_point().size() / kPackedPointBytes;
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
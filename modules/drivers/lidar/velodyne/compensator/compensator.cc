@@ -86,7 +86,9 @@ bool Compensator::MotionCompensation(
   uint64_t new_time = cyber::Time().Now().ToNanosecond();
   AINFO << "compenstator new msg diff:" << new_time - start
         << ";meta:" << msg->header().lidar_timestamp();
-  msg_compensated->mutable_point()->Reserve(240000);
+  if (!config_.packed_output()) {
+    msg_compensated->mutable_point()->Reserve(240000);
+  }
 
   // compensate point cloud, remove nan point
   if (QueryPoseAffineFromTF2(timestamp_min, &pose_min_time, frame_id) &&
@@ -97,7 +99,11 @@ bool Compensator::MotionCompensation(
     MotionCompensation(msg, msg_compensated, timestamp_min, timestamp_max,
                        pose_min_time, pose_max_time);
     uint64_t com_time = cyber::Time().Now().ToNanosecond();
-    msg_compensated->set_width(msg_compensated->point_size() / msg->height());
+    const size_t num_points = config_.packed_output()
+                                  ? lidar::PackedPointSize(*msg_compensated)
+                                  : msg_compensated->point_size();
+    msg_compensated->set_width(static_cast<uint32_t>(num_points) /
+                               msg->height());
     AINFO << "compenstator com msg diff:" << com_time - tf_time
           << ";meta:" << msg->header().lidar_timestamp();
     return true;
@@ -141,6 +147,27 @@ void Compensator::MotionCompensation(
   q1.normalize();
   translation = q_max.conjugate() * translation;
 
+  // the packed points are written at once, without a message per point
+  std::unique_ptr<lidar::PackedPointCloudWriter> packed_writer;
+  if (config_.packed_output()) {
+    packed_writer.reset(new lidar::PackedPointCloudWriter(
+        timestamp_min, msg->point_size(), msg_compensated.get()));
+  }
+  const auto add_point = [&msg_compensated, &packed_writer](
+                             const PointXYZIT& point, const float x,
+                             const float y, const float z) {
+    if (packed_writer != nullptr) {
+      packed_writer->AddPoint(x, y, z, point.intensity(), point.timestamp());
+      return;
+    }
+    auto* point_new = msg_compensated->add_point();
+    point_new->set_intensity(point.intensity());
+    point_new->set_timestamp(point.timestamp());
+    point_new->set_x(x);
+    point_new->set_y(y);
+    point_new->set_z(z);
+  };
+
   // int total = msg->width * msg->height;
 
   double d = q0.dot(q1);
@@ -161,8 +188,7 @@ void Compensator::MotionCompensation(
       float x_scalar = point.x();
       if (std::isnan(x_scalar)) {
         // if (config_.organized()) {
-        auto* point_new = msg_compensated->add_point();
-        point_new->CopyFrom(point);
+        add_point(point, point.x(), point.y(), point.z());
         // } else {
         //   AERROR << "nan point do not need motion compensation";
         // }
@@ -184,12 +210,11 @@ void Compensator::MotionCompensation(
       Eigen::Affine3d trans = ti * qi;
       p = trans * p;
 
-      auto* point_new = msg_compensated->add_point();
-      point_new->set_intensity(point.intensity());
-      point_new->set_timestamp(point.timestamp());
-      point_new->set_x(static_cast<float>(p.x()));
-      point_new->set_y(static_cast<float>(p.y()));
-      point_new->set_z(static_cast<float>(p.z()));
+      add_point(point, static_cast<float>(p.x()), static_cast<float>(p.y()),
+                static_cast<float>(p.z()));
+    }
+    if (packed_writer != nullptr) {
+      packed_writer->Finish();
     }
     return;
   }
@@ -210,12 +235,11 @@ void Compensator::MotionCompensation(
 
     p = ti * p;
 
-    auto* point_new = msg_compensated->add_point();
-    point_new->set_intensity(point.intensity());
-    point_new->set_timestamp(point.timestamp());
-    point_new->set_x(static_cast<float>(p.x()));
-    point_new->set_y(static_cast<float>(p.y()));
-    point_new->set_z(static_cast<float>(p.z()));
+    add_point(point, static_cast<float>(p.x()), static_cast<float>(p.y()),
+              static_cast<float>(p.z()));
+  }
+  if (packed_writer != nullptr) {
+    packed_writer->Finish();
   }
 }
 
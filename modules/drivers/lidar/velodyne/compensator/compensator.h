@@ -30,6 +30,8 @@
 #include "modules/drivers/lidar/proto/velodyne_config.pb.h"
 #include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
 
+#include "modules/drivers/lidar/common/packed_point_cloud/packed_point_cloud.h"
+
 #include "modules/transform/buffer.h"
 
 namespace apollo {
@@ -15,16 +15,20 @@
  *****************************************************************************/
 #pragma once
 
+#include <atomic>
 #include <deque>
 #include <list>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <vector>
 
 #include "modules/perception/base/object_pool.h"
 
+// pooling is opt in: build with -DPERCEPTION_BASE_ENABLE_POOL to recycle the
+// objects, which then rely on the Reset of their initializer to start clean
+#ifndef PERCEPTION_BASE_ENABLE_POOL
 #define PERCEPTION_BASE_DISABLE_POOL
+#endif
 namespace apollo {
 namespace perception {
 namespace base {
@@ -37,6 +41,138 @@ template <class T>
 struct ObjectPoolDefaultInitializer {
   void operator()(T* t) const {}
 };
+
+// @brief objects of a pool and the control blocks of the shared pointers it
+//        hands out. A released object goes on top of the free objects and
+//        its control block on top of the free blocks, so that a get in the
+//        steady state allocates nothing and reuses the memory released last.
+//        Owned by the pool and by the pointers handed out, which may outlive
+//        the pool.
+template <class ObjectType>
+class PoolStorage {
+ public:
+  PoolStorage() = default;
+  ~PoolStorage() {
+    for (void* block : free_blocks_) {
+      ::operator delete(block);
+    }
+  }
+  // @brief add num objects, should add lock before invoke this function
+  void Add(size_t num) {
+    objects_.reserve(objects_.size() + num);
+    // room for all the objects, a release never allocates
+    free_objects_.reserve(objects_.size() + num);
+    for (size_t i = 0; i < num; ++i) {
+      objects_.emplace_back(new ObjectType);
+      free_objects_.push_back(objects_.back().get());
+    }
+    num_allocs_ += num;
+  }
+  // @brief take the free object released last, should add lock before invoke
+  //        this function
+  ObjectType* Pop() {
+    ObjectType* object = free_objects_.back();
+    free_objects_.pop_back();
+    return object;
+  }
+  // @brief give back an object released by all its owners
+  void Push(ObjectType* object) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_objects_.push_back(object);
+  }
+  // @brief allocate a control block, from the free blocks if there is one
+  void* AllocateBlock(size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (block_size_ == 0) {
+        block_size_ = size;
+      }
+      if (size == block_size_ && !free_blocks_.empty()) {
+        void* block = free_blocks_.back();
+        free_blocks_.pop_back();
+        return block;
+      }
+    }
+    ++num_allocs_;
+    return ::operator new(size);
+  }
+  // @brief give back a control block
+  void DeallocateBlock(void* block, size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (size == block_size_) {
+        free_blocks_.push_back(block);
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+  size_t size() const { return objects_.size(); }
+  size_t num_free() const { return free_objects_.size(); }
+  size_t num_allocs() const { return num_allocs_; }
+
+  std::mutex mutex_;
+
+ private:
+  std::vector<std::unique_ptr<ObjectType>> objects_;
+  std::vector<ObjectType*> free_objects_;
+  size_t block_size_ = 0;
+  std::vector<void*> free_blocks_;
+  std::atomic<size_t> num_allocs_{0};
+};
+
+// @brief deleter of the pointers handed out by a pool, gives the object back
+template <class ObjectType>
+struct PoolDeleter {
+  void operator()(ObjectType* object) const { storage->Push(object); }
+  std::shared_ptr<PoolStorage<ObjectType>> storage;
+};
+
+// @brief allocator of the control blocks of the pointers handed out by a pool
+template <class T, class ObjectType>
+struct PoolBlockAllocator {
+  typedef T value_type;
+  template <class U>
+  struct rebind {
+    typedef PoolBlockAllocator<U, ObjectType> other;
+  };
+
+  explicit PoolBlockAllocator(
+      const std::shared_ptr<PoolStorage<ObjectType>>& pool_storage)
+      : storage(pool_storage) {}
+  template <class U>
+  PoolBlockAllocator(const PoolBlockAllocator<U, ObjectType>& other)
+      : storage(other.storage) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(storage->AllocateBlock(n * sizeof(T)));
+  }
+  void deallocate(T* block, size_t n) {
+    storage->DeallocateBlock(block, n * sizeof(T));
+  }
+  template <class U>
+  bool operator==(const PoolBlockAllocator<U, ObjectType>& other) const {
+    return storage == other.storage;
+  }
+  template <class U>
+  bool operator!=(const PoolBlockAllocator<U, ObjectType>& other) const {
+    return storage != other.storage;
+  }
+
+  std::shared_ptr<PoolStorage<ObjectType>> storage;
+};
+
+// @brief share an object of the storage, given back to it once released by
+//        all the owners
+template <class ObjectType>
+std::shared_ptr<ObjectType> SharePooledObject(
+    const std::shared_ptr<PoolStorage<ObjectType>>& storage,
+    ObjectType* object) {
+  return std::shared_ptr<ObjectType>(
+      object, PoolDeleter<ObjectType>{storage},
+      PoolBlockAllocator<ObjectType, ObjectType>(storage));
+}
+
 // @brief concurrent object pool with dynamic size
 template <class ObjectType, size_t N = kPoolDefaultSize,
           class Initializer = ObjectPoolDefaultInitializer<ObjectType>>
@@ -44,67 +180,23 @@ class ConcurrentObjectPool : public BaseObjectPool<ObjectType> {
  public:
   // using ObjectTypePtr = typename BaseObjectPool<ObjectType>::ObjectTypePtr;
   using BaseObjectPool<ObjectType>::capacity_;
+  using BaseObjectPool<ObjectType>::num_gets_;
+  using BaseObjectPool<ObjectType>::num_allocs_;
   // @brief Only allow accessing from global instance
   static ConcurrentObjectPool& Instance() {
     static ConcurrentObjectPool pool(N);
     return pool;
   }
   // @brief overrided function to get object smart pointer
-  std::shared_ptr<ObjectType> Get() override {
-// TODO(All): remove conditional build
-#ifndef PERCEPTION_BASE_DISABLE_POOL
-    ObjectType* ptr = nullptr;
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (queue_.empty()) {
-        Add(1 + kPoolDefaultExtendNum);
-      }
-      ptr = queue_.front();
-      queue_.pop();
-    }
-    // For efficiency consideration, initialization should be invoked
-    // after releasing the mutex
-    kInitializer(ptr);
-    return std::shared_ptr<ObjectType>(ptr, [&](ObjectType* obj_ptr) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      queue_.push(obj_ptr);
-    });
-#else
-    return std::shared_ptr<ObjectType>(new ObjectType);
-#endif
-  }
+  std::shared_ptr<ObjectType> Get() override { return Create(1); }
   // @brief overrided function to get batch of smart pointers
   // @params[IN] num: batch number
   // @params[OUT] data: vector container to store the pointers
   void BatchGet(size_t num,
                 std::vector<std::shared_ptr<ObjectType>>* data) override {
-#ifndef PERCEPTION_BASE_DISABLE_POOL
-    std::vector<ObjectType*> buffer(num, nullptr);
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (queue_.size() < num) {
-        Add(num - queue_.size() + kPoolDefaultExtendNum);
-      }
-      for (size_t i = 0; i < num; ++i) {
-        buffer[i] = queue_.front();
-        queue_.pop();
-      }
-    }
-    // For efficiency consideration, initialization should be invoked
-    // after releasing the mutex
     for (size_t i = 0; i < num; ++i) {
-      kInitializer(buffer[i]);
-      data->emplace_back(
-          std::shared_ptr<ObjectType>(buffer[i], [&](ObjectType* obj_ptr) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(obj_ptr);
-          }));
+      data->push_back(Create(num - i));
     }
-#else
-    for (size_t i = 0; i < num; ++i) {
-      data->emplace_back(new ObjectType);
-    }
-#endif
   }
   // @brief overrided function to get batch of smart pointers
   // @params[IN] num: batch number
@@ -112,40 +204,10 @@ class ConcurrentObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: list container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::list<std::shared_ptr<ObjectType>>* data) override {
-#ifndef PERCEPTION_BASE_DISABLE_POOL
-    std::vector<ObjectType*> buffer(num, nullptr);
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (queue_.size() < num) {
-        Add(num - queue_.size() + kPoolDefaultExtendNum);
-      }
-      for (size_t i = 0; i < num; ++i) {
-        buffer[i] = queue_.front();
-        queue_.pop();
-      }
-    }
-    // For efficiency consideration, initialization should be invoked
-    // after releasing the mutex
     for (size_t i = 0; i < num; ++i) {
-      kInitializer(buffer[i]);
-      is_front ? data->emplace_front(std::shared_ptr<ObjectType>(
-                     buffer[i],
-                     [&](ObjectType* obj_ptr) {
-                       std::lock_guard<std::mutex> lock(mutex_);
-                       queue_.push(obj_ptr);
-                     }))
-               : data->emplace_back(std::shared_ptr<ObjectType>(
-                     buffer[i], [&](ObjectType* obj_ptr) {
-                       std::lock_guard<std::mutex> lock(mutex_);
-                       queue_.push(obj_ptr);
-                     }));
+      is_front ? data->push_front(Create(num - i))
+               : data->push_back(Create(num - i));
     }
-#else
-    for (size_t i = 0; i < num; ++i) {
-      is_front ? data->emplace_front(new ObjectType)
-               : data->emplace_back(new ObjectType);
-    }
-#endif
   }
   // @brief overrided function to get batch of smart pointers
   // @params[IN] num: batch number
@@ -153,93 +215,71 @@ class ConcurrentObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: deque container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::deque<std::shared_ptr<ObjectType>>* data) override {
-#ifndef PERCEPTION_BASE_DISABLE_POOL
-    std::vector<ObjectType*> buffer(num, nullptr);
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (queue_.size() < num) {
-        Add(num - queue_.size() + kPoolDefaultExtendNum);
-      }
-      for (size_t i = 0; i < num; ++i) {
-        buffer[i] = queue_.front();
-        queue_.pop();
-      }
-    }
     for (size_t i = 0; i < num; ++i) {
-      kInitializer(buffer[i]);
-      is_front ? data->emplace_front(std::shared_ptr<ObjectType>(
-                     buffer[i],
-                     [&](ObjectType* obj_ptr) {
-                       std::lock_guard<std::mutex> lock(mutex_);
-                       queue_.push(obj_ptr);
-                     }))
-               : data->emplace_back(std::shared_ptr<ObjectType>(
-                     buffer[i], [&](ObjectType* obj_ptr) {
-                       std::lock_guard<std::mutex> lock(mutex_);
-                       queue_.push(obj_ptr);
-                     }));
+      is_front ? data->push_front(Create(num - i))
+               : data->push_back(Create(num - i));
     }
-#else
-    for (size_t i = 0; i < num; ++i) {
-      is_front ? data->emplace_front(new ObjectType)
-               : data->emplace_back(new ObjectType);
-    }
-#endif
   }
 #ifndef PERCEPTION_BASE_DISABLE_POOL
   // @brief overrided function to set capacity
   void set_capacity(size_t capacity) override {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
     if (capacity_ < capacity) {
       Add(capacity - capacity_);
     }
   }
   // @brief get remained object number
-  size_t RemainedNum() override { return queue_.size(); }
-#endif
-  // @brief destructor to release the cached memory
-  ~ConcurrentObjectPool() override {
-    if (cache_) {
-      delete[] cache_;
-      cache_ = nullptr;
-    }
-    for (auto& ptr : extended_cache_) {
-      delete ptr;
-    }
-    extended_cache_.clear();
+  size_t RemainedNum() override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    return storage_->num_free();
   }
+  // @brief overrided function to get the number of heap allocations
+  size_t num_allocs() const override { return storage_->num_allocs(); }
+#endif
+  // @brief destructor, the objects still in use go with their last owner
+  ~ConcurrentObjectPool() override = default;
 
  protected:
-// @brief add num objects, should add lock before invoke this function
+  // @brief get an object, num is the number of objects the get still hands
+  //        out, by which an empty pool grows
+  std::shared_ptr<ObjectType> Create(size_t num) {
+    ++num_gets_;
 #ifndef PERCEPTION_BASE_DISABLE_POOL
-  void Add(size_t num) {
-    for (size_t i = 0; i < num; ++i) {
-      ObjectType* ptr = new ObjectType;
-      extended_cache_.push_back(ptr);
-      queue_.push(ptr);
+    ObjectType* ptr = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(storage_->mutex_);
+      if (storage_->num_free() == 0) {
+        Add(num + kPoolDefaultExtendNum);
+      }
+      ptr = storage_->Pop();
     }
-    capacity_ = kDefaultCacheSize + extended_cache_.size();
+    // For efficiency consideration, initialization should be invoked
+    // after releasing the mutex
+    kInitializer(ptr);
+    return SharePooledObject(storage_, ptr);
+#else
+    num_allocs_ += 2;
+    return std::shared_ptr<ObjectType>(new ObjectType);
+#endif
+  }
+#ifndef PERCEPTION_BASE_DISABLE_POOL
+  // @brief add num objects, should add lock before invoke this function
+  void Add(size_t num) {
+    storage_->Add(num);
+    capacity_ = storage_->size();
   }
 #endif
   // @brief default constructor
   explicit ConcurrentObjectPool(const size_t default_size)
       : kDefaultCacheSize(default_size) {
 #ifndef PERCEPTION_BASE_DISABLE_POOL
-    cache_ = new ObjectType[kDefaultCacheSize];
-    for (size_t i = 0; i < kDefaultCacheSize; ++i) {
-      queue_.push(&cache_[i]);
-    }
-    capacity_ = kDefaultCacheSize;
+    storage_ = std::make_shared<PoolStorage<ObjectType>>();
+    Add(kDefaultCacheSize);
 #endif
   }
-  std::mutex mutex_;
-  std::queue<ObjectType*> queue_;
-  // @brief point to a continuous memory of default pool size
-  ObjectType* cache_ = nullptr;
+  std::shared_ptr<PoolStorage<ObjectType>> storage_;
   const size_t kDefaultCacheSize;
-  // @brief list to store extended memory, not as efficient
-  std::list<ObjectType*> extended_cache_;
-  static const Initializer kInitializer;
+  const Initializer kInitializer = Initializer();
 };
 
 }  // namespace base
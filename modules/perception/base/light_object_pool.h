@@ -19,7 +19,7 @@
 #include <list>
 #include <map>
 #include <memory>
-#include <queue>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,6 +39,7 @@ template <class ObjectType, size_t N = kPoolDefaultSize,
 class LightObjectPool : public BaseObjectPool<ObjectType> {
  public:
   using BaseObjectPool<ObjectType>::capacity_;
+  using BaseObjectPool<ObjectType>::num_gets_;
 
   // @brief Only allow accessing from global instance
   static LightObjectPool& Instance(
@@ -55,33 +56,15 @@ class LightObjectPool : public BaseObjectPool<ObjectType> {
   }
 
   // @brief overrided function to get object smart pointer
-  std::shared_ptr<ObjectType> Get() override {
-    ObjectType* ptr = nullptr;
-    if (queue_.empty()) {
-      Add(1 + kPoolDefaultExtendNum);
-    }
-    ptr = queue_.front();
-    queue_.pop();
-    kInitializer(ptr);
-    return std::shared_ptr<ObjectType>(
-        ptr, [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); });
-  }
+  std::shared_ptr<ObjectType> Get() override { return Create(1); }
 
   // @brief overrided function to get batch of smart pointers
   // @params[IN] num: batch number
   // @params[OUT] data: vector container to store the pointers
   void BatchGet(size_t num,
                 std::vector<std::shared_ptr<ObjectType>>* data) override {
-    if (queue_.size() < num) {
-      Add(num - queue_.size() + kPoolDefaultExtendNum);
-    }
-    ObjectType* ptr = nullptr;
     for (size_t i = 0; i < num; ++i) {
-      ptr = queue_.front();
-      queue_.pop();
-      kInitializer(ptr);
-      data->emplace_back(std::shared_ptr<ObjectType>(
-          ptr, [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); }));
+      data->push_back(Create(num - i));
     }
   }
 
@@ -91,21 +74,9 @@ class LightObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: list container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::list<std::shared_ptr<ObjectType>>* data) override {
-    std::vector<ObjectType*> buffer(num, nullptr);
-    if (queue_.size() < num) {
-      Add(num - queue_.size() + kPoolDefaultExtendNum);
-    }
-    for (size_t i = 0; i < num; ++i) {
-      buffer[i] = queue_.front();
-      queue_.pop();
-    }
     for (size_t i = 0; i < num; ++i) {
-      kInitializer(buffer[i]);
-      is_front
-          ? data->emplace_front(std::shared_ptr<ObjectType>(
-                buffer[i], [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); }))
-          : data->emplace_back(std::shared_ptr<ObjectType>(
-                buffer[i], [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); }));
+      is_front ? data->push_front(Create(num - i))
+               : data->push_back(Create(num - i));
     }
   }
 
@@ -115,72 +86,60 @@ class LightObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: deque container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::deque<std::shared_ptr<ObjectType>>* data) override {
-    std::vector<ObjectType*> buffer(num, nullptr);
-    if (queue_.size() < num) {
-      Add(num - queue_.size() + kPoolDefaultExtendNum);
-    }
     for (size_t i = 0; i < num; ++i) {
-      buffer[i] = queue_.front();
-      queue_.pop();
-    }
-    for (size_t i = 0; i < num; ++i) {
-      kInitializer(buffer[i]);
-      is_front
-          ? data->emplace_front(std::shared_ptr<ObjectType>(
-                buffer[i], [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); }))
-          : data->emplace_back(std::shared_ptr<ObjectType>(
-                buffer[i], [&](ObjectType* obj_ptr) { queue_.push(obj_ptr); }));
+      is_front ? data->push_front(Create(num - i))
+               : data->push_back(Create(num - i));
     }
   }
 
   // @brief overrided function to set capacity
   void set_capacity(size_t capacity) override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
     if (capacity_ < capacity) {
       Add(capacity - capacity_);
     }
   }
 
   // @brief get remained object number
-  size_t RemainedNum() override { return queue_.size(); }
-  // @brief destructor to release the cached memory
-  ~LightObjectPool() override {
-    if (cache_) {
-      delete[] cache_;
-      cache_ = nullptr;
-    }
-    for (auto& ptr : extended_cache_) {
-      delete ptr;
+  size_t RemainedNum() override { return storage_->num_free(); }
+  // @brief overrided function to get the number of heap allocations
+  size_t num_allocs() const override { return storage_->num_allocs(); }
+  // @brief destructor, the objects still in use go with their last owner
+  ~LightObjectPool() override = default;
+
+ protected:
+  // @brief get an object, num is the number of objects the get still hands
+  //        out, by which an empty pool grows
+  std::shared_ptr<ObjectType> Create(size_t num) {
+    ObjectType* ptr = nullptr;
+    {
+      // the objects may be released on other threads
+      std::lock_guard<std::mutex> lock(storage_->mutex_);
+      if (storage_->num_free() == 0) {
+        Add(num + kPoolDefaultExtendNum);
+      }
+      ptr = storage_->Pop();
     }
-    extended_cache_.clear();
+    ++num_gets_;
+    kInitializer(ptr);
+    return SharePooledObject(storage_, ptr);
   }
 
- protected:
   // @brief add num objects, should add lock before invoke this function
   void Add(size_t num) {
-    for (size_t i = 0; i < num; ++i) {
-      ObjectType* ptr = new ObjectType;
-      extended_cache_.push_back(ptr);
-      queue_.push(ptr);
-    }
-    capacity_ = kDefaultCacheSize + extended_cache_.size();
+    storage_->Add(num);
+    capacity_ = storage_->size();
   }
 
   // @brief default constructor
   explicit LightObjectPool(const size_t default_size)
-      : kDefaultCacheSize(default_size) {
-    cache_ = new ObjectType[kDefaultCacheSize];
-    for (size_t i = 0; i < kDefaultCacheSize; ++i) {
-      queue_.push(&cache_[i]);
-    }
-    capacity_ = kDefaultCacheSize;
+      : storage_(std::make_shared<PoolStorage<ObjectType>>()),
+        kDefaultCacheSize(default_size) {
+    Add(kDefaultCacheSize);
   }
 
-  std::queue<ObjectType*> queue_;
-  // @brief point to a continuous memory of default pool size
-  ObjectType* cache_ = nullptr;
+  std::shared_ptr<PoolStorage<ObjectType>> storage_;
   const size_t kDefaultCacheSize;
-  // @brief list to store extended memory, not as efficient
-  std::list<ObjectType*> extended_cache_;
   // TODO(All): Fix lint issue with static const
   Initializer kInitializer;
   // Initializer kInitializer;
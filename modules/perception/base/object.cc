@@ -63,6 +63,8 @@ void Object::Reset() {
 
   car_light.Reset();
   motion_state = MotionState::UNKNOWN;
+  drop_num = 0;
+  b_cipv = false;
 
   lidar_supplement.Reset();
   radar_supplement.Reset();
@@ -15,6 +15,7 @@
  *****************************************************************************/
 #pragma once
 
+#include <atomic>
 #include <deque>
 #include <list>
 #include <memory>
@@ -59,11 +60,18 @@ class BaseObjectPool {
   size_t get_capacity() { return capacity_; }
   // @brief get remained object number
   virtual size_t RemainedNum() { return 0; }
+  // @brief number of objects handed out
+  size_t num_gets() const { return num_gets_; }
+  // @brief number of heap allocations made to hand out the objects, of the
+  //        objects and of the control blocks of their pointers
+  virtual size_t num_allocs() const { return num_allocs_; }
 
  protected:
   BaseObjectPool(const BaseObjectPool& rhs) = delete;
   BaseObjectPool& operator=(const BaseObjectPool& rhs) = delete;
   size_t capacity_ = 0;
+  std::atomic<size_t> num_gets_{0};
+  std::atomic<size_t> num_allocs_{0};
 };  // class BaseObjectPool
 
 // @brief dummy object pool implementation, not managing memory
@@ -77,6 +85,7 @@ class DummyObjectPool : public BaseObjectPool<ObjectType> {
   }
   // @brief overrided function to get object smart pointer
   std::shared_ptr<ObjectType> Get() override {
+    Count(1);
     return std::shared_ptr<ObjectType>(new ObjectType);
   }
   // @brief overrided function to get batch of smart pointers
@@ -84,6 +93,7 @@ class DummyObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: vector container to store the pointers
   void BatchGet(size_t num,
                 std::vector<std::shared_ptr<ObjectType>>* data) override {
+    Count(num);
     for (size_t i = 0; i < num; ++i) {
       data->emplace_back(std::shared_ptr<ObjectType>(new ObjectType));
     }
@@ -94,6 +104,7 @@ class DummyObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: list container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::list<std::shared_ptr<ObjectType>>* data) override {
+    Count(num);
     for (size_t i = 0; i < num; ++i) {
       is_front
           ? data->emplace_front(std::shared_ptr<ObjectType>(new ObjectType))
@@ -106,6 +117,7 @@ class DummyObjectPool : public BaseObjectPool<ObjectType> {
   // @params[OUT] data: deque container to store the pointers
   void BatchGet(size_t num, bool is_front,
                 std::deque<std::shared_ptr<ObjectType>>* data) override {
+    Count(num);
     for (size_t i = 0; i < num; ++i) {
       is_front
           ? data->emplace_front(std::shared_ptr<ObjectType>(new ObjectType))
@@ -116,6 +128,11 @@ class DummyObjectPool : public BaseObjectPool<ObjectType> {
  protected:
   // @brief default constructor
   DummyObjectPool() = default;
+  // @brief a get allocates the objects and their control blocks
+  void Count(size_t num) {
+    this->num_gets_ += num;
+    this->num_allocs_ += 2 * num;
+  }
 };  // class DummyObjectPool
 
 }  // namespace base
@@ -282,6 +282,51 @@ TEST(ObjectPoolTest, concurrent_object_pool_initializer_test) {
   }
 }
 
+TEST(ObjectPoolTest, concurrent_object_pool_recycle_test) {
+  typedef ConcurrentObjectPool<Object, 20, ObjectInitializer> TestObjectPool;
+  auto& pool = TestObjectPool::Instance();
+  // frames of objects released at the end of the frame, the first one
+  // allocates the control blocks
+  size_t num_allocs = 0;
+  const size_t num_gets = pool.num_gets();
+  for (int frame = 0; frame < 100; ++frame) {
+    if (frame == 1) {
+      num_allocs = pool.num_allocs();
+    }
+    std::vector<std::shared_ptr<Object>> objects;
+    pool.BatchGet(15, &objects);
+    objects.push_back(pool.Get());
+    for (auto& object : objects) {
+      EXPECT_EQ(object->id, -1);
+      EXPECT_TRUE(object->polygon.empty());
+      object->id = frame;
+      object->polygon.resize(8);
+    }
+  }
+  EXPECT_EQ(pool.num_gets(), num_gets + 1600);
+#ifndef PERCEPTION_BASE_DISABLE_POOL
+  EXPECT_EQ(pool.num_allocs(), num_allocs);
+  EXPECT_EQ(pool.RemainedNum(), 20);
+  // an object kept across frames is not handed out again
+  std::shared_ptr<Object> kept = pool.Get();
+  kept->id = 7;
+  for (int frame = 0; frame < 10; ++frame) {
+    if (frame == 1) {
+      num_allocs = pool.num_allocs();
+    }
+    std::vector<std::shared_ptr<Object>> objects;
+    pool.BatchGet(19, &objects);
+    for (auto& object : objects) {
+      EXPECT_NE(object, kept);
+    }
+  }
+  EXPECT_EQ(kept->id, 7);
+  EXPECT_EQ(pool.num_allocs(), num_allocs);
+#else
+  EXPECT_EQ(pool.num_allocs(), num_allocs + 2 * 1584);
+#endif
+}
+
 TEST(ObjectPoolTest, light_object_pool_capacity_test) {
   typedef LightObjectPool<Object, kPoolDefaultSize, TestObjectPoolInitializer,
                           SensorType::UNKNOWN_SENSOR_TYPE>
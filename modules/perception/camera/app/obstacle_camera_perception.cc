@@ -29,6 +29,7 @@
 #include "modules/perception/common/io/io_util.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
 #include "modules/perception/inference/utils/cuda_util.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 
 namespace apollo {
 namespace perception {
@@ -327,7 +328,7 @@ bool ObstacleCameraPerception::Perception(
   ObstaclePostprocessorOptions obstacle_postprocessor_options;
   ObstacleTrackerOptions tracker_options;
   FeatureExtractorOptions extractor_options;
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   frame->camera_k_matrix =
       name_intrinsic_map_.at(frame->data_provider->sensor_name());
   if (frame->calibration_service == nullptr) {
@@ -341,27 +342,27 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to detect lane.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "LaneDetector");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "LaneDetector");
 
   if (!lane_postprocessor_->Process2D(lane_postprocessor_options, frame)) {
     AERROR << "Failed to postprocess lane 2D.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "LanePostprocessor2D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "LanePostprocessor2D");
 
   // Calibration service
   frame->calibration_service->Update(frame);
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "CalibrationService");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "CalibrationService");
 
   if (!lane_postprocessor_->Process3D(lane_postprocessor_options, frame)) {
     AERROR << "Failed to postprocess lane 3D.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "LanePostprocessor3D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "LanePostprocessor3D");
 
   if (write_out_lane_file_) {
     std::string lane_file_path =
@@ -380,7 +381,8 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to predict.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "Predict");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Predict");
 
   std::shared_ptr<BaseObstacleDetector> detector =
       name_detector_map_.at(frame->data_provider->sensor_name());
@@ -389,7 +391,8 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to detect.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "detect");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "detect");
 
   // Save all detections results as kitti format
   WriteDetections(
@@ -401,8 +404,8 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to extractor";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "external_feature");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "external_feature");
 
   // Save detection results with bbox, detection_feature
   WriteDetections(
@@ -419,15 +422,15 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to associate2d.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Associate2D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Associate2D");
 
   if (!transformer_->Transform(transformer_options, frame)) {
     AERROR << "Failed to transform.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Transform");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Transform");
 
   // Obstacle postprocessor
   obstacle_postprocessor_options.do_refinement_with_calibration_service =
@@ -437,21 +440,22 @@ bool ObstacleCameraPerception::Perception(
     AERROR << "Failed to post process obstacles.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "PostprocessObsacle");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "PostprocessObsacle");
 
   if (!tracker_->Associate3D(tracker_options, frame)) {
     AERROR << "Failed to Associate3D.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Associate3D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Associate3D");
 
   if (!tracker_->Track(tracker_options, frame)) {
     AERROR << "Failed to track.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "Track");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Track");
 
   if (perception_param_.has_debug_param()) {
     if (perception_param_.debug_param().has_camera2world_out_file()) {
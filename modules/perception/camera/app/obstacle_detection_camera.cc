@@ -33,6 +33,7 @@
 #include "modules/perception/common/io/io_util.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
 #include "modules/perception/inference/utils/cuda_util.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 
 namespace apollo {
 namespace perception {
@@ -270,7 +271,7 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
   ObstaclePostprocessorOptions obstacle_postprocessor_options;
   ObstacleTrackerOptions tracker_options;
   FeatureExtractorOptions extractor_options;
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   frame->camera_k_matrix =
       name_intrinsic_map_.at(frame->data_provider->sensor_name());
 
@@ -279,7 +280,8 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
     AERROR << "Failed to predict.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "Predict");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Predict");
 
   std::shared_ptr<BaseObstacleDetector> detector =
       name_detector_map_.at(frame->data_provider->sensor_name());
@@ -288,7 +290,8 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
     AERROR << "Failed to detect.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "detect");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "detect");
 
   // Save all detections results as kitti format
   WriteDetections(
@@ -301,8 +304,8 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
   //   AERROR << "Failed to extractor";
   //   return false;
   // }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "external_feature");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "external_feature");
 
   // Save detection results with bbox, detection_feature
   WriteDetections(
@@ -319,15 +322,15 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
     AERROR << "Failed to associate2d.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Associate2D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Associate2D");
 
   if (!transformer_->Transform(transformer_options, frame)) {
     AERROR << "Failed to transform.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Transform");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Transform");
 
   // Obstacle postprocessor
   obstacle_postprocessor_options.do_refinement_with_calibration_service =
@@ -337,21 +340,22 @@ bool ObstacleDetectionCamera::Perception(const CameraPerceptionOptions &options,
     AERROR << "Failed to post process obstacles.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "PostprocessObsacle");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "PostprocessObsacle");
 
   if (!tracker_->Associate3D(tracker_options, frame)) {
     AERROR << "Failed to Associate3D.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
-                                "Associate3D");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Associate3D");
 
   if (!tracker_->Track(tracker_options, frame)) {
     AERROR << "Failed to track.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(), "Track");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(frame->data_provider->sensor_name(),
+                                           "Track");
 
   if (perception_param_.has_debug_param()) {
     if (perception_param_.debug_param().has_camera2world_out_file()) {
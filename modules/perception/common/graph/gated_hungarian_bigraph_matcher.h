@@ -26,6 +26,7 @@
 
 #include "modules/perception/common/graph/connected_component_analysis.h"
 #include "modules/perception/common/graph/hungarian_optimizer.h"
+#include "modules/perception/common/graph/sparse_assignment_solver.h"
 
 namespace apollo {
 namespace perception {
@@ -52,6 +53,15 @@ class GatedHungarianMatcher {
   const SecureMat<T>& global_costs() const { return global_costs_; }
   SecureMat<T>* mutable_global_costs() { return &global_costs_; }
 
+  /* @brief: solve the gated costs with the sparse assignment solver instead
+   * of the hungarian optimizer over each connected component. both reach the
+   * same optimum, the choice among equally good assignments may differ, and
+   * the assignments of the sparse solver are sorted by row. */
+  void set_use_sparse_solver(bool use_sparse_solver) {
+    use_sparse_solver_ = use_sparse_solver;
+  }
+  bool use_sparse_solver() const { return use_sparse_solver_; }
+
   void Match(T cost_thresh, OptimizeFlag opt_flag,
              std::vector<std::pair<size_t, size_t>>* assignments,
              std::vector<size_t>* unassigned_rows,
@@ -97,9 +107,17 @@ class GatedHungarianMatcher {
   void OptimizeAdapter(
       std::vector<std::pair<size_t, size_t>>* local_assignments);
 
+  /* @brief: replace step 2 & 3, the valid costs are the edges of the sparse
+   * solver, with the gain over the bound value as weight. */
+  void OptimizeSparse();
+
   /* Hungarian optimizer */
   HungarianOptimizer<T> optimizer_;
 
+  /* sparse assignment solver */
+  bool use_sparse_solver_ = false;
+  SparseAssignmentSolver<T> sparse_solver_;
+
   /* global costs matrix */
   SecureMat<T> global_costs_;
 
@@ -147,6 +165,12 @@ void GatedHungarianMatcher<T>::Match(
   assignments_ptr_ = assignments;
   MatchInit();
 
+  if (use_sparse_solver_) {
+    this->OptimizeSparse();
+    this->GenerateUnassignedData(unassigned_rows, unassigned_cols);
+    return;
+  }
+
   /* compute components */
   std::vector<std::vector<size_t>> row_components;
   std::vector<std::vector<size_t>> col_components;
@@ -260,6 +284,28 @@ void GatedHungarianMatcher<T>::OptimizeConnectedComponent(
   }
 }
 
+template <typename T>
+void GatedHungarianMatcher<T>::OptimizeSparse() {
+  /* with invalid costs at the bound value, the hungarian optimizer reaches
+   * the matching of the valid pairs with the largest total gain over the
+   * bound value. the scan covers every pair, so compare with the threshold
+   * directly and go by column, in the order of the storage. */
+  const bool minimize = opt_flag_ == OptimizeFlag::OPTMIN;
+  sparse_solver_.Reset(rows_num_, cols_num_);
+  for (size_t j = 0; j < cols_num_; ++j) {
+    for (size_t i = 0; i < rows_num_; ++i) {
+      const T current_cost = global_costs_(i, j);
+      if (minimize ? current_cost < cost_thresh_
+                   : current_cost > cost_thresh_) {
+        sparse_solver_.AddEdge(i, j,
+                               minimize ? bound_value_ - current_cost
+                                        : current_cost - bound_value_);
+      }
+    }
+  }
+  sparse_solver_.Maximize(assignments_ptr_);
+}
+
 template <typename T>
 void GatedHungarianMatcher<T>::GenerateUnassignedData(
     std::vector<size_t>* unassigned_rows,
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Latency of GatedHungarianMatcher with the hungarian optimizer over the
+// connected components (argument 1 is 0) and with the sparse assignment
+// solver (argument 1 is 1), on the track to object costs of a synthetic
+// scene: the center distance of the tracks, predicted with some noise, to
+// the detections, gated at 4m with a bound of 100 as in the lidar tracker.
+// BM_MatchTraffic spreads the objects over a 200m x 40m road and
+// BM_MatchCrowd packs them on a 40m x 20m square, where the gating leaves
+// large connected components. Argument 0 is the number of tracks and
+// objects. The counters report the valid pairs and the assignments. Run with
+// bazel run -c opt //modules/perception/common/graph:gated_hungarian_bigraph_matcher_benchmark
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/common/graph/gated_hungarian_bigraph_matcher.h"
+
+namespace apollo {
+namespace perception {
+namespace common {
+namespace {
+
+constexpr float kCostThresh = 4.0f;
+constexpr float kBoundValue = 100.0f;
+
+// the distances of the tracks to the detections of a frame
+void MakeCosts(const size_t num_objects, const float length, const float width,
+               SecureMat<float>* costs) {
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<float> x_distribution(0.0f, length);
+  std::uniform_real_distribution<float> y_distribution(0.0f, width);
+  std::normal_distribution<float> noise_distribution(0.0f, 0.5f);
+  std::vector<std::pair<float, float>> objects(num_objects);
+  std::vector<std::pair<float, float>> tracks(num_objects);
+  for (size_t i = 0; i < num_objects; ++i) {
+    objects[i].first = x_distribution(generator);
+    objects[i].second = y_distribution(generator);
+    tracks[i].first = objects[i].first + noise_distribution(generator);
+    tracks[i].second = objects[i].second + noise_distribution(generator);
+  }
+  // a tenth of the tracks are lost and a tenth of the objects are new
+  std::shuffle(tracks.begin(), tracks.end(), generator);
+  for (size_t i = 0; i < num_objects / 10; ++i) {
+    tracks[i].first = x_distribution(generator);
+    tracks[i].second = y_distribution(generator);
+  }
+  costs->Resize(num_objects, num_objects);
+  for (size_t i = 0; i < num_objects; ++i) {
+    for (size_t j = 0; j < num_objects; ++j) {
+      (*costs)(i, j) = std::hypot(tracks[i].first - objects[j].first,
+                                  tracks[i].second - objects[j].second);
+    }
+  }
+}
+
+void RunMatch(const float length, const float width,
+              benchmark::State* state) {
+  const size_t num_objects = static_cast<size_t>(state->range(0));
+  GatedHungarianMatcher<float> matcher(1000);
+  matcher.set_use_sparse_solver(state->range(1) != 0);
+  SecureMat<float>* costs = matcher.mutable_global_costs();
+  MakeCosts(num_objects, length, width, costs);
+  double num_valid_pairs = 0.0;
+  for (size_t i = 0; i < costs->height(); ++i) {
+    for (size_t j = 0; j < costs->width(); ++j) {
+      num_valid_pairs += (*costs)(i, j) < kCostThresh ? 1.0 : 0.0;
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> assignments;
+  std::vector<size_t> unassigned_rows;
+  std::vector<size_t> unassigned_cols;
+  for (auto _ : *state) {
+    matcher.Match(kCostThresh, kBoundValue,
+                  GatedHungarianMatcher<float>::OptimizeFlag::OPTMIN,
+                  &assignments, &unassigned_rows, &unassigned_cols);
+    benchmark::DoNotOptimize(assignments.data());
+  }
+  state->counters["valid_pairs"] = num_valid_pairs;
+  state->counters["assignments"] = static_cast<double>(assignments.size());
+}
+
+void BM_MatchTraffic(benchmark::State& state) {
+  RunMatch(200.0f, 40.0f, &state);
+}
+
+void BM_MatchCrowd(benchmark::State& state) {
+  RunMatch(40.0f, 20.0f, &state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MatchTraffic)
+    ->ArgsProduct({{50, 100, 200, 400}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatchCrowd)
+    ->ArgsProduct({{50, 100, 200}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace common
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
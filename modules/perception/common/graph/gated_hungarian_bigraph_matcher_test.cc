@@ -16,6 +16,8 @@
 
 #include "modules/perception/common/graph/gated_hungarian_bigraph_matcher.h"
 
+#include <random>
+
 #include "Eigen/Core"
 #include "gtest/gtest.h"
 
@@ -551,6 +553,83 @@ TEST_F(GatedHungarianMatcherTest, test_Match_Maximize) {
   EXPECT_EQ(0, unassigned_rows.size());
 }
 
+namespace {
+
+/* the total gain of the assignments over the bound value, which both
+ * solvers maximize */
+float GatedGain(const SecureMat<float>& costs, float bound_value,
+                bool minimize,
+                const std::vector<std::pair<size_t, size_t>>& assignments) {
+  float gain = 0.0f;
+  for (const auto& assignment : assignments) {
+    const float cost = costs(assignment.first, assignment.second);
+    gain += minimize ? bound_value - cost : cost - bound_value;
+  }
+  return gain;
+}
+
+}  // namespace
+
+TEST_F(GatedHungarianMatcherTest, test_Match_sparse_solver) {
+  SecureMat<float>* global_costs = optimizer_->mutable_global_costs();
+  global_costs->Reserve(1000, 1000);
+  GatedHungarianMatcher<float> sparse_optimizer(1000);
+  sparse_optimizer.set_use_sparse_solver(true);
+  EXPECT_TRUE(sparse_optimizer.use_sparse_solver());
+  SecureMat<float>* sparse_costs = sparse_optimizer.mutable_global_costs();
+
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<size_t> size_distribution(1, 24);
+  std::uniform_real_distribution<float> cost_distribution(0.0f, 4.0f);
+  const GatedHungarianMatcher<float>::OptimizeFlag opt_flags[] = {
+      GatedHungarianMatcher<float>::OptimizeFlag::OPTMIN,
+      GatedHungarianMatcher<float>::OptimizeFlag::OPTMAX};
+  std::vector<std::pair<size_t, size_t>> assignments;
+  std::vector<size_t> unassigned_rows;
+  std::vector<size_t> unassigned_cols;
+  std::vector<std::pair<size_t, size_t>> sparse_assignments;
+  std::vector<size_t> sparse_unassigned_rows;
+  std::vector<size_t> sparse_unassigned_cols;
+  for (int trial = 0; trial < 300; ++trial) {
+    const auto opt_flag = opt_flags[trial % 2];
+    const bool minimize =
+        opt_flag == GatedHungarianMatcher<float>::OptimizeFlag::OPTMIN;
+    const float cost_thresh = minimize ? 1.0f : 3.0f;
+    const float bound_value = minimize ? 4.0f : 0.0f;
+    const size_t rows = size_distribution(generator);
+    const size_t cols = size_distribution(generator);
+    global_costs->Resize(rows, cols);
+    sparse_costs->Resize(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        (*global_costs)(i, j) = cost_distribution(generator);
+        (*sparse_costs)(i, j) = (*global_costs)(i, j);
+      }
+    }
+    optimizer_->Match(cost_thresh, bound_value, opt_flag, &assignments,
+                      &unassigned_rows, &unassigned_cols);
+    sparse_optimizer.Match(cost_thresh, bound_value, opt_flag,
+                           &sparse_assignments, &sparse_unassigned_rows,
+                           &sparse_unassigned_cols);
+
+    EXPECT_EQ(rows, sparse_assignments.size() + sparse_unassigned_rows.size());
+    EXPECT_EQ(cols, sparse_assignments.size() + sparse_unassigned_cols.size());
+    for (size_t i = 0; i < sparse_assignments.size(); ++i) {
+      const auto& assignment = sparse_assignments[i];
+      const float cost = (*global_costs)(assignment.first, assignment.second);
+      EXPECT_TRUE(minimize ? cost < cost_thresh : cost > cost_thresh);
+      if (i > 0) {
+        EXPECT_LT(sparse_assignments[i - 1].first, assignment.first);
+      }
+    }
+    EXPECT_NEAR(
+        GatedGain(*global_costs, bound_value, minimize, assignments),
+        GatedGain(*global_costs, bound_value, minimize, sparse_assignments),
+        1e-3f)
+        << "trial " << trial;
+  }
+}
+
 }  // namespace common
 }  // namespace perception
 }  // namespace apollo
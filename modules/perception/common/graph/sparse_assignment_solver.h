@@ -0,0 +1,274 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace common {
+
+/* @brief: maximum weight bipartite matching over a sparse set of edges, by
+ * shortest augmenting paths with dual potentials (the Jonker-Volgenant
+ * scheme). Each row may also stay unassigned, through a dummy column of its
+ * own with a zero weight, so the matching is not required to be perfect.
+ * The search of a row only visits the edges reachable from it, so the
+ * connected components of the graph are solved independently of each other,
+ * in O(E log V) per row of a component instead of O(n^3) over the dense
+ * padded matrix. */
+template <typename T>
+class SparseAssignmentSolver {
+ public:
+  SparseAssignmentSolver() = default;
+  ~SparseAssignmentSolver() = default;
+
+  /* @brief: start a problem of rows_num x cols_num without any edge. the
+   * memory of the previous problem is kept. */
+  void Reset(const size_t rows_num, const size_t cols_num);
+
+  /* @brief: the pair (row, col) may be assigned, with a gain of weight */
+  void AddEdge(const size_t row, const size_t col, const T weight);
+
+  size_t rows_num() const { return rows_num_; }
+  size_t cols_num() const { return cols_num_; }
+  size_t edges_num() const { return edge_rows_.size(); }
+
+  /* @brief: the assignments of maximum total weight among the edges, sorted
+   * by row. the edges of a weight <= 0 are never worth assigning. */
+  void Maximize(std::vector<std::pair<size_t, size_t>>* assignments);
+
+ private:
+  static constexpr int kUnassigned = -1;
+
+  /* sort the edges by row, as in compressed sparse rows */
+  void BuildGraph();
+
+  /* assign row, re-assigning the rows along the shortest augmenting path */
+  void Augment(const size_t row);
+
+  /* relax the edges of row, whose matched column is at distance min_dist */
+  void ScanRow(const size_t row, const double min_dist);
+
+  /* relax column col from row with the reduced cost reduced_cost */
+  void Relax(const size_t row, const size_t col, const double reduced_cost);
+
+  size_t rows_num_ = 0;
+  size_t cols_num_ = 0;
+
+  /* input edges */
+  std::vector<size_t> edge_rows_;
+  std::vector<size_t> edge_cols_;
+  std::vector<T> edge_weights_;
+
+  /* the edges of row i are [row_offsets_[i], row_offsets_[i + 1]) of
+   * adj_cols_ and adj_costs_, with a cost of -weight */
+  std::vector<size_t> row_offsets_;
+  std::vector<size_t> fill_offsets_;
+  std::vector<size_t> adj_cols_;
+  std::vector<double> adj_costs_;
+
+  /* the columns are the real ones, then the dummy column of each row */
+  std::vector<int> col_of_row_;
+  std::vector<int> row_of_col_;
+  std::vector<double> row_potentials_;
+  std::vector<double> col_potentials_;
+
+  /* shortest path search */
+  std::vector<double> dists_;
+  std::vector<int> paths_;
+  std::vector<bool> col_done_;
+  std::vector<size_t> touched_cols_;
+  std::vector<size_t> done_cols_;
+  std::vector<size_t> scanned_rows_;
+  /* min heap of the columns by distance, an entry is stale once the
+   * distance of its column decreases */
+  typedef std::pair<double, size_t> HeapNode;
+  std::vector<HeapNode> heap_;
+};  // class SparseAssignmentSolver
+
+template <typename T>
+constexpr int SparseAssignmentSolver<T>::kUnassigned;
+
+template <typename T>
+void SparseAssignmentSolver<T>::Reset(const size_t rows_num,
+                                      const size_t cols_num) {
+  rows_num_ = rows_num;
+  cols_num_ = cols_num;
+  edge_rows_.clear();
+  edge_cols_.clear();
+  edge_weights_.clear();
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::AddEdge(const size_t row, const size_t col,
+                                        const T weight) {
+  if (row >= rows_num_ || col >= cols_num_ || !(weight > static_cast<T>(0))) {
+    return;
+  }
+  edge_rows_.push_back(row);
+  edge_cols_.push_back(col);
+  edge_weights_.push_back(weight);
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Maximize(
+    std::vector<std::pair<size_t, size_t>>* assignments) {
+  assignments->clear();
+  BuildGraph();
+
+  const size_t all_cols_num = cols_num_ + rows_num_;
+  col_of_row_.assign(rows_num_, kUnassigned);
+  row_of_col_.assign(all_cols_num, kUnassigned);
+  row_potentials_.assign(rows_num_, 0.0);
+  col_potentials_.assign(all_cols_num, 0.0);
+  dists_.assign(all_cols_num, std::numeric_limits<double>::infinity());
+  paths_.assign(all_cols_num, kUnassigned);
+  col_done_.assign(all_cols_num, false);
+
+  for (size_t row = 0; row < rows_num_; ++row) {
+    /* a row without edges stays on its dummy column */
+    if (row_offsets_[row] != row_offsets_[row + 1]) {
+      Augment(row);
+    }
+  }
+
+  for (size_t row = 0; row < rows_num_; ++row) {
+    const int col = col_of_row_[row];
+    if (col != kUnassigned && static_cast<size_t>(col) < cols_num_) {
+      assignments->push_back(std::make_pair(row, static_cast<size_t>(col)));
+    }
+  }
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::BuildGraph() {
+  row_offsets_.assign(rows_num_ + 1, 0);
+  for (const size_t row : edge_rows_) {
+    ++row_offsets_[row + 1];
+  }
+  for (size_t row = 0; row < rows_num_; ++row) {
+    row_offsets_[row + 1] += row_offsets_[row];
+  }
+  adj_cols_.resize(edge_rows_.size());
+  adj_costs_.resize(edge_rows_.size());
+  fill_offsets_.assign(row_offsets_.begin(), row_offsets_.end() - 1);
+  for (size_t edge = 0; edge < edge_rows_.size(); ++edge) {
+    const size_t pos = fill_offsets_[edge_rows_[edge]]++;
+    adj_cols_[pos] = edge_cols_[edge];
+    adj_costs_[pos] = -static_cast<double>(edge_weights_[edge]);
+  }
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Relax(const size_t row, const size_t col,
+                                      const double reduced_cost) {
+  if (col_done_[col] || !(reduced_cost < dists_[col])) {
+    return;
+  }
+  if (paths_[col] == kUnassigned) {
+    touched_cols_.push_back(col);
+  }
+  dists_[col] = reduced_cost;
+  paths_[col] = static_cast<int>(row);
+  heap_.push_back(std::make_pair(reduced_cost, col));
+  std::push_heap(heap_.begin(), heap_.end(), std::greater<HeapNode>());
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::ScanRow(const size_t row,
+                                        const double min_dist) {
+  scanned_rows_.push_back(row);
+  const double row_potential = row_potentials_[row];
+  for (size_t k = row_offsets_[row]; k < row_offsets_[row + 1]; ++k) {
+    const size_t col = adj_cols_[k];
+    Relax(row, col,
+          min_dist + adj_costs_[k] - row_potential - col_potentials_[col]);
+  }
+  const size_t dummy_col = cols_num_ + row;
+  Relax(row, dummy_col,
+        min_dist - row_potential - col_potentials_[dummy_col]);
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Augment(const size_t row) {
+  touched_cols_.clear();
+  done_cols_.clear();
+  scanned_rows_.clear();
+  heap_.clear();
+
+  /* dijkstra over the columns, the dummy column of row is always free so
+   * the search ends */
+  double min_dist = 0.0;
+  size_t sink = 0;
+  ScanRow(row, min_dist);
+  while (!heap_.empty()) {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<HeapNode>());
+    const HeapNode node = heap_.back();
+    heap_.pop_back();
+    const size_t col = node.second;
+    if (col_done_[col] || node.first > dists_[col]) {
+      continue;
+    }
+    col_done_[col] = true;
+    done_cols_.push_back(col);
+    min_dist = node.first;
+    if (row_of_col_[col] == kUnassigned) {
+      sink = col;
+      break;
+    }
+    ScanRow(static_cast<size_t>(row_of_col_[col]), min_dist);
+  }
+
+  /* update the potentials, keeping the reduced costs of the scanned edges
+   * non negative and those of the matched edges zero */
+  row_potentials_[row] += min_dist;
+  for (size_t i = 1; i < scanned_rows_.size(); ++i) {
+    const size_t scanned_row = scanned_rows_[i];
+    row_potentials_[scanned_row] +=
+        min_dist - dists_[col_of_row_[scanned_row]];
+  }
+  for (const size_t col : done_cols_) {
+    col_potentials_[col] -= min_dist - dists_[col];
+  }
+
+  /* flip the matching along the path */
+  size_t col = sink;
+  while (true) {
+    const size_t path_row = static_cast<size_t>(paths_[col]);
+    row_of_col_[col] = static_cast<int>(path_row);
+    const int previous_col = col_of_row_[path_row];
+    col_of_row_[path_row] = static_cast<int>(col);
+    if (path_row == row) {
+      break;
+    }
+    col = static_cast<size_t>(previous_col);
+  }
+
+  for (const size_t touched_col : touched_cols_) {
+    dists_[touched_col] = std::numeric_limits<double>::infinity();
+    paths_[touched_col] = kUnassigned;
+    col_done_[touched_col] = false;
+  }
+}
+
+}  // namespace common
+}  // namespace perception
+}  // namespace apollo
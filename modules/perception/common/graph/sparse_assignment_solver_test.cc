@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/graph/sparse_assignment_solver.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace common {
+
+namespace {
+
+/* the best total weight of the rows [row, rows) given the used cols, by
+ * trying every col of each row and leaving it unassigned */
+double BruteForceMaximize(const std::vector<std::vector<double>>& weights,
+                          size_t row, std::vector<bool>* used_cols) {
+  if (row == weights.size()) {
+    return 0.0;
+  }
+  double best = BruteForceMaximize(weights, row + 1, used_cols);
+  for (size_t col = 0; col < used_cols->size(); ++col) {
+    if (weights[row][col] <= 0.0 || (*used_cols)[col]) {
+      continue;
+    }
+    (*used_cols)[col] = true;
+    best = std::max(best, weights[row][col] +
+                              BruteForceMaximize(weights, row + 1, used_cols));
+    (*used_cols)[col] = false;
+  }
+  return best;
+}
+
+}  // namespace
+
+TEST(SparseAssignmentSolverTest, test_Maximize) {
+  SparseAssignmentSolver<float> solver;
+  std::vector<std::pair<size_t, size_t>> assignments;
+
+  /* case 1: empty one */
+  solver.Reset(0, 0);
+  solver.Maximize(&assignments);
+  EXPECT_EQ(0, assignments.size());
+
+  /* case 2: the heavy edge loses against the two it blocks
+   * weights:
+   * 2.0,  3.0
+   * 0.0,  2.0
+   * matches:
+   * (0->0, 1->1) */
+  solver.Reset(2, 2);
+  solver.AddEdge(0, 0, 2.0f);
+  solver.AddEdge(0, 1, 3.0f);
+  solver.AddEdge(1, 1, 2.0f);
+  EXPECT_EQ(3, solver.edges_num());
+  solver.Maximize(&assignments);
+  ASSERT_EQ(2, assignments.size());
+  EXPECT_EQ(0, assignments[0].first);
+  EXPECT_EQ(0, assignments[0].second);
+  EXPECT_EQ(1, assignments[1].first);
+  EXPECT_EQ(1, assignments[1].second);
+
+  /* case 3: a row is better left unassigned than re-routing
+   * weights:
+   * 5.0,  1.0,  0.0
+   * 4.0,  0.0,  0.0
+   * matches:
+   * (0->1, 1->0) gains 5.0, as does (0->0), so any of them */
+  solver.Reset(2, 3);
+  solver.AddEdge(1, 0, 4.0f);
+  solver.AddEdge(0, 0, 5.0f);
+  solver.AddEdge(0, 1, 1.0f);
+  /* invalid edges are ignored */
+  solver.AddEdge(0, 2, 0.0f);
+  solver.AddEdge(2, 0, 1.0f);
+  solver.AddEdge(0, 3, 1.0f);
+  EXPECT_EQ(3, solver.edges_num());
+  solver.Maximize(&assignments);
+  float gain = 0.0f;
+  for (const auto& assignment : assignments) {
+    gain += assignment.second == 0 ? (assignment.first == 0 ? 5.0f : 4.0f)
+                                   : 1.0f;
+  }
+  EXPECT_FLOAT_EQ(5.0f, gain);
+}
+
+TEST(SparseAssignmentSolverTest, test_Maximize_random) {
+  SparseAssignmentSolver<double> solver;
+  std::vector<std::pair<size_t, size_t>> assignments;
+  std::mt19937 generator(11);
+  std::uniform_int_distribution<size_t> size_distribution(1, 6);
+  std::uniform_real_distribution<double> weight_distribution(-1.0, 2.0);
+  for (int trial = 0; trial < 500; ++trial) {
+    const size_t rows = size_distribution(generator);
+    const size_t cols = size_distribution(generator);
+    std::vector<std::vector<double>> weights(rows,
+                                             std::vector<double>(cols, 0.0));
+    solver.Reset(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        weights[i][j] = weight_distribution(generator);
+        solver.AddEdge(i, j, weights[i][j]);
+      }
+    }
+    solver.Maximize(&assignments);
+
+    std::vector<bool> used_rows(rows, false);
+    std::vector<bool> used_cols(cols, false);
+    double gain = 0.0;
+    for (const auto& assignment : assignments) {
+      ASSERT_LT(assignment.first, rows);
+      ASSERT_LT(assignment.second, cols);
+      EXPECT_FALSE(used_rows[assignment.first]);
+      EXPECT_FALSE(used_cols[assignment.second]);
+      used_rows[assignment.first] = true;
+      used_cols[assignment.second] = true;
+      EXPECT_GT(weights[assignment.first][assignment.second], 0.0);
+      gain += weights[assignment.first][assignment.second];
+    }
+    std::fill(used_cols.begin(), used_cols.end(), false);
+    EXPECT_NEAR(BruteForceMaximize(weights, 0, &used_cols), gain, 1e-9)
+        << "trial " << trial;
+  }
+}
+
+}  // namespace common
+}  // namespace perception
+}  // namespace apollo
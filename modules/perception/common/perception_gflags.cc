@@ -189,5 +189,29 @@ DEFINE_string(torch_detector_model,
 
 // lidar sensor name
 DEFINE_string(lidar_sensor_name, "velodyne128", "lidar sensor name");
+
+// thread pool shared by the stages
+DEFINE_int32(perception_thread_pool_size, 8,
+             "Number of workers of the thread pool shared by the stages.");
+
+// latency profiler
+DEFINE_bool(enable_perception_latency_profiler, false,
+            "Whether to profile the latency of the pipeline stages.");
+DEFINE_int32(perception_latency_trace_frames, 100,
+             "Number of latest frames of each pipeline and sensor kept for "
+             "the Chrome trace.");
+DEFINE_string(perception_latency_trace_file,
+              "/apollo/data/log/perception_latency_trace.json",
+              "The Chrome trace file written when a request has no path.");
+
+// batch inference
+DEFINE_bool(enable_lidar_batch_inference, false,
+            "Whether the cnn segmentation detectors run their net on the "
+            "batch inference server, batching the lidars of the same model.");
+DEFINE_int32(lidar_batch_inference_max_batch_size, 4,
+             "The most lidar frames run by one forward pass of the net.");
+DEFINE_int32(lidar_batch_inference_max_latency_us, 2000,
+             "How long a lidar frame may wait for the frames of the other "
+             "lidars before its batch is run, in microseconds.");
 }  // namespace perception
 }  // namespace apollo
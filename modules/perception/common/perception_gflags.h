@@ -95,5 +95,18 @@ DECLARE_string(torch_detector_model);
 
 // lidar sensor name
 DECLARE_string(lidar_sensor_name);
+
+// thread pool shared by the stages
+DECLARE_int32(perception_thread_pool_size);
+
+// latency profiler
+DECLARE_bool(enable_perception_latency_profiler);
+DECLARE_int32(perception_latency_trace_frames);
+DECLARE_string(perception_latency_trace_file);
+
+// batch inference
+DECLARE_bool(enable_lidar_batch_inference);
+DECLARE_int32(lidar_batch_inference_max_batch_size);
+DECLARE_int32(lidar_batch_inference_max_latency_us);
 }  // namespace perception
 }  // namespace apollo
@@ -15,6 +15,8 @@
  *****************************************************************************/
 #include "modules/perception/fusion/base/sensor_frame.h"
 
+#include <memory>
+
 namespace apollo {
 namespace perception {
 namespace fusion {
@@ -38,7 +40,8 @@ void SensorFrame::Initialize(const base::FrameConstPtr& base_frame_ptr) {
   foreground_objects_.reserve(base_objects.size());
 
   for (const auto& base_obj : base_objects) {
-    SensorObjectPtr obj(new SensorObject(base_obj, header_));
+    // object and control block in one allocation
+    SensorObjectPtr obj = std::make_shared<SensorObject>(base_obj, header_);
     if (base_obj->lidar_supplement.is_background) {
       background_objects_.emplace_back(obj);
     } else {
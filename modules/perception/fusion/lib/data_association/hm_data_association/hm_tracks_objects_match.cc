@@ -20,10 +20,16 @@
 #include <utility>
 
 #include "modules/perception/common/graph/secure_matrix.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 
 namespace apollo {
 namespace perception {
 namespace fusion {
+namespace {
+// a lidar to camera distance projects the object cloud, a few tracks are
+// worth a thread
+constexpr size_t kMinTracksPerThread = 4;
+}  // namespace
 
 double HMTrackersObjectsAssociation::s_match_distance_thresh_ = 4.0;
 double HMTrackersObjectsAssociation::s_match_distance_bound_ = 100.0;
@@ -32,6 +38,9 @@ double HMTrackersObjectsAssociation::s_match_distance_bound_ = 100.0;
  * is 2 times of ave error around 200m. */
 double HMTrackersObjectsAssociation::s_association_center_dist_threshold_ =
     30.0;
+/* the association of a frame is small, the hungarian optimizer over the
+ * connected components is kept unless the scenes get crowded. */
+bool HMTrackersObjectsAssociation::s_use_sparse_solver_ = false;
 
 template <typename T>
 void extract_vector(const std::vector<T>& vec,
@@ -80,7 +89,7 @@ bool HMTrackersObjectsAssociation::Associate(
   ComputeAssociationDistanceMat(fusion_tracks, sensor_objects, ref_point,
                                 association_result->unassigned_tracks,
                                 association_result->unassigned_measurements,
-                                &association_mat);
+                                &association_mat, options.num_threads);
 
   int num_track = static_cast<int>(fusion_tracks.size());
   int num_measurement = static_cast<int>(sensor_objects.size());
@@ -301,7 +310,8 @@ void HMTrackersObjectsAssociation::ComputeAssociationDistanceMat(
     const Eigen::Vector3d& ref_point,
     const std::vector<size_t>& unassigned_tracks,
     const std::vector<size_t>& unassigned_measurements,
-    std::vector<std::vector<double>>* association_mat) {
+    std::vector<std::vector<double>>* association_mat,
+    const size_t num_threads) {
   // if (sensor_objects.empty()) return;
   TrackObjectDistanceOptions opt;
   // TODO(linjian) ref_point
@@ -309,8 +319,12 @@ void HMTrackersObjectsAssociation::ComputeAssociationDistanceMat(
   opt.ref_point = &tmp;
   association_mat->resize(unassigned_tracks.size());
   for (size_t i = 0; i < unassigned_tracks.size(); ++i) {
-    size_t fusion_idx = unassigned_tracks[i];
     (*association_mat)[i].resize(unassigned_measurements.size());
+  }
+  // the rows are independent, a track is compared with all the measurements
+  // by the thread owning it
+  auto compute_row = [&](size_t i) {
+    size_t fusion_idx = unassigned_tracks[i];
     const TrackPtr& fusion_track = fusion_tracks[fusion_idx];
     for (size_t j = 0; j < unassigned_measurements.size(); ++j) {
       size_t sensor_idx = unassigned_measurements[j];
@@ -335,7 +349,14 @@ void HMTrackersObjectsAssociation::ComputeAssociationDistanceMat(
              << ", obs_id: " << sensor_object->GetBaseObject()->track_id
              << ", distance: " << distance;
     }
-  }
+  };
+  lib::ParallelFor(0, unassigned_tracks.size(), num_threads,
+                   kMinTracksPerThread,
+                   [&compute_row](size_t, size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                       compute_row(i);
+                     }
+                   });
 }
 
 void HMTrackersObjectsAssociation::IdAssign(
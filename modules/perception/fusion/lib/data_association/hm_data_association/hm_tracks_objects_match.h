@@ -35,6 +35,7 @@ class HMTrackersObjectsAssociation : public BaseDataAssociation {
   bool Init() override {
     track_object_distance_.set_distance_thresh(
         static_cast<float>(s_match_distance_thresh_));
+    optimizer_.set_use_sparse_solver(s_use_sparse_solver_);
     return true;
   }
 
@@ -49,7 +50,8 @@ class HMTrackersObjectsAssociation : public BaseDataAssociation {
       const Eigen::Vector3d& ref_point,
       const std::vector<size_t>& unassigned_tracks,
       const std::vector<size_t>& unassigned_measurements,
-      std::vector<std::vector<double>>* association_mat);
+      std::vector<std::vector<double>>* association_mat,
+      const size_t num_threads = 1);
 
   void IdAssign(const std::vector<TrackPtr>& fusion_tracks,
                 const std::vector<SensorObjectPtr>& sensor_objects,
@@ -93,6 +95,7 @@ class HMTrackersObjectsAssociation : public BaseDataAssociation {
   static double s_match_distance_thresh_;
   static double s_match_distance_bound_;
   static double s_association_center_dist_threshold_;
+  static bool s_use_sparse_solver_;
 
   DISALLOW_COPY_AND_ASSIGN(HMTrackersObjectsAssociation);
 };
@@ -15,6 +15,7 @@
  *****************************************************************************/
 #pragma once
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -182,8 +183,9 @@ class ProjectionCache {
   double measurement_timestamp_;
   // project cache memeory
   std::vector<Eigen::Vector2d> point2ds_;
-  // cache reference on frames
-  std::vector<ProjectionCacheFrame> frames_;
+  // cache reference on frames, a deque keeps the objects returned by
+  // BuildObject in place while frames are added
+  std::deque<ProjectionCacheFrame> frames_;
 };  // class ProjectionCache
 
 typedef ProjectionCache* ProjectionCachePtr;
@@ -22,6 +22,7 @@
 
 #include <boost/format.hpp>
 
+#include "cyber/base/rw_lock_guard.h"
 #include "modules/perception/base/camera.h"
 #include "modules/perception/base/point.h"
 #include "modules/perception/base/sensor_meta.h"
@@ -122,15 +123,9 @@ ProjectionCacheObject* TrackObjectDistance::BuildProjectionCacheObject(
   double width = static_cast<double>(camera_model->get_width());
   double height = static_cast<double>(camera_model->get_height());
   const int lidar_object_id = lidar->GetBaseObject()->id;
-  ProjectionCacheObject* cache_object = projection_cache_.BuildObject(
-      measurement_sensor_id, measurement_timestamp, projection_sensor_id,
-      projection_timestamp, lidar_object_id);
-  if (cache_object == nullptr) {
-    AERROR << "Failed to build projection cache object";
-    return nullptr;
-  }
-  size_t start_ind = projection_cache_.GetPoint2dsSize();
-  size_t end_ind = projection_cache_.GetPoint2dsSize();
+  // the points are projected without holding the cache, and cached at once
+  // under the write lock
+  std::vector<Eigen::Vector2f> project_pts;
   float xmin = std::numeric_limits<float>::max();
   float ymin = std::numeric_limits<float>::max();
   float xmax = -std::numeric_limits<float>::max();
@@ -203,10 +198,30 @@ ProjectionCacheObject* TrackObjectDistance::BuildProjectionCacheObject(
       if (project_pt2f.y() > ymax) {
         ymax = project_pt2f.y();
       }
-      projection_cache_.AddPoint(project_pt2f);
+      project_pts.push_back(project_pt2f);
     }
   }
-  end_ind = projection_cache_.GetPoint2dsSize();
+  cyber::base::WriteLockGuard<cyber::base::AtomicRWLock> lock(
+      projection_cache_lock_);
+  // another thread may have cached the same object in the meantime
+  ProjectionCacheObject* cache_object = projection_cache_.QueryObject(
+      measurement_sensor_id, measurement_timestamp, projection_sensor_id,
+      projection_timestamp, lidar_object_id);
+  if (cache_object != nullptr) {
+    return cache_object;
+  }
+  cache_object = projection_cache_.BuildObject(
+      measurement_sensor_id, measurement_timestamp, projection_sensor_id,
+      projection_timestamp, lidar_object_id);
+  if (cache_object == nullptr) {
+    AERROR << "Failed to build projection cache object";
+    return nullptr;
+  }
+  size_t start_ind = projection_cache_.GetPoint2dsSize();
+  for (const auto& project_pt2f : project_pts) {
+    projection_cache_.AddPoint(project_pt2f);
+  }
+  size_t end_ind = projection_cache_.GetPoint2dsSize();
   cache_object->SetStartInd(start_ind);
   cache_object->SetEndInd(end_ind);
   base::BBox2DF box = base::BBox2DF(xmin, ymin, xmax, ymax);
@@ -228,11 +243,15 @@ ProjectionCacheObject* TrackObjectDistance::QueryProjectionCacheObject(
   const double projection_timestamp =
       measurement_is_lidar ? camera->GetTimestamp() : lidar->GetTimestamp();
   const int lidar_object_id = lidar->GetBaseObject()->id;
-  ProjectionCacheObject* cache_object = projection_cache_.QueryObject(
-      measurement_sensor_id, measurement_timestamp, projection_sensor_id,
-      projection_timestamp, lidar_object_id);
-  if (cache_object != nullptr) {
-    return cache_object;
+  {
+    cyber::base::ReadLockGuard<cyber::base::AtomicRWLock> lock(
+        projection_cache_lock_);
+    ProjectionCacheObject* cache_object = projection_cache_.QueryObject(
+        measurement_sensor_id, measurement_timestamp, projection_sensor_id,
+        projection_timestamp, lidar_object_id);
+    if (cache_object != nullptr) {
+      return cache_object;
+    }
   }  // 2. if query failed, build projection and cache it
   return BuildProjectionCacheObject(
       lidar, camera, camera_model, measurement_sensor_id, measurement_timestamp,
@@ -483,8 +502,13 @@ float TrackObjectDistance::ComputeLidarCamera(
       AERROR << "Failed to query projection cached object";
       return distance;
     }
-    double similarity =
-        ComputePtsBoxSimilarity(&projection_cache_, cache_object, camera_bbox);
+    double similarity = 0.0;
+    {
+      cyber::base::ReadLockGuard<cyber::base::AtomicRWLock> lock(
+          projection_cache_lock_);
+      similarity = ComputePtsBoxSimilarity(&projection_cache_, cache_object,
+                                           camera_bbox);
+    }
     distance =
         distance_thresh_ * ((1.0f - static_cast<float>(similarity)) /
                             (1.0f - vc_similarity2distance_penalize_thresh_));
@@ -644,6 +668,8 @@ double TrackObjectDistance::ComputeLidarCameraSimilarity(
     if (cache_object == nullptr) {
       return similarity;
     }
+    cyber::base::ReadLockGuard<cyber::base::AtomicRWLock> lock(
+        projection_cache_lock_);
     similarity =
         ComputePtsBoxSimilarity(&projection_cache_, cache_object, camera_bbox);
   }
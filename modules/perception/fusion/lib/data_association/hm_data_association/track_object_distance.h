@@ -20,6 +20,7 @@
 
 #include "Eigen/StdVector"
 
+#include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/macros.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
 #include "modules/perception/fusion/base/fusion_log.h"
@@ -170,6 +171,9 @@ class TrackObjectDistance {
       const SensorObjectConstPtr& lidar, const SensorObjectConstPtr& camera);
 
   ProjectionCache projection_cache_;
+  // the distances of a frame may be computed from several threads, which
+  // share the projections of the lidar objects through the cache
+  cyber::base::AtomicRWLock projection_cache_lock_;
   float distance_thresh_ = 4.0f;
   const float vc_similarity2distance_penalize_thresh_ = 0.07f;
   const float vc_diff2distance_scale_factor_ = 0.8f;
@@ -30,6 +30,8 @@
 #include "modules/perception/fusion/lib/data_fusion/type_fusion/dst_type_fusion/dst_type_fusion.h"
 #include "modules/perception/fusion/lib/gatekeeper/pbf_gatekeeper/pbf_gatekeeper.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 
 namespace apollo {
 namespace perception {
@@ -37,6 +39,12 @@ namespace fusion {
 
 using cyber::common::GetAbsolutePath;
 
+namespace {
+// the update of a track is a few small filters, the threads only pay off on
+// crowded frames
+constexpr size_t kMinTracksPerThread = 16;
+}  // namespace
+
 bool ProbabilisticFusion::Init(const FusionInitOptions& init_options) {
   main_sensor_ = init_options.main_sensor;
 
@@ -64,6 +72,7 @@ bool ProbabilisticFusion::Init(const FusionInitOptions& init_options) {
   for (int i = 0; i < params.prohibition_sensors_size(); ++i) {
     params_.prohibition_sensors.push_back(params.prohibition_sensors(i));
   }
+  params_.num_threads = params.num_threads();
 
   // static member initialization from PB config
   Track::SetMaxLidarInvisiblePeriod(params.max_lidar_invisible_period());
@@ -114,6 +123,7 @@ bool ProbabilisticFusion::Init(const StageConfig& stage_config) {
           probabilistic_fusion_config_.prohibition_sensors()) {
     params_.prohibition_sensors.push_back(prohibition_sensor);
   }
+  params_.num_threads = probabilistic_fusion_config_.num_threads();
 
   // static member initialization from PB config
   Track::SetMaxLidarInvisiblePeriod(
@@ -230,28 +240,30 @@ void ProbabilisticFusion::FuseFrame(const SensorFramePtr& frame) {
 }
 
 void ProbabilisticFusion::FuseForegroundTrack(const SensorFramePtr& frame) {
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   std::string indicator = "fusion_" + frame->GetSensorId();
 
   AssociationOptions options;
+  options.num_threads = params_.num_threads;
   AssociationResult association_result;
   matcher_->Associate(options, frame, scenes_, &association_result);
-  PERF_BLOCK_END_WITH_INDICATOR(indicator, "association");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(indicator, "association");
 
   const std::vector<TrackMeasurmentPair>& assignments =
       association_result.assignments;
   UpdateAssignedTracks(frame, assignments);
-  PERF_BLOCK_END_WITH_INDICATOR(indicator, "update_assigned_track");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(indicator, "update_assigned_track");
 
   const std::vector<size_t>& unassigned_track_inds =
       association_result.unassigned_tracks;
   UpdateUnassignedTracks(frame, unassigned_track_inds);
-  PERF_BLOCK_END_WITH_INDICATOR(indicator, "update_unassigned_track");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(indicator,
+                                           "update_unassigned_track");
 
   const std::vector<size_t>& unassigned_obj_inds =
       association_result.unassigned_measurements;
   CreateNewTracks(frame, unassigned_obj_inds);
-  PERF_BLOCK_END_WITH_INDICATOR(indicator, "create_track");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(indicator, "create_track");
 }
 
 void ProbabilisticFusion::UpdateAssignedTracks(
@@ -264,12 +276,30 @@ void ProbabilisticFusion::UpdateAssignedTracks(
   TrackerOptions options;
   options.match_distance = 0;
   std::vector<SensorObjectPtr>& f_ground_objs = frame->GetForegroundObjects();
-  for (size_t i = 0; i < assignments.size(); ++i) {
+  auto update_track = [&](size_t i) {
     size_t track_ind = assignments[i].first;
     size_t obj_ind = assignments[i].second;
     trackers_[track_ind]->UpdateWithMeasurement(
         options, f_ground_objs[obj_ind], frame->GetTimestamp());
-  }
+  };
+  // the trackers are independent, unless the id assignment gave two objects
+  // to the same track, whose updates then run in order
+  std::vector<bool> track_assigned(trackers_.size(), false);
+  bool unique_tracks = true;
+  for (const auto& assignment : assignments) {
+    if (track_assigned[assignment.first]) {
+      unique_tracks = false;
+      break;
+    }
+    track_assigned[assignment.first] = true;
+  }
+  const size_t num_threads = unique_tracks ? params_.num_threads : 1;
+  lib::ParallelFor(0, assignments.size(), num_threads, kMinTracksPerThread,
+                   [&update_track](size_t, size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                       update_track(i);
+                     }
+                   });
 }
 
 void ProbabilisticFusion::UpdateUnassignedTracks(
@@ -283,11 +313,18 @@ void ProbabilisticFusion::UpdateUnassignedTracks(
   TrackerOptions options;
   options.match_distance = 0;
   std::string sensor_id = frame->GetSensorId();
-  for (size_t i = 0; i < unassigned_track_inds.size(); ++i) {
+  auto update_track = [&](size_t i) {
     size_t track_ind = unassigned_track_inds[i];
     trackers_[track_ind]->UpdateWithoutMeasurement(
         options, sensor_id, frame->GetTimestamp(), frame->GetTimestamp());
-  }
+  };
+  lib::ParallelFor(0, unassigned_track_inds.size(), params_.num_threads,
+                   kMinTracksPerThread,
+                   [&update_track](size_t, size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                       update_track(i);
+                     }
+                   });
 }
 
 void ProbabilisticFusion::CreateNewTracks(
@@ -40,6 +40,7 @@ struct FusionParams {
   std::string data_association_method;
   std::string gate_keeper_method;
   std::vector<std::string> prohibition_sensors;
+  size_t num_threads = 1;
 };
 
 class ProbabilisticFusion : public BaseFusionSystem {
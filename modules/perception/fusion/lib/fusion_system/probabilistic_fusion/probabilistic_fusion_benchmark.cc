@@ -0,0 +1,311 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Per-frame latency of ProbabilisticFusion replaying a synthetic drive of the
+// velodyne64, radar and front_camera sensors of the fusion testdata. Each
+// 100ms cycle sends a camera, a radar and a lidar frame, the lidar being the
+// main sensor whose Fuse call fuses the cycle. The vehicles drive on five
+// lanes around the ego, with a cloud of a few hundred points per lidar
+// object, and the camera tracks are renewed every second so that the
+// lidar to camera distances are computed all along the drive. Argument 0 is
+// the number of vehicles and argument 1 the number of fusion threads. The
+// counters report the distribution of the fusion time of a cycle. Run with
+// bazel run -c opt //modules/perception/fusion/lib/fusion_system/probabilistic_fusion:probabilistic_fusion_benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/common/sensor_manager/sensor_manager.h"
+#include "modules/perception/fusion/base/sensor_data_manager.h"
+#include "modules/perception/fusion/lib/fusion_system/probabilistic_fusion/probabilistic_fusion.h"
+
+namespace apollo {
+namespace perception {
+namespace fusion {
+namespace {
+
+constexpr int kNumCycles = 200;
+constexpr double kCycleTime = 0.1;
+constexpr double kStartTime = 1.5e9;
+constexpr double kEgoSpeed = 10.0;
+constexpr double kRange = 120.0;
+constexpr int kNumLanes = 5;
+constexpr double kLaneWidth = 3.5;
+constexpr int kCameraTrackPeriod = 10;
+constexpr size_t kImageWidth = 1920;
+constexpr size_t kImageHeight = 1080;
+
+struct Vehicle {
+  int id = 0;
+  double x = 0.0;
+  double y = 0.0;
+  double speed = 0.0;
+};
+
+base::ObjectPtr MakeObject(const Vehicle& vehicle, const int track_id) {
+  base::ObjectPtr object(new base::Object);
+  object->id = track_id;
+  object->track_id = track_id;
+  object->center = Eigen::Vector3d(vehicle.x, vehicle.y, 0.8);
+  object->anchor_point = object->center;
+  object->size = Eigen::Vector3f(4.5f, 1.8f, 1.6f);
+  object->direction = Eigen::Vector3f(1.0f, 0.0f, 0.0f);
+  object->velocity = Eigen::Vector3f(static_cast<float>(vehicle.speed), 0, 0);
+  object->type = base::ObjectType::VEHICLE;
+  object->type_probs.assign(
+      static_cast<size_t>(base::ObjectType::MAX_OBJECT_TYPE), 0.0f);
+  object->type_probs[static_cast<size_t>(base::ObjectType::VEHICLE)] = 1.0f;
+  const double corners[4][2] = {{-2.25, -0.9}, {2.25, -0.9}, {2.25, 0.9},
+                                {-2.25, 0.9}};
+  for (const auto& corner : corners) {
+    base::PointD point;
+    point.x = vehicle.x + corner[0];
+    point.y = vehicle.y + corner[1];
+    point.z = 0.0;
+    object->polygon.push_back(point);
+  }
+  return object;
+}
+
+// the points seen by the lidar on the rear and on the inner side of the box
+void AddCloud(const Eigen::Vector3d& lidar_position, base::Object* object) {
+  const double rear_x = object->center.x() - 2.25;
+  const double side_y =
+      object->center.y() + (object->center.y() > lidar_position.y() ? -0.9
+                                                                     : 0.9);
+  for (int i = 0; i < 12; ++i) {
+    for (int j = 0; j < 16; ++j) {
+      const double z = 0.1 + 0.1 * i;
+      base::PointF rear_point;
+      rear_point.x = static_cast<float>(rear_x - lidar_position.x());
+      rear_point.y = static_cast<float>(object->center.y() - 0.9 + 0.12 * j -
+                                        lidar_position.y());
+      rear_point.z = static_cast<float>(z - lidar_position.z());
+      object->lidar_supplement.cloud.push_back(rear_point);
+      base::PointF side_point;
+      side_point.x = static_cast<float>(rear_x + 0.3 * j - lidar_position.x());
+      side_point.y = static_cast<float>(side_y - lidar_position.y());
+      side_point.z = rear_point.z;
+      object->lidar_supplement.cloud.push_back(side_point);
+    }
+  }
+}
+
+// the box of the projected corners, false out of the image
+bool ProjectBox(const Eigen::Affine3d& world2camera,
+                base::BaseCameraModel* camera_model,
+                const base::Object& object, base::BBox2DF* box) {
+  float xmin = static_cast<float>(kImageWidth);
+  float ymin = static_cast<float>(kImageHeight);
+  float xmax = 0.0f;
+  float ymax = 0.0f;
+  for (const auto& point : object.polygon) {
+    for (const double z : {0.0, 1.6}) {
+      const Eigen::Vector3d local =
+          world2camera * Eigen::Vector3d(point.x, point.y, z);
+      if (local.z() < 1.0) {
+        return false;
+      }
+      const Eigen::Vector2f pixel = camera_model->Project(local.cast<float>());
+      xmin = std::min(xmin, pixel.x());
+      ymin = std::min(ymin, pixel.y());
+      xmax = std::max(xmax, pixel.x());
+      ymax = std::max(ymax, pixel.y());
+    }
+  }
+  xmin = std::max(xmin, 0.0f);
+  ymin = std::max(ymin, 0.0f);
+  xmax = std::min(xmax, static_cast<float>(kImageWidth - 1));
+  ymax = std::min(ymax, static_cast<float>(kImageHeight - 1));
+  if (xmin >= xmax || ymin >= ymax) {
+    return false;
+  }
+  *box = base::BBox2DF(xmin, ymin, xmax, ymax);
+  return true;
+}
+
+base::FramePtr MakeFrame(const std::string& sensor_name,
+                         const double timestamp,
+                         const Eigen::Affine3d& sensor2world_pose) {
+  base::FramePtr frame(new base::Frame);
+  common::SensorManager::Instance()->GetSensorInfo(sensor_name,
+                                                   &frame->sensor_info);
+  frame->timestamp = timestamp;
+  frame->sensor2world_pose = sensor2world_pose;
+  return frame;
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point& start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+bool InitFusion(const uint32_t num_threads, ProbabilisticFusion* fusion) {
+  FLAGS_work_root =
+      "/apollo/modules/perception/testdata/fusion/probabilistic_fusion";
+  FLAGS_obs_sensor_meta_path = "./data/sensor_meta.pt";
+  FLAGS_obs_sensor_intrinsic_path =
+      "/apollo/modules/perception/testdata/fusion/probabilistic_fusion/params";
+  SensorDataManager* sensor_data_manager = SensorDataManager::Instance();
+  sensor_data_manager->Reset();
+  sensor_data_manager->Init();
+  FusionInitOptions init_options;
+  init_options.main_sensor = "velodyne64";
+  if (!fusion->Init(init_options)) {
+    return false;
+  }
+  fusion->params_.num_threads = num_threads;
+  // the testdata intrinsics are a placeholder, a 1080p front camera is set
+  // so that the lidar clouds project into the image
+  auto camera_model = std::dynamic_pointer_cast<base::PinholeCameraModel>(
+      sensor_data_manager->GetCameraIntrinsic("front_camera"));
+  if (camera_model == nullptr) {
+    return false;
+  }
+  Eigen::Matrix3f intrinsic_params;
+  intrinsic_params << 2000.0f, 0.0f, 960.0f, 0.0f, 2000.0f, 540.0f, 0.0f,
+      0.0f, 1.0f;
+  camera_model->set_width(kImageWidth);
+  camera_model->set_height(kImageHeight);
+  camera_model->set_intrinsic_params(intrinsic_params);
+  return true;
+}
+
+void BM_FuseDrive(benchmark::State& state) {
+  const int num_vehicles = static_cast<int>(state.range(0));
+  std::vector<double> fuse_times;
+  double num_fused_objects = 0.0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ProbabilisticFusion fusion;
+    if (!InitFusion(static_cast<uint32_t>(state.range(1)), &fusion)) {
+      state.SkipWithError("failed to init the fusion");
+      return;
+    }
+    base::BaseCameraModelPtr camera_model =
+        SensorDataManager::Instance()->GetCameraIntrinsic("front_camera");
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> x_distribution(-20.0, kRange);
+    std::uniform_real_distribution<double> speed_distribution(6.0, 14.0);
+    std::normal_distribution<double> noise_distribution(0.0, 0.2);
+    std::vector<Vehicle> vehicles(num_vehicles);
+    for (int i = 0; i < num_vehicles; ++i) {
+      vehicles[i].id = i;
+      vehicles[i].x = x_distribution(generator);
+      vehicles[i].y = kLaneWidth * (i % kNumLanes - kNumLanes / 2);
+      vehicles[i].speed = speed_distribution(generator);
+    }
+    num_fused_objects = 0.0;
+    state.ResumeTiming();
+
+    for (int cycle = 0; cycle < kNumCycles; ++cycle) {
+      state.PauseTiming();
+      const double timestamp = kStartTime + cycle * kCycleTime;
+      const double ego_x = kEgoSpeed * cycle * kCycleTime;
+      for (auto& vehicle : vehicles) {
+        vehicle.x += vehicle.speed * kCycleTime;
+        // leaving the range, a new vehicle comes in at the other end
+        if (vehicle.x - ego_x > kRange || vehicle.x - ego_x < -20.0) {
+          vehicle.x = ego_x + (vehicle.x - ego_x > kRange ? -20.0 : kRange);
+          vehicle.id += num_vehicles;
+        }
+      }
+      const Eigen::Vector3d lidar_position(ego_x, 0.0, 1.9);
+      const Eigen::Affine3d lidar2world =
+          Eigen::Affine3d(Eigen::Translation3d(lidar_position));
+      Eigen::Matrix3d camera_axes;
+      camera_axes << 0, 0, 1, -1, 0, 0, 0, -1, 0;
+      const Eigen::Affine3d camera2world =
+          Eigen::Translation3d(ego_x + 1.5, 0.0, 1.5) * camera_axes;
+      const Eigen::Affine3d world2camera = camera2world.inverse();
+      const Eigen::Affine3d radar2world =
+          Eigen::Affine3d(Eigen::Translation3d(ego_x + 3.5, 0.0, 0.5));
+
+      base::FramePtr camera_frame =
+          MakeFrame("front_camera", timestamp, camera2world);
+      base::FramePtr radar_frame =
+          MakeFrame("radar", timestamp + 0.03, radar2world);
+      base::FramePtr lidar_frame =
+          MakeFrame("velodyne64", timestamp + 0.06, lidar2world);
+      for (const auto& vehicle : vehicles) {
+        base::ObjectPtr lidar_object = MakeObject(vehicle, vehicle.id);
+        AddCloud(lidar_position, lidar_object.get());
+        lidar_frame->objects.push_back(lidar_object);
+        if (vehicle.x > ego_x) {
+          Vehicle radar_vehicle = vehicle;
+          radar_vehicle.x += noise_distribution(generator);
+          radar_frame->objects.push_back(
+              MakeObject(radar_vehicle, vehicle.id));
+        }
+        // the mono camera estimates the distance within a few percent
+        Vehicle camera_vehicle = vehicle;
+        camera_vehicle.x +=
+            0.05 * (vehicle.x - ego_x) * noise_distribution(generator);
+        base::ObjectPtr camera_object = MakeObject(
+            camera_vehicle,
+            vehicle.id + (cycle / kCameraTrackPeriod) * 100000);
+        if (ProjectBox(world2camera, camera_model.get(), *lidar_object,
+                       &camera_object->camera_supplement.box)) {
+          camera_frame->objects.push_back(camera_object);
+        }
+      }
+      state.ResumeTiming();
+
+      FusionOptions options;
+      std::vector<base::ObjectPtr> fused_objects;
+      fusion.Fuse(options, camera_frame, &fused_objects);
+      fusion.Fuse(options, radar_frame, &fused_objects);
+      const auto start_time = std::chrono::steady_clock::now();
+      fusion.Fuse(options, lidar_frame, &fused_objects);
+      fuse_times.push_back(ElapsedMicroseconds(start_time));
+      num_fused_objects += static_cast<double>(fused_objects.size());
+    }
+  }
+  std::sort(fuse_times.begin(), fuse_times.end());
+  const auto percentile = [&fuse_times](const double p) {
+    return fuse_times[static_cast<size_t>(
+        p * static_cast<double>(fuse_times.size() - 1))];
+  };
+  double total_time = 0.0;
+  for (const double fuse_time : fuse_times) {
+    total_time += fuse_time;
+  }
+  state.counters["mean_us"] = total_time / fuse_times.size();
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["max_us"] = fuse_times.back();
+  state.counters["fused_objects"] = num_fused_objects / kNumCycles;
+}
+
+}  // namespace
+
+BENCHMARK(BM_FuseDrive)
+    ->ArgsProduct({{20, 60, 120}, {1, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace fusion
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
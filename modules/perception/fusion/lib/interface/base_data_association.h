@@ -29,7 +29,10 @@ namespace apollo {
 namespace perception {
 namespace fusion {
 
-struct AssociationOptions {};
+struct AssociationOptions {
+  // threads splitting the track object distances of a frame
+  size_t num_threads = 1;
+};
 
 typedef std::pair<size_t, size_t> TrackMeasurmentPair;
 
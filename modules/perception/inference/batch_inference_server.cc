@@ -0,0 +1,290 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/inference/batch_inference_server.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+BatchInferenceServer::BatchInferenceServer() {}
+
+BatchInferenceServer::~BatchInferenceServer() { Shutdown(); }
+
+bool BatchInferenceServer::AddModel(
+    const std::string &name, std::unique_ptr<Inference> net,
+    const std::map<std::string, std::vector<int>> &sample_shapes,
+    const std::vector<std::string> &output_names,
+    const BatchInferenceOptions &options) {
+  if (net == nullptr || sample_shapes.empty() || output_names.empty() ||
+      options.max_batch_size < 1) {
+    AERROR << "Invalid model " << name;
+    return false;
+  }
+  std::shared_ptr<Model> model = std::make_shared<Model>();
+  model->options = options;
+  model->output_names = output_names;
+  std::map<std::string, std::vector<int>> batch_shapes;
+  for (const auto &sample_shape : sample_shapes) {
+    if (sample_shape.second.empty() || sample_shape.second[0] != 1) {
+      AERROR << "Input " << sample_shape.first << " of " << name
+             << " is not a single sample";
+      return false;
+    }
+    model->input_names.push_back(sample_shape.first);
+    model->sample_shapes.push_back(sample_shape.second);
+    std::vector<int> batch_shape = sample_shape.second;
+    batch_shape[0] = options.max_batch_size;
+    batch_shapes.emplace(sample_shape.first, batch_shape);
+  }
+  net->set_max_batch_size(options.max_batch_size);
+  if (!net->Init(batch_shapes)) {
+    AERROR << "Failed to init the net of " << name;
+    return false;
+  }
+  for (const auto &blob_name : model->input_names) {
+    if (net->get_blob(blob_name) == nullptr) {
+      AERROR << "Net of " << name << " has no input " << blob_name;
+      return false;
+    }
+  }
+  model->net = std::move(net);
+
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  if (models_.find(name) != models_.end()) {
+    AERROR << "Model " << name << " is already served";
+    return false;
+  }
+  Model *model_ptr = model.get();
+  model->worker = std::thread([this, model_ptr]() { Serve(model_ptr); });
+  models_.emplace(name, model);
+  AINFO << "Serving " << name << " with batches of up to "
+        << options.max_batch_size << " samples";
+  return true;
+}
+
+void BatchInferenceServer::RemoveModel(const std::string &name) {
+  std::shared_ptr<Model> model;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    auto iter = models_.find(name);
+    if (iter == models_.end()) {
+      return;
+    }
+    model = iter->second;
+    models_.erase(iter);
+  }
+  StopModel(model);
+}
+
+bool BatchInferenceServer::HasModel(const std::string &name) {
+  return GetModel(name) != nullptr;
+}
+
+std::future<bool> BatchInferenceServer::Submit(
+    const std::string &name, const std::vector<BlobPtr> &inputs,
+    const std::vector<BlobPtr> &outputs) {
+  std::unique_ptr<Request> request(new Request);
+  std::future<bool> done = request->done.get_future();
+  std::shared_ptr<Model> model = GetModel(name);
+  if (model == nullptr) {
+    AERROR << "Model " << name << " is not served";
+    request->done.set_value(false);
+    return done;
+  }
+  bool valid = inputs.size() == model->input_names.size() &&
+               outputs.size() == model->output_names.size();
+  for (size_t i = 0; valid && i < inputs.size(); ++i) {
+    valid =
+        inputs[i] != nullptr && inputs[i]->shape() == model->sample_shapes[i];
+  }
+  for (size_t i = 0; valid && i < outputs.size(); ++i) {
+    valid = outputs[i] != nullptr;
+  }
+  if (!valid) {
+    AERROR << "Request of " << name << " does not match its inputs";
+    request->done.set_value(false);
+    return done;
+  }
+  request->inputs = inputs;
+  request->outputs = outputs;
+  request->enqueue_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(model->mutex);
+    if (model->stop) {
+      request->done.set_value(false);
+      return done;
+    }
+    model->requests.push_back(std::move(request));
+  }
+  model->condition.notify_one();
+  return done;
+}
+
+bool BatchInferenceServer::Infer(const std::string &name,
+                                 const std::vector<BlobPtr> &inputs,
+                                 const std::vector<BlobPtr> &outputs) {
+  return Submit(name, inputs, outputs).get();
+}
+
+bool BatchInferenceServer::GetStats(const std::string &name,
+                                    BatchInferenceStats *stats) {
+  std::shared_ptr<Model> model = GetModel(name);
+  if (model == nullptr || stats == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(model->mutex);
+  *stats = model->stats;
+  return true;
+}
+
+void BatchInferenceServer::Shutdown() {
+  std::map<std::string, std::shared_ptr<Model>> models;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    models.swap(models_);
+  }
+  for (auto &model : models) {
+    StopModel(model.second);
+  }
+}
+
+void BatchInferenceServer::Serve(Model *model) {
+  std::vector<std::unique_ptr<Request>> batch;
+  while (true) {
+    WaitBatch(model, &batch);
+    if (batch.empty()) {
+      return;
+    }
+    const bool state = RunBatch(model, batch);
+    {
+      std::lock_guard<std::mutex> lock(model->mutex);
+      ++model->stats.num_batches;
+      model->stats.num_samples += batch.size();
+    }
+    for (auto &request : batch) {
+      request->done.set_value(state);
+    }
+  }
+}
+
+void BatchInferenceServer::WaitBatch(
+    Model *model, std::vector<std::unique_ptr<Request>> *batch) {
+  batch->clear();
+  const size_t max_batch_size =
+      static_cast<size_t>(model->options.max_batch_size);
+  std::unique_lock<std::mutex> lock(model->mutex);
+  model->condition.wait(
+      lock, [model]() { return model->stop || !model->requests.empty(); });
+  if (model->stop) {
+    return;
+  }
+  // the oldest request sets the deadline, the batch is run once full
+  const auto deadline =
+      model->requests.front()->enqueue_time +
+      std::chrono::microseconds(model->options.max_latency_us);
+  model->condition.wait_until(lock, deadline, [model, max_batch_size]() {
+    return model->stop || model->requests.size() >= max_batch_size;
+  });
+  if (model->stop) {
+    return;
+  }
+  const size_t batch_size = std::min(model->requests.size(), max_batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    batch->push_back(std::move(model->requests.front()));
+    model->requests.pop_front();
+  }
+}
+
+bool BatchInferenceServer::RunBatch(
+    Model *model, const std::vector<std::unique_ptr<Request>> &batch) {
+  const int batch_size = static_cast<int>(batch.size());
+  for (size_t i = 0; i < model->input_names.size(); ++i) {
+    BlobPtr blob = model->net->get_blob(model->input_names[i]);
+    std::vector<int> batch_shape = model->sample_shapes[i];
+    batch_shape[0] = batch_size;
+    blob->Reshape(batch_shape);
+    const int sample_count = blob->count(1);
+    float *batch_data = blob->mutable_cpu_data();
+    for (int j = 0; j < batch_size; ++j) {
+      memcpy(batch_data + j * sample_count, batch[j]->inputs[i]->cpu_data(),
+             sample_count * sizeof(float));
+    }
+  }
+
+  // an exception of the net must not end the worker
+  try {
+    model->net->Infer();
+  } catch (const std::exception &e) {
+    AERROR << "Failed to run a batch of " << batch_size << ": " << e.what();
+    return false;
+  }
+
+  for (size_t i = 0; i < model->output_names.size(); ++i) {
+    BlobPtr blob = model->net->get_blob(model->output_names[i]);
+    if (blob == nullptr || blob->num_axes() < 1 ||
+        blob->shape(0) != batch_size) {
+      AERROR << "Output " << model->output_names[i]
+             << " does not hold the batch";
+      return false;
+    }
+    std::vector<int> sample_shape = blob->shape();
+    sample_shape[0] = 1;
+    const int sample_count = blob->count(1);
+    const float *batch_data = blob->cpu_data();
+    for (int j = 0; j < batch_size; ++j) {
+      BlobPtr output = batch[j]->outputs[i];
+      output->Reshape(sample_shape);
+      memcpy(output->mutable_cpu_data(), batch_data + j * sample_count,
+             sample_count * sizeof(float));
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<BatchInferenceServer::Model> BatchInferenceServer::GetModel(
+    const std::string &name) {
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  auto iter = models_.find(name);
+  return iter == models_.end() ? nullptr : iter->second;
+}
+
+void BatchInferenceServer::StopModel(const std::shared_ptr<Model> &model) {
+  std::deque<std::unique_ptr<Request>> requests;
+  {
+    std::lock_guard<std::mutex> lock(model->mutex);
+    model->stop = true;
+    requests.swap(model->requests);
+  }
+  model->condition.notify_all();
+  if (model->worker.joinable()) {
+    model->worker.join();
+  }
+  for (auto &request : requests) {
+    request->done.set_value(false);
+  }
+}
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "modules/perception/base/blob.h"
+#include "modules/perception/inference/inference.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+using BlobPtr = std::shared_ptr<apollo::perception::base::Blob<float>>;
+
+struct BatchInferenceOptions {
+  // the most samples run by one forward pass of the net
+  int max_batch_size = 8;
+  // how long the oldest request of a batch may wait for more requests before
+  // the batch is run anyway, in microseconds
+  int max_latency_us = 2000;
+};
+
+struct BatchInferenceStats {
+  size_t num_batches = 0;
+  size_t num_samples = 0;
+};
+
+// @brief: runs the requests of several components or cameras on a shared
+//         net, stacking the samples received within the latency budget into
+//         one forward pass. Each model is served by a worker thread of its
+//         own, so the nets are only run from one thread at a time. The inputs
+//         and outputs of a request are blobs of a single sample, with a
+//         leading dimension of 1, and the net sees the same blobs with a
+//         leading dimension of the batch size. The cnn segmentation lidar
+//         detectors share their net on it with --enable_lidar_batch_inference.
+class BatchInferenceServer {
+ public:
+  ~BatchInferenceServer();
+
+  // @brief: serve net as name, sample_shapes are the shapes of the inputs of
+  //         one sample. The net is initialized by the server for batches of
+  //         options.max_batch_size samples.
+  bool AddModel(const std::string &name, std::unique_ptr<Inference> net,
+                const std::map<std::string, std::vector<int>> &sample_shapes,
+                const std::vector<std::string> &output_names,
+                const BatchInferenceOptions &options);
+
+  // @brief: stop serving name, the pending requests fail.
+  void RemoveModel(const std::string &name);
+
+  bool HasModel(const std::string &name);
+
+  // @brief: queue a sample for name, inputs are given in the order of the
+  //         input names of AddModel (sorted by name) and the outputs are
+  //         reshaped and filled in the order of output_names. The future is
+  //         false if the request could not be run, e.g. a shape mismatch.
+  std::future<bool> Submit(const std::string &name,
+                           const std::vector<BlobPtr> &inputs,
+                           const std::vector<BlobPtr> &outputs);
+
+  // @brief: Submit and wait for the outputs.
+  bool Infer(const std::string &name, const std::vector<BlobPtr> &inputs,
+             const std::vector<BlobPtr> &outputs);
+
+  bool GetStats(const std::string &name, BatchInferenceStats *stats);
+
+  void Shutdown();
+
+ private:
+  struct Request {
+    std::vector<BlobPtr> inputs;
+    std::vector<BlobPtr> outputs;
+    std::promise<bool> done;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  struct Model {
+    std::unique_ptr<Inference> net;
+    std::vector<std::string> input_names;
+    std::vector<std::vector<int>> sample_shapes;
+    std::vector<std::string> output_names;
+    BatchInferenceOptions options;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::unique_ptr<Request>> requests;
+    bool stop = false;
+    BatchInferenceStats stats;
+    std::thread worker;
+  };
+
+  // the loop of the worker of model
+  void Serve(Model *model);
+
+  // wait for the next batch of model, empty once the model is stopped
+  void WaitBatch(Model *model, std::vector<std::unique_ptr<Request>> *batch);
+
+  // run batch through the net of model and fill the outputs of the requests
+  bool RunBatch(Model *model,
+                const std::vector<std::unique_ptr<Request>> &batch);
+
+  std::shared_ptr<Model> GetModel(const std::string &name);
+
+  void StopModel(const std::shared_ptr<Model> &model);
+
+  std::mutex models_mutex_;
+  std::map<std::string, std::shared_ptr<Model>> models_;
+
+  DECLARE_SINGLETON(BatchInferenceServer)
+};
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
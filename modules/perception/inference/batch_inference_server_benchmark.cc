@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Throughput and latency of BatchInferenceServer on the cpu libtorch
+// backend, with a small convolutional classifier of 3x64x64 crops scripted
+// and saved at startup, so that no model file nor gpu is needed. Argument 0
+// is the max batch size, 1 running every request on its own, and argument 1
+// the number of clients (components or cameras) sending requests
+// concurrently, each waiting for its result before sending the next one.
+// The latency budget is 2ms. The counters report the samples per second,
+// the distribution of the request latency and the mean batch size. Run with
+// bazel run -c opt //modules/perception/inference:batch_inference_server_benchmark
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/inference/batch_inference_server.h"
+#include "modules/perception/inference/libtorch/torch_cpu_net.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+namespace {
+
+constexpr int kCropSize = 64;
+constexpr int kRequestsPerClient = 32;
+constexpr int kMaxLatencyUs = 2000;
+
+const char kModelFile[] = "/tmp/batch_inference_server_benchmark.pt";
+
+// three strided convolutions, a global pooling and a 4 class softmax
+bool SaveClassifier() {
+  torch::manual_seed(0);
+  torch::jit::Module module("RoiClassifier");
+  module.register_parameter("conv1", torch::randn({16, 3, 3, 3}) * 0.2,
+                            false);
+  module.register_parameter("conv2", torch::randn({32, 16, 3, 3}) * 0.1,
+                            false);
+  module.register_parameter("conv3", torch::randn({64, 32, 3, 3}) * 0.1,
+                            false);
+  module.register_parameter("fc", torch::randn({64, 4}) * 0.1, false);
+  module.define(R"JIT(
+    def forward(self, x):
+        x = torch.relu(torch.conv2d(x, self.conv1, None, [2, 2], [1, 1]))
+        x = torch.relu(torch.conv2d(x, self.conv2, None, [2, 2], [1, 1]))
+        x = torch.relu(torch.conv2d(x, self.conv3, None, [2, 2], [1, 1]))
+        x = torch.mean(x, [2, 3])
+        return torch.softmax(torch.matmul(x, self.fc), 1)
+  )JIT");
+  try {
+    module.save(kModelFile);
+  } catch (const c10::Error &) {
+    return false;
+  }
+  return true;
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point &start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+void BM_Serve(benchmark::State &state) {
+  static const bool saved = SaveClassifier();
+  if (!saved) {
+    state.SkipWithError("failed to save the model");
+    return;
+  }
+  const std::string name = "classifier_" + std::to_string(state.range(0)) +
+                           "_" + std::to_string(state.range(1));
+  BatchInferenceServer *server = BatchInferenceServer::Instance();
+  BatchInferenceOptions options;
+  options.max_batch_size = static_cast<int>(state.range(0));
+  options.max_latency_us = state.range(0) > 1 ? kMaxLatencyUs : 0;
+  if (!server->AddModel(
+          name,
+          std::unique_ptr<Inference>(
+              new TorchCpuNet(kModelFile, {"prob"}, {"data"})),
+          {{"data", {1, 3, kCropSize, kCropSize}}}, {"prob"}, options)) {
+    state.SkipWithError("failed to add the model");
+    return;
+  }
+
+  const int num_clients = static_cast<int>(state.range(1));
+  std::mutex latencies_mutex;
+  std::vector<double> latencies;
+  auto run_client = [&]() {
+    BlobPtr input =
+        std::make_shared<base::Blob<float>>(1, 3, kCropSize, kCropSize);
+    std::fill(input->mutable_cpu_data(),
+              input->mutable_cpu_data() + input->count(), 0.5f);
+    BlobPtr output = std::make_shared<base::Blob<float>>();
+    std::vector<double> client_latencies;
+    for (int i = 0; i < kRequestsPerClient; ++i) {
+      const auto start_time = std::chrono::steady_clock::now();
+      server->Infer(name, {input}, {output});
+      client_latencies.push_back(ElapsedMicroseconds(start_time));
+    }
+    std::lock_guard<std::mutex> lock(latencies_mutex);
+    latencies.insert(latencies.end(), client_latencies.begin(),
+                     client_latencies.end());
+  };
+  for (auto _ : state) {
+    std::vector<std::thread> clients;
+    for (int i = 0; i < num_clients; ++i) {
+      clients.emplace_back(run_client);
+    }
+    for (auto &client : clients) {
+      client.join();
+    }
+  }
+
+  BatchInferenceStats stats;
+  server->GetStats(name, &stats);
+  server->RemoveModel(name);
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](const double p) {
+    return latencies[static_cast<size_t>(
+        p * static_cast<double>(latencies.size() - 1))];
+  };
+  double total_latency = 0.0;
+  for (const double latency : latencies) {
+    total_latency += latency;
+  }
+  state.counters["samples"] = benchmark::Counter(
+      static_cast<double>(latencies.size()), benchmark::Counter::kIsRate);
+  state.counters["mean_us"] = total_latency / latencies.size();
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["batch_size"] =
+      static_cast<double>(stats.num_samples) / stats.num_batches;
+}
+
+}  // namespace
+
+BENCHMARK(BM_Serve)
+    ->ArgsProduct({{1, 4, 8}, {1, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
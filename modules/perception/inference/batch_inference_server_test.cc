@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/inference/batch_inference_server.h"
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+// output = 2 * input + sample index in the batch, on the cpu
+class FakeNet : public Inference {
+ public:
+  bool Init(const std::map<std::string, std::vector<int>> &shapes) override {
+    auto iter = shapes.find("data");
+    if (iter == shapes.end()) {
+      return false;
+    }
+    blobs_["data"] = std::make_shared<base::Blob<float>>(iter->second);
+    blobs_["prob"] = std::make_shared<base::Blob<float>>(iter->second);
+    return true;
+  }
+
+  void Infer() override {
+    if (throw_on_infer_) {
+      throw std::runtime_error("failed forward");
+    }
+    const BlobPtr &input = blobs_["data"];
+    const BlobPtr &output = blobs_["prob"];
+    output->ReshapeLike(*input);
+    const int sample_count = input->count(1);
+    for (int i = 0; i < input->count(); ++i) {
+      output->mutable_cpu_data()[i] =
+          2.0f * input->cpu_data()[i] + static_cast<float>(i / sample_count);
+    }
+    batch_sizes_.push_back(input->shape(0));
+  }
+
+  BlobPtr get_blob(const std::string &name) override {
+    auto iter = blobs_.find(name);
+    return iter == blobs_.end() ? nullptr : iter->second;
+  }
+
+  static std::vector<int> batch_sizes_;
+  static bool throw_on_infer_;
+
+ private:
+  BlobMap blobs_;
+};
+
+std::vector<int> FakeNet::batch_sizes_;
+bool FakeNet::throw_on_infer_ = false;
+
+BlobPtr MakeSample(const float value) {
+  BlobPtr blob = std::make_shared<base::Blob<float>>(1, 2, 1, 3);
+  for (int i = 0; i < blob->count(); ++i) {
+    blob->mutable_cpu_data()[i] = value + static_cast<float>(i);
+  }
+  return blob;
+}
+
+bool AddFakeModel(const std::string &name, const int max_batch_size,
+                  const int max_latency_us) {
+  BatchInferenceOptions options;
+  options.max_batch_size = max_batch_size;
+  options.max_latency_us = max_latency_us;
+  return BatchInferenceServer::Instance()->AddModel(
+      name, std::unique_ptr<Inference>(new FakeNet), {{"data", {1, 2, 1, 3}}},
+      {"prob"}, options);
+}
+
+TEST(BatchInferenceServerTest, test_infer) {
+  BatchInferenceServer *server = BatchInferenceServer::Instance();
+  EXPECT_TRUE(AddFakeModel("infer", 4, 500));
+  EXPECT_FALSE(AddFakeModel("infer", 4, 500));
+  EXPECT_TRUE(server->HasModel("infer"));
+
+  BlobPtr output = std::make_shared<base::Blob<float>>();
+  EXPECT_TRUE(server->Infer("infer", {MakeSample(1.0f)}, {output}));
+  ASSERT_EQ(output->shape(), std::vector<int>({1, 2, 1, 3}));
+  for (int i = 0; i < output->count(); ++i) {
+    EXPECT_FLOAT_EQ(output->cpu_data()[i], 2.0f * (1.0f + i));
+  }
+  BatchInferenceStats stats;
+  EXPECT_TRUE(server->GetStats("infer", &stats));
+  EXPECT_EQ(stats.num_batches, 1);
+  EXPECT_EQ(stats.num_samples, 1);
+
+  // wrong shape, unknown model
+  BlobPtr wrong_input = std::make_shared<base::Blob<float>>(1, 3, 1, 3);
+  EXPECT_FALSE(server->Infer("infer", {wrong_input}, {output}));
+  EXPECT_FALSE(server->Infer("infer", {MakeSample(1.0f)}, {}));
+  EXPECT_FALSE(server->Infer("unknown", {MakeSample(1.0f)}, {output}));
+
+  server->RemoveModel("infer");
+  EXPECT_FALSE(server->HasModel("infer"));
+  EXPECT_FALSE(server->Infer("infer", {MakeSample(1.0f)}, {output}));
+  EXPECT_FALSE(server->GetStats("infer", &stats));
+}
+
+TEST(BatchInferenceServerTest, test_batching) {
+  BatchInferenceServer *server = BatchInferenceServer::Instance();
+  FakeNet::batch_sizes_.clear();
+  // a budget long enough for the requests to fill the batches
+  EXPECT_TRUE(AddFakeModel("batching", 4, 1000000));
+
+  std::vector<BlobPtr> outputs;
+  std::vector<std::future<bool>> results;
+  for (int i = 0; i < 8; ++i) {
+    outputs.push_back(std::make_shared<base::Blob<float>>());
+    results.push_back(server->Submit(
+        "batching", {MakeSample(static_cast<float>(10 * i))}, {outputs[i]}));
+  }
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(results[i].get());
+    // the sample is the (i % 4)th of its batch
+    for (int j = 0; j < outputs[i]->count(); ++j) {
+      EXPECT_FLOAT_EQ(outputs[i]->cpu_data()[j],
+                      2.0f * (10.0f * i + j) + static_cast<float>(i % 4));
+    }
+  }
+  EXPECT_EQ(FakeNet::batch_sizes_, std::vector<int>({4, 4}));
+  BatchInferenceStats stats;
+  EXPECT_TRUE(server->GetStats("batching", &stats));
+  EXPECT_EQ(stats.num_batches, 2);
+  EXPECT_EQ(stats.num_samples, 8);
+  server->RemoveModel("batching");
+}
+
+TEST(BatchInferenceServerTest, test_latency_budget) {
+  BatchInferenceServer *server = BatchInferenceServer::Instance();
+  FakeNet::batch_sizes_.clear();
+  EXPECT_TRUE(AddFakeModel("latency", 8, 1000));
+
+  // a lone request is run once the budget is spent
+  BlobPtr output = std::make_shared<base::Blob<float>>();
+  const auto start_time = std::chrono::steady_clock::now();
+  EXPECT_TRUE(server->Infer("latency", {MakeSample(0.0f)}, {output}));
+  EXPECT_GE(std::chrono::steady_clock::now() - start_time,
+            std::chrono::microseconds(1000));
+  EXPECT_EQ(FakeNet::batch_sizes_, std::vector<int>({1}));
+
+  // pending requests fail when the model is removed
+  server->RemoveModel("latency");
+  EXPECT_TRUE(AddFakeModel("latency", 8, 10000000));
+  std::future<bool> result =
+      server->Submit("latency", {MakeSample(0.0f)}, {output});
+  server->RemoveModel("latency");
+  EXPECT_FALSE(result.get());
+}
+
+TEST(BatchInferenceServerTest, test_failed_batch) {
+  BatchInferenceServer *server = BatchInferenceServer::Instance();
+  EXPECT_TRUE(AddFakeModel("failed", 4, 500));
+
+  // the batch fails, and the model is still served
+  BlobPtr output = std::make_shared<base::Blob<float>>();
+  FakeNet::throw_on_infer_ = true;
+  EXPECT_FALSE(server->Infer("failed", {MakeSample(1.0f)}, {output}));
+  FakeNet::throw_on_infer_ = false;
+  EXPECT_TRUE(server->Infer("failed", {MakeSample(1.0f)}, {output}));
+  BatchInferenceStats stats;
+  EXPECT_TRUE(server->GetStats("failed", &stats));
+  EXPECT_EQ(stats.num_batches, 2);
+  server->RemoveModel("failed");
+}
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
@@ -16,6 +16,7 @@
 
 #include "modules/perception/inference/inference_factory.h"
 
+#include "modules/perception/inference/libtorch/torch_cpu_net.h"
 #include "modules/perception/inference/libtorch/torch_det.h"
 #include "modules/perception/inference/libtorch/torch_net.h"
 #include "modules/perception/inference/onnx/libtorch_obstacle_detector.h"
@@ -49,6 +50,8 @@ Inference *CreateInferenceByName(const std::string &name,
     return new TorchDet(proto_file, weight_file, outputs, inputs);
   } else if (name == "TorchNet") {
     return new TorchNet(proto_file, weight_file, outputs, inputs);
+  } else if (name == "TorchCpuNet") {
+    return new TorchCpuNet(weight_file, outputs, inputs);
   } else if (name == "Obstacle") {
     return new ObstacleDetector(proto_file, weight_file, outputs, inputs);
   } else if (name == "PaddleNet") {
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/inference/libtorch/torch_cpu_net.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+using apollo::perception::base::Blob;
+
+TorchCpuNet::TorchCpuNet(const std::string &model_file,
+                         const std::vector<std::string> &outputs,
+                         const std::vector<std::string> &inputs)
+    : model_file_(model_file), output_names_(outputs), input_names_(inputs) {}
+
+bool TorchCpuNet::Init(const std::map<std::string, std::vector<int>> &shapes) {
+  try {
+    net_ = torch::jit::load(model_file_, torch::Device(torch::kCPU));
+  } catch (const c10::Error &e) {
+    AERROR << "Failed to load " << model_file_ << ": " << e.what();
+    return false;
+  }
+  net_.eval();
+
+  for (const auto &name : input_names_) {
+    auto iter = shapes.find(name);
+    if (iter == shapes.end()) {
+      AERROR << "No shape for input " << name;
+      return false;
+    }
+    blobs_.emplace(name, std::make_shared<Blob<float>>(iter->second));
+  }
+  // reshaped by Infer to the outputs of the model
+  for (const auto &name : output_names_) {
+    blobs_.emplace(name, std::make_shared<Blob<float>>());
+  }
+  return true;
+}
+
+BlobPtr TorchCpuNet::get_blob(const std::string &name) {
+  auto iter = blobs_.find(name);
+  if (iter == blobs_.end()) {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void TorchCpuNet::Infer() {
+  torch::NoGradGuard no_grad;
+  std::vector<torch::jit::IValue> inputs;
+  for (const auto &name : input_names_) {
+    const BlobPtr &blob = blobs_[name];
+    std::vector<int64_t> sizes(blob->shape().begin(), blob->shape().end());
+    inputs.emplace_back(
+        torch::from_blob(blob->mutable_cpu_data(), sizes, torch::kFloat32));
+  }
+
+  std::vector<torch::Tensor> output_tensors;
+  try {
+    torch::jit::IValue output = net_.forward(inputs);
+    if (output.isTuple()) {
+      for (const auto &element : output.toTuple()->elements()) {
+        output_tensors.push_back(element.toTensor());
+      }
+    } else {
+      output_tensors.push_back(output.toTensor());
+    }
+  } catch (const c10::Error &e) {
+    AERROR << "Failed to run " << model_file_ << ": " << e.what();
+    // empty outputs, not to be taken for the outputs of the last run
+    for (const auto &name : output_names_) {
+      blobs_[name]->Reshape(std::vector<int>{0});
+    }
+    return;
+  }
+  if (output_tensors.size() < output_names_.size()) {
+    AERROR << "Model " << model_file_ << " has " << output_tensors.size()
+           << " outputs, expected " << output_names_.size();
+  }
+
+  const size_t num_outputs =
+      std::min(output_tensors.size(), output_names_.size());
+  for (size_t i = 0; i < num_outputs; ++i) {
+    torch::Tensor tensor = output_tensors[i].to(torch::kFloat32).contiguous();
+    std::vector<int> shape(tensor.sizes().begin(), tensor.sizes().end());
+    const BlobPtr &blob = blobs_[output_names_[i]];
+    blob->Reshape(shape);
+    memcpy(blob->mutable_cpu_data(), tensor.data_ptr<float>(),
+           tensor.numel() * sizeof(float));
+  }
+}
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <torch/script.h>
+#include <torch/torch.h>
+
+#include "modules/perception/inference/inference.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+using BlobPtr = std::shared_ptr<apollo::perception::base::Blob<float>>;
+
+// @brief: a torchscript model run on the cpu. The input blobs are passed to
+//         forward in the order of inputs, as float tensors of the blob
+//         shapes, and the outputs of forward (a tensor or a tuple of tensors)
+//         fill the output blobs in the order of outputs. The leading
+//         dimension of the inputs may change between runs, so the net can
+//         be fed batches of any size. A failed forward leaves the output
+//         blobs empty.
+class TorchCpuNet : public Inference {
+ public:
+  TorchCpuNet(const std::string &model_file,
+              const std::vector<std::string> &outputs,
+              const std::vector<std::string> &inputs);
+
+  virtual ~TorchCpuNet() {}
+
+  bool Init(const std::map<std::string, std::vector<int>> &shapes) override;
+
+  void Infer() override;
+  BlobPtr get_blob(const std::string &name) override;
+
+ protected:
+  torch::jit::script::Module net_;
+
+ private:
+  std::string model_file_;
+  std::vector<std::string> output_names_;
+  std::vector<std::string> input_names_;
+  BlobMap blobs_;
+};
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
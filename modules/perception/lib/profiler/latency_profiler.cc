@@ -0,0 +1,242 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lib/profiler/latency_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "cyber/common/log.h"
+#include "modules/perception/common/perception_gflags.h"
+
+namespace apollo {
+namespace perception {
+namespace lib {
+namespace {
+
+constexpr double kMinBucketMs = 0.01;
+constexpr double kBucketsPerOctave = 4.0;
+
+thread_local LatencyFrameScope *current_frame = nullptr;
+
+double BucketUpperBound(const int bucket) {
+  return kMinBucketMs * std::exp2(bucket / kBucketsPerOctave);
+}
+
+std::string EscapeJson(const std::string &str) {
+  std::string escaped;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+}  // namespace
+
+int64_t LatencyNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void LatencyHistogram::Add(const double duration_ms) {
+  int bucket = 0;
+  if (duration_ms >= kMinBucketMs) {
+    bucket = static_cast<int>(
+        std::floor(kBucketsPerOctave * std::log2(duration_ms / kMinBucketMs)) +
+        1);
+    bucket = std::min(bucket, kBucketCount - 1);
+  }
+  ++buckets_[bucket];
+  ++count_;
+  sum_ += duration_ms;
+  max_ = std::max(max_, duration_ms);
+}
+
+double LatencyHistogram::Percentile(const double p) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  const size_t rank = static_cast<size_t>(std::ceil(p * count_));
+  size_t accumulated = 0;
+  for (int i = 0; i < kBucketCount; ++i) {
+    accumulated += buckets_[i];
+    if (accumulated >= std::max<size_t>(rank, 1)) {
+      return std::min(BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+LatencyProfiler::LatencyProfiler() : summary_time_us_(LatencyNowUs()) {}
+
+void LatencyProfiler::AddFrame(const std::string &name,
+                               const std::string &sensor_name,
+                               const double timestamp,
+                               std::vector<LatencyEvent> *events) {
+  const size_t max_frames =
+      static_cast<size_t>(std::max(FLAGS_perception_latency_trace_frames, 0));
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &event : *events) {
+    histograms_[StageKey(sensor_name, event.stage)].Add(
+        static_cast<double>(event.end_us - event.start_us) * 1e-3);
+  }
+  if (max_frames == 0) {
+    return;
+  }
+  std::deque<TraceFrame> &frames = traces_[TrackKey(name, sensor_name)];
+  if (frames.size() >= max_frames) {
+    frames.pop_front();
+  }
+  frames.emplace_back();
+  frames.back().timestamp = timestamp;
+  frames.back().events.swap(*events);
+}
+
+void LatencyProfiler::Summarize(PerceptionLatencySummary *summary) {
+  summary->clear_stage_latency();
+  std::map<StageKey, LatencyHistogram> histograms;
+  const int64_t now_us = LatencyNowUs();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histograms.swap(histograms_);
+    summary->set_period(static_cast<double>(now_us - summary_time_us_) * 1e-6);
+    summary_time_us_ = now_us;
+  }
+  for (const auto &histogram : histograms) {
+    StageLatency *stage_latency = summary->add_stage_latency();
+    stage_latency->set_sensor_name(histogram.first.first);
+    stage_latency->set_stage(histogram.first.second);
+    stage_latency->set_count(static_cast<uint32_t>(histogram.second.count()));
+    stage_latency->set_mean_ms(histogram.second.mean());
+    stage_latency->set_p50_ms(histogram.second.Percentile(0.5));
+    stage_latency->set_p90_ms(histogram.second.Percentile(0.9));
+    stage_latency->set_p99_ms(histogram.second.Percentile(0.99));
+    stage_latency->set_max_ms(histogram.second.max());
+  }
+}
+
+bool LatencyProfiler::DumpChromeTrace(const std::string &file_path) {
+  std::map<TrackKey, std::deque<TraceFrame>> traces;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    traces = traces_;
+  }
+  std::ofstream fout(file_path);
+  if (!fout.is_open()) {
+    AERROR << "Failed to open " << file_path;
+    return false;
+  }
+  fout << std::fixed << std::setprecision(6) << "{\"traceEvents\":[";
+  int tid = 0;
+  bool first_event = true;
+  for (const auto &trace : traces) {
+    ++tid;
+    const std::string track =
+        EscapeJson(trace.first.first + " " + trace.first.second);
+    fout << (first_event ? "" : ",")
+         << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << tid << ",\"args\":{\"name\":\"" << track << "\"}}";
+    first_event = false;
+    for (const auto &frame : trace.second) {
+      for (const auto &event : frame.events) {
+        fout << ",\n{\"name\":\"" << EscapeJson(event.stage)
+             << "\",\"cat\":\"" << EscapeJson(trace.first.second)
+             << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+             << ",\"ts\":" << event.start_us
+             << ",\"dur\":" << event.end_us - event.start_us
+             << ",\"args\":{\"timestamp\":" << frame.timestamp << "}}";
+      }
+    }
+  }
+  fout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  fout.close();
+  if (!fout) {
+    AERROR << "Failed to write " << file_path;
+    return false;
+  }
+  AINFO << "Wrote the latency trace of " << traces.size() << " tracks to "
+        << file_path;
+  return true;
+}
+
+void LatencyProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  histograms_.clear();
+  traces_.clear();
+  summary_time_us_ = LatencyNowUs();
+}
+
+LatencyFrameScope::LatencyFrameScope(const std::string &name,
+                                     const std::string &sensor_name,
+                                     const double timestamp)
+    : name_(name),
+      sensor_name_(sensor_name),
+      timestamp_(timestamp),
+      enabled_(FLAGS_enable_perception_latency_profiler) {
+  if (!enabled_) {
+    return;
+  }
+  // the frame itself comes first
+  LatencyEvent event;
+  event.stage = name_;
+  event.start_us = LatencyNowUs();
+  events_.push_back(event);
+  parent_ = current_frame;
+  current_frame = this;
+}
+
+LatencyFrameScope::~LatencyFrameScope() {
+  if (!enabled_) {
+    return;
+  }
+  current_frame = parent_;
+  events_.front().end_us = LatencyNowUs();
+  LatencyProfiler::Instance()->AddFrame(name_, sensor_name_, timestamp_,
+                                        &events_);
+}
+
+LatencyFrameScope *LatencyFrameScope::Current() { return current_frame; }
+
+void LatencyFrameScope::AddStage(const std::string &stage,
+                                 const int64_t start_us,
+                                 const int64_t end_us) {
+  LatencyEvent event;
+  event.stage = stage;
+  event.start_us = start_us;
+  event.end_us = end_us;
+  events_.push_back(event);
+}
+
+void LatencyTimer::Start() { start_us_ = LatencyNowUs(); }
+
+void LatencyTimer::End(const std::string &stage) {
+  const int64_t end_us = LatencyNowUs();
+  LatencyFrameScope *frame = LatencyFrameScope::Current();
+  if (frame != nullptr) {
+    frame->AddStage(stage, start_us_, end_us);
+  }
+  start_us_ = end_us;
+}
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
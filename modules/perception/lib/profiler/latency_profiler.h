@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "modules/common/util/perf_util.h"
+#include "modules/perception/proto/perception_latency.pb.h"
+
+// How to Use:
+// 1) Open a LatencyFrameScope for the frame of a sensor at the entry of a
+//    pipeline, it is profiled as a whole under the name of the pipeline:
+//      bool LidarDetectionComponent::InternalProc(...) {
+//          lib::LatencyFrameScope frame_scope("lidar_detection",
+//                                             sensor_name_, timestamp);
+//          // process the frame
+//      }
+// 2) Use PERCEPTION_PERF_BLOCK_START/END_WITH_INDICATOR in place of
+//    PERF_BLOCK_START/END_WITH_INDICATOR, which they keep logging with, to
+//    profile the stages of the frame open on the calling thread:
+//      PERCEPTION_PERF_BLOCK_START();
+//      // do detection
+//      PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "detection");
+// LatencyProfiler then holds the latency histograms of each sensor and
+// stage, and the stages of the latest frames of each pipeline and sensor.
+namespace apollo {
+namespace perception {
+namespace lib {
+
+// @brief: durations in log scale buckets, 4 per octave from 0.01ms, so the
+//         percentiles are within 19% of the exact ones.
+class LatencyHistogram {
+ public:
+  void Add(double duration_ms);
+
+  size_t count() const { return count_; }
+  double mean() const { return count_ > 0 ? sum_ / count_ : 0.0; }
+  double max() const { return max_; }
+  // @brief: upper bound of the bucket of the p quantile, p in [0, 1].
+  double Percentile(double p) const;
+
+ private:
+  static constexpr int kBucketCount = 80;
+
+  std::array<size_t, kBucketCount> buckets_{};
+  size_t count_ = 0;
+  double sum_ = 0.0;
+  double max_ = 0.0;
+};
+
+struct LatencyEvent {
+  std::string stage;
+  // steady clock microseconds
+  int64_t start_us = 0;
+  int64_t end_us = 0;
+};
+
+class LatencyProfiler {
+ public:
+  ~LatencyProfiler() = default;
+
+  // @brief: add a profiled frame of sensor_name in the pipeline name, with
+  //         the frame itself as its first event.
+  void AddFrame(const std::string &name, const std::string &sensor_name,
+                double timestamp, std::vector<LatencyEvent> *events);
+
+  // @brief: summary of the stages of the frames added since the previous
+  //         summary, the header is left to the caller.
+  void Summarize(PerceptionLatencySummary *summary);
+
+  // @brief: write the kept frames as a Chrome trace (chrome://tracing or
+  //         Perfetto), one track per pipeline and sensor.
+  bool DumpChromeTrace(const std::string &file_path);
+
+  void Clear();
+
+ private:
+  struct TraceFrame {
+    double timestamp = 0.0;
+    std::vector<LatencyEvent> events;
+  };
+
+  // (sensor name, stage)
+  typedef std::pair<std::string, std::string> StageKey;
+  // (pipeline name, sensor name)
+  typedef std::pair<std::string, std::string> TrackKey;
+
+  std::mutex mutex_;
+  std::map<StageKey, LatencyHistogram> histograms_;
+  std::map<TrackKey, std::deque<TraceFrame>> traces_;
+  int64_t summary_time_us_ = 0;
+
+  DECLARE_SINGLETON(LatencyProfiler)
+};
+
+// @brief: profiles the frame of a sensor in a pipeline on the calling
+//         thread, from its construction to its destruction, along with the
+//         stages LatencyTimer ends meanwhile on the thread. Does nothing
+//         when FLAGS_enable_perception_latency_profiler is false.
+class LatencyFrameScope {
+ public:
+  LatencyFrameScope(const std::string &name, const std::string &sensor_name,
+                    double timestamp);
+  ~LatencyFrameScope();
+
+  // @brief: the frame profiled on the calling thread, nullptr if none.
+  static LatencyFrameScope *Current();
+
+  const std::string &sensor_name() const { return sensor_name_; }
+
+  void AddStage(const std::string &stage, int64_t start_us, int64_t end_us);
+
+ private:
+  std::string name_;
+  std::string sensor_name_;
+  double timestamp_ = 0.0;
+  bool enabled_ = false;
+  std::vector<LatencyEvent> events_;
+  LatencyFrameScope *parent_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyFrameScope);
+};
+
+// @brief: times the consecutive stages of the frame profiled on the calling
+//         thread.
+class LatencyTimer {
+ public:
+  LatencyTimer() { Start(); }
+
+  void Start();
+  // @brief: add the stage since the previous start or end to the frame and
+  //         start timing the next one.
+  void End(const std::string &stage);
+
+ private:
+  int64_t start_us_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyTimer);
+};
+
+// @brief: steady clock microseconds.
+int64_t LatencyNowUs();
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
+
+#define PERCEPTION_PERF_BLOCK_START() \
+  PERF_BLOCK_START();                 \
+  apollo::perception::lib::LatencyTimer _latency_timer_
+#define PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(indicator, msg) \
+  PERF_BLOCK_END_WITH_INDICATOR(indicator, msg);                 \
+  _latency_timer_.End(msg)
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lib/profiler/latency_profiler.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/common/perception_gflags.h"
+
+namespace apollo {
+namespace perception {
+namespace lib {
+
+TEST(LatencyProfilerTest, test_histogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_DOUBLE_EQ(histogram.Percentile(0.5), 0.0);
+  for (int i = 1; i <= 100; ++i) {
+    histogram.Add(static_cast<double>(i));
+  }
+  EXPECT_EQ(histogram.count(), 100);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+  EXPECT_DOUBLE_EQ(histogram.max(), 100.0);
+  // within a bucket of the exact percentiles
+  EXPECT_GE(histogram.Percentile(0.5), 50.0);
+  EXPECT_LE(histogram.Percentile(0.5), 50.0 * 1.19);
+  EXPECT_GE(histogram.Percentile(0.9), 90.0);
+  EXPECT_LE(histogram.Percentile(0.9), 90.0 * 1.19);
+  EXPECT_DOUBLE_EQ(histogram.Percentile(1.0), 100.0);
+  histogram.Add(0.0);
+  EXPECT_LE(histogram.Percentile(0.0), 0.01);
+}
+
+TEST(LatencyProfilerTest, test_frame_scope) {
+  const bool enabled = FLAGS_enable_perception_latency_profiler;
+  FLAGS_enable_perception_latency_profiler = true;
+  LatencyProfiler *profiler = LatencyProfiler::Instance();
+  profiler->Clear();
+  // stages out of a frame are not profiled
+  {
+    PERCEPTION_PERF_BLOCK_START();
+    PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR("front_6mm", "detect");
+  }
+  for (int i = 0; i < 3; ++i) {
+    LatencyFrameScope frame_scope("lidar_detection", "velodyne128",
+                                  0.1 * i);
+    EXPECT_EQ(LatencyFrameScope::Current(), &frame_scope);
+    PERCEPTION_PERF_BLOCK_START();
+    PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR("velodyne128", "preprocess");
+    {
+      LatencyFrameScope fusion_scope("fusion", "velodyne128", 0.1 * i);
+      EXPECT_EQ(LatencyFrameScope::Current(), &fusion_scope);
+    }
+    EXPECT_EQ(LatencyFrameScope::Current(), &frame_scope);
+    PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR("velodyne128", "detection");
+  }
+  EXPECT_EQ(LatencyFrameScope::Current(), nullptr);
+
+  PerceptionLatencySummary summary;
+  profiler->Summarize(&summary);
+  EXPECT_GT(summary.period(), 0.0);
+  ASSERT_EQ(summary.stage_latency_size(), 4);
+  // in (sensor name, stage) order
+  EXPECT_EQ(summary.stage_latency(0).stage(), "detection");
+  EXPECT_EQ(summary.stage_latency(1).stage(), "fusion");
+  EXPECT_EQ(summary.stage_latency(2).stage(), "lidar_detection");
+  EXPECT_EQ(summary.stage_latency(3).stage(), "preprocess");
+  for (const auto &stage_latency : summary.stage_latency()) {
+    EXPECT_EQ(stage_latency.sensor_name(), "velodyne128");
+    EXPECT_EQ(stage_latency.count(), 3);
+    EXPECT_LE(stage_latency.p50_ms(), stage_latency.max_ms());
+  }
+  // the histograms restart with each summary
+  profiler->Summarize(&summary);
+  EXPECT_EQ(summary.stage_latency_size(), 0);
+
+  FLAGS_enable_perception_latency_profiler = false;
+  {
+    LatencyFrameScope frame_scope("radar_detection", "radar_front", 0.0);
+    EXPECT_EQ(LatencyFrameScope::Current(), nullptr);
+  }
+  profiler->Summarize(&summary);
+  EXPECT_EQ(summary.stage_latency_size(), 0);
+  FLAGS_enable_perception_latency_profiler = enabled;
+}
+
+TEST(LatencyProfilerTest, test_chrome_trace) {
+  LatencyProfiler *profiler = LatencyProfiler::Instance();
+  profiler->Clear();
+  const bool enabled = FLAGS_enable_perception_latency_profiler;
+  FLAGS_enable_perception_latency_profiler = true;
+  const int trace_frames = FLAGS_perception_latency_trace_frames;
+  FLAGS_perception_latency_trace_frames = 2;
+  for (int i = 0; i < 3; ++i) {
+    LatencyFrameScope frame_scope("radar_detection", "radar_front",
+                                  static_cast<double>(i));
+    PERCEPTION_PERF_BLOCK_START();
+    PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR("radar_front", "tracker");
+  }
+  FLAGS_enable_perception_latency_profiler = enabled;
+  FLAGS_perception_latency_trace_frames = trace_frames;
+
+  const std::string file_path = "/tmp/latency_profiler_test_trace.json";
+  EXPECT_TRUE(profiler->DumpChromeTrace(file_path));
+  std::ifstream fin(file_path);
+  std::stringstream trace;
+  trace << fin.rdbuf();
+  const std::string content = trace.str();
+  EXPECT_EQ(content.find("{\"traceEvents\":["), 0);
+  EXPECT_NE(content.find("\"name\":\"radar_detection radar_front\""),
+            std::string::npos);
+  // only the latest 2 frames are kept
+  EXPECT_EQ(content.find("\"timestamp\":0.000000"), std::string::npos);
+  EXPECT_NE(content.find("\"timestamp\":1.000000"), std::string::npos);
+  EXPECT_NE(content.find("\"timestamp\":2.000000"), std::string::npos);
+  EXPECT_NE(content.find("\"name\":\"tracker\""), std::string::npos);
+
+  EXPECT_FALSE(profiler->DumpChromeTrace("/nonexistent/trace.json"));
+}
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lib/thread/parallel_for.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "google/protobuf/stubs/callback.h"
+
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/lib/thread/mutex.h"
+
+namespace apollo {
+namespace perception {
+namespace lib {
+
+using google::protobuf::NewCallback;
+
+namespace {
+
+struct ParallelChunk {
+  const std::function<void(size_t, size_t, size_t)>* func = nullptr;
+  size_t chunk = 0;
+  size_t begin = 0;
+  size_t end = 0;
+  BlockingCounter* counter = nullptr;
+};
+
+void RunChunk(ParallelChunk* chunk) {
+  (*chunk->func)(chunk->chunk, chunk->begin, chunk->end);
+  chunk->counter->Decrement();
+}
+
+}  // namespace
+
+ThreadPool* SharedThreadPool() {
+  static ThreadPool* thread_pool = [] {
+    ThreadPool* pool =
+        new ThreadPool(std::max(FLAGS_perception_thread_pool_size, 1));
+    pool->Start();
+    return pool;
+  }();
+  return thread_pool;
+}
+
+size_t NumParallelChunks(const size_t begin, const size_t end,
+                         const size_t num_chunks,
+                         const size_t min_chunk_size) {
+  if (begin >= end) {
+    return 0;
+  }
+  const size_t max_num_chunks =
+      (end - begin) / std::max<size_t>(min_chunk_size, 1);
+  return std::max<size_t>(1, std::min(num_chunks, max_num_chunks));
+}
+
+void ParallelFor(const size_t begin, const size_t end, const size_t num_chunks,
+                 const size_t min_chunk_size,
+                 const std::function<void(size_t, size_t, size_t)>& func) {
+  const size_t chunks =
+      NumParallelChunks(begin, end, num_chunks, min_chunk_size);
+  if (chunks == 0) {
+    return;
+  }
+  if (chunks == 1) {
+    func(0, begin, end);
+    return;
+  }
+
+  // the first size % chunks chunks take one more index
+  const size_t chunk_size = (end - begin) / chunks;
+  const size_t remainder = (end - begin) % chunks;
+  const auto chunk_begin = [&](const size_t i) {
+    return begin + i * chunk_size + std::min(i, remainder);
+  };
+
+  BlockingCounter counter(chunks - 1);
+  std::vector<ParallelChunk> tasks(chunks);
+  ThreadPool* thread_pool = SharedThreadPool();
+  for (size_t i = 1; i < chunks; ++i) {
+    ParallelChunk& task = tasks[i];
+    task.func = &func;
+    task.chunk = i;
+    task.begin = chunk_begin(i);
+    task.end = chunk_begin(i + 1);
+    task.counter = &counter;
+    thread_pool->Add(NewCallback(&RunChunk, &task));
+  }
+  func(0, chunk_begin(0), chunk_begin(1));
+  counter.Wait();
+}
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "modules/perception/lib/thread/thread_pool.h"
+
+namespace apollo {
+namespace perception {
+namespace lib {
+
+// @brief: the thread pool shared by the perception stages, started on first
+//         use with FLAGS_perception_thread_pool_size workers.
+ThreadPool* SharedThreadPool();
+
+// @brief: split [begin, end) into at most num_chunks contiguous chunks of at
+//         least min_chunk_size indices, and call func(chunk, chunk_begin,
+//         chunk_end) on each of them. The chunks are numbered in index
+//         order, so outputs kept per chunk and merged by chunk number do not
+//         depend on num_chunks. The first chunk runs on the calling thread
+//         and the others on SharedThreadPool(). Returns once every chunk is
+//         done.
+void ParallelFor(const size_t begin, const size_t end, const size_t num_chunks,
+                 const size_t min_chunk_size,
+                 const std::function<void(size_t, size_t, size_t)>& func);
+
+// @brief: the number of chunks ParallelFor splits [begin, end) into.
+size_t NumParallelChunks(const size_t begin, const size_t end,
+                         const size_t num_chunks, const size_t min_chunk_size);
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lib/thread/parallel_for.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lib {
+
+TEST(ParallelForTest, NumParallelChunks) {
+  EXPECT_EQ(NumParallelChunks(0, 0, 4, 1), 0u);
+  EXPECT_EQ(NumParallelChunks(5, 3, 4, 1), 0u);
+  EXPECT_EQ(NumParallelChunks(0, 10, 4, 1), 4u);
+  EXPECT_EQ(NumParallelChunks(0, 10, 4, 4), 2u);
+  EXPECT_EQ(NumParallelChunks(0, 10, 4, 100), 1u);
+  EXPECT_EQ(NumParallelChunks(0, 10, 0, 1), 1u);
+}
+
+TEST(ParallelForTest, ChunksCoverRange) {
+  for (size_t num_chunks = 1; num_chunks <= 8; ++num_chunks) {
+    const size_t begin = 3;
+    const size_t end = 1003;
+    std::vector<int> visits(end, 0);
+    std::vector<size_t> chunk_begins(num_chunks, end);
+    std::vector<size_t> chunk_ends(num_chunks, end);
+    ParallelFor(begin, end, num_chunks, 1,
+                [&](size_t chunk, size_t chunk_begin, size_t chunk_end) {
+                  chunk_begins[chunk] = chunk_begin;
+                  chunk_ends[chunk] = chunk_end;
+                  for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                    ++visits[i];
+                  }
+                });
+    for (size_t i = 0; i < end; ++i) {
+      EXPECT_EQ(visits[i], i < begin ? 0 : 1);
+    }
+    // the chunks are numbered in index order
+    EXPECT_EQ(chunk_begins.front(), begin);
+    EXPECT_EQ(chunk_ends.back(), end);
+    for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+      EXPECT_EQ(chunk_begins[chunk], chunk_ends[chunk - 1]);
+    }
+  }
+}
+
+TEST(ParallelForTest, DeterministicMerge) {
+  const size_t size = 100000;
+  std::vector<int> expected;
+  for (size_t i = 0; i < size; ++i) {
+    if (i % 7 == 3) {
+      expected.push_back(static_cast<int>(i));
+    }
+  }
+  for (size_t num_chunks = 1; num_chunks <= 8; ++num_chunks) {
+    std::vector<std::vector<int>> chunk_indices(num_chunks);
+    ParallelFor(0, size, num_chunks, 1000,
+                [&](size_t chunk, size_t chunk_begin, size_t chunk_end) {
+                  for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                    if (i % 7 == 3) {
+                      chunk_indices[chunk].push_back(static_cast<int>(i));
+                    }
+                  }
+                });
+    std::vector<int> indices;
+    for (const auto& chunk : chunk_indices) {
+      indices.insert(indices.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(indices, expected);
+  }
+}
+
+}  // namespace lib
+}  // namespace perception
+}  // namespace apollo
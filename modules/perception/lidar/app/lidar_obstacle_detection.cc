@@ -18,6 +18,7 @@
 #include "cyber/common/file.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/lidar/app/proto/lidar_obstacle_detection_config.pb.h"
 #include "modules/perception/lidar/common/lidar_log.h"
 #include "modules/perception/lidar/lib/scene_manager/scene_manager.h"
@@ -132,11 +133,11 @@ LidarProcessResult LidarObstacleDetection::Process(
 
   PERF_FUNCTION_WITH_INDICATOR(options.sensor_name);
 
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   PointCloudPreprocessorOptions preprocessor_options;
   preprocessor_options.sensor2novatel_extrinsics =
       options.sensor2novatel_extrinsics;
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "preprocess");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "preprocess");
   if (cloud_preprocessor_->Preprocess(preprocessor_options, message, frame)) {
     return ProcessCommon(options, frame);
   }
@@ -148,7 +149,7 @@ LidarProcessResult LidarObstacleDetection::ProcessCommon(
     const LidarObstacleDetectionOptions& options, LidarFrame* frame) {
   const auto& sensor_name = options.sensor_name;
 
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   if (use_map_manager_) {
     MapManagerOptions map_manager_options;
     if (!map_manager_.Update(map_manager_options, frame)) {
@@ -156,14 +157,14 @@ LidarProcessResult LidarObstacleDetection::ProcessCommon(
                                 "Failed to update map structure.");
     }
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "map_manager");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "map_manager");
 
   LidarDetectorOptions detection_options;
   if (!detector_->Detect(detection_options, frame)) {
     return LidarProcessResult(LidarErrorCode::DetectionError,
                               "Failed to detect.");
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "detection");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "detection");
 
   if (use_object_builder_) {
     ObjectBuilderOptions builder_options;
@@ -172,7 +173,7 @@ LidarProcessResult LidarObstacleDetection::ProcessCommon(
                                 "Failed to build objects.");
     }
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "object_builder");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "object_builder");
 
   if (use_object_filter_bank_) {
     ObjectFilterOptions filter_options;
@@ -181,7 +182,7 @@ LidarProcessResult LidarObstacleDetection::ProcessCommon(
                                 "Failed to filter objects.");
     }
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "filter_bank");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "filter_bank");
 
   return LidarProcessResult(LidarErrorCode::Succeed);
 }
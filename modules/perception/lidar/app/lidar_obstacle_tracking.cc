@@ -18,6 +18,7 @@
 #include "cyber/common/file.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/lidar/app/proto/lidar_obstacle_tracking_config.pb.h"
 #include "modules/perception/lidar/common/lidar_log.h"
 
@@ -80,20 +81,20 @@ LidarProcessResult LidarObstacleTracking::Process(
 
   PERF_FUNCTION_WITH_INDICATOR(sensor_name);
 
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   MultiTargetTrackerOptions tracker_options;
   if (!multi_target_tracker_->Track(tracker_options, frame)) {
     return LidarProcessResult(LidarErrorCode::TrackerError,
                               "Fail to track objects.");
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "tracker");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "tracker");
 
   ClassifierOptions fusion_classifier_options;
   if (!fusion_classifier_->Classify(fusion_classifier_options, frame)) {
     return LidarProcessResult(LidarErrorCode::ClassifierError,
                               "Fail to fuse object types.");
   }
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "type_fusion");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "type_fusion");
 
   return LidarProcessResult(LidarErrorCode::Succeed);
 }
@@ -0,0 +1,274 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Per-stage latency of the CPU lidar stages on the frames of
+// lidar_app_lidar_pipeline_test: PointCloudPreprocessor, HdmapROIFilter,
+// SpatioTemporalGroundDetector and ObjectBuilder, with the num_threads of
+// each stage set to the argument. The road polygons are a crossroads around
+// the vehicle and the objects are the non ground roi points binned on a 2m
+// grid, standing in for the map and the detector. The counters report the
+// time and the heap allocations, the operator new calls, of each stage in a
+// frame. Run with
+// bazel run -c opt //modules/perception/lidar/app:lidar_pipeline_benchmark
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/base/object_pool_types.h"
+#include "modules/perception/lidar/common/lidar_frame.h"
+#include "modules/perception/lidar/common/pcl_util.h"
+#include "modules/perception/lidar/lib/ground_detector/spatio_temporal_ground_detector/spatio_temporal_ground_detector.h"
+#include "modules/perception/lidar/lib/object_builder/object_builder.h"
+#include "modules/perception/lidar/lib/pointcloud_preprocessor/pointcloud_preprocessor.h"
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
+
+namespace {
+std::atomic<size_t> num_allocations(0);
+}  // namespace
+
+void* operator new(size_t size) {
+  ++num_allocations;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+const char kDataPath[] =
+    "/apollo/modules/perception/testdata/lidar/app/data/";
+const char* const kFrameNames[] = {"0001_00", "0002_00"};
+constexpr double kObjectCellSize = 2.0;
+constexpr size_t kMinObjectPoints = 10;
+
+struct LidarStages {
+  PointCloudPreprocessor preprocessor;
+  HdmapROIFilter roi_filter;
+  SpatioTemporalGroundDetector ground_detector;
+  ObjectBuilder object_builder;
+};
+
+bool InitStages(const uint32_t num_threads, LidarStages* stages) {
+  pipeline::StageConfig preprocessor_config;
+  preprocessor_config.set_stage_type(pipeline::POINTCLOUD_PREPROCESSOR);
+  auto* pointcloud_preprocessor_config =
+      preprocessor_config.mutable_pointcloud_preprocessor_config();
+  pointcloud_preprocessor_config->set_filter_nearby_box_points(true);
+  pointcloud_preprocessor_config->set_box_forward_x(2.5f);
+  pointcloud_preprocessor_config->set_box_backward_x(-2.5f);
+  pointcloud_preprocessor_config->set_box_forward_y(1.2f);
+  pointcloud_preprocessor_config->set_box_backward_y(-1.2f);
+  pointcloud_preprocessor_config->set_num_threads(num_threads);
+
+  pipeline::StageConfig roi_filter_config;
+  roi_filter_config.mutable_hdmap_roi_filter_config()->set_num_threads(
+      num_threads);
+
+  pipeline::StageConfig ground_detector_config;
+  auto* spatio_temporal_ground_detector_config =
+      ground_detector_config.mutable_spatio_temporal_ground_detector_config();
+  spatio_temporal_ground_detector_config->set_use_ground_service(false);
+  spatio_temporal_ground_detector_config->set_num_threads(num_threads);
+
+  pipeline::StageConfig object_builder_config;
+  object_builder_config.set_stage_type(pipeline::OBJECT_BUILDER);
+  object_builder_config.mutable_object_builder_config()->set_num_threads(
+      num_threads);
+
+  return stages->preprocessor.Init(preprocessor_config) &&
+         stages->roi_filter.Init(roi_filter_config) &&
+         stages->ground_detector.Init(ground_detector_config) &&
+         stages->object_builder.Init(object_builder_config);
+}
+
+base::PolygonDType MakeRectangle(const double min_x, const double max_x,
+                                 const double min_y, const double max_y) {
+  base::PolygonDType polygon;
+  base::PointD point;
+  point.x = min_x;
+  point.y = min_y;
+  polygon.push_back(point);
+  point.x = max_x;
+  polygon.push_back(point);
+  point.y = max_y;
+  polygon.push_back(point);
+  point.x = min_x;
+  polygon.push_back(point);
+  return polygon;
+}
+
+std::shared_ptr<base::HdmapStruct> MakeCrossroads() {
+  auto hdmap_struct = std::make_shared<base::HdmapStruct>();
+  hdmap_struct->road_polygons.push_back(
+      MakeRectangle(-100.0, -12.0, -8.0, 8.0));
+  hdmap_struct->road_polygons.push_back(MakeRectangle(12.0, 100.0, -8.0, 8.0));
+  hdmap_struct->road_polygons.push_back(
+      MakeRectangle(-8.0, 8.0, -100.0, -12.0));
+  hdmap_struct->road_polygons.push_back(MakeRectangle(-8.0, 8.0, 12.0, 100.0));
+  hdmap_struct->junction_polygons.push_back(
+      MakeRectangle(-12.0, 12.0, -12.0, 12.0));
+  return hdmap_struct;
+}
+
+// the non ground roi points of the frame binned on a grid
+std::vector<std::shared_ptr<base::Object>> MakeObjects(
+    const LidarFrame& frame) {
+  std::map<std::pair<int, int>, base::PointFCloud> cells;
+  for (const int index : frame.non_ground_indices.indices) {
+    const auto& point = frame.cloud->at(index);
+    const auto cell =
+        std::make_pair(static_cast<int>(std::floor(point.x / kObjectCellSize)),
+                       static_cast<int>(std::floor(point.y / kObjectCellSize)));
+    cells[cell].push_back(point, frame.cloud->points_timestamp(index));
+  }
+  std::vector<std::shared_ptr<base::Object>> objects;
+  for (auto& cell : cells) {
+    if (cell.second.size() < kMinObjectPoints) {
+      continue;
+    }
+    auto object = std::make_shared<base::Object>();
+    object->lidar_supplement.cloud.SwapPointCloud(&cell.second);
+    objects.push_back(std::move(object));
+  }
+  return objects;
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point& start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+void BM_LidarStages(benchmark::State& state) {
+  std::vector<base::PointFCloud> clouds;
+  for (const char* frame_name : kFrameNames) {
+    base::PointFCloud cloud;
+    if (!LoadPCLPCD(std::string(kDataPath) + frame_name + ".pcd", &cloud)) {
+      state.SkipWithError("failed to load the lidar app test frames");
+      return;
+    }
+    clouds.push_back(std::move(cloud));
+  }
+  LidarStages stages;
+  if (!InitStages(static_cast<uint32_t>(state.range(0)), &stages)) {
+    state.SkipWithError("failed to init the lidar stages");
+    return;
+  }
+  const auto hdmap_struct = MakeCrossroads();
+  PointCloudPreprocessorOptions preprocessor_options;
+  preprocessor_options.sensor2novatel_extrinsics = Eigen::Affine3d::Identity();
+
+  // the objects of each frame, from a single threaded pass
+  std::vector<std::vector<std::shared_ptr<base::Object>>> frame_objects;
+  for (const auto& cloud : clouds) {
+    LidarFrame frame;
+    frame.cloud = std::make_shared<base::PointFCloud>(cloud);
+    frame.lidar2world_pose = Eigen::Affine3d::Identity();
+    frame.hdmap_struct = hdmap_struct;
+    stages.preprocessor.Preprocess(preprocessor_options, &frame);
+    stages.roi_filter.Filter(ROIFilterOptions(), &frame);
+    stages.ground_detector.Detect(GroundDetectorOptions(), &frame);
+    frame_objects.push_back(MakeObjects(frame));
+  }
+
+  std::vector<double> stage_times(4, 0.0);
+  std::vector<size_t> stage_allocations(4, 0);
+  auto& object_pool = base::ObjectPool::Instance();
+  const size_t num_object_allocs = object_pool.num_allocs();
+  size_t frame_id = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const size_t id = frame_id++ % clouds.size();
+    LidarFrame frame;
+    frame.cloud = std::make_shared<base::PointFCloud>(clouds[id]);
+    frame.lidar2world_pose = Eigen::Affine3d::Identity();
+    frame.hdmap_struct = hdmap_struct;
+    state.ResumeTiming();
+
+    size_t allocations = num_allocations;
+    auto start_time = std::chrono::steady_clock::now();
+    stages.preprocessor.Preprocess(preprocessor_options, &frame);
+    stage_times[0] += ElapsedMicroseconds(start_time);
+    stage_allocations[0] += num_allocations - allocations;
+    allocations = num_allocations;
+    start_time = std::chrono::steady_clock::now();
+    stages.roi_filter.Filter(ROIFilterOptions(), &frame);
+    stage_times[1] += ElapsedMicroseconds(start_time);
+    stage_allocations[1] += num_allocations - allocations;
+    allocations = num_allocations;
+    start_time = std::chrono::steady_clock::now();
+    stages.ground_detector.Detect(GroundDetectorOptions(), &frame);
+    stage_times[2] += ElapsedMicroseconds(start_time);
+    stage_allocations[2] += num_allocations - allocations;
+
+    state.PauseTiming();
+    // pooled as the segmented objects of the detectors
+    for (const auto& object : frame_objects[id]) {
+      auto segmented_object = object_pool.Get();
+      *segmented_object = *object;
+      frame.segmented_objects.push_back(segmented_object);
+    }
+    state.ResumeTiming();
+    allocations = num_allocations;
+    start_time = std::chrono::steady_clock::now();
+    stages.object_builder.Build(ObjectBuilderOptions(), &frame);
+    stage_times[3] += ElapsedMicroseconds(start_time);
+    stage_allocations[3] += num_allocations - allocations;
+  }
+  const double num_frames = static_cast<double>(state.iterations());
+  state.counters["preprocessor_us"] = stage_times[0] / num_frames;
+  state.counters["roi_filter_us"] = stage_times[1] / num_frames;
+  state.counters["ground_detector_us"] = stage_times[2] / num_frames;
+  state.counters["object_builder_us"] = stage_times[3] / num_frames;
+  state.counters["preprocessor_allocs"] =
+      static_cast<double>(stage_allocations[0]) / num_frames;
+  state.counters["roi_filter_allocs"] =
+      static_cast<double>(stage_allocations[1]) / num_frames;
+  state.counters["ground_detector_allocs"] =
+      static_cast<double>(stage_allocations[2]) / num_frames;
+  state.counters["object_builder_allocs"] =
+      static_cast<double>(stage_allocations[3]) / num_frames;
+  state.counters["object_pool_allocs"] =
+      static_cast<double>(object_pool.num_allocs() - num_object_allocs) /
+      num_frames;
+  state.counters["objects"] = static_cast<double>(frame_objects[0].size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_LidarStages)->DenseRange(1, 8)->Unit(benchmark::kMillisecond);
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -72,6 +72,7 @@ struct LidarFrame {
     timestamp = 0.0;
     lidar2world_pose = Eigen::Affine3d::Identity();
     novatel2world_pose = Eigen::Affine3d::Identity();
+    lidar2novatel_extrinsics = Eigen::Affine3d::Identity();
     if (hdmap_struct) {
       hdmap_struct->road_boundary.clear();
       hdmap_struct->road_polygons.clear();
@@ -83,6 +84,8 @@ struct LidarFrame {
     roi_indices.indices.clear();
     non_ground_indices.indices.clear();
     secondary_indices.indices.clear();
+    sensor_info.Reset();
+    reserve.clear();
   }
 
   void FilterPointCloud(base::PointCloud<base::PointF> *filtered_cloud,
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar/common/lidar_frame.h"
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/lidar/common/lidar_frame_pool.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+// a frame recycled by LidarFramePool is the same as a fresh one
+TEST(LidarFrameTest, lidar_frame_reset_test) {
+  LidarFrame frame;
+  frame.cloud = base::PointFCloudPool::Instance().Get();
+  frame.cloud->push_back(base::PointF());
+  frame.world_cloud = base::PointDCloudPool::Instance().Get();
+  frame.world_cloud->push_back(base::PointD());
+  frame.timestamp = 1.0;
+  const Eigen::Affine3d pose(Eigen::Translation3d(1.0, 2.0, 3.0));
+  frame.lidar2world_pose = pose;
+  frame.novatel2world_pose = pose;
+  frame.lidar2novatel_extrinsics = pose;
+  frame.hdmap_struct.reset(new base::HdmapStruct);
+  frame.hdmap_struct->road_boundary.resize(1);
+  frame.hdmap_struct->road_polygons.resize(1);
+  frame.hdmap_struct->junction_polygons.resize(1);
+  frame.hdmap_struct->hole_polygons.resize(1);
+  frame.segmented_objects.push_back(base::ObjectPool::Instance().Get());
+  frame.tracked_objects.push_back(base::ObjectPool::Instance().Get());
+  frame.roi_indices.indices.push_back(0);
+  frame.non_ground_indices.indices.push_back(0);
+  frame.secondary_indices.indices.push_back(0);
+  frame.sensor_info.name = "velodyne64";
+  frame.sensor_info.type = base::SensorType::VELODYNE_64;
+  frame.sensor_info.orientation = base::SensorOrientation::LEFT;
+  frame.sensor_info.frame_id = "velodyne64";
+  frame.reserve = "reserve";
+
+  LidarFrameInitializer()(&frame);
+  const LidarFrame fresh_frame;
+  EXPECT_TRUE(frame.cloud->empty());
+  EXPECT_TRUE(frame.world_cloud->empty());
+  EXPECT_EQ(fresh_frame.timestamp, frame.timestamp);
+  EXPECT_TRUE(fresh_frame.lidar2world_pose.isApprox(frame.lidar2world_pose));
+  EXPECT_TRUE(
+      fresh_frame.novatel2world_pose.isApprox(frame.novatel2world_pose));
+  EXPECT_TRUE(fresh_frame.lidar2novatel_extrinsics.isApprox(
+      frame.lidar2novatel_extrinsics));
+  EXPECT_TRUE(frame.hdmap_struct->road_boundary.empty());
+  EXPECT_TRUE(frame.hdmap_struct->road_polygons.empty());
+  EXPECT_TRUE(frame.hdmap_struct->junction_polygons.empty());
+  EXPECT_TRUE(frame.hdmap_struct->hole_polygons.empty());
+  EXPECT_TRUE(frame.segmented_objects.empty());
+  EXPECT_TRUE(frame.tracked_objects.empty());
+  EXPECT_TRUE(frame.roi_indices.indices.empty());
+  EXPECT_TRUE(frame.non_ground_indices.indices.empty());
+  EXPECT_TRUE(frame.secondary_indices.indices.empty());
+  EXPECT_EQ(fresh_frame.sensor_info.name, frame.sensor_info.name);
+  EXPECT_EQ(fresh_frame.sensor_info.type, frame.sensor_info.type);
+  EXPECT_EQ(fresh_frame.sensor_info.orientation,
+            frame.sensor_info.orientation);
+  EXPECT_EQ(fresh_frame.sensor_info.frame_id, frame.sensor_info.frame_id);
+  EXPECT_EQ(fresh_frame.reserve, frame.reserve);
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
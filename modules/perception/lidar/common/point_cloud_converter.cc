@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar/common/point_cloud_converter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+namespace {
+// float32 fields of a packed point: x, y, z, intensity and time
+constexpr size_t kPackedPointFields = 5;
+constexpr size_t kPackedPointBytes = kPackedPointFields * sizeof(float);
+// number of packed points copied at once into an aligned buffer
+constexpr size_t kPackedBlockSize = 256;
+}  // namespace
+
+void ConvertPointCloud(const drivers::PointCloud& message,
+                       base::PointFCloud* cloud) {
+  const std::string& packed_point = message.packed_point();
+  const size_t num_points = packed_point.empty()
+                                ? static_cast<size_t>(message.point_size())
+                                : packed_point.size() / kPackedPointBytes;
+  cloud->clear();
+  cloud->set_timestamp(message.measurement_time());
+  // sized once, the height and label keep the defaults of resize()
+  cloud->resize(num_points);
+  if (num_points == 0) {
+    return;
+  }
+  double* timestamps = cloud->mutable_points_timestamp()->data();
+  std::vector<int32_t>* beam_ids = cloud->mutable_points_beam_id();
+  std::iota(beam_ids->begin(), beam_ids->end(), 0);
+
+  if (packed_point.empty()) {
+    for (size_t i = 0; i < num_points; ++i) {
+      const drivers::PointXYZIT& pt = message.point(static_cast<int>(i));
+      base::PointF& point = cloud->at(i);
+      point.x = pt.x();
+      point.y = pt.y();
+      point.z = pt.z();
+      point.intensity = static_cast<float>(pt.intensity());
+      timestamps[i] = static_cast<double>(pt.timestamp()) * 1e-9;
+    }
+    return;
+  }
+
+  // The bytes of the message carry no alignment guarantee, so the records
+  // are copied block by block into an aligned buffer and deinterleaved from
+  // there in a loop the compiler can vectorize.
+  const double base_time =
+      static_cast<double>(message.packed_base_timestamp()) * 1e-9;
+  float block[kPackedBlockSize * kPackedPointFields];
+  for (size_t begin = 0; begin < num_points; begin += kPackedBlockSize) {
+    const size_t block_size = std::min(kPackedBlockSize, num_points - begin);
+    std::memcpy(block, packed_point.data() + begin * kPackedPointBytes,
+                block_size * kPackedPointBytes);
+    base::PointF* points = &cloud->at(begin);
+    for (size_t i = 0; i < block_size; ++i) {
+      const float* record = block + i * kPackedPointFields;
+      points[i].x = record[0];
+      points[i].y = record[1];
+      points[i].z = record[2];
+      points[i].intensity = record[3];
+      timestamps[begin + i] = base_time + static_cast<double>(record[4]);
+    }
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
+#include "modules/perception/base/point_cloud.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+// @brief: convert a driver point cloud message, in bulk from the fixed
+//         stride records of packed_point when it is set, otherwise from the
+//         repeated points. The index of each point in the message is kept as
+//         its beam id, like the per point conversions did.
+// @param [in]: message
+// @param [out]: cloud, replaced by the points of the message
+void ConvertPointCloud(const drivers::PointCloud& message,
+                       base::PointFCloud* cloud);
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
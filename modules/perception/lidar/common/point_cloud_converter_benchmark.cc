@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Conversion time of a lidar sweep from the driver message into
+// base::PointFCloud: the former per point push_back, and ConvertPointCloud on
+// the repeated points and on the packed points. BM_ParseAndConvertPointCloud
+// adds the deserialization of the message the component receives. The first
+// argument is the number of points of the sweep. Run with
+// bazel run -c opt //modules/perception/lidar/common:point_cloud_converter_benchmark
+#include <limits>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/lidar/common/point_cloud_converter.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+constexpr uint64_t kSweepStartTimestamp = 1600000000000000000ULL;
+// 10Hz sweep
+constexpr uint64_t kSweepDuration = 100000000ULL;
+
+drivers::PointCloud MakeSweep(const int num_points, const bool packed) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> coordinate(-80.0f, 80.0f);
+  std::uniform_real_distribution<float> height(-2.0f, 4.0f);
+  drivers::PointCloud message;
+  message.set_measurement_time(static_cast<double>(kSweepStartTimestamp) *
+                               1e-9);
+  message.set_packed_base_timestamp(kSweepStartTimestamp);
+  std::string* bytes = message.mutable_packed_point();
+  for (int i = 0; i < num_points; ++i) {
+    const float x = coordinate(rng);
+    const float y = coordinate(rng);
+    const float z = height(rng);
+    const uint32_t intensity = static_cast<uint32_t>(i % 256);
+    const uint64_t time_diff = kSweepDuration * i / num_points;
+    if (packed) {
+      const float record[5] = {x, y, z, static_cast<float>(intensity),
+                               static_cast<float>(time_diff * 1e-9)};
+      bytes->append(reinterpret_cast<const char*>(record), sizeof(record));
+      continue;
+    }
+    auto* point = message.add_point();
+    point->set_x(x);
+    point->set_y(y);
+    point->set_z(z);
+    point->set_intensity(intensity);
+    point->set_timestamp(kSweepStartTimestamp + time_diff);
+  }
+  return message;
+}
+
+void BM_ConvertPerPoint(benchmark::State& state) {
+  const drivers::PointCloud message =
+      MakeSweep(static_cast<int>(state.range(0)), false);
+  base::PointFCloud cloud;
+  for (auto _ : state) {
+    cloud.clear();
+    cloud.set_timestamp(message.measurement_time());
+    cloud.reserve(message.point_size());
+    base::PointF point;
+    for (int i = 0; i < message.point_size(); ++i) {
+      const drivers::PointXYZIT& pt = message.point(i);
+      point.x = pt.x();
+      point.y = pt.y();
+      point.z = pt.z();
+      point.intensity = static_cast<float>(pt.intensity());
+      cloud.push_back(point, static_cast<double>(pt.timestamp()) * 1e-9,
+                      std::numeric_limits<float>::max(), i, 0);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["message_bytes"] = message.ByteSizeLong();
+}
+
+void BM_ConvertPointCloud(benchmark::State& state) {
+  const bool packed = state.range(1) != 0;
+  const drivers::PointCloud message =
+      MakeSweep(static_cast<int>(state.range(0)), packed);
+  base::PointFCloud cloud;
+  for (auto _ : state) {
+    ConvertPointCloud(message, &cloud);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["message_bytes"] = message.ByteSizeLong();
+}
+
+void BM_ParseAndConvertPointCloud(benchmark::State& state) {
+  const bool packed = state.range(1) != 0;
+  std::string serialized;
+  MakeSweep(static_cast<int>(state.range(0)), packed)
+      .SerializeToString(&serialized);
+  drivers::PointCloud message;
+  base::PointFCloud cloud;
+  for (auto _ : state) {
+    message.ParseFromString(serialized);
+    ConvertPointCloud(message, &cloud);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_ConvertPerPoint)
+    ->Arg(120000)
+    ->Arg(240000)
+    ->Unit(benchmark::kMicrosecond);
+// the second argument is 1 for the packed points
+BENCHMARK(BM_ConvertPointCloud)
+    ->Args({120000, 0})
+    ->Args({120000, 1})
+    ->Args({240000, 0})
+    ->Args({240000, 1})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParseAndConvertPointCloud)
+    ->Args({240000, 0})
+    ->Args({240000, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
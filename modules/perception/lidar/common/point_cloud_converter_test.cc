@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar/common/point_cloud_converter.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+namespace {
+
+drivers::PointCloud MakeMessage(const int num_points) {
+  drivers::PointCloud message;
+  message.set_measurement_time(1600000000.5);
+  for (int i = 0; i < num_points; ++i) {
+    auto* point = message.add_point();
+    point->set_x(0.5f * static_cast<float>(i));
+    point->set_y(-0.25f * static_cast<float>(i));
+    point->set_z(0.01f * static_cast<float>(i % 50));
+    point->set_intensity(static_cast<uint32_t>(i % 256));
+    point->set_timestamp(1600000000400000000ULL + 1000ULL * i);
+  }
+  return message;
+}
+
+// the same points as little endian float32 {x, y, z, intensity, time}
+// records relative to the first point
+drivers::PointCloud PackMessage(const drivers::PointCloud& message) {
+  drivers::PointCloud packed;
+  packed.set_measurement_time(message.measurement_time());
+  const uint64_t base_timestamp = message.point(0).timestamp();
+  packed.set_packed_base_timestamp(base_timestamp);
+  std::string* bytes = packed.mutable_packed_point();
+  for (const auto& point : message.point()) {
+    const float record[5] = {
+        point.x(), point.y(), point.z(),
+        static_cast<float>(point.intensity()),
+        static_cast<float>(
+            static_cast<double>(point.timestamp() - base_timestamp) * 1e-9)};
+    bytes->append(reinterpret_cast<const char*>(record), sizeof(record));
+  }
+  return packed;
+}
+
+}  // namespace
+
+TEST(PointCloudConverterTest, convert_points) {
+  const drivers::PointCloud message = MakeMessage(1000);
+  base::PointFCloud cloud;
+  ConvertPointCloud(message, &cloud);
+  ASSERT_EQ(cloud.size(), 1000);
+  EXPECT_TRUE(cloud.CheckConsistency());
+  EXPECT_DOUBLE_EQ(cloud.get_timestamp(), 1600000000.5);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const auto& pt = message.point(static_cast<int>(i));
+    EXPECT_FLOAT_EQ(cloud[i].x, pt.x());
+    EXPECT_FLOAT_EQ(cloud[i].y, pt.y());
+    EXPECT_FLOAT_EQ(cloud[i].z, pt.z());
+    EXPECT_FLOAT_EQ(cloud[i].intensity, static_cast<float>(pt.intensity()));
+    EXPECT_DOUBLE_EQ(cloud.points_timestamp(i),
+                     static_cast<double>(pt.timestamp()) * 1e-9);
+    EXPECT_EQ(cloud.points_beam_id(i), static_cast<int32_t>(i));
+    EXPECT_EQ(cloud.points_height(i), std::numeric_limits<float>::max());
+    EXPECT_EQ(cloud.points_label(i), 0);
+  }
+}
+
+TEST(PointCloudConverterTest, convert_packed_points) {
+  const drivers::PointCloud message = MakeMessage(1000);
+  const drivers::PointCloud packed = PackMessage(message);
+  base::PointFCloud expected_cloud;
+  ConvertPointCloud(message, &expected_cloud);
+
+  // stale points of a reused cloud are replaced
+  base::PointFCloud cloud;
+  cloud.push_back(base::PointF(), 1.0, 2.0f, 7, 3);
+  ConvertPointCloud(packed, &cloud);
+  ASSERT_EQ(cloud.size(), expected_cloud.size());
+  EXPECT_TRUE(cloud.CheckConsistency());
+  EXPECT_DOUBLE_EQ(cloud.get_timestamp(), 1600000000.5);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    EXPECT_FLOAT_EQ(cloud[i].x, expected_cloud[i].x);
+    EXPECT_FLOAT_EQ(cloud[i].y, expected_cloud[i].y);
+    EXPECT_FLOAT_EQ(cloud[i].z, expected_cloud[i].z);
+    EXPECT_FLOAT_EQ(cloud[i].intensity, expected_cloud[i].intensity);
+    EXPECT_NEAR(cloud.points_timestamp(i), expected_cloud.points_timestamp(i),
+                1e-6);
+    EXPECT_EQ(cloud.points_beam_id(i), static_cast<int32_t>(i));
+    EXPECT_EQ(cloud.points_height(i), std::numeric_limits<float>::max());
+    EXPECT_EQ(cloud.points_label(i), 0);
+  }
+}
+
+TEST(PointCloudConverterTest, convert_empty) {
+  base::PointFCloud cloud;
+  cloud.push_back(base::PointF());
+  ConvertPointCloud(drivers::PointCloud(), &cloud);
+  EXPECT_TRUE(cloud.empty());
+  EXPECT_TRUE(cloud.CheckConsistency());
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -15,12 +15,16 @@
  *****************************************************************************/
 #include "modules/perception/lidar/lib/detector/cnn_segmentation/cnn_segmentation.h"
 
+#include <cstring>
 #include <map>
+#include <utility>
 
 #include "cyber/common/file.h"
 #include "cyber/common/log.h"
 #include "modules/common/adapters/adapter_gflags.h"
 #include "modules/perception/base/object_pool_types.h"
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/inference/batch_inference_server.h"
 #include "modules/perception/inference/inference_factory.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
 #include "modules/perception/lidar/common/lidar_point_label.h"
@@ -100,27 +104,32 @@ bool CNNSegmentation::Init(const LidarDetectorInitOptions& options) {
   if (!feature_param.use_constant_feature()) {
     input_shape[1] -= 2;
   }
-  ACHECK(inference_->Init(input_shapes)) << "Failed to init inference.";
-
-  // init blobs
-  instance_pt_blob_ = inference_->get_blob(network_param.instance_pt_blob());
-  CHECK_NOTNULL(instance_pt_blob_.get());
-  category_pt_blob_ = inference_->get_blob(network_param.category_pt_blob());
-  CHECK_NOTNULL(category_pt_blob_.get());
-  confidence_pt_blob_ =
-      inference_->get_blob(network_param.confidence_pt_blob());
-  CHECK_NOTNULL(confidence_pt_blob_.get());
-  height_pt_blob_ = inference_->get_blob(network_param.height_pt_blob());
-  CHECK_NOTNULL(height_pt_blob_.get());
-  feature_blob_ = inference_->get_blob(network_param.feature_blob());
-  CHECK_NOTNULL(feature_blob_.get());
-  if (cnnseg_param_.do_classification()) {
-    classify_pt_blob_ = inference_->get_blob(network_param.class_pt_blob());
-    CHECK_NOTNULL(classify_pt_blob_.get());
-  }
-  if (cnnseg_param_.do_heading()) {
-    heading_pt_blob_ = inference_->get_blob(network_param.heading_pt_blob());
-    CHECK_NOTNULL(heading_pt_blob_.get());
+  if (FLAGS_enable_lidar_batch_inference) {
+    ACHECK(ServeInference(proto_file + ":" + weight_file, input_shapes))
+        << "Failed to serve inference.";
+  } else {
+    ACHECK(inference_->Init(input_shapes)) << "Failed to init inference.";
+
+    // init blobs
+    instance_pt_blob_ = inference_->get_blob(network_param.instance_pt_blob());
+    CHECK_NOTNULL(instance_pt_blob_.get());
+    category_pt_blob_ = inference_->get_blob(network_param.category_pt_blob());
+    CHECK_NOTNULL(category_pt_blob_.get());
+    confidence_pt_blob_ =
+        inference_->get_blob(network_param.confidence_pt_blob());
+    CHECK_NOTNULL(confidence_pt_blob_.get());
+    height_pt_blob_ = inference_->get_blob(network_param.height_pt_blob());
+    CHECK_NOTNULL(height_pt_blob_.get());
+    feature_blob_ = inference_->get_blob(network_param.feature_blob());
+    CHECK_NOTNULL(feature_blob_.get());
+    if (cnnseg_param_.do_classification()) {
+      classify_pt_blob_ = inference_->get_blob(network_param.class_pt_blob());
+      CHECK_NOTNULL(classify_pt_blob_.get());
+    }
+    if (cnnseg_param_.do_heading()) {
+      heading_pt_blob_ = inference_->get_blob(network_param.heading_pt_blob());
+      CHECK_NOTNULL(heading_pt_blob_.get());
+    }
   }
 
   // init feature generator
@@ -206,27 +215,34 @@ bool CNNSegmentation::Init(const StageConfig& stage_config) {
   if (!feature_param.use_constant_feature()) {
     input_shape[1] -= 2;
   }
-  ACHECK(inference_->Init(input_shapes)) << "Failed to init inference.";
-
-  // init blobs
-  instance_pt_blob_ = inference_->get_blob(network_param.instance_pt_blob());
-  CHECK_NOTNULL(instance_pt_blob_.get());
-  category_pt_blob_ = inference_->get_blob(network_param.category_pt_blob());
-  CHECK_NOTNULL(category_pt_blob_.get());
-  confidence_pt_blob_ =
-      inference_->get_blob(network_param.confidence_pt_blob());
-  CHECK_NOTNULL(confidence_pt_blob_.get());
-  height_pt_blob_ = inference_->get_blob(network_param.height_pt_blob());
-  CHECK_NOTNULL(height_pt_blob_.get());
-  feature_blob_ = inference_->get_blob(network_param.feature_blob());
-  CHECK_NOTNULL(feature_blob_.get());
-  if (cnnseg_param_.do_classification()) {
-    classify_pt_blob_ = inference_->get_blob(network_param.class_pt_blob());
-    CHECK_NOTNULL(classify_pt_blob_.get());
-  }
-  if (cnnseg_param_.do_heading()) {
-    heading_pt_blob_ = inference_->get_blob(network_param.heading_pt_blob());
-    CHECK_NOTNULL(heading_pt_blob_.get());
+  if (FLAGS_enable_lidar_batch_inference) {
+    ACHECK(ServeInference(
+        cnnseg_config_.proto_file() + ":" + cnnseg_config_.weight_file(),
+        input_shapes))
+        << "Failed to serve inference.";
+  } else {
+    ACHECK(inference_->Init(input_shapes)) << "Failed to init inference.";
+
+    // init blobs
+    instance_pt_blob_ = inference_->get_blob(network_param.instance_pt_blob());
+    CHECK_NOTNULL(instance_pt_blob_.get());
+    category_pt_blob_ = inference_->get_blob(network_param.category_pt_blob());
+    CHECK_NOTNULL(category_pt_blob_.get());
+    confidence_pt_blob_ =
+        inference_->get_blob(network_param.confidence_pt_blob());
+    CHECK_NOTNULL(confidence_pt_blob_.get());
+    height_pt_blob_ = inference_->get_blob(network_param.height_pt_blob());
+    CHECK_NOTNULL(height_pt_blob_.get());
+    feature_blob_ = inference_->get_blob(network_param.feature_blob());
+    CHECK_NOTNULL(feature_blob_.get());
+    if (cnnseg_param_.do_classification()) {
+      classify_pt_blob_ = inference_->get_blob(network_param.class_pt_blob());
+      CHECK_NOTNULL(classify_pt_blob_.get());
+    }
+    if (cnnseg_param_.do_heading()) {
+      heading_pt_blob_ = inference_->get_blob(network_param.heading_pt_blob());
+      CHECK_NOTNULL(heading_pt_blob_.get());
+    }
   }
 
   // init feature generator
@@ -255,6 +271,56 @@ bool CNNSegmentation::Process(DataFrame* data_frame) {
   return res;
 }
 
+bool CNNSegmentation::ServeInference(
+    const std::string& model_name,
+    const std::map<std::string, std::vector<int>>& input_shapes) {
+  const NetworkParam& network_param = cnnseg_param_.network_param();
+  feature_blob_.reset(new base::Blob<float>(input_shapes.begin()->second));
+  instance_pt_blob_.reset(new base::Blob<float>);
+  category_pt_blob_.reset(new base::Blob<float>);
+  confidence_pt_blob_.reset(new base::Blob<float>);
+  height_pt_blob_.reset(new base::Blob<float>);
+  std::vector<std::string> output_names = {
+      network_param.instance_pt_blob(), network_param.category_pt_blob(),
+      network_param.confidence_pt_blob(), network_param.height_pt_blob()};
+  served_output_blobs_ = {instance_pt_blob_, category_pt_blob_,
+                          confidence_pt_blob_, height_pt_blob_};
+  if (cnnseg_param_.do_classification()) {
+    classify_pt_blob_.reset(new base::Blob<float>);
+    output_names.push_back(network_param.class_pt_blob());
+    served_output_blobs_.push_back(classify_pt_blob_);
+  }
+  if (cnnseg_param_.do_heading()) {
+    heading_pt_blob_.reset(new base::Blob<float>);
+    output_names.push_back(network_param.heading_pt_blob());
+    served_output_blobs_.push_back(heading_pt_blob_);
+  }
+
+  // the first lidar of the model hands its net to the server, the others
+  // share it and drop theirs
+  auto* server = inference::BatchInferenceServer::Instance();
+  if (!server->HasModel(model_name)) {
+    inference::BatchInferenceOptions options;
+    options.max_batch_size = FLAGS_lidar_batch_inference_max_batch_size;
+    options.max_latency_us = FLAGS_lidar_batch_inference_max_latency_us;
+    // another lidar may add the model meanwhile
+    if (!server->AddModel(model_name, std::move(inference_), input_shapes,
+                          output_names, options) &&
+        !server->HasModel(model_name)) {
+      AERROR << "Failed to serve " << model_name;
+      return false;
+    }
+  }
+  inference_.reset();
+  served_model_ = model_name;
+
+  // run a blank sample to shape the outputs, the spp engine keeps pointers
+  // to their data
+  memset(feature_blob_->mutable_cpu_data(), 0,
+         feature_blob_->count() * sizeof(float));
+  return server->Infer(model_name, {feature_blob_}, served_output_blobs_);
+}
+
 bool CNNSegmentation::InitClusterAndBackgroundSegmentation() {
   // init ground detector
   ground_detector_ = BaseGroundDetectorRegisterer::GetInstanceByName(
@@ -349,27 +415,8 @@ bool CNNSegmentation::InitClusterAndBackgroundSegmentation() {
 
 void CNNSegmentation::MapPointToGrid(
     const std::shared_ptr<AttributePointCloud<PointF>>& pc_ptr) {
-  float inv_res_x = 0.5f * static_cast<float>(width_) / range_;
-  // float inv_res_y = 0.5 * static_cast<float>(height_) / range_;
-  point2grid_.assign(pc_ptr->size(), -1);
-  int pos_x = -1;
-  int pos_y = -1;
-  for (size_t i = 0; i < pc_ptr->size(); ++i) {
-    const auto& pt = pc_ptr->at(i);
-    if (pt.z <= min_height_ || pt.z >= max_height_) {
-      continue;
-    }
-    // the coordinates of x and y are exchanged here
-    // (row <-> x, column <-> y)
-    // int pos_x = F2I(pt.y, range_, inv_res_x);  // col
-    // int pos_y = F2I(pt.x, range_, inv_res_y);  // row
-    // 2018.6.21, switch to axis rotated projection
-    GroupPc2Pixel(pt.x, pt.y, inv_res_x, range_, &pos_x, &pos_y);
-    if (pos_y < 0 || pos_y >= height_ || pos_x < 0 || pos_x >= width_) {
-      continue;
-    }
-    point2grid_[i] = pos_y * width_ + pos_x;
-  }
+  // axis rotated projection, see FeatureGenerator::MapPointToGrid
+  feature_generator_->MapPointToGrid(pc_ptr, &point2grid_);
 }
 
 bool CNNSegmentation::Detect(const LidarDetectorOptions& options,
@@ -420,7 +467,13 @@ bool CNNSegmentation::Detect(const LidarDetectorOptions& options,
   feature_time_ = timer.toc(true);
 
   // model inference
-  inference_->Infer();
+  if (inference_ != nullptr) {
+    inference_->Infer();
+  } else if (!inference::BatchInferenceServer::Instance()->Infer(
+                 served_model_, {feature_blob_}, served_output_blobs_)) {
+    AERROR << "Failed to run " << served_model_ << " on the server.";
+    return false;
+  }
   infer_time_ = timer.toc(true);
 
   // processing clustering
@@ -15,6 +15,7 @@
  *****************************************************************************/
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -64,6 +65,12 @@ class CNNSegmentation : public BaseLidarDetector {
 
   bool InitClusterAndBackgroundSegmentation();
 
+  // run the net on the batch inference server as model_name instead of
+  // owning it, the blobs then hold the sample of this lidar only
+  bool ServeInference(
+      const std::string& model_name,
+      const std::map<std::string, std::vector<int>>& input_shapes);
+
   void GetObjectsFromSppEngine(
       std::vector<std::shared_ptr<base::Object>>* objects);
 
@@ -71,7 +78,10 @@ class CNNSegmentation : public BaseLidarDetector {
       const std::shared_ptr<base::AttributePointCloud<base::PointF>>& pc_ptr);
 
   CNNSegParam cnnseg_param_;
-  std::shared_ptr<inference::Inference> inference_;
+  // null when the net is served by the batch inference server
+  std::unique_ptr<inference::Inference> inference_;
+  std::string served_model_;
+  std::vector<std::shared_ptr<base::Blob<float>>> served_output_blobs_;
   std::shared_ptr<FeatureGenerator> feature_generator_;
 
   // output blobs
@@ -16,6 +16,7 @@
 #include "modules/perception/lidar/lib/detector/cnn_segmentation/cnn_segmentation.h"
 
 #include <algorithm>
+#include <future>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -23,6 +24,7 @@
 
 #include "modules/perception/common/io/io_util.h"
 #include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/inference/batch_inference_server.h"
 
 namespace {
 constexpr float kFloatEpsilon = std::numeric_limits<float>::epsilon();
@@ -197,6 +199,63 @@ TEST(CNNSegmentationTest, cnn_segmentation_test) {
   //  EXPECT_LE(4, objects.size());
 }
 
+TEST(CNNSegmentationTest, cnn_segmentation_batch_inference_test) {
+  unsetenv("CYBER_PATH");
+  unsetenv("MODULE_PATH");
+  FLAGS_work_root =
+      "/apollo/modules/perception/testdata/"
+      "lidar/lib/segmentation/cnnseg/";
+
+  auto pcl_ptr = std::shared_ptr<base::PointFCloud>(new base::PointFCloud);
+  std::string filename =
+      "/apollo/modules/perception/testdata/lidar/app/data/0002_00.pcd";
+  ACHECK(LoadPCDFile(filename, pcl_ptr)) << "Failed to load " << filename;
+  auto make_frame = [&pcl_ptr]() {
+    std::shared_ptr<LidarFrame> frame(new LidarFrame);
+    frame->cloud = pcl_ptr;
+    frame->world_cloud = base::PointDCloudPool::Instance().Get();
+    frame->world_cloud->resize(pcl_ptr->size());
+    return frame;
+  };
+
+  // the objects of the own net
+  LidarDetectorOptions options;
+  CNNSegmentation segmentation;
+  EXPECT_TRUE(segmentation.Init());
+  auto expected_frame = make_frame();
+  EXPECT_TRUE(segmentation.Detect(options, expected_frame.get()));
+
+  // two lidars of the same model share a net on the server
+  FLAGS_enable_lidar_batch_inference = true;
+  CNNSegmentation served_segmentations[2];
+  for (auto& served_segmentation : served_segmentations) {
+    EXPECT_TRUE(served_segmentation.Init());
+  }
+  FLAGS_enable_lidar_batch_inference = false;
+  std::shared_ptr<LidarFrame> frames[2] = {make_frame(), make_frame()};
+  std::future<bool> detected[2];
+  for (int i = 0; i < 2; ++i) {
+    detected[i] = std::async(std::launch::async, [&, i]() {
+      return served_segmentations[i].Detect(options, frames[i].get());
+    });
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(detected[i].get());
+    const auto& expected_objects = expected_frame->segmented_objects;
+    const auto& objects = frames[i]->segmented_objects;
+    ASSERT_EQ(expected_objects.size(), objects.size());
+    for (size_t j = 0; j < objects.size(); ++j) {
+      EXPECT_EQ(expected_objects[j]->lidar_supplement.cloud.size(),
+                objects[j]->lidar_supplement.cloud.size());
+      EXPECT_NEAR(expected_objects[j]->confidence, objects[j]->confidence,
+                  1e-4);
+    }
+  }
+
+  // stop the worker of the shared net
+  inference::BatchInferenceServer::Instance()->Shutdown();
+}
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
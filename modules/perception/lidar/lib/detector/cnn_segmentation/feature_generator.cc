@@ -15,15 +15,28 @@
  *****************************************************************************/
 #include "modules/perception/lidar/lib/detector/cnn_segmentation/feature_generator.h"
 
+#include <smmintrin.h>
+
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 #include "modules/perception/base/common.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 #include "modules/perception/lidar/lib/detector/cnn_segmentation/util.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+namespace {
+// points of a cloud chunk below which a thread is not worth its dispatch
+constexpr size_t kMinPointsPerThread = 8192;
+// rows of a band of the feature map below which a thread is not worth its
+// dispatch
+constexpr size_t kMinRowsPerThread = 32;
+}  // namespace
+
 bool FeatureGenerator::Init(const FeatureParam& feature_param,
                             base::Blob<float>* out_blob) {
   // set output feature blob
@@ -39,6 +52,8 @@ bool FeatureGenerator::Init(const FeatureParam& feature_param,
       << "Current implementation version requires input_width == input_height.";
   use_intensity_feature_ = feature_param.use_intensity_feature();
   use_constant_feature_ = feature_param.use_constant_feature();
+  use_cpu_ = feature_param.use_cpu();
+  num_threads_ = std::max<size_t>(feature_param.num_threads(), 1);
 
   // set log lookup table
   log_table_.resize(kMaxLogNum);
@@ -49,12 +64,16 @@ bool FeatureGenerator::Init(const FeatureParam& feature_param,
   // set output feature blob data
   float* out_blob_data = nullptr;
 #if USE_GPU == 1
-  log_blob_.reset(
-      new base::Blob<float>(1, 1, 1, static_cast<int>(log_table_.size())));
-  float* log_table = log_blob_->mutable_gpu_data();
-  cudaMemcpy(log_table, log_table_.data(), log_table_.size() * sizeof(float),
-             cudaMemcpyHostToDevice);
-  out_blob_data = out_blob_->mutable_gpu_data();
+  if (!use_cpu_) {
+    log_blob_.reset(
+        new base::Blob<float>(1, 1, 1, static_cast<int>(log_table_.size())));
+    float* log_table = log_blob_->mutable_gpu_data();
+    cudaMemcpy(log_table, log_table_.data(),
+               log_table_.size() * sizeof(float), cudaMemcpyHostToDevice);
+    out_blob_data = out_blob_->mutable_gpu_data();
+  } else {
+    out_blob_data = out_blob_->mutable_cpu_data();
+  }
 #else
   out_blob_data = out_blob_->mutable_cpu_data();
 #endif
@@ -98,10 +117,18 @@ bool FeatureGenerator::Init(const FeatureParam& feature_param,
 
 // memory copy direction and distance features
 #if USE_GPU == 1
-    cudaMemcpy(direction_data_, direction_data.data(),
-               direction_data.size() * sizeof(float), cudaMemcpyHostToDevice);
-    cudaMemcpy(distance_data_, distance_data.data(),
-               distance_data.size() * sizeof(float), cudaMemcpyHostToDevice);
+    if (!use_cpu_) {
+      cudaMemcpy(direction_data_, direction_data.data(),
+                 direction_data.size() * sizeof(float),
+                 cudaMemcpyHostToDevice);
+      cudaMemcpy(distance_data_, distance_data.data(),
+                 distance_data.size() * sizeof(float), cudaMemcpyHostToDevice);
+    } else {
+      memcpy(direction_data_, direction_data.data(),
+             direction_data.size() * sizeof(float));
+      memcpy(distance_data_, distance_data.data(),
+             distance_data.size() * sizeof(float));
+    }
 #else
     memcpy(direction_data_, direction_data.data(),
            direction_data.size() * sizeof(float));
@@ -112,6 +139,84 @@ bool FeatureGenerator::Init(const FeatureParam& feature_param,
   return true;
 }
 
+void FeatureGenerator::MapPointToGrid(const base::PointFCloudPtr& pc_ptr,
+                                      std::vector<int>* point2grid) const {
+  static_assert(sizeof(base::PointF) == 4 * sizeof(float),
+                "the points are loaded as four floats");
+  const float inv_res_x = 0.5f * static_cast<float>(width_) / range_;
+  point2grid->resize(pc_ptr->size());
+  if (pc_ptr->empty()) {
+    return;
+  }
+  const float* data = &(pc_ptr->at(0).x);
+  int* grid = point2grid->data();
+  lib::ParallelFor(
+      0, pc_ptr->size(), num_threads_, kMinPointsPerThread,
+      [&](size_t, size_t begin, size_t end) {
+        // GroupPc2Pixel on four points, out of the height range when z is
+        // not in (min_height, max_height)
+        const __m128 v_min_height = _mm_set1_ps(min_height_);
+        const __m128 v_max_height = _mm_set1_ps(max_height_);
+        const __m128 v_range = _mm_set1_ps(range_);
+        const __m128 v_scale = _mm_set1_ps(inv_res_x);
+        const __m128 v_rotation = _mm_set1_ps(0.707107f);
+        const __m128 v_zero = _mm_setzero_ps();
+        const __m128i v_minus_one = _mm_set1_epi32(-1);
+        const __m128i v_width = _mm_set1_epi32(width_);
+        const __m128i v_height = _mm_set1_epi32(height_);
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+          __m128 v_xs = _mm_loadu_ps(data + 4 * i);
+          __m128 v_ys = _mm_loadu_ps(data + 4 * (i + 1));
+          __m128 v_zs = _mm_loadu_ps(data + 4 * (i + 2));
+          __m128 v_intensities = _mm_loadu_ps(data + 4 * (i + 3));
+          _MM_TRANSPOSE4_PS(v_xs, v_ys, v_zs, v_intensities);
+
+          const __m128 v_fx = _mm_mul_ps(
+              _mm_sub_ps(v_range,
+                         _mm_mul_ps(v_rotation, _mm_add_ps(v_xs, v_ys))),
+              v_scale);
+          const __m128 v_fy = _mm_mul_ps(
+              _mm_sub_ps(v_range,
+                         _mm_mul_ps(v_rotation, _mm_sub_ps(v_xs, v_ys))),
+              v_scale);
+          const __m128i v_pos_x =
+              _mm_or_si128(_mm_cvttps_epi32(v_fx),
+                           _mm_castps_si128(_mm_cmplt_ps(v_fx, v_zero)));
+          const __m128i v_pos_y =
+              _mm_or_si128(_mm_cvttps_epi32(v_fy),
+                           _mm_castps_si128(_mm_cmplt_ps(v_fy, v_zero)));
+          const __m128i v_in_height = _mm_castps_si128(
+              _mm_and_ps(_mm_cmpnle_ps(v_zs, v_min_height),
+                         _mm_cmpnge_ps(v_zs, v_max_height)));
+          const __m128i v_in_map = _mm_and_si128(
+              _mm_and_si128(_mm_cmpgt_epi32(v_pos_x, v_minus_one),
+                            _mm_cmplt_epi32(v_pos_x, v_width)),
+              _mm_and_si128(_mm_cmpgt_epi32(v_pos_y, v_minus_one),
+                            _mm_cmplt_epi32(v_pos_y, v_height)));
+          const __m128i v_valid = _mm_and_si128(v_in_height, v_in_map);
+          const __m128i v_idx = _mm_add_epi32(
+              _mm_mullo_epi32(v_pos_y, v_width), v_pos_x);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(grid + i),
+                           _mm_blendv_epi8(v_minus_one, v_idx, v_valid));
+        }
+        int pos_x = -1;
+        int pos_y = -1;
+        for (; i < end; ++i) {
+          const auto& pt = pc_ptr->at(i);
+          grid[i] = -1;
+          if (pt.z <= min_height_ || pt.z >= max_height_) {
+            continue;
+          }
+          GroupPc2Pixel(pt.x, pt.y, inv_res_x, range_, &pos_x, &pos_y);
+          if (pos_y < 0 || pos_y >= height_ || pos_x < 0 || pos_x >= width_) {
+            continue;
+          }
+          grid[i] = pos_y * width_ + pos_x;
+        }
+      });
+}
+
 void FeatureGenerator::GenerateCPU(const base::PointFCloudPtr& pc_ptr,
                                    const std::vector<int>& point2grid) {
   // DO NOT remove this line!!!
@@ -119,42 +224,146 @@ void FeatureGenerator::GenerateCPU(const base::PointFCloudPtr& pc_ptr,
   // It marks the head at cpu for blob.
   out_blob_->mutable_cpu_data();
 
-  // fill initial value for feature blob
   const int map_size = height_ * width_;
-  for (int i = 0; i < map_size; ++i) {
-    max_height_data_[i] = -5.f;
+  const size_t num_points = pc_ptr->size();
+  size_t num_bands = lib::NumParallelChunks(
+      0, static_cast<size_t>(height_), num_threads_, kMinRowsPerThread);
+  if (num_bands <= 1) {
+    ResetCells(0, map_size);
+    for (size_t i = 0; i < num_points; ++i) {
+      if (point2grid[i] != -1) {
+        AddPoint(pc_ptr->at(i), point2grid[i]);
+      }
+    }
+    AverageCells(0, map_size);
+    return;
+  }
+
+  // the feature map is split into bands of rows, and the points of a band
+  // are reduced by one thread in index order, so that the features do not
+  // depend on the number of threads and the cells need no atomics. The
+  // points are bucketed by band with a counting sort over chunks of the
+  // cloud.
+  const int band_rows = (height_ + static_cast<int>(num_bands) - 1) /
+                        static_cast<int>(num_bands);
+  const int band_size = band_rows * width_;
+  num_bands = (height_ + band_rows - 1) / band_rows;
+  const size_t num_chunks = lib::NumParallelChunks(
+      0, num_points, num_threads_, kMinPointsPerThread);
+  chunk_band_counts_.assign(num_chunks * num_bands, 0);
+  lib::ParallelFor(0, num_points, num_threads_, kMinPointsPerThread,
+                   [&](size_t chunk, size_t begin, size_t end) {
+                     size_t* counts =
+                         chunk_band_counts_.data() + chunk * num_bands;
+                     for (size_t i = begin; i < end; ++i) {
+                       if (point2grid[i] != -1) {
+                         ++counts[point2grid[i] / band_size];
+                       }
+                     }
+                   });
+  // the counts become the first position of the points of a chunk in a band
+  band_offsets_.assign(num_bands + 1, 0);
+  size_t offset = 0;
+  for (size_t band = 0; band < num_bands; ++band) {
+    band_offsets_[band] = offset;
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+      size_t& count = chunk_band_counts_[chunk * num_bands + band];
+      const size_t chunk_offset = offset;
+      offset += count;
+      count = chunk_offset;
+    }
+  }
+  band_offsets_[num_bands] = offset;
+  band_points_.resize(offset);
+  lib::ParallelFor(0, num_points, num_threads_, kMinPointsPerThread,
+                   [&](size_t chunk, size_t begin, size_t end) {
+                     size_t* offsets =
+                         chunk_band_counts_.data() + chunk * num_bands;
+                     for (size_t i = begin; i < end; ++i) {
+                       if (point2grid[i] != -1) {
+                         band_points_[offsets[point2grid[i] / band_size]++] =
+                             static_cast<int>(i);
+                       }
+                     }
+                   });
+
+  lib::ParallelFor(
+      0, num_bands, num_bands, 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t band = begin; band < end; ++band) {
+          const int cell_begin = static_cast<int>(band) * band_size;
+          const int cell_end = std::min(cell_begin + band_size, map_size);
+          ResetCells(cell_begin, cell_end);
+          for (size_t k = band_offsets_[band]; k < band_offsets_[band + 1];
+               ++k) {
+            const int i = band_points_[k];
+            AddPoint(pc_ptr->at(i), point2grid[i]);
+          }
+          AverageCells(cell_begin, cell_end);
+        }
+      });
+}
+
+void FeatureGenerator::ResetCells(const int cell_begin, const int cell_end) {
+  const size_t size = (cell_end - cell_begin) * sizeof(float);
+  std::fill(max_height_data_ + cell_begin, max_height_data_ + cell_end, -5.f);
+  memset(mean_height_data_ + cell_begin, 0, size);
+  memset(count_data_ + cell_begin, 0, size);
+  memset(nonempty_data_ + cell_begin, 0, size);
+  if (use_intensity_feature_) {
+    memset(top_intensity_data_ + cell_begin, 0, size);
+    memset(mean_intensity_data_ + cell_begin, 0, size);
   }
-  memset(mean_height_data_, 0, map_size * sizeof(float));
-  memset(count_data_, 0, map_size * sizeof(float));
-  memset(nonempty_data_, 0, map_size * sizeof(float));
+}
+
+void FeatureGenerator::AddPoint(const base::PointF& pt, const int idx) {
+  float pz = pt.z;
+  float pi = pt.intensity / 255.0f;
+  if (max_height_data_[idx] < pz) {
+    max_height_data_[idx] = pz;
+    if (use_intensity_feature_) {
+      top_intensity_data_[idx] = pi;
+    }
+  }
+  mean_height_data_[idx] += static_cast<float>(pz);
   if (use_intensity_feature_) {
-    memset(top_intensity_data_, 0, map_size * sizeof(float));
-    memset(mean_intensity_data_, 0, map_size * sizeof(float));
+    mean_intensity_data_[idx] += static_cast<float>(pi);
   }
+  count_data_[idx] += 1.f;
+}
 
-  // compute features
-  for (size_t i = 0; i < pc_ptr->size(); ++i) {
-    int idx = point2grid[i];
-    if (idx == -1) {
+void FeatureGenerator::AverageCells(const int cell_begin, const int cell_end) {
+  // four cells at a time, the division of the empty cells is masked out
+  const __m128 v_epsilon = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+  const __m128 v_one = _mm_set1_ps(1.f);
+  int i = cell_begin;
+  for (; i + 4 <= cell_end; i += 4) {
+    const __m128 v_count = _mm_loadu_ps(count_data_ + i);
+    const __m128 v_nonempty = _mm_cmpgt_ps(v_count, v_epsilon);
+    if (_mm_movemask_ps(v_nonempty) == 0) {
+      // most cells are empty, their sums and counts are already zero
+      _mm_storeu_ps(max_height_data_ + i, _mm_setzero_ps());
       continue;
     }
-    const auto& pt = pc_ptr->at(i);
-    float pz = pt.z;
-    float pi = pt.intensity / 255.0f;
-    if (max_height_data_[idx] < pz) {
-      max_height_data_[idx] = pz;
-      if (use_intensity_feature_) {
-        top_intensity_data_[idx] = pi;
-      }
-    }
-    mean_height_data_[idx] += static_cast<float>(pz);
+    _mm_storeu_ps(max_height_data_ + i,
+                  _mm_and_ps(v_nonempty, _mm_loadu_ps(max_height_data_ + i)));
+    const __m128 v_mean_height = _mm_loadu_ps(mean_height_data_ + i);
+    _mm_storeu_ps(mean_height_data_ + i,
+                  _mm_blendv_ps(v_mean_height,
+                                _mm_div_ps(v_mean_height, v_count),
+                                v_nonempty));
     if (use_intensity_feature_) {
-      mean_intensity_data_[idx] += static_cast<float>(pi);
+      const __m128 v_mean_intensity = _mm_loadu_ps(mean_intensity_data_ + i);
+      _mm_storeu_ps(mean_intensity_data_ + i,
+                    _mm_blendv_ps(v_mean_intensity,
+                                  _mm_div_ps(v_mean_intensity, v_count),
+                                  v_nonempty));
+    }
+    _mm_storeu_ps(nonempty_data_ + i, _mm_and_ps(v_nonempty, v_one));
+    for (int j = i; j < i + 4; ++j) {
+      count_data_[j] = LogCount(static_cast<int>(count_data_[j]));
     }
-    count_data_[idx] += 1.f;
   }
-
-  for (int i = 0; i < map_size; ++i) {
+  for (; i < cell_end; ++i) {
     if (count_data_[i] <= std::numeric_limits<float>::epsilon()) {
       max_height_data_[i] = 0.f;
     } else {
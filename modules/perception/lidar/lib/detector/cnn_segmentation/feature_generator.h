@@ -50,13 +50,21 @@ class FeatureGenerator {
 
   bool Init(const FeatureParam& feature_param, base::Blob<float>* out_blob);
 
+  // @brief: map the points to the cells of the feature map with the axis
+  // rotated projection, -1 for the points out of the map or of the height
+  // range
+  void MapPointToGrid(const base::PointFCloudPtr& pc_ptr,
+                      std::vector<int>* point2grid) const;
+
   void Generate(const base::PointFCloudPtr& pc_ptr,
                 const std::vector<int>& point2grid) {
 #if USE_GPU == 1
-    GenerateGPU(pc_ptr, point2grid);
-#else
-    GenerateCPU(pc_ptr, point2grid);
+    if (!use_cpu_) {
+      GenerateGPU(pc_ptr, point2grid);
+      return;
+    }
 #endif
+    GenerateCPU(pc_ptr, point2grid);
   }
 
   inline std::string Name() const { return "FeatureGenerator"; }
@@ -69,6 +77,11 @@ class FeatureGenerator {
 #endif
   void GenerateCPU(const base::PointFCloudPtr& pc_ptr,
                    const std::vector<int>& point2grid);
+  // the cells [cell_begin, cell_end) of the feature map, each cell is only
+  // touched by the thread of its rows
+  void ResetCells(const int cell_begin, const int cell_end);
+  void AddPoint(const base::PointF& pt, const int idx);
+  void AverageCells(const int cell_begin, const int cell_end);
 
   float LogCount(int count) {
     if (count < static_cast<int>(log_table_.size())) {
@@ -91,6 +104,9 @@ class FeatureGenerator {
   float max_height_ = 0.0f;
   bool use_intensity_feature_ = false;
   bool use_constant_feature_ = false;
+  // cpu generation in a gpu build, and threads of the cpu generation
+  bool use_cpu_ = false;
+  size_t num_threads_ = 1;
 
   // raw feature data
   float* max_height_data_ = nullptr;
@@ -105,6 +121,13 @@ class FeatureGenerator {
   // 1-d index in feature map of each point
   std::vector<int> map_idx_;
 
+  // points of each band of rows in index order, the points of the band b
+  // are band_points_[band_offsets_[b], band_offsets_[b + 1]), and the
+  // points of each chunk of the cloud in each band, chunk major
+  std::vector<int> band_points_;
+  std::vector<size_t> band_offsets_;
+  std::vector<size_t> chunk_band_counts_;
+
   // output feature blob
   base::Blob<float>* out_blob_ = nullptr;
 
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Latency of the cnnseg point to grid mapping and feature generation on a
+// synthetic 64 beam sweep, on the cpu at 1 to 8 threads (BM_FeatureCPU) and,
+// in a gpu build, with the cuda kernels (BM_FeatureGPU). The counters report
+// the mapping and the generation time of a frame. Run with
+// bazel run -c opt //modules/perception/lidar/lib/detector/cnn_segmentation:feature_generator_benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/lidar/lib/detector/cnn_segmentation/feature_generator.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+constexpr int kNumBeams = 64;
+constexpr int kNumAzimuths = 1800;
+
+// the ground and a ring of walls 30m away, as the feature map of cnnseg64
+base::PointFCloudPtr MakeSweep() {
+  base::PointFCloudPtr cloud(new base::PointFCloud);
+  for (int azimuth = 0; azimuth < kNumAzimuths; ++azimuth) {
+    const double angle = 2.0 * M_PI * azimuth / kNumAzimuths;
+    for (int beam = 0; beam < kNumBeams; ++beam) {
+      const double pitch = -0.43 + 0.0075 * beam;
+      const double distance =
+          std::min(pitch < 0.0 ? 1.9 / std::tan(-pitch) : 200.0, 30.0);
+      base::PointF point;
+      point.x = static_cast<float>(distance * std::cos(angle));
+      point.y = static_cast<float>(distance * std::sin(angle));
+      point.z = static_cast<float>(distance * std::tan(pitch));
+      point.intensity = static_cast<float>((azimuth + beam) % 256);
+      cloud->push_back(point);
+    }
+  }
+  return cloud;
+}
+
+FeatureParam MakeParam() {
+  FeatureParam param;
+  param.set_point_cloud_range(70.f);
+  param.set_width(672);
+  param.set_height(672);
+  param.set_min_height(-5.f);
+  param.set_max_height(5.f);
+  param.set_use_intensity_feature(true);
+  param.set_use_constant_feature(false);
+  return param;
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point& start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+void RunFeatureGenerator(const FeatureParam& param, benchmark::State* state) {
+  const base::PointFCloudPtr cloud = MakeSweep();
+  base::Blob<float> feature_blob(1, 6, param.height(), param.width());
+  FeatureGenerator generator;
+  if (!generator.Init(param, &feature_blob)) {
+    state->SkipWithError("failed to init the feature generator");
+    return;
+  }
+  std::vector<int> point2grid;
+  double map_time = 0.0;
+  double generate_time = 0.0;
+  for (auto _ : *state) {
+    auto start_time = std::chrono::steady_clock::now();
+    generator.MapPointToGrid(cloud, &point2grid);
+    map_time += ElapsedMicroseconds(start_time);
+    start_time = std::chrono::steady_clock::now();
+    generator.Generate(cloud, point2grid);
+#if USE_GPU == 1
+    // the inference reads the features on the gpu, wait for the upload or
+    // the kernels
+    feature_blob.gpu_data();
+    cudaDeviceSynchronize();
+#endif
+    generate_time += ElapsedMicroseconds(start_time);
+  }
+  const double num_iterations = static_cast<double>(state->iterations());
+  state->counters["map_us"] = map_time / num_iterations;
+  state->counters["generate_us"] = generate_time / num_iterations;
+  state->counters["points"] = static_cast<double>(cloud->size());
+}
+
+void BM_FeatureCPU(benchmark::State& state) {
+  FeatureParam param = MakeParam();
+  param.set_use_cpu(true);
+  param.set_num_threads(static_cast<uint32_t>(state.range(0)));
+  RunFeatureGenerator(param, &state);
+}
+
+#if USE_GPU == 1
+void BM_FeatureGPU(benchmark::State& state) {
+  RunFeatureGenerator(MakeParam(), &state);
+}
+#endif
+
+}  // namespace
+
+BENCHMARK(BM_FeatureCPU)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+#if USE_GPU == 1
+BENCHMARK(BM_FeatureGPU)->Unit(benchmark::kMicrosecond)->UseRealTime();
+#endif
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
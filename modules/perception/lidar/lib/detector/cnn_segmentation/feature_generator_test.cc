@@ -15,6 +15,8 @@
  *****************************************************************************/
 #include "modules/perception/lidar/lib/detector/cnn_segmentation/feature_generator.h"
 
+#include <random>
+
 #include "opencv2/opencv.hpp"
 
 #include "modules/perception/common/perception_gflags.h"
@@ -107,6 +109,71 @@ class FeatureGeneratorTest : public ::testing::Test {
            distance_data.size() * sizeof(float));
   }
 
+  // the axis rotated projection of CNNSegmentation, one point at a time
+  void MapPointToGridRotated(const base::PointFCloudPtr& pc_ptr,
+                             std::vector<int>* point2grid, float range,
+                             int width, int height, float min_height,
+                             float max_height) {
+    float inv_res_x = 0.5f * static_cast<float>(width) / range;
+    point2grid->assign(pc_ptr->size(), -1);
+    int pos_x = -1;
+    int pos_y = -1;
+    for (size_t i = 0; i < pc_ptr->size(); ++i) {
+      const auto& pt = pc_ptr->at(i);
+      if (pt.z <= min_height || pt.z >= max_height) {
+        continue;
+      }
+      GroupPc2Pixel(pt.x, pt.y, inv_res_x, range, &pos_x, &pos_y);
+      if (pos_y < 0 || pos_y >= height || pos_x < 0 || pos_x >= width) {
+        continue;
+      }
+      point2grid->at(i) = pos_y * width + pos_x;
+    }
+  }
+
+  // the features of a single thread, one point at a time, in the channels
+  // max height, mean height, count, top intensity, mean intensity, nonempty
+  void GenerateReference(const base::PointFCloudPtr& pc_ptr,
+                         const std::vector<int>& point2grid, int map_size,
+                         std::vector<float>* features) {
+    features->assign(6 * map_size, 0.f);
+    float* max_height_data = features->data();
+    float* mean_height_data = max_height_data + map_size;
+    float* count_data = mean_height_data + map_size;
+    float* top_intensity_data = count_data + map_size;
+    float* mean_intensity_data = top_intensity_data + map_size;
+    float* nonempty_data = mean_intensity_data + map_size;
+    for (int i = 0; i < map_size; ++i) {
+      max_height_data[i] = -5.f;
+    }
+    for (size_t i = 0; i < pc_ptr->size(); ++i) {
+      int idx = point2grid[i];
+      if (idx == -1) {
+        continue;
+      }
+      const auto& pt = pc_ptr->at(i);
+      float pz = pt.z;
+      float pi = pt.intensity / 255.0f;
+      if (max_height_data[idx] < pz) {
+        max_height_data[idx] = pz;
+        top_intensity_data[idx] = pi;
+      }
+      mean_height_data[idx] += pz;
+      mean_intensity_data[idx] += pi;
+      count_data[idx] += 1.f;
+    }
+    for (int i = 0; i < map_size; ++i) {
+      if (count_data[i] <= std::numeric_limits<float>::epsilon()) {
+        max_height_data[i] = 0.f;
+      } else {
+        mean_height_data[i] /= count_data[i];
+        mean_intensity_data[i] /= count_data[i];
+        nonempty_data[i] = 1.f;
+      }
+      count_data[i] = std::log(1.f + count_data[i]);
+    }
+  }
+
  protected:
   std::unique_ptr<FeatureGenerator> generator_;
 };
@@ -217,6 +284,67 @@ TEST_F(FeatureGeneratorTest, basic_test) {
   }
 }
 
+TEST_F(FeatureGeneratorTest, cpu_threads_test) {
+  // clusters of points over the map, many points fall in the same cells
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<float> center_dist(-75.f, 75.f);
+  std::normal_distribution<float> offset_dist(0.f, 0.3f);
+  std::uniform_real_distribution<float> height_dist(-6.f, 6.f);
+  std::uniform_real_distribution<float> intensity_dist(0.f, 255.f);
+  base::PointFCloudPtr pc_ptr(new base::PointFCloud);
+  for (int cluster = 0; cluster < 2000; ++cluster) {
+    const float center_x = center_dist(generator);
+    const float center_y = center_dist(generator);
+    for (int i = 0; i < 60; ++i) {
+      base::PointF pt;
+      pt.x = center_x + offset_dist(generator);
+      pt.y = center_y + offset_dist(generator);
+      pt.z = height_dist(generator);
+      pt.intensity = std::round(intensity_dist(generator));
+      pc_ptr->push_back(pt);
+    }
+  }
+  // an odd size for the tails of the simd loops
+  pc_ptr->push_back(pc_ptr->at(0));
+
+  FeatureParam param;
+  param.set_point_cloud_range(70.f);
+  param.set_width(672);
+  param.set_height(672);
+  param.set_min_height(-5.f);
+  param.set_max_height(5.f);
+  param.set_use_intensity_feature(true);
+  param.set_use_constant_feature(false);
+  param.set_use_cpu(true);
+  const int map_size = param.width() * param.height();
+
+  std::vector<int> expected_point2grid;
+  MapPointToGridRotated(pc_ptr, &expected_point2grid, param.point_cloud_range(),
+                        param.width(), param.height(), param.min_height(),
+                        param.max_height());
+  std::vector<float> expected_features;
+  GenerateReference(pc_ptr, expected_point2grid, map_size, &expected_features);
+
+  for (const int num_threads : {1, 2, 3, 8}) {
+    param.set_num_threads(num_threads);
+    generator_.reset(new FeatureGenerator);
+    base::Blob<float> feature_blob;
+    feature_blob.Reshape(1, 6, param.height(), param.width());
+    EXPECT_TRUE(generator_->Init(param, &feature_blob));
+    std::vector<int> point2grid;
+    generator_->MapPointToGrid(pc_ptr, &point2grid);
+    EXPECT_EQ(point2grid, expected_point2grid) << num_threads;
+    // the same generator over frames
+    for (int frame = 0; frame < 2; ++frame) {
+      generator_->Generate(pc_ptr, point2grid);
+      EXPECT_EQ(memcmp(feature_blob.cpu_data(), expected_features.data(),
+                       expected_features.size() * sizeof(float)),
+                0)
+          << num_threads;
+    }
+  }
+}
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
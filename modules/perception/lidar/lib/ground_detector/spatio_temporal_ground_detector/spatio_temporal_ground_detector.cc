@@ -16,9 +16,12 @@
 
 #include "modules/perception/lidar/lib/ground_detector/spatio_temporal_ground_detector/spatio_temporal_ground_detector.h"
 
+#include <vector>
+
 #include "cyber/common/file.h"
 #include "modules/perception/common/point_cloud_processing/common.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 #include "modules/perception/lidar/common/lidar_log.h"
 #include "modules/perception/lidar/common/lidar_point_label.h"
 #include "modules/perception/pipeline/proto/stage/spatio_temporal_ground_detector_config.pb.h"
@@ -29,6 +32,11 @@ namespace lidar {
 
 using apollo::cyber::common::GetProtoFromFile;
 
+namespace {
+// points of a frame below which a thread is not worth its dispatch
+constexpr size_t kMinPointsPerThread = 8192;
+}  // namespace
+
 bool SpatioTemporalGroundDetector::Init(
     const GroundDetectorInitOptions& options) {
   const lib::ModelConfig* model_config = nullptr;
@@ -53,6 +61,7 @@ bool SpatioTemporalGroundDetector::Init(
   ground_thres_ = config_params.ground_thres();
   use_roi_ = config_params.use_roi();
   use_ground_service_ = config_params.use_ground_service();
+  num_threads_ = config_params.num_threads();
 
   param_ = new common::PlaneFitGroundDetectorParam;
   param_->roi_region_rad_x = config_params.roi_rad_x();
@@ -85,6 +94,7 @@ bool SpatioTemporalGroundDetector::Init(const StageConfig& stage_config) {
   ground_thres_ = config_.ground_thres();
   use_roi_ = config_.use_roi();
   use_ground_service_ = config_.use_ground_service();
+  num_threads_ = config_.num_threads();
 
   param_ = new common::PlaneFitGroundDetectorParam;
   param_->roi_region_rad_x = config_.roi_rad_x();
@@ -129,15 +139,10 @@ bool SpatioTemporalGroundDetector::Detect(const GroundDetectorOptions& options,
     return false;
   }
 
-  unsigned int data_id = 0;
   unsigned int valid_point_num = 0;
-  unsigned int valid_point_num_cur = 0;
-  size_t i = 0;
   size_t num_points = 0;
   size_t num_points_all = 0;
-  int index = 0;
   unsigned int nr_points_element = 3;
-  float z_distance = 0.0f;
 
   cloud_center_(0) = frame->lidar2world_pose(0, 3);
   cloud_center_(1) = frame->lidar2world_pose(1, 3);
@@ -170,28 +175,20 @@ bool SpatioTemporalGroundDetector::Detect(const GroundDetectorOptions& options,
   }
 
   // copy point data, filtering lower points under ground
-  if (use_roi_) {
-    for (i = 0; i < num_points; ++i) {
-      index = frame->roi_indices.indices[i];
-      const auto& pt = frame->world_cloud->at(index);
-      point_indices_temp_[valid_point_num++] = index;
-      data_[data_id++] = static_cast<float>(pt.x - cloud_center_(0));
-      data_[data_id++] = static_cast<float>(pt.y - cloud_center_(1));
-      data_[data_id++] = static_cast<float>(pt.z - cloud_center_(2));
-    }
-  } else {
-    for (i = 0; i < num_points; ++i) {
-      const auto& pt = frame->world_cloud->at(i);
-      point_indices_temp_[valid_point_num++] = static_cast<int>(i);
-      data_[data_id++] = static_cast<float>(pt.x - cloud_center_(0));
-      data_[data_id++] = static_cast<float>(pt.y - cloud_center_(1));
-      data_[data_id++] = static_cast<float>(pt.z - cloud_center_(2));
-    }
-  }
-
-  valid_point_num_cur = valid_point_num;
-
-  CHECK_EQ(data_id, valid_point_num * 3);
+  lib::ParallelFor(
+      0, num_points, num_threads_, kMinPointsPerThread,
+      [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          const int index =
+              use_roi_ ? frame->roi_indices.indices[i] : static_cast<int>(i);
+          const auto& pt = frame->world_cloud->at(index);
+          point_indices_temp_[i] = index;
+          data_[i * 3] = static_cast<float>(pt.x - cloud_center_(0));
+          data_[i * 3 + 1] = static_cast<float>(pt.y - cloud_center_(1));
+          data_[i * 3 + 2] = static_cast<float>(pt.z - cloud_center_(2));
+        }
+      });
+  valid_point_num = static_cast<unsigned int>(num_points);
   base::PointIndices& non_ground_indices = frame->non_ground_indices;
   ADEBUG << "input of ground detector:" << valid_point_num;
 
@@ -204,20 +201,37 @@ bool SpatioTemporalGroundDetector::Detect(const GroundDetectorOptions& options,
     return false;
   }
 
-  for (i = 0; i < valid_point_num_cur; ++i) {
-    z_distance = ground_height_signed_.data()[i];
-    frame->cloud->mutable_points_height()->at(point_indices_temp_[i]) =
-        z_distance;
-    frame->world_cloud->mutable_points_height()->at(point_indices_temp_[i]) =
-        z_distance;
-    if (common::IAbs(z_distance) > ground_thres_) {
-      non_ground_indices.indices.push_back(point_indices_temp_[i]);
-    } else {
-      frame->cloud->mutable_points_label()->at(point_indices_temp_[i]) =
-          static_cast<uint8_t>(LidarPointLabel::GROUND);
-      frame->world_cloud->mutable_points_label()->at(point_indices_temp_[i]) =
-          static_cast<uint8_t>(LidarPointLabel::GROUND);
-    }
+  // the non ground points of each chunk, appended in chunk order afterwards
+  const size_t num_chunks = lib::NumParallelChunks(
+      0, valid_point_num, num_threads_, kMinPointsPerThread);
+  chunk_indices_.resize(num_chunks);
+  for (auto& indices : chunk_indices_) {
+    indices.clear();
+  }
+  lib::ParallelFor(
+      0, valid_point_num, num_threads_, kMinPointsPerThread,
+      [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<int>* indices =
+            chunk == 0 ? &non_ground_indices.indices : &chunk_indices_[chunk];
+        for (size_t i = begin; i < end; ++i) {
+          const float z_distance = ground_height_signed_[i];
+          const int index = point_indices_temp_[i];
+          frame->cloud->mutable_points_height()->at(index) = z_distance;
+          frame->world_cloud->mutable_points_height()->at(index) = z_distance;
+          if (common::IAbs(z_distance) > ground_thres_) {
+            indices->push_back(index);
+          } else {
+            frame->cloud->mutable_points_label()->at(index) =
+                static_cast<uint8_t>(LidarPointLabel::GROUND);
+            frame->world_cloud->mutable_points_label()->at(index) =
+                static_cast<uint8_t>(LidarPointLabel::GROUND);
+          }
+        }
+      });
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    non_ground_indices.indices.insert(non_ground_indices.indices.end(),
+                                      chunk_indices_[chunk].begin(),
+                                      chunk_indices_[chunk].end());
   }
   AINFO << "succeed to call ground detector with non ground points "
         << non_ground_indices.indices.size();
@@ -60,11 +60,15 @@ class SpatioTemporalGroundDetector : public BaseGroundDetector {
   std::vector<float> data_;
   std::vector<float> ground_height_signed_;
   std::vector<int> point_indices_temp_;
+  // non ground points of the chunks after the first, kept across frames
+  std::vector<std::vector<int>> chunk_indices_;
 
   bool use_roi_ = true;
   bool use_ground_service_ = false;
   float ground_thres_ = 0.25f;
   size_t default_point_size_ = 320000;
+  // threads splitting the points of a frame
+  uint32_t num_threads_ = 1;
   Eigen::Vector3d cloud_center_ = Eigen::Vector3d(0.0, 0.0, 0.0);
   GroundServiceContent ground_service_content_;
 
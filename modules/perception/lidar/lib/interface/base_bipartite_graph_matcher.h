@@ -34,6 +34,7 @@ struct BipartiteGraphMatcherInitOptions {};
 struct BipartiteGraphMatcherOptions {
   float cost_thresh = 4.0f;
   float bound_value = 100.0f;
+  bool use_sparse_solver = false;
 };
 
 class BaseBipartiteGraphMatcher {
@@ -21,6 +21,7 @@
 #include "modules/perception/common/geometry/common.h"
 #include "modules/perception/common/geometry/convex_hull_2d.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 
 namespace apollo {
 namespace perception {
@@ -29,6 +30,8 @@ namespace lidar {
 static const float kEpsilon = 1e-6f;
 static const float kEpsilonForSize = 1e-2f;
 static const float kEpsilonForLine = 1e-3f;
+// objects of a frame below which a thread is not worth its dispatch
+static const size_t kMinObjectsPerThread = 16;
 using apollo::perception::base::PointD;
 using apollo::perception::base::PointF;
 using ObjectPtr = std::shared_ptr<apollo::perception::base::Object>;
@@ -43,6 +46,7 @@ bool ObjectBuilder::Init(const StageConfig& stage_config) {
   if (!Initialize(stage_config)) {
     return false;
   }
+  num_threads_ = stage_config.object_builder_config().num_threads();
   return true;
 }
 
@@ -62,14 +66,18 @@ bool ObjectBuilder::Build(const ObjectBuilderOptions& options,
     return false;
   }
   std::vector<ObjectPtr>* objects = &(frame->segmented_objects);
-  for (size_t i = 0; i < objects->size(); ++i) {
-    if (objects->at(i)) {
-      objects->at(i)->id = static_cast<int>(i);
-      ComputePolygon2D(objects->at(i));
-      ComputePolygonSizeCenter(objects->at(i));
-      ComputeOtherObjectInformation(objects->at(i));
-    }
-  }
+  // every object is built independently
+  lib::ParallelFor(0, objects->size(), num_threads_, kMinObjectsPerThread,
+                   [&](size_t, size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                       if (objects->at(i)) {
+                         objects->at(i)->id = static_cast<int>(i);
+                         ComputePolygon2D(objects->at(i));
+                         ComputePolygonSizeCenter(objects->at(i));
+                         ComputeOtherObjectInformation(objects->at(i));
+                       }
+                     }
+                   });
   return true;
 }
 
@@ -103,6 +103,9 @@ class ObjectBuilder : public pipeline::Stage {
   void GetMinMax3D(const apollo::perception::base::PointCloud<
                        apollo::perception::base::PointF>& cloud,
                    Eigen::Vector3f* min_pt, Eigen::Vector3f* max_pt);
+
+  // threads splitting the objects of a frame
+  uint32_t num_threads_ = 1;
 };  // class ObjectBuilder
 
 }  // namespace lidar
@@ -17,12 +17,15 @@
 
 #include <limits>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/common/file.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/perception/base/object_pool_types.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 #include "modules/perception/lidar/common/lidar_log.h"
+#include "modules/perception/lidar/common/point_cloud_converter.h"
 
 namespace apollo {
 namespace perception {
@@ -30,6 +33,11 @@ namespace lidar {
 
 using cyber::common::GetAbsolutePath;
 
+namespace {
+// points of a frame below which a thread is not worth its dispatch
+constexpr size_t kMinPointsPerThread = 8192;
+}  // namespace
+
 const float PointCloudPreprocessor::kPointInfThreshold = 1e3;
 
 bool PointCloudPreprocessor::Init(
@@ -60,6 +68,7 @@ bool PointCloudPreprocessor::Init(
   box_backward_y_ = static_cast<float>(-vehicle_param.back_edge_to_center());*/
   filter_high_z_points_ = config.filter_high_z_points();
   z_threshold_ = config.z_threshold();
+  num_threads_ = config.num_threads();
   return true;
 }
 
@@ -83,6 +92,7 @@ bool PointCloudPreprocessor::Init(const StageConfig& stage_config) {
   filter_high_z_points_ =
       pointcloud_preprocessor_config_.filter_high_z_points();
   z_threshold_    = pointcloud_preprocessor_config_.z_threshold();
+  num_threads_ = pointcloud_preprocessor_config_.num_threads();
   return true;
 }
 
@@ -113,40 +123,47 @@ bool PointCloudPreprocessor::Preprocess(
   if (frame->world_cloud == nullptr) {
     frame->world_cloud = base::PointDCloudPool::Instance().Get();
   }
+  if (!message->packed_point().empty()) {
+    // converted in bulk, then filtered in place
+    ConvertPointCloud(*message, frame->cloud.get());
+    return Preprocess(options, frame);
+  }
   frame->cloud->set_timestamp(message->measurement_time());
   if (message->point_size() > 0) {
-    frame->cloud->reserve(message->point_size());
-    base::PointF point;
-    for (int i = 0; i < message->point_size(); ++i) {
-      const apollo::drivers::PointXYZIT& pt = message->point(i);
-      if (filter_naninf_points_) {
-        if (std::isnan(pt.x()) || std::isnan(pt.y()) || std::isnan(pt.z())) {
-          continue;
-        }
-        if (fabs(pt.x()) > kPointInfThreshold ||
-            fabs(pt.y()) > kPointInfThreshold ||
-            fabs(pt.z()) > kPointInfThreshold) {
-          continue;
-        }
-      }
-      Eigen::Vector3d vec3d_lidar(pt.x(), pt.y(), pt.z());
-      Eigen::Vector3d vec3d_novatel =
-          options.sensor2novatel_extrinsics * vec3d_lidar;
-      if (filter_nearby_box_points_ && vec3d_novatel[0] < box_forward_x_ &&
-          vec3d_novatel[0] > box_backward_x_ &&
-          vec3d_novatel[1] < box_forward_y_ &&
-          vec3d_novatel[1] > box_backward_y_) {
-        continue;
-      }
-      if (filter_high_z_points_ && pt.z() > z_threshold_) {
-        continue;
-      }
-      point.x = pt.x();
-      point.y = pt.y();
-      point.z = pt.z();
-      point.intensity = static_cast<float>(pt.intensity());
-      frame->cloud->push_back(point, static_cast<double>(pt.timestamp()) * 1e-9,
-                              std::numeric_limits<float>::max(), i, 0);
+    const size_t num_points = static_cast<size_t>(message->point_size());
+    const size_t num_chunks = lib::NumParallelChunks(
+        0, num_points, num_threads_, kMinPointsPerThread);
+    // the points kept by each chunk, appended in chunk order afterwards
+    chunk_clouds_.resize(num_chunks - 1);
+    for (auto& cloud : chunk_clouds_) {
+      cloud.clear();
+    }
+    lib::ParallelFor(
+        0, num_points, num_threads_, kMinPointsPerThread,
+        [&](size_t chunk, size_t begin, size_t end) {
+          base::PointFCloud* cloud =
+              chunk == 0 ? frame->cloud.get() : &chunk_clouds_[chunk - 1];
+          cloud->reserve(cloud->size() + end - begin);
+          base::PointF point;
+          for (size_t i = begin; i < end; ++i) {
+            const apollo::drivers::PointXYZIT& pt =
+                message->point(static_cast<int>(i));
+            if (IsFilteredPoint(pt.x(), pt.y(), pt.z(),
+                                options.sensor2novatel_extrinsics)) {
+              continue;
+            }
+            point.x = pt.x();
+            point.y = pt.y();
+            point.z = pt.z();
+            point.intensity = static_cast<float>(pt.intensity());
+            cloud->push_back(point,
+                             static_cast<double>(pt.timestamp()) * 1e-9,
+                             std::numeric_limits<float>::max(),
+                             static_cast<int32_t>(i), 0);
+          }
+        });
+    for (const auto& cloud : chunk_clouds_) {
+      *frame->cloud += cloud;
     }
     TransformCloud(frame->cloud, frame->lidar2world_pose, frame->world_cloud);
   }
@@ -162,41 +179,36 @@ bool PointCloudPreprocessor::Preprocess(
     frame->world_cloud = base::PointDCloudPool::Instance().Get();
   }
   if (frame->cloud->size() > 0) {
-    size_t size = frame->cloud->size();
-    size_t i = 0;
-    while (i < size) {
-      auto& pt = frame->cloud->at(i);
-      if (filter_naninf_points_) {
-        if (std::isnan(pt.x) || std::isnan(pt.y) || std::isnan(pt.z)) {
-          frame->cloud->SwapPoint(i, size--);
-          continue;
-        }
-        if (fabs(pt.x) > kPointInfThreshold ||
-            fabs(pt.y) > kPointInfThreshold ||
-            fabs(pt.z) > kPointInfThreshold) {
-          frame->cloud->SwapPoint(i, size--);
-          continue;
-        }
-      }
-      Eigen::Vector3d vec3d_lidar(pt.x, pt.y, pt.z);
-      Eigen::Vector3d vec3d_novatel =
-          options.sensor2novatel_extrinsics * vec3d_lidar;
-      if (filter_nearby_box_points_ && vec3d_novatel[0] < box_forward_x_ &&
-          vec3d_novatel[0] > box_backward_x_ &&
-          vec3d_novatel[1] < box_forward_y_ &&
-          vec3d_novatel[1] > box_backward_y_) {
-        frame->cloud->SwapPoint(i, size--);
-        continue;
-      }
-      if (filter_high_z_points_ && pt.z > z_threshold_) {
-        frame->cloud->SwapPoint(i, size--);
-        continue;
+    base::PointFCloud* cloud = frame->cloud.get();
+    const size_t size = cloud->size();
+    // the points kept by each chunk, compacted in chunk order afterwards so
+    // that the output does not depend on the number of threads
+    chunk_indices_.resize(
+        lib::NumParallelChunks(0, size, num_threads_, kMinPointsPerThread));
+    for (auto& indices : chunk_indices_) {
+      indices.clear();
+    }
+    lib::ParallelFor(
+        0, size, num_threads_, kMinPointsPerThread,
+        [&](size_t chunk, size_t begin, size_t end) {
+          std::vector<size_t>& indices = chunk_indices_[chunk];
+          indices.reserve(end - begin);
+          for (size_t i = begin; i < end; ++i) {
+            const auto& pt = cloud->at(i);
+            if (!IsFilteredPoint(pt.x, pt.y, pt.z,
+                                 options.sensor2novatel_extrinsics)) {
+              indices.push_back(i);
+            }
+          }
+        });
+    size_t num_kept = 0;
+    for (const auto& indices : chunk_indices_) {
+      for (const size_t index : indices) {
+        cloud->CopyPoint(num_kept++, index, *cloud);
       }
-      ++i;
     }
-    AINFO << "Preprocessor filter points: "
-          << frame->cloud->size() << " to " << size;
-    frame->cloud->resize(size);
+    AINFO << "Preprocessor filter points: " << size << " to " << num_kept;
+    cloud->resize(num_kept);
     TransformCloud(frame->cloud, frame->lidar2world_pose, frame->world_cloud);
   }
   return true;
@@ -209,23 +221,52 @@ bool PointCloudPreprocessor::TransformCloud(
     return false;
   }
   world_cloud->clear();
-  world_cloud->reserve(local_cloud->size());
-  for (size_t i = 0; i < local_cloud->size(); ++i) {
-    auto& pt = local_cloud->at(i);
-    Eigen::Vector3d trans_point(pt.x, pt.y, pt.z);
-    trans_point = pose * trans_point;
-    base::PointD world_point;
-    world_point.x = trans_point(0);
-    world_point.y = trans_point(1);
-    world_point.z = trans_point(2);
-    world_point.intensity = pt.intensity;
-    world_cloud->push_back(world_point, local_cloud->points_timestamp(i),
-                           std::numeric_limits<float>::max(),
-                           local_cloud->points_beam_id()[i], 0);
-  }
+  world_cloud->resize(local_cloud->size());
+  lib::ParallelFor(
+      0, local_cloud->size(), num_threads_, kMinPointsPerThread,
+      [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          const auto& pt = local_cloud->at(i);
+          const Eigen::Vector3d trans_point =
+              pose * Eigen::Vector3d(pt.x, pt.y, pt.z);
+          base::PointD& world_point = world_cloud->at(i);
+          world_point.x = trans_point(0);
+          world_point.y = trans_point(1);
+          world_point.z = trans_point(2);
+          world_point.intensity = pt.intensity;
+          world_cloud->mutable_points_timestamp()->at(i) =
+              local_cloud->points_timestamp(i);
+          world_cloud->points_beam_id(i) = local_cloud->points_beam_id(i);
+        }
+      });
   return true;
 }
 
+bool PointCloudPreprocessor::IsFilteredPoint(
+    const float x, const float y, const float z,
+    const Eigen::Affine3d& sensor2novatel_extrinsics) const {
+  if (filter_naninf_points_) {
+    if (std::isnan(x) || std::isnan(y) || std::isnan(z)) {
+      return true;
+    }
+    if (fabs(x) > kPointInfThreshold || fabs(y) > kPointInfThreshold ||
+        fabs(z) > kPointInfThreshold) {
+      return true;
+    }
+  }
+  if (filter_nearby_box_points_) {
+    Eigen::Vector3d vec3d_lidar(x, y, z);
+    Eigen::Vector3d vec3d_novatel = sensor2novatel_extrinsics * vec3d_lidar;
+    if (vec3d_novatel[0] < box_forward_x_ &&
+        vec3d_novatel[0] > box_backward_x_ &&
+        vec3d_novatel[1] < box_forward_y_ &&
+        vec3d_novatel[1] > box_backward_y_) {
+      return true;
+    }
+  }
+  return filter_high_z_points_ && z > z_threshold_;
+}
+
 PERCEPTION_REGISTER_POINTCLOUDPREPROCESSOR(PointCloudPreprocessor);
 
 }  // namespace lidar
@@ -17,6 +17,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "modules/perception/lidar/lib/interface/base_pointcloud_preprocessor.h"
 #include "modules/perception/pipeline/proto/stage/pointcloud_preprocessor_config.pb.h"
@@ -54,6 +55,8 @@ class PointCloudPreprocessor : public BasePointCloudPreprocessor {
   bool TransformCloud(const base::PointFCloudPtr& local_cloud,
                       const Eigen::Affine3d& pose,
                       base::PointDCloudPtr world_cloud) const;
+  bool IsFilteredPoint(const float x, const float y, const float z,
+                       const Eigen::Affine3d& sensor2novatel_extrinsics) const;
   // params
   bool filter_naninf_points_ = true;
   bool filter_nearby_box_points_ = true;
@@ -63,8 +66,12 @@ class PointCloudPreprocessor : public BasePointCloudPreprocessor {
   float box_backward_y_ = 0.0f;
   bool filter_high_z_points_ = true;
   float z_threshold_ = 5.0f;
+  uint32_t num_threads_ = 1;
   static const float kPointInfThreshold;
-
+  // per chunk buffers of the parallel filtering, kept across frames so that
+  // a frame does not allocate them again
+  mutable std::vector<base::PointFCloud> chunk_clouds_;
+  mutable std::vector<std::vector<size_t>> chunk_indices_;
 
   PointcloudPreprocessorConfig pointcloud_preprocessor_config_;
 };  // class PointCloudPreprocessor
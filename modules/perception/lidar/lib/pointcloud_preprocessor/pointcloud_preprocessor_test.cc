@@ -129,6 +129,70 @@ TEST_F(PointCloudPreprocessorTest, basic_test) {
 #endif
 }
 
+TEST_F(PointCloudPreprocessorTest, multi_thread_test) {
+  pipeline::StageConfig stage_config;
+  stage_config.set_stage_type(pipeline::POINTCLOUD_PREPROCESSOR);
+  stage_config.set_enabled(true);
+  auto* config = stage_config.mutable_pointcloud_preprocessor_config();
+  config->set_filter_nearby_box_points(true);
+  config->set_box_forward_x(2.f);
+  config->set_box_backward_x(-2.f);
+  config->set_box_forward_y(5.f);
+  config->set_box_backward_y(-5.f);
+  config->set_filter_high_z_points(true);
+
+  base::PointFCloud cloud;
+  cloud.resize(100000);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const float angle = 0.01f * static_cast<float>(i);
+    const float range = 1.f + 0.001f * static_cast<float>(i);
+    cloud.at(i).x = range * std::cos(angle);
+    cloud.at(i).y = range * std::sin(angle);
+    cloud.at(i).z = 0.0001f * static_cast<float>(i % 70000) - 2.f;
+    cloud.at(i).intensity = static_cast<float>(i % 256);
+    cloud.mutable_points_timestamp()->at(i) = 1e-6 * static_cast<double>(i);
+    cloud.points_beam_id(i) = static_cast<int32_t>(i % 64);
+    if (i % 1000 == 0) {
+      cloud.at(i).y = std::numeric_limits<float>::quiet_NaN();
+    }
+  }
+
+  PointCloudPreprocessorOptions option;
+  option.sensor2novatel_extrinsics = Eigen::Affine3d::Identity();
+  LidarFrame expected_frame;
+  for (const uint32_t num_threads : {1, 2, 3, 8}) {
+    config->set_num_threads(num_threads);
+    PointCloudPreprocessor multi_thread_preprocessor;
+    EXPECT_TRUE(multi_thread_preprocessor.Init(stage_config));
+    LidarFrame frame;
+    frame.cloud = base::PointFCloudPool::Instance().Get();
+    *frame.cloud = cloud;
+    frame.lidar2world_pose = Eigen::Affine3d::Identity();
+    frame.lidar2world_pose.translation() << 100.0, 200.0, 1.0;
+    EXPECT_TRUE(multi_thread_preprocessor.Preprocess(option, &frame));
+    if (num_threads == 1) {
+      expected_frame = frame;
+      EXPECT_GT(frame.cloud->size(), 0);
+      EXPECT_LT(frame.cloud->size(), cloud.size());
+      continue;
+    }
+    // the same points in the same order as a single thread
+    ASSERT_EQ(frame.cloud->size(), expected_frame.cloud->size());
+    ASSERT_EQ(frame.world_cloud->size(), expected_frame.world_cloud->size());
+    for (size_t i = 0; i < frame.cloud->size(); ++i) {
+      EXPECT_EQ(frame.cloud->at(i).x, expected_frame.cloud->at(i).x);
+      EXPECT_EQ(frame.cloud->at(i).y, expected_frame.cloud->at(i).y);
+      EXPECT_EQ(frame.cloud->at(i).z, expected_frame.cloud->at(i).z);
+      EXPECT_EQ(frame.cloud->points_beam_id(i),
+                expected_frame.cloud->points_beam_id(i));
+      EXPECT_EQ(frame.world_cloud->at(i).x,
+                expected_frame.world_cloud->at(i).x);
+      EXPECT_EQ(frame.world_cloud->points_timestamp(i),
+                expected_frame.world_cloud->points_timestamp(i));
+    }
+  }
+}
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
@@ -17,9 +17,11 @@
 #include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "cyber/common/file.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/thread/parallel_for.h"
 #include "modules/perception/lidar/common/lidar_point_label.h"
 #include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/polygon_mask.h"
 #include "modules/perception/lidar/lib/scene_manager/scene_manager.h"
@@ -35,6 +37,11 @@ using apollo::cyber::common::GetAbsolutePath;
 template <typename T>
 using Polygon = typename PolygonScanCvter<T>::Polygon;
 
+namespace {
+// points of a frame below which a thread is not worth its dispatch
+constexpr size_t kMinPointsPerThread = 8192;
+}  // namespace
+
 bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   // load model config
   auto config_manager = lib::ConfigManager::Instance();
@@ -53,6 +60,9 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   extend_dist_ = config.extend_dist();
   no_edge_table_ = config.no_edge_table();
   set_roi_service_ = config.set_roi_service();
+  num_threads_ = config.num_threads();
+  use_raster_cache_ = config.use_raster_cache();
+  raster_cache_margin_ = config.raster_cache_margin();
 
   // reserve mem
   const size_t KPolygonMaxNum = 100;
@@ -64,13 +74,15 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   Eigen::Vector2d max_range(range_, range_);
   Eigen::Vector2d cell_size(cell_size_, cell_size_);
   bitmap_.Init(min_range, max_range, cell_size);
+  raster_cache_.Init(range_, cell_size_, raster_cache_margin_, extend_dist_);
 
   // output input parameters
   AINFO << " HDMap Roi Filter Parameters: "
         << " range: " << range_ << " cell_size: " << cell_size_
         << " extend_dist: " << extend_dist_
         << " no_edge_table: " << no_edge_table_
-        << " set_roi_service: " << set_roi_service_;
+        << " set_roi_service: " << set_roi_service_
+        << " use_raster_cache: " << use_raster_cache_;
   return true;
 }
 
@@ -85,6 +97,9 @@ bool HdmapROIFilter::Init(const StageConfig& stage_config) {
   extend_dist_ = hdmap_roi_filter_config_.extend_dist();
   no_edge_table_ = hdmap_roi_filter_config_.no_edge_table();
   set_roi_service_ = hdmap_roi_filter_config_.set_roi_service();
+  num_threads_ = hdmap_roi_filter_config_.num_threads();
+  use_raster_cache_ = hdmap_roi_filter_config_.use_raster_cache();
+  raster_cache_margin_ = hdmap_roi_filter_config_.raster_cache_margin();
 
   // reserve mem
   const size_t KPolygonMaxNum = 100;
@@ -96,6 +111,7 @@ bool HdmapROIFilter::Init(const StageConfig& stage_config) {
   Eigen::Vector2d max_range(range_, range_);
   Eigen::Vector2d cell_size(cell_size_, cell_size_);
   bitmap_.Init(min_range, max_range, cell_size);
+  raster_cache_.Init(range_, cell_size_, raster_cache_margin_, extend_dist_);
 
   // output input parameters
   AINFO << " HDMap Roi Filter Parameters: "
@@ -133,22 +149,33 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
     polygons_world_[i++] = &polygon;
   }
 
-  // transform to local
-  base::PointFCloudPtr cloud_local = base::PointFCloudPool::Instance().Get();
-  TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
-                 &polygons_local_, &cloud_local);
-
-  bool ret = FilterWithPolygonMask(cloud_local, polygons_local_,
-                                   &(frame->roi_indices));
+  bool ret = false;
+  if (use_raster_cache_) {
+    ret = FilterWithRasterCache(frame->cloud, frame->lidar2world_pose,
+                                polygons_world_, &(frame->roi_indices));
+  } else {
+    // transform to local
+    base::PointFCloudPtr cloud_local = base::PointFCloudPool::Instance().Get();
+    TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
+                   &polygons_local_, &cloud_local);
+
+    ret = FilterWithPolygonMask(cloud_local, polygons_local_,
+                                &(frame->roi_indices));
+  }
 
   // set roi points label
   if (ret) {
-    for (auto index : frame->roi_indices.indices) {
-      frame->cloud->mutable_points_label()->at(index) =
-          static_cast<uint8_t>(LidarPointLabel::ROI);
-      frame->world_cloud->mutable_points_label()->at(index) =
-          static_cast<uint8_t>(LidarPointLabel::ROI);
-    }
+    const std::vector<int>& indices = frame->roi_indices.indices;
+    lib::ParallelFor(
+        0, indices.size(), num_threads_, kMinPointsPerThread,
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            frame->cloud->mutable_points_label()->at(indices[i]) =
+                static_cast<uint8_t>(LidarPointLabel::ROI);
+            frame->world_cloud->mutable_points_label()->at(indices[i]) =
+                static_cast<uint8_t>(LidarPointLabel::ROI);
+          }
+        });
   }
 
   // set roi service
@@ -158,9 +185,18 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
       roi_service_content_.range_ = range_;
       roi_service_content_.cell_size_ = cell_size_;
       roi_service_content_.map_size_ = bitmap_.map_size();
-      roi_service_content_.bitmap_ = bitmap_.bitmap();
-      roi_service_content_.major_dir_ =
-          static_cast<ROIServiceContent::DirectionMajor>(bitmap_.dir_major());
+      if (use_raster_cache_) {
+        raster_cache_.CopyToBitmap(frame->lidar2world_pose.translation(),
+                                   bitmap_.map_size(),
+                                   &roi_service_content_.bitmap_);
+        roi_service_content_.major_dir_ =
+            ROIServiceContent::DirectionMajor::XMAJOR;
+      } else {
+        roi_service_content_.bitmap_ = bitmap_.bitmap();
+        roi_service_content_.major_dir_ =
+            static_cast<ROIServiceContent::DirectionMajor>(
+                bitmap_.dir_major());
+      }
       roi_service_content_.transform_ = frame->lidar2world_pose.translation();
       if (!ret) {
         std::fill(roi_service_content_.bitmap_.begin(),
@@ -241,13 +277,52 @@ void HdmapROIFilter::TransformFrame(
   // transform cloud
   (*cloud_local)->clear();
   (*cloud_local)->resize(cloud->size());
-  for (size_t i = 0; i < (*cloud_local)->size(); ++i) {
-    const auto& pt = cloud->at(i);
-    auto& local_pt = (*cloud_local)->at(i);
-    Eigen::Vector3d e_pt(pt.x, pt.y, pt.z);
-    local_pt.x = static_cast<float>(x_axis.dot(e_pt));
-    local_pt.y = static_cast<float>(y_axis.dot(e_pt));
+  lib::ParallelFor(0, cloud->size(), num_threads_, kMinPointsPerThread,
+                   [&](size_t, size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                       const auto& pt = cloud->at(i);
+                       auto& local_pt = (*cloud_local)->at(i);
+                       Eigen::Vector3d e_pt(pt.x, pt.y, pt.z);
+                       local_pt.x = static_cast<float>(x_axis.dot(e_pt));
+                       local_pt.y = static_cast<float>(y_axis.dot(e_pt));
+                     }
+                   });
+}
+
+bool HdmapROIFilter::FilterWithRasterCache(
+    const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
+    const EigenVector<PolygonDType*>& polygons_world,
+    base::PointIndices* roi_indices) {
+  const Eigen::Vector3d vel_location = vel_pose.translation();
+  if (!raster_cache_.Update(polygons_world, vel_location)) {
+    AERROR << " Failed to rasterize the roi polygons.";
+    return false;
   }
+  if (!raster_cache_.Check(vel_location.head<2>())) {
+    AWARN << " Car is not in roi!!.";
+    return false;
+  }
+  roi_indices->indices.clear();
+  roi_indices->indices.reserve(cloud->size());
+  const size_t num_chunks = lib::NumParallelChunks(
+      0, cloud->size(), num_threads_, kMinPointsPerThread);
+  chunk_indices_.resize(num_chunks);
+  for (auto& indices : chunk_indices_) {
+    indices.clear();
+  }
+  lib::ParallelFor(0, cloud->size(), num_threads_, kMinPointsPerThread,
+                   [&](size_t chunk, size_t begin, size_t end) {
+                     raster_cache_.FilterPoints(
+                         *cloud, vel_pose, begin, end,
+                         chunk == 0 ? &roi_indices->indices
+                                    : &chunk_indices_[chunk]);
+                   });
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    roi_indices->indices.insert(roi_indices->indices.end(),
+                                chunk_indices_[chunk].begin(),
+                                chunk_indices_[chunk].end());
+  }
+  return true;
 }
 
 bool HdmapROIFilter::Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
@@ -259,15 +334,33 @@ bool HdmapROIFilter::Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
   }
   roi_indices->indices.clear();
   roi_indices->indices.reserve(in_cloud->size());
-  for (size_t i = 0; i < in_cloud->size(); ++i) {
-    const auto& pt = in_cloud->at(i);
-    Eigen::Vector2d e_pt(pt.x, pt.y);
-    if (!bitmap.IsExists(e_pt)) {
-      continue;
-    }
-    if (bitmap.Check(e_pt)) {
-      roi_indices->indices.push_back(static_cast<int>(i));
-    }
+  // the roi points of each chunk, appended in chunk order afterwards
+  const size_t num_chunks = lib::NumParallelChunks(
+      0, in_cloud->size(), num_threads_, kMinPointsPerThread);
+  chunk_indices_.resize(num_chunks);
+  for (auto& indices : chunk_indices_) {
+    indices.clear();
+  }
+  lib::ParallelFor(
+      0, in_cloud->size(), num_threads_, kMinPointsPerThread,
+      [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<int>* indices =
+            chunk == 0 ? &roi_indices->indices : &chunk_indices_[chunk];
+        for (size_t i = begin; i < end; ++i) {
+          const auto& pt = in_cloud->at(i);
+          Eigen::Vector2d e_pt(pt.x, pt.y);
+          if (!bitmap.IsExists(e_pt)) {
+            continue;
+          }
+          if (bitmap.Check(e_pt)) {
+            indices->push_back(static_cast<int>(i));
+          }
+        }
+      });
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    roi_indices->indices.insert(roi_indices->indices.end(),
+                                chunk_indices_[chunk].begin(),
+                                chunk_indices_[chunk].end());
   }
   return true;
 }
@@ -23,6 +23,7 @@
 #include "modules/perception/base/point_cloud.h"
 #include "modules/perception/lidar/lib/interface/base_roi_filter.h"
 #include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/bitmap2d.h"
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/roi_raster_cache.h"
 #include "modules/perception/lidar/lib/scene_manager/roi_service/roi_service.h"
 #include "modules/perception/pipeline/stage.h"
 
@@ -69,6 +70,11 @@ class HdmapROIFilter : public BaseROIFilter {
       const apollo::common::EigenVector<base::PolygonDType>& map_polygons,
       base::PointIndices* roi_indices);
 
+  bool FilterWithRasterCache(
+      const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
+      base::PointIndices* roi_indices);
+
   bool Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
                       const Bitmap2D& bitmap, base::PointIndices* roi_indices);
 
@@ -78,6 +84,14 @@ class HdmapROIFilter : public BaseROIFilter {
   double extend_dist_ = 0.0;
   bool no_edge_table_ = false;
   bool set_roi_service_ = false;
+  // threads splitting the points of a frame
+  uint32_t num_threads_ = 1;
+  // roi points of the chunks after the first, kept across frames
+  std::vector<std::vector<int>> chunk_indices_;
+  // world frame raster kept across frames
+  bool use_raster_cache_ = false;
+  double raster_cache_margin_ = 20.0;
+  ROIRasterCache raster_cache_;
   apollo::common::EigenVector<base::PolygonDType*> polygons_world_;
   apollo::common::EigenVector<base::PolygonDType> polygons_local_;
   Bitmap2D bitmap_;
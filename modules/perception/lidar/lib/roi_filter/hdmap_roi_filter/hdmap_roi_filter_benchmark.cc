@@ -0,0 +1,222 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Per-frame latency of HdmapROIFilter on a drive through a synthetic road
+// grid, rasterizing the polygons of every frame (argument 0) and with the
+// cached world frame raster (argument 1). The road grid is tilted so that
+// the polygon edges are slanted, and each frame gets the polygons of the map
+// within a query radius of the vehicle, as the hdmap input does. The cloud is
+// a 64 beam sweep around the vehicle. The counters report the distribution
+// of the filter time of a frame and the roi points of the drive. Run with
+// bazel run -c opt //modules/perception/lidar/lib/roi_filter/hdmap_roi_filter:hdmap_roi_filter_benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/lidar/common/lidar_frame.h"
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+// utm like origin of the map
+constexpr double kMapX = 440000.0;
+constexpr double kMapY = 4430000.0;
+constexpr double kMapHeading = 0.5;
+constexpr double kBlockSize = 120.0;
+constexpr double kRoadWidth = 16.0;
+constexpr double kSectionLength = 40.0;
+constexpr int kNumBlocks = 12;
+constexpr double kQueryRadius = 150.0;
+
+constexpr int kNumFrames = 300;
+constexpr double kFrameDistance = 1.0;
+
+constexpr int kNumBeams = 64;
+constexpr int kNumAzimuths = 1800;
+
+Eigen::Vector2d MapToWorld(const double u, const double v) {
+  const double cos_heading = std::cos(kMapHeading);
+  const double sin_heading = std::sin(kMapHeading);
+  return Eigen::Vector2d(kMapX + u * cos_heading - v * sin_heading,
+                         kMapY + u * sin_heading + v * cos_heading);
+}
+
+base::PolygonDType MakeBlockPolygon(const double min_u, const double max_u,
+                                    const double min_v, const double max_v) {
+  base::PolygonDType polygon;
+  const double corners[4][2] = {
+      {min_u, min_v}, {max_u, min_v}, {max_u, max_v}, {min_u, max_v}};
+  for (const auto& corner : corners) {
+    const Eigen::Vector2d world = MapToWorld(corner[0], corner[1]);
+    base::PointD point;
+    point.x = world.x();
+    point.y = world.y();
+    polygon.push_back(point);
+  }
+  return polygon;
+}
+
+// roads along u and v every kBlockSize, cut into sections, and junctions
+struct RoadMap {
+  std::vector<base::PolygonDType> road_polygons;
+  std::vector<base::PolygonDType> junction_polygons;
+};
+
+RoadMap MakeRoadMap() {
+  RoadMap map;
+  const double half_width = 0.5 * kRoadWidth;
+  for (int i = 0; i <= kNumBlocks; ++i) {
+    const double road = i * kBlockSize;
+    for (int j = 0; j <= kNumBlocks; ++j) {
+      const double cross_road = j * kBlockSize;
+      map.junction_polygons.push_back(
+          MakeBlockPolygon(road - half_width, road + half_width,
+                           cross_road - half_width, cross_road + half_width));
+      if (j == kNumBlocks) {
+        continue;
+      }
+      for (double s = cross_road + half_width;
+           s < cross_road + kBlockSize - half_width; s += kSectionLength) {
+        const double e =
+            std::min(s + kSectionLength, cross_road + kBlockSize - half_width);
+        map.road_polygons.push_back(
+            MakeBlockPolygon(road - half_width, road + half_width, s, e));
+        map.road_polygons.push_back(
+            MakeBlockPolygon(s, e, road - half_width, road + half_width));
+      }
+    }
+  }
+  return map;
+}
+
+void QueryPolygons(const std::vector<base::PolygonDType>& polygons,
+                   const Eigen::Vector3d& location,
+                   apollo::common::EigenVector<base::PolygonDType>* result) {
+  result->clear();
+  for (const auto& polygon : polygons) {
+    for (size_t i = 0; i < polygon.size(); ++i) {
+      if (std::hypot(polygon[i].x - location.x(),
+                     polygon[i].y - location.y()) < kQueryRadius) {
+        result->push_back(polygon);
+        break;
+      }
+    }
+  }
+}
+
+// a sweep of the ground and of walls 30m away on both sides
+base::PointFCloud MakeSweep() {
+  base::PointFCloud cloud;
+  for (int azimuth = 0; azimuth < kNumAzimuths; ++azimuth) {
+    const double angle = 2.0 * M_PI * azimuth / kNumAzimuths;
+    for (int beam = 0; beam < kNumBeams; ++beam) {
+      const double pitch = -0.43 + 0.0075 * beam;
+      double distance = pitch < 0.0 ? 1.9 / std::tan(-pitch) : 200.0;
+      const double wall_distance = 30.0 / std::max(std::abs(std::sin(angle)),
+                                                   1.0e-3);
+      distance = std::min(distance, wall_distance);
+      base::PointF point;
+      point.x = static_cast<float>(distance * std::cos(angle));
+      point.y = static_cast<float>(distance * std::sin(angle));
+      point.z = static_cast<float>(distance * std::tan(pitch));
+      point.intensity = 1.0f;
+      cloud.push_back(point);
+    }
+  }
+  return cloud;
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point& start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+void BM_ROIFilterDrive(benchmark::State& state) {
+  const RoadMap map = MakeRoadMap();
+  const base::PointFCloud sweep = MakeSweep();
+  std::vector<double> filter_times;
+  double num_roi_points = 0.0;
+  for (auto _ : state) {
+    HdmapROIFilter roi_filter;
+    pipeline::StageConfig stage_config;
+    stage_config.mutable_hdmap_roi_filter_config()->set_use_raster_cache(
+        state.range(0) != 0);
+    if (!roi_filter.Init(stage_config)) {
+      state.SkipWithError("failed to init the roi filter");
+      return;
+    }
+    num_roi_points = 0.0;
+    for (int frame_id = 0; frame_id < kNumFrames; ++frame_id) {
+      state.PauseTiming();
+      // along the road at u = kBlockSize, through two junctions
+      const double v = 0.5 * kBlockSize + frame_id * kFrameDistance;
+      const Eigen::Vector2d location = MapToWorld(kBlockSize + 2.0, v);
+      LidarFrame frame;
+      frame.lidar2world_pose = Eigen::Translation3d(location.x(),
+                                                    location.y(), 0.0) *
+                               Eigen::AngleAxisd(kMapHeading + M_PI / 2.0,
+                                                 Eigen::Vector3d::UnitZ());
+      frame.cloud = std::make_shared<base::PointFCloud>(sweep);
+      frame.world_cloud = std::make_shared<base::PointDCloud>();
+      frame.world_cloud->resize(sweep.size());
+      frame.hdmap_struct = std::make_shared<base::HdmapStruct>();
+      const Eigen::Vector3d location_3d = frame.lidar2world_pose.translation();
+      QueryPolygons(map.road_polygons, location_3d,
+                    &frame.hdmap_struct->road_polygons);
+      QueryPolygons(map.junction_polygons, location_3d,
+                    &frame.hdmap_struct->junction_polygons);
+      state.ResumeTiming();
+
+      const auto start_time = std::chrono::steady_clock::now();
+      roi_filter.Filter(ROIFilterOptions(), &frame);
+      filter_times.push_back(ElapsedMicroseconds(start_time));
+      num_roi_points +=
+          static_cast<double>(frame.roi_indices.indices.size());
+    }
+  }
+  std::sort(filter_times.begin(), filter_times.end());
+  const auto percentile = [&filter_times](const double p) {
+    return filter_times[static_cast<size_t>(
+        p * static_cast<double>(filter_times.size() - 1))];
+  };
+  double total_time = 0.0;
+  for (const double filter_time : filter_times) {
+    total_time += filter_time;
+  }
+  state.counters["mean_us"] = total_time / filter_times.size();
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["max_us"] = filter_times.back();
+  state.counters["roi_points"] = num_roi_points / kNumFrames;
+}
+
+}  // namespace
+
+BENCHMARK(BM_ROIFilterDrive)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
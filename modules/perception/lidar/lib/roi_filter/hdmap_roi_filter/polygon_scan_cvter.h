@@ -471,8 +471,8 @@ bool PolygonScanCvter<T>::ConvertSegment(const size_t seg_id,
   }
   edge.min_y = edge.y;
 
-  // save top edge
-  if (static_cast<size_t>(x_id) >= scans_size_) {
+  // save top edge, the edges starting below the first scan are not
+  if (x_id >= 0 && static_cast<size_t>(x_id) >= scans_size_) {
     std::pair<double, double> seg(low_vertex[op_dir_major_],
                                   high_vertex[op_dir_major_]);
     top_segments_.push_back(seg);
@@ -0,0 +1,526 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/roi_raster_cache.h"
+
+#include <smmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#include "modules/perception/lidar/common/lidar_log.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+using apollo::common::EigenVector;
+
+namespace {
+constexpr int64_t kWordBits = 64;
+
+int64_t FloorToInt(const double value) {
+  return static_cast<int64_t>(std::floor(value));
+}
+}  // namespace
+
+void ROIRasterCache::Init(const double range, const double cell_size,
+                          const double margin, const double extend_dist) {
+  CHECK_GT(range, 0.0);
+  CHECK_GT(cell_size, 0.0);
+  range_ = range;
+  cell_size_ = cell_size;
+  // the window still covers the range once its first cell is snapped
+  margin_ = std::max(margin, 2.0 * cell_size);
+  extend_dist_ = extend_dist;
+
+  const double window_size = 2.0 * (range_ + margin_);
+  num_rows_ = static_cast<size_t>(std::ceil(window_size / cell_size_));
+  num_words_ =
+      static_cast<size_t>(std::ceil(window_size / (kWordBits * cell_size_))) +
+      1;
+  words_.assign(num_rows_ * num_words_, 0);
+  built_ = false;
+  polygons_.clear();
+  num_rebuilds_ = 0;
+  num_shifts_ = 0;
+}
+
+bool ROIRasterCache::Update(
+    const EigenVector<base::PolygonDType*>& polygons_world,
+    const Eigen::Vector3d& location) {
+  frame_keys_.resize(polygons_world.size());
+  size_t num_cached = 0;
+  for (size_t i = 0; i < polygons_world.size(); ++i) {
+    frame_keys_[i] = PolygonKey(*polygons_world[i]);
+    num_cached += polygons_.count(frame_keys_[i]);
+  }
+  if (!built_ || num_cached == 0) {
+    if (!Rebuild(polygons_world, frame_keys_, location)) {
+      built_ = false;
+      return false;
+    }
+    return true;
+  }
+  if (!Covers(location) && !Shift(location)) {
+    built_ = false;
+    return false;
+  }
+
+  // the polygons new to the cache, drawn within their bounding box
+  draw_polygons_.clear();
+  double min_x = std::numeric_limits<double>::max();
+  double min_y = std::numeric_limits<double>::max();
+  double max_x = -std::numeric_limits<double>::max();
+  double max_y = -std::numeric_limits<double>::max();
+  for (size_t i = 0; i < polygons_world.size(); ++i) {
+    if (polygons_.count(frame_keys_[i]) > 0) {
+      continue;
+    }
+    CachedPolygon* cached = &polygons_[frame_keys_[i]];
+    AddPolygon(*polygons_world[i], cached);
+    min_x = std::min(min_x, cached->min_x);
+    min_y = std::min(min_y, cached->min_y);
+    max_x = std::max(max_x, cached->max_x);
+    max_y = std::max(max_y, cached->max_y);
+    draw_polygons_.push_back(cached);
+  }
+  if (draw_polygons_.empty()) {
+    return true;
+  }
+  const Eigen::Vector2d origin = Origin();
+  const double word_size = kWordBits * cell_size_;
+  const auto clamp = [](const int64_t value, const size_t size) {
+    return static_cast<size_t>(
+        std::min(std::max(value, static_cast<int64_t>(0)),
+                 static_cast<int64_t>(size)));
+  };
+  const size_t row_begin = clamp(
+      FloorToInt((min_x - extend_dist_ - origin.x()) / cell_size_), num_rows_);
+  const size_t row_end = clamp(
+      FloorToInt((max_x + extend_dist_ - origin.x()) / cell_size_) + 1,
+      num_rows_);
+  const size_t word_begin = clamp(
+      FloorToInt((min_y - extend_dist_ - origin.y()) / word_size), num_words_);
+  const size_t word_end = clamp(
+      FloorToInt((max_y + extend_dist_ - origin.y()) / word_size) + 1,
+      num_words_);
+  if (!Rasterize(row_begin, row_end, word_begin, word_end, draw_polygons_)) {
+    built_ = false;
+    return false;
+  }
+  return true;
+}
+
+inline bool ROIRasterCache::IsSet(const int64_t row, const int64_t col) const {
+  if (row < 0 || row >= static_cast<int64_t>(num_rows_) || col < 0 ||
+      col >= static_cast<int64_t>(num_words_) * kWordBits) {
+    return false;
+  }
+  const uint64_t word = words_[row * num_words_ + (col / kWordBits)];
+  return (word >> (col % kWordBits)) & 1;
+}
+
+bool ROIRasterCache::Check(const Eigen::Vector2d& world_point) const {
+  if (!built_) {
+    return false;
+  }
+  const Eigen::Vector2d cell = (world_point - Origin()) / cell_size_;
+  return IsSet(FloorToInt(cell.x()), FloorToInt(cell.y()));
+}
+
+void ROIRasterCache::FilterPoints(const base::PointFCloud& cloud,
+                                  const Eigen::Affine3d& pose,
+                                  const size_t begin, const size_t end,
+                                  std::vector<int>* indices) const {
+  static_assert(sizeof(base::PointF) == 4 * sizeof(float),
+                "the points are loaded as four floats");
+  if (!built_ || begin >= end) {
+    return;
+  }
+  // the points rotated to the world axes, in cells, and the window cell of
+  // the pose translation
+  const Eigen::Matrix3f rotation = (pose.linear() / cell_size_).cast<float>();
+  const Eigen::Vector2d offset =
+      (pose.translation().head<2>() - Origin()) / cell_size_;
+  const float cell_range = static_cast<float>(range_ / cell_size_);
+
+  const __m128 v_r00 = _mm_set1_ps(rotation(0, 0));
+  const __m128 v_r01 = _mm_set1_ps(rotation(0, 1));
+  const __m128 v_r02 = _mm_set1_ps(rotation(0, 2));
+  const __m128 v_r10 = _mm_set1_ps(rotation(1, 0));
+  const __m128 v_r11 = _mm_set1_ps(rotation(1, 1));
+  const __m128 v_r12 = _mm_set1_ps(rotation(1, 2));
+  const __m128 v_offset_x = _mm_set1_ps(static_cast<float>(offset.x()));
+  const __m128 v_offset_y = _mm_set1_ps(static_cast<float>(offset.y()));
+  const __m128 v_range_min = _mm_set1_ps(-cell_range);
+  const __m128 v_range_max = _mm_set1_ps(cell_range);
+  alignas(16) int32_t rows[4];
+  alignas(16) int32_t cols[4];
+
+  const float* data = &(cloud.at(0).x);
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 v_xs = _mm_load_ps(data + 4 * i);
+    __m128 v_ys = _mm_load_ps(data + 4 * (i + 1));
+    __m128 v_zs = _mm_load_ps(data + 4 * (i + 2));
+    __m128 v_intensities = _mm_load_ps(data + 4 * (i + 3));
+    _MM_TRANSPOSE4_PS(v_xs, v_ys, v_zs, v_intensities);
+
+    const __m128 v_rxs = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(v_r00, v_xs), _mm_mul_ps(v_r01, v_ys)),
+        _mm_mul_ps(v_r02, v_zs));
+    const __m128 v_rys = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(v_r10, v_xs), _mm_mul_ps(v_r11, v_ys)),
+        _mm_mul_ps(v_r12, v_zs));
+    const __m128 v_in_range = _mm_and_ps(
+        _mm_and_ps(_mm_cmpge_ps(v_rxs, v_range_min),
+                   _mm_cmplt_ps(v_rxs, v_range_max)),
+        _mm_and_ps(_mm_cmpge_ps(v_rys, v_range_min),
+                   _mm_cmplt_ps(v_rys, v_range_max)));
+    const int in_range_mask = _mm_movemask_ps(v_in_range);
+    if (in_range_mask == 0) {
+      continue;
+    }
+    _mm_store_si128(
+        reinterpret_cast<__m128i*>(rows),
+        _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(v_rxs, v_offset_x))));
+    _mm_store_si128(
+        reinterpret_cast<__m128i*>(cols),
+        _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(v_rys, v_offset_y))));
+    for (int lane = 0; lane < 4; ++lane) {
+      if (((in_range_mask >> lane) & 1) && IsSet(rows[lane], cols[lane])) {
+        indices->push_back(static_cast<int>(i + lane));
+      }
+    }
+  }
+  for (; i < end; ++i) {
+    const auto& pt = cloud.at(i);
+    const float rx = rotation(0, 0) * pt.x + rotation(0, 1) * pt.y +
+                     rotation(0, 2) * pt.z;
+    const float ry = rotation(1, 0) * pt.x + rotation(1, 1) * pt.y +
+                     rotation(1, 2) * pt.z;
+    if (rx < -cell_range || rx >= cell_range || ry < -cell_range ||
+        ry >= cell_range) {
+      continue;
+    }
+    if (IsSet(FloorToInt(rx + static_cast<float>(offset.x())),
+              FloorToInt(ry + static_cast<float>(offset.y())))) {
+      indices->push_back(static_cast<int>(i));
+    }
+  }
+}
+
+void ROIRasterCache::CopyToBitmap(const Eigen::Vector3d& location,
+                                  const Bitmap2D::Vec2ui& map_size,
+                                  std::vector<uint64_t>* bitmap) const {
+  bitmap->assign(map_size[0] * map_size[1], 0);
+  if (!built_) {
+    return;
+  }
+  // window cells of the centers of the first row and the first bit
+  const Eigen::Vector2d first_cell =
+      (location.head<2>() - Eigen::Vector2d(range_, range_) - Origin()) /
+      cell_size_;
+  const int64_t row_offset = FloorToInt(first_cell.x() + 0.5);
+  const int64_t bit_offset = FloorToInt(first_cell.y() + 0.5);
+  const int64_t num_words = static_cast<int64_t>(num_words_);
+  for (size_t row = 0; row < map_size[0]; ++row) {
+    const int64_t window_row = row_offset + static_cast<int64_t>(row);
+    if (window_row < 0 || window_row >= static_cast<int64_t>(num_rows_)) {
+      continue;
+    }
+    const uint64_t* src = &words_[window_row * num_words_];
+    uint64_t* dst = &(*bitmap)[row * map_size[1]];
+    for (size_t word = 0; word < map_size[1]; ++word) {
+      const int64_t bit = bit_offset + static_cast<int64_t>(word) * kWordBits;
+      const int64_t src_word =
+          FloorToInt(static_cast<double>(bit) / kWordBits);
+      const int64_t shift = bit - src_word * kWordBits;
+      uint64_t value = 0;
+      if (src_word >= 0 && src_word < num_words) {
+        value = src[src_word] >> shift;
+      }
+      if (shift > 0 && src_word + 1 >= 0 && src_word + 1 < num_words) {
+        value |= src[src_word + 1] << (kWordBits - shift);
+      }
+      dst[word] = value;
+    }
+  }
+}
+
+size_t ROIRasterCache::PolygonKey(const base::PolygonDType& polygon) {
+  size_t key = polygon.size();
+  const auto combine = [&key](const double value) {
+    key ^= std::hash<double>()(value) + 0x9e3779b97f4a7c15ULL + (key << 6) +
+           (key >> 2);
+  };
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    combine(polygon[i].x);
+    combine(polygon[i].y);
+  }
+  return key;
+}
+
+void ROIRasterCache::AddPolygon(const base::PolygonDType& polygon_world,
+                                CachedPolygon* cached) {
+  cached->polygon.resize(polygon_world.size());
+  cached->min_x = std::numeric_limits<double>::max();
+  cached->min_y = std::numeric_limits<double>::max();
+  cached->max_x = -std::numeric_limits<double>::max();
+  cached->max_y = -std::numeric_limits<double>::max();
+  for (size_t i = 0; i < polygon_world.size(); ++i) {
+    const auto& pt = polygon_world[i];
+    cached->polygon[i] = Eigen::Vector2d(pt.x, pt.y);
+    cached->min_x = std::min(cached->min_x, pt.x);
+    cached->min_y = std::min(cached->min_y, pt.y);
+    cached->max_x = std::max(cached->max_x, pt.x);
+    cached->max_y = std::max(cached->max_y, pt.y);
+  }
+}
+
+int64_t ROIRasterCache::RowBegin(const Eigen::Vector3d& location) const {
+  return FloorToInt((location.x() - range_ - margin_) / cell_size_);
+}
+
+int64_t ROIRasterCache::WordBegin(const Eigen::Vector3d& location) const {
+  return FloorToInt((location.y() - range_ - margin_) /
+                    (kWordBits * cell_size_));
+}
+
+Eigen::Vector2d ROIRasterCache::Origin() const {
+  return Eigen::Vector2d(static_cast<double>(row_begin_) * cell_size_,
+                         static_cast<double>(word_begin_ * kWordBits) *
+                             cell_size_);
+}
+
+bool ROIRasterCache::Covers(const Eigen::Vector3d& location) const {
+  const int64_t first_row = FloorToInt((location.x() - range_) / cell_size_);
+  const int64_t last_row = FloorToInt((location.x() + range_) / cell_size_);
+  const int64_t first_bit = FloorToInt((location.y() - range_) / cell_size_);
+  const int64_t last_bit = FloorToInt((location.y() + range_) / cell_size_);
+  return first_row >= row_begin_ &&
+         last_row < row_begin_ + static_cast<int64_t>(num_rows_) &&
+         first_bit >= word_begin_ * kWordBits &&
+         last_bit <
+             (word_begin_ + static_cast<int64_t>(num_words_)) * kWordBits;
+}
+
+bool ROIRasterCache::Overlaps(const CachedPolygon& polygon,
+                              const Eigen::Vector2d& min_point,
+                              const Eigen::Vector2d& max_point) const {
+  return polygon.max_x + extend_dist_ >= min_point.x() &&
+         polygon.min_x - extend_dist_ < max_point.x() &&
+         polygon.max_y + extend_dist_ >= min_point.y() &&
+         polygon.min_y - extend_dist_ < max_point.y();
+}
+
+bool ROIRasterCache::Rebuild(
+    const EigenVector<base::PolygonDType*>& polygons_world,
+    const std::vector<size_t>& keys, const Eigen::Vector3d& location) {
+  polygons_.clear();
+  row_begin_ = RowBegin(location);
+  word_begin_ = WordBegin(location);
+  std::fill(words_.begin(), words_.end(), 0);
+  built_ = true;
+  ++num_rebuilds_;
+
+  draw_polygons_.clear();
+  for (size_t i = 0; i < polygons_world.size(); ++i) {
+    if (polygons_.count(keys[i]) > 0) {
+      continue;
+    }
+    CachedPolygon* cached = &polygons_[keys[i]];
+    AddPolygon(*polygons_world[i], cached);
+    draw_polygons_.push_back(cached);
+  }
+  return Rasterize(0, num_rows_, 0, num_words_, draw_polygons_);
+}
+
+bool ROIRasterCache::Shift(const Eigen::Vector3d& location) {
+  const int64_t row_begin = RowBegin(location);
+  const int64_t word_begin = WordBegin(location);
+  const int64_t num_rows = static_cast<int64_t>(num_rows_);
+  const int64_t num_words = static_cast<int64_t>(num_words_);
+
+  // move the cells kept by the window, in world rows and words
+  const int64_t kept_row_begin = std::max(row_begin_, row_begin);
+  const int64_t kept_row_end =
+      std::min(row_begin_ + num_rows, row_begin + num_rows);
+  const int64_t kept_word_begin = std::max(word_begin_, word_begin);
+  const int64_t kept_word_end =
+      std::min(word_begin_ + num_words, word_begin + num_words);
+  const bool has_kept_cells =
+      kept_row_begin < kept_row_end && kept_word_begin < kept_word_end;
+  shifted_words_.assign(words_.size(), 0);
+  if (has_kept_cells) {
+    for (int64_t row = kept_row_begin; row < kept_row_end; ++row) {
+      memcpy(&shifted_words_[(row - row_begin) * num_words +
+                             (kept_word_begin - word_begin)],
+             &words_[(row - row_begin_) * num_words +
+                     (kept_word_begin - word_begin_)],
+             sizeof(words_[0]) * (kept_word_end - kept_word_begin));
+    }
+  }
+  words_.swap(shifted_words_);
+  row_begin_ = row_begin;
+  word_begin_ = word_begin;
+  ++num_shifts_;
+
+  // forget the polygons left behind, they come back with the frames that
+  // need them
+  const Eigen::Vector2d window_min = Origin();
+  const Eigen::Vector2d window_max =
+      window_min + Eigen::Vector2d(num_rows * cell_size_,
+                                   num_words * kWordBits * cell_size_);
+  draw_polygons_.clear();
+  for (auto iter = polygons_.begin(); iter != polygons_.end();) {
+    if (!Overlaps(iter->second, window_min, window_max)) {
+      iter = polygons_.erase(iter);
+    } else {
+      draw_polygons_.push_back(&iter->second);
+      ++iter;
+    }
+  }
+  if (!has_kept_cells) {
+    return Rasterize(0, num_rows_, 0, num_words_, draw_polygons_);
+  }
+
+  // the rows before and after the kept cells, then the words on either
+  // side of the kept cells in the kept rows
+  const size_t kept_rows_begin =
+      static_cast<size_t>(kept_row_begin - row_begin);
+  const size_t kept_rows_end = static_cast<size_t>(kept_row_end - row_begin);
+  const size_t kept_words_begin =
+      static_cast<size_t>(kept_word_begin - word_begin);
+  const size_t kept_words_end = static_cast<size_t>(kept_word_end - word_begin);
+  return Rasterize(0, kept_rows_begin, 0, num_words_, draw_polygons_) &&
+         Rasterize(kept_rows_end, num_rows_, 0, num_words_, draw_polygons_) &&
+         Rasterize(kept_rows_begin, kept_rows_end, 0, kept_words_begin,
+                   draw_polygons_) &&
+         Rasterize(kept_rows_begin, kept_rows_end, kept_words_end, num_words_,
+                   draw_polygons_);
+}
+
+bool ROIRasterCache::Rasterize(
+    const size_t row_begin, const size_t row_end, const size_t word_begin,
+    const size_t word_end, const std::vector<const CachedPolygon*>& polygons) {
+  if (row_begin >= row_end || word_begin >= word_end) {
+    return true;
+  }
+  const Eigen::Vector2d origin = Origin();
+  const Eigen::Vector2d min_point =
+      origin + Eigen::Vector2d(static_cast<double>(row_begin) * cell_size_,
+                               static_cast<double>(word_begin * kWordBits) *
+                                   cell_size_);
+  const Eigen::Vector2d max_point =
+      origin + Eigen::Vector2d(static_cast<double>(row_end) * cell_size_,
+                               static_cast<double>(word_end * kWordBits) *
+                                   cell_size_);
+  for (const CachedPolygon* cached : polygons) {
+    if (Overlaps(*cached, min_point, max_point) &&
+        !DrawPolygon(*cached, row_begin, row_end, word_begin * kWordBits,
+                     word_end * kWordBits)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ROIRasterCache::DrawPolygon(const CachedPolygon& cached,
+                                 const size_t row_begin, const size_t row_end,
+                                 const size_t bit_begin, const size_t bit_end) {
+  typedef PolygonScanCvter<double>::IntervalIn IntervalIn;
+  typedef PolygonScanCvter<double>::IntervalOut IntervalOut;
+  if (cached.max_x <= cached.min_x || cached.max_y <= cached.min_y) {
+    AERROR << "Invalid polygon";
+    return false;
+  }
+  const Eigen::Vector2d origin = Origin();
+  local_polygon_.resize(cached.polygon.size());
+  for (size_t i = 0; i < local_polygon_.size(); ++i) {
+    local_polygon_[i] = cached.polygon[i] - origin;
+  }
+
+  // scans at the row centers from the row of the polygon start, as
+  // DrawPolygonMask does. The scans stop at the polygon end or a row after
+  // the region, so that the rows of the region do not depend on where it
+  // clips the polygon.
+  const int64_t first_row =
+      std::max(static_cast<int64_t>(row_begin),
+               FloorToInt((cached.min_x - origin.x()) / cell_size_));
+  IntervalIn scans_range;
+  scans_range.first = (static_cast<double>(first_row) + 0.5) * cell_size_;
+  scans_range.second =
+      std::min(cached.max_x - origin.x(),
+               (static_cast<double>(row_end) + 0.75) * cell_size_);
+  if (scans_range.second <= scans_range.first + cell_size_) {
+    return true;
+  }
+  poly_scan_cvter_.Init(local_polygon_);
+  poly_scan_cvter_.ScansCvt(scans_range, PolygonScanCvter<double>::XMAJOR,
+                            cell_size_, &scans_intervals_);
+
+  for (size_t i = 0; i < scans_intervals_.size(); ++i) {
+    const int64_t row = first_row + static_cast<int64_t>(i);
+    if (row >= static_cast<int64_t>(row_end)) {
+      break;
+    }
+    for (const IntervalOut& scan_interval : scans_intervals_[i]) {
+      if (scan_interval.first > scan_interval.second) {
+        AERROR << "The input polygon is illegal(complex polygon)";
+        return false;
+      }
+      const int64_t first_bit = std::max(
+          static_cast<int64_t>(bit_begin),
+          FloorToInt((scan_interval.first - extend_dist_) / cell_size_));
+      const int64_t last_bit = std::min(
+          static_cast<int64_t>(bit_end) - 1,
+          FloorToInt((scan_interval.second + extend_dist_) / cell_size_));
+      if (first_bit <= last_bit) {
+        SetBits(static_cast<size_t>(row), static_cast<size_t>(first_bit),
+                static_cast<size_t>(last_bit));
+      }
+    }
+  }
+  return true;
+}
+
+void ROIRasterCache::SetBits(const size_t row, const size_t first_bit,
+                             const size_t last_bit) {
+  uint64_t* words = &words_[row * num_words_];
+  const size_t first_word = first_bit / kWordBits;
+  const size_t last_word = last_bit / kWordBits;
+  const uint64_t first_mask = static_cast<uint64_t>(-1)
+                              << (first_bit % kWordBits);
+  const uint64_t last_mask =
+      static_cast<uint64_t>(-1) >> (kWordBits - 1 - last_bit % kWordBits);
+  if (first_word == last_word) {
+    words[first_word] |= first_mask & last_mask;
+    return;
+  }
+  words[first_word] |= first_mask;
+  for (size_t word = first_word + 1; word < last_word; ++word) {
+    words[word] = static_cast<uint64_t>(-1);
+  }
+  words[last_word] |= last_mask;
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
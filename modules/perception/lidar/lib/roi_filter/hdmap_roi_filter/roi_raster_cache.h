@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Eigen/Core"
+#include "Eigen/Geometry"
+
+#include "modules/common/util/eigen_defs.h"
+#include "modules/perception/base/point_cloud.h"
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/bitmap2d.h"
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/polygon_scan_cvter.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+// @brief: roi raster of the map polygons on a world aligned grid, in a
+// window around the vehicle that is kept across frames. A polygon is
+// rasterized once, when it first shows up in a frame, and a moving vehicle
+// slides the window over whole rows and 64 bit words, rasterizing only the
+// cells the window slides onto.
+class ROIRasterCache {
+ public:
+  typedef PolygonScanCvter<double>::Polygon Polygon;
+
+  ROIRasterCache() = default;
+  ~ROIRasterCache() = default;
+
+  // @brief: the window covers range + margin around the vehicle, the cells
+  // are rows along x of cell_size and the polygons are extended along y by
+  // extend_dist, as in DrawPolygonMask with the edge table
+  void Init(const double range, const double cell_size, const double margin,
+            const double extend_dist);
+
+  // @brief: bring the raster up to date with the map polygons of a frame at
+  // the vehicle location. The polygons that are not cached yet are
+  // rasterized; a frame without any cached polygon, e.g. after a map switch,
+  // rebuilds the raster. return false if a polygon fails to rasterize.
+  bool Update(
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
+      const Eigen::Vector3d& location);
+
+  // @brief: check a world point, false out of the window
+  bool Check(const Eigen::Vector2d& world_point) const;
+
+  // @brief: append the indices in [begin, end) of the points in roi and in
+  // range of the pose translation, in index order. The points are in the
+  // lidar frame and the pose is lidar to world.
+  void FilterPoints(const base::PointFCloud& cloud,
+                    const Eigen::Affine3d& pose, const size_t begin,
+                    const size_t end, std::vector<int>* indices) const;
+
+  // @brief: resample the raster to the x major bitmap of map_size words
+  // whose first cell starts at location - range, the layout of the roi
+  // service, with the nearest cell of the raster
+  void CopyToBitmap(const Eigen::Vector3d& location,
+                    const Bitmap2D::Vec2ui& map_size,
+                    std::vector<uint64_t>* bitmap) const;
+
+  size_t num_polygons() const { return polygons_.size(); }
+  size_t num_rebuilds() const { return num_rebuilds_; }
+  size_t num_shifts() const { return num_shifts_; }
+
+ private:
+  struct CachedPolygon {
+    // world frame
+    Polygon polygon;
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double max_x = 0.0;
+    double max_y = 0.0;
+  };
+
+  static size_t PolygonKey(const base::PolygonDType& polygon);
+  static void AddPolygon(const base::PolygonDType& polygon_world,
+                         CachedPolygon* cached);
+
+  bool IsSet(const int64_t row, const int64_t col) const;
+
+  // the window cells starting at the first row and word covering location
+  int64_t RowBegin(const Eigen::Vector3d& location) const;
+  int64_t WordBegin(const Eigen::Vector3d& location) const;
+  Eigen::Vector2d Origin() const;
+  bool Covers(const Eigen::Vector3d& location) const;
+  bool Overlaps(const CachedPolygon& polygon, const Eigen::Vector2d& min_point,
+                const Eigen::Vector2d& max_point) const;
+
+  bool Rebuild(
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
+      const std::vector<size_t>& keys, const Eigen::Vector3d& location);
+  bool Shift(const Eigen::Vector3d& location);
+  // or the polygons into the rows [row_begin, row_end) and the words
+  // [word_begin, word_end) of the window
+  bool Rasterize(const size_t row_begin, const size_t row_end,
+                 const size_t word_begin, const size_t word_end,
+                 const std::vector<const CachedPolygon*>& polygons);
+  bool DrawPolygon(const CachedPolygon& cached, const size_t row_begin,
+                   const size_t row_end, const size_t bit_begin,
+                   const size_t bit_end);
+  // set the bits [first_bit, last_bit] of a row, a closed range
+  void SetBits(const size_t row, const size_t first_bit,
+               const size_t last_bit);
+
+  double range_ = 120.0;
+  double cell_size_ = 0.25;
+  double margin_ = 20.0;
+  double extend_dist_ = 0.0;
+
+  // window of num_rows_ rows of num_words_ words, the row of x in
+  // [row_begin_ * cell_size_, (row_begin_ + 1) * cell_size_) first and the
+  // bit of y in [64 * word_begin_ * cell_size_, ...) first
+  bool built_ = false;
+  int64_t row_begin_ = 0;
+  int64_t word_begin_ = 0;
+  size_t num_rows_ = 0;
+  size_t num_words_ = 0;
+  std::vector<uint64_t> words_;
+  std::vector<uint64_t> shifted_words_;
+
+  std::unordered_map<size_t, CachedPolygon> polygons_;
+  PolygonScanCvter<double> poly_scan_cvter_;
+  Polygon local_polygon_;
+  std::vector<std::vector<PolygonScanCvter<double>::IntervalOut>>
+      scans_intervals_;
+  std::vector<size_t> frame_keys_;
+  std::vector<const CachedPolygon*> draw_polygons_;
+
+  size_t num_rebuilds_ = 0;
+  size_t num_shifts_ = 0;
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
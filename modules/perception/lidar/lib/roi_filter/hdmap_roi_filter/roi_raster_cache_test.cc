@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar/lib/roi_filter/hdmap_roi_filter/roi_raster_cache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+using apollo::common::EigenVector;
+
+namespace {
+
+// a world offset as large as the utm coordinates of the maps
+constexpr double kWorldX = 440000.0;
+constexpr double kWorldY = 4430000.0;
+
+base::PolygonDType MakePolygon(const std::vector<double>& xys) {
+  base::PolygonDType polygon;
+  base::PointD point;
+  for (size_t i = 0; i + 1 < xys.size(); i += 2) {
+    point.x = kWorldX + xys[i];
+    point.y = kWorldY + xys[i + 1];
+    polygon.push_back(point);
+  }
+  return polygon;
+}
+
+// hexagons with slanted edges on a 40m grid
+std::vector<base::PolygonDType> MakeMap(const double min_xy,
+                                        const double max_xy) {
+  std::vector<base::PolygonDType> polygons;
+  for (double x = min_xy; x < max_xy; x += 40.0) {
+    for (double y = min_xy; y < max_xy; y += 40.0) {
+      polygons.push_back(MakePolygon({x + 3.1, y + 1.3, x + 31.7, y + 2.9,
+                                      x + 38.3, y + 17.1, x + 29.9, y + 36.7,
+                                      x + 5.3, y + 33.9, x + 1.7, y + 15.1}));
+    }
+  }
+  return polygons;
+}
+
+// the polygons the map query returns around the location
+EigenVector<base::PolygonDType*> QueryPolygons(
+    const Eigen::Vector3d& location, const double radius,
+    std::vector<base::PolygonDType>* polygons) {
+  EigenVector<base::PolygonDType*> result;
+  for (auto& polygon : *polygons) {
+    if (std::abs(polygon[0].x - location.x()) < radius &&
+        std::abs(polygon[0].y - location.y()) < radius) {
+      result.push_back(&polygon);
+    }
+  }
+  return result;
+}
+
+Eigen::Vector3d WorldLocation(const double x, const double y) {
+  return Eigen::Vector3d(kWorldX + x, kWorldY + y, 0.0);
+}
+
+}  // namespace
+
+TEST(ROIRasterCacheTest, filter_points) {
+  std::vector<base::PolygonDType> polygons = {
+      MakePolygon({-10.0, -5.0, 30.0, -5.0, 30.0, 5.0, -10.0, 5.0})};
+  EigenVector<base::PolygonDType*> polygons_world = {&polygons[0]};
+  const Eigen::Vector3d location = WorldLocation(0.0, 0.0);
+
+  ROIRasterCache cache;
+  cache.Init(50.0, 0.25, 10.0, 0.0);
+  ASSERT_TRUE(cache.Update(polygons_world, location));
+  EXPECT_EQ(cache.num_polygons(), 1);
+  EXPECT_TRUE(cache.Check(location.head<2>()));
+  EXPECT_FALSE(cache.Check(WorldLocation(0.0, 6.0).head<2>()));
+
+  // the lidar heads along y
+  Eigen::Affine3d pose = Eigen::Affine3d::Identity();
+  pose.translate(location);
+  pose.rotate(Eigen::AngleAxisd(M_PI / 2.0, Eigen::Vector3d::UnitZ()));
+  base::PointFCloud cloud;
+  const std::vector<std::pair<float, float>> lidar_points = {
+      {0.0f, 0.0f},    {1.0f, -20.0f}, {-3.0f, 9.0f},  {5.5f, 9.0f},
+      {0.0f, -29.0f},  {0.0f, 11.0f},  {6.0f, 0.0f},   {-4.9f, -25.0f},
+      {0.0f, -60.0f}};
+  const std::vector<int> expected_indices = {0, 1, 2, 4, 7};
+  for (const auto& lidar_point : lidar_points) {
+    base::PointF point;
+    point.x = lidar_point.first;
+    point.y = lidar_point.second;
+    point.z = 1.0f;
+    cloud.push_back(point);
+  }
+  for (size_t begin = 0; begin < 4; ++begin) {
+    std::vector<int> indices;
+    cache.FilterPoints(cloud, pose, begin, cloud.size(), &indices);
+    std::vector<int> expected;
+    for (const int index : expected_indices) {
+      if (index >= static_cast<int>(begin)) {
+        expected.push_back(index);
+      }
+    }
+    EXPECT_EQ(indices, expected);
+  }
+}
+
+TEST(ROIRasterCacheTest, incremental_matches_rebuild) {
+  std::vector<base::PolygonDType> polygons = MakeMap(-200.0, 600.0);
+  const double range = 60.0;
+  const double cell_size = 0.25;
+  const double query_radius = 110.0;
+  ROIRasterCache cache;
+  cache.Init(range, cell_size, 10.0, 0.5);
+
+  Bitmap2D bitmap;
+  bitmap.Init(Eigen::Vector2d(-range, -range), Eigen::Vector2d(range, range),
+              Eigen::Vector2d(cell_size, cell_size));
+  std::vector<uint64_t> cached_bitmap;
+  std::vector<uint64_t> rebuilt_bitmap;
+  for (int frame = 0; frame < 150; ++frame) {
+    const Eigen::Vector3d location =
+        WorldLocation(1.7 * frame, 1.1 * frame);
+    ASSERT_TRUE(cache.Update(QueryPolygons(location, query_radius, &polygons),
+                             location));
+    ROIRasterCache rebuilt_cache;
+    rebuilt_cache.Init(range, cell_size, 10.0, 0.5);
+    ASSERT_TRUE(rebuilt_cache.Update(
+        QueryPolygons(location, query_radius, &polygons), location));
+
+    cache.CopyToBitmap(location, bitmap.map_size(), &cached_bitmap);
+    rebuilt_cache.CopyToBitmap(location, bitmap.map_size(), &rebuilt_bitmap);
+    size_t num_set_bits = 0;
+    for (const uint64_t word : cached_bitmap) {
+      num_set_bits += __builtin_popcountll(word);
+    }
+    EXPECT_GT(num_set_bits, 0);
+    EXPECT_TRUE(cached_bitmap == rebuilt_bitmap) << "frame " << frame;
+  }
+  EXPECT_EQ(cache.num_rebuilds(), 1);
+  EXPECT_GT(cache.num_shifts(), 5);
+}
+
+TEST(ROIRasterCacheTest, copy_to_bitmap) {
+  std::vector<base::PolygonDType> polygons = MakeMap(-80.0, 80.0);
+  const double range = 40.0;
+  const double cell_size = 0.25;
+  ROIRasterCache cache;
+  cache.Init(range, cell_size, 8.0, 0.0);
+  const Eigen::Vector3d location = WorldLocation(13.37, -7.77);
+  ASSERT_TRUE(cache.Update(QueryPolygons(location, 200.0, &polygons),
+                           location));
+
+  Bitmap2D bitmap;
+  bitmap.Init(Eigen::Vector2d(-range, -range), Eigen::Vector2d(range, range),
+              Eigen::Vector2d(cell_size, cell_size));
+  const Bitmap2D::Vec2ui& map_size = bitmap.map_size();
+  std::vector<uint64_t> words;
+  cache.CopyToBitmap(location, map_size, &words);
+  ASSERT_EQ(words.size(), map_size[0] * map_size[1]);
+  // the cell centers of the bitmap against the raster
+  for (size_t row = 0; row < bitmap.dims()[0]; ++row) {
+    for (size_t col = 0; col < bitmap.dims()[1]; ++col) {
+      const Eigen::Vector2d center =
+          location.head<2>() - Eigen::Vector2d(range, range) +
+          Eigen::Vector2d(row + 0.5, col + 0.5) * cell_size;
+      const bool is_set =
+          (words[row * map_size[1] + (col >> 6)] >> (col & 63)) & 1;
+      EXPECT_EQ(is_set, cache.Check(center)) << row << " " << col;
+    }
+  }
+}
+
+TEST(ROIRasterCacheTest, map_switch) {
+  std::vector<base::PolygonDType> polygons = MakeMap(-80.0, 80.0);
+  std::vector<base::PolygonDType> other_polygons = {
+      MakePolygon({-2.0, -2.0, 2.0, -2.0, 2.0, 2.0, -2.0, 2.0})};
+  EigenVector<base::PolygonDType*> other_polygons_world = {
+      &other_polygons[0]};
+  const Eigen::Vector3d location = WorldLocation(20.0, 20.0);
+  ROIRasterCache cache;
+  cache.Init(40.0, 0.25, 8.0, 0.0);
+  ASSERT_TRUE(cache.Update(QueryPolygons(location, 200.0, &polygons),
+                           location));
+  EXPECT_TRUE(cache.Check(WorldLocation(20.0, 20.0).head<2>()));
+  EXPECT_EQ(cache.num_rebuilds(), 1);
+
+  ASSERT_TRUE(cache.Update(other_polygons_world, location));
+  EXPECT_EQ(cache.num_rebuilds(), 2);
+  EXPECT_EQ(cache.num_polygons(), 1);
+  EXPECT_FALSE(cache.Check(WorldLocation(20.0, 20.0).head<2>()));
+  EXPECT_TRUE(cache.Check(WorldLocation(0.0, 0.0).head<2>()));
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
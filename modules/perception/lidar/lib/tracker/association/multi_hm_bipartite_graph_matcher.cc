@@ -38,6 +38,7 @@ void MultiHmBipartiteGraphMatcher::Match(
     std::vector<size_t> *unassigned_cols) {
   common::GatedHungarianMatcher<float>::OptimizeFlag opt_flag =
       common::GatedHungarianMatcher<float>::OptimizeFlag::OPTMIN;
+  optimizer_.set_use_sparse_solver(options.use_sparse_solver);
   optimizer_.Match(options.cost_thresh, options.bound_value, opt_flag,
                    assignments, unassigned_rows, unassigned_cols);
 }
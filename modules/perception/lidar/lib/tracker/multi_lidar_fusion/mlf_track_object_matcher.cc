@@ -63,6 +63,7 @@ bool MlfTrackObjectMatcher::Init(
 
   bound_value_ = config.bound_value();
   max_match_distance_ = config.max_match_distance();
+  use_sparse_solver_ = config.use_sparse_solver();
   return true;
 }
 
@@ -90,6 +91,7 @@ bool MlfTrackObjectMatcher::Init(const PluginConfig& plugin_config) {
 
   bound_value_ = config.bound_value();
   max_match_distance_ = config.max_match_distance();
+  use_sparse_solver_ = config.use_sparse_solver();
   return true;
 }
 
@@ -114,6 +116,7 @@ void MlfTrackObjectMatcher::Match(
   BipartiteGraphMatcherOptions matcher_options;
   matcher_options.cost_thresh = max_match_distance_;
   matcher_options.bound_value = bound_value_;
+  matcher_options.use_sparse_solver = use_sparse_solver_;
 
   BaseBipartiteGraphMatcher *matcher =
       objects[0]->is_background ? background_matcher_ : foreground_matcher_;
@@ -82,6 +82,7 @@ class MlfTrackObjectMatcher : public pipeline::Plugin {
 
   float bound_value_ = 100.f;
   float max_match_distance_ = 4.0f;
+  bool use_sparse_solver_ = false;
   bool use_semantic_map = false;
 
  private:
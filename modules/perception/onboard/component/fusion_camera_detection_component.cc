@@ -28,6 +28,7 @@
 #include "modules/common/util/string_util.h"
 #include "modules/perception/common/perception_gflags.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/onboard/common_flags/common_flags.h"
 #include "modules/perception/onboard/component/camera_perception_viz_message.h"
 
@@ -674,6 +675,8 @@ int FusionCameraDetectionComponent::InternalProc(
     apollo::perception::PerceptionObstacles *out_message) {
   const double msg_timestamp =
       in_message->measurement_time() + timestamp_offset_;
+  lib::LatencyFrameScope frame_scope("camera_detection", camera_name,
+                                     msg_timestamp);
   const int frame_size = static_cast<int>(camera_frames_.size());
   camera::CameraFrame &camera_frame = camera_frames_[frame_id_ % frame_size];
 
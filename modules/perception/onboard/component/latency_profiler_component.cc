@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/onboard/component/latency_profiler_component.h"
+
+#include <string>
+
+#include "modules/common/util/message_util.h"
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+bool LatencyProfilerComponent::Init() {
+  writer_ = node_->CreateWriter<PerceptionLatencySummary>(
+      "/apollo/perception/latency_summary");
+  trace_request_reader_ = node_->CreateReader<PerceptionLatencyTraceRequest>(
+      "/apollo/perception/latency_trace_request",
+      [this](const std::shared_ptr<PerceptionLatencyTraceRequest>& request) {
+        OnTraceRequest(request);
+      });
+  return true;
+}
+
+bool LatencyProfilerComponent::Proc() {
+  std::shared_ptr<PerceptionLatencySummary> summary(
+      new PerceptionLatencySummary);
+  lib::LatencyProfiler::Instance()->Summarize(summary.get());
+  common::util::FillHeader(node_->Name(), summary.get());
+  writer_->Write(summary);
+  return true;
+}
+
+void LatencyProfilerComponent::OnTraceRequest(
+    const std::shared_ptr<PerceptionLatencyTraceRequest>& request) {
+  const std::string file_path = request->file_path().empty()
+                                    ? FLAGS_perception_latency_trace_file
+                                    : request->file_path();
+  lib::LatencyProfiler::Instance()->DumpChromeTrace(file_path);
+}
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <memory>
+
+#include "cyber/component/timer_component.h"
+#include "cyber/cyber.h"
+#include "modules/perception/proto/perception_latency.pb.h"
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+// Publishes the latency summary of the perception stages profiled in this
+// process at each timer interval, and dumps the Chrome trace of the latest
+// frames on request. It is in no production dag: add it as a timer component
+// of the perception dag and set --enable_perception_latency_profiler to use.
+class LatencyProfilerComponent : public cyber::TimerComponent {
+ public:
+  LatencyProfilerComponent() = default;
+  ~LatencyProfilerComponent() = default;
+
+  bool Init() override;
+  bool Proc() override;
+
+ private:
+  void OnTraceRequest(
+      const std::shared_ptr<PerceptionLatencyTraceRequest>& request);
+
+ private:
+  std::shared_ptr<cyber::Writer<PerceptionLatencySummary>> writer_;
+  std::shared_ptr<cyber::Reader<PerceptionLatencyTraceRequest>>
+      trace_request_reader_;
+};  // class LatencyProfilerComponent
+
+CYBER_REGISTER_COMPONENT(LatencyProfilerComponent);
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
@@ -18,9 +18,11 @@
 #include "cyber/time/clock.h"
 #include "modules/common/util/string_util.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/lidar/common/lidar_error_code.h"
 #include "modules/perception/lidar/common/lidar_frame_pool.h"
 #include "modules/perception/lidar/common/lidar_log.h"
+#include "modules/perception/lidar/common/point_cloud_converter.h"
 #include "modules/perception/onboard/common_flags/common_flags.h"
 
 using ::apollo::cyber::Clock;
@@ -118,18 +120,7 @@ bool LidarDetectionComponent::InitAlgorithmPlugin() {
 bool LidarDetectionComponent::ConvertCloud(
     const std::shared_ptr<const drivers::PointCloud>& from,
     std::shared_ptr<base::AttributePointCloud<base::PointF>> to) {
-  to->set_timestamp(from->measurement_time());
-  to->reserve(from->point_size());
-  base::PointF point;
-  for (int i = 0; i < from->point_size(); ++i) {
-    const apollo::drivers::PointXYZIT& pt = from->point(i);
-    point.x = pt.x();
-    point.y = pt.y();
-    point.z = pt.z();
-    point.intensity = static_cast<float>(pt.intensity());
-    to->push_back(point, static_cast<double>(pt.timestamp()) * 1e-9,
-                  std::numeric_limits<float>::max(), i, 0);
-  }
+  lidar::ConvertPointCloud(*from, to.get());
   return true;
 }
 
@@ -138,6 +129,8 @@ bool LidarDetectionComponent::InternalProc(
     const std::shared_ptr<LidarFrameMessage>& out_message) {
   uint32_t seq_num = seq_num_.fetch_add(1);
   const double timestamp = in_message->measurement_time();
+  lib::LatencyFrameScope frame_scope("lidar_detection", sensor_name_,
+                                     timestamp);
   const double cur_time = Clock::NowInSeconds();
   const double start_latency = (cur_time - timestamp) * 1e3;
   AINFO << std::setprecision(16) << "FRAME_STATISTICS:Lidar:Start:msg_time["
@@ -19,6 +19,7 @@
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/base/object_pool_types.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/lidar/common/lidar_error_code.h"
 #include "modules/perception/lidar/common/lidar_log.h"
 
@@ -107,6 +108,8 @@ bool LidarTrackingComponent::InternalProc(
     const std::shared_ptr<SensorFrameMessage>& out_message) {
   auto& sensor_name = in_message->lidar_frame_->sensor_info.name;
   PERF_FUNCTION_WITH_INDICATOR(sensor_name);
+  lib::LatencyFrameScope frame_scope("lidar_tracking", sensor_name,
+                                     in_message->timestamp_);
   out_message->timestamp_ = in_message->timestamp_;
   out_message->lidar_timestamp_ = in_message->lidar_timestamp_;
   out_message->seq_num_ = in_message->seq_num_;
@@ -119,13 +122,14 @@ bool LidarTrackingComponent::InternalProc(
     return true;
   }
 
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   auto& lidar_frame = in_message->lidar_frame_;
   pipeline::DataFrame data_frame;
   data_frame.lidar_frame = lidar_frame.get();
   bool res = tracker_->Process(&data_frame);
 
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "recognition_1::track_obstacle");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name,
+                                           "recognition_1::track_obstacle");
   if (!res) {
     out_message->error_code_ =
         apollo::common::ErrorCode::PERCEPTION_ERROR_PROCESS;
@@ -157,7 +161,8 @@ bool LidarTrackingComponent::InternalProc(
   frame->sensor2world_pose = lidar_frame->lidar2world_pose;
   frame->lidar_frame_supplement.on_use = true;
   frame->lidar_frame_supplement.cloud_ptr = lidar_frame->cloud;
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "recognition_2::fill_out_message");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name,
+                                           "recognition_2::fill_out_message");
 
   const double end_timestamp = Clock::NowInSeconds();
   const double end_latency = (end_timestamp - in_message->timestamp_) * 1e3;
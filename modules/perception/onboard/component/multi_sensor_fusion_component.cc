@@ -18,6 +18,7 @@
 #include "cyber/time/clock.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/base/object_pool_types.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/onboard/common_flags/common_flags.h"
 #include "modules/perception/onboard/msg_serializer/msg_serializer.h"
 
@@ -128,7 +129,9 @@ bool MultiSensorFusionComponent::InternalProc(
     s_seq_num_++;
   }
 
-  PERF_BLOCK_START();
+  lib::LatencyFrameScope frame_scope("fusion", in_message->sensor_id_,
+                                     in_message->timestamp_);
+  PERCEPTION_PERF_BLOCK_START();
   const double timestamp = in_message->timestamp_;
   const uint64_t lidar_timestamp = in_message->lidar_timestamp_;
   std::vector<base::ObjectPtr> valid_objects;
@@ -168,7 +171,8 @@ bool MultiSensorFusionComponent::InternalProc(
   //   return false;
   // }
 
-  PERF_BLOCK_END_WITH_INDICATOR("fusion_process", in_message->sensor_id_);
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(in_message->sensor_id_,
+                                           "fusion_process");
 
   if (in_message->sensor_id_ != fusion_main_sensor_) {
     return true;
@@ -195,7 +199,8 @@ bool MultiSensorFusionComponent::InternalProc(
   } else {
     valid_objects.assign(fused_objects.begin(), fused_objects.end());
   }
-  PERF_BLOCK_END_WITH_INDICATOR("fusion_roi_check", in_message->sensor_id_);
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(in_message->sensor_id_,
+                                           "fusion_roi_check");
 
   // produce visualization msg
   if (FLAGS_obs_enable_visualization) {
@@ -218,8 +223,8 @@ bool MultiSensorFusionComponent::InternalProc(
     AERROR << "Failed to gen PerceptionObstacles object.";
     return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR("fusion_serialize_message",
-                                in_message->sensor_id_);
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(in_message->sensor_id_,
+                                           "fusion_serialize_message");
 
   const double cur_time = ::apollo::cyber::Clock::NowInSeconds();
   const double latency = (cur_time - timestamp) * 1e3;
@@ -18,6 +18,7 @@
 #include "cyber/time/clock.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/common/sensor_manager/sensor_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 
 using Clock = apollo::cyber::Clock;
 
@@ -102,6 +103,8 @@ bool RadarDetectionComponent::InternalProc(
     const std::shared_ptr<ContiRadar>& in_message,
     std::shared_ptr<SensorFrameMessage> out_message) {
   PERF_FUNCTION_WITH_INDICATOR(radar_info_.name);
+  lib::LatencyFrameScope frame_scope("radar_detection", radar_info_.name,
+                                     in_message->header().timestamp_sec());
   ContiRadar raw_obstacles = *in_message;
   {
     std::unique_lock<std::mutex> lock(_mutex);
@@ -113,13 +116,14 @@ bool RadarDetectionComponent::InternalProc(
   AINFO << "FRAME_STATISTICS:Radar:Start:msg_time[" << timestamp
         << "]:cur_time[" << cur_time << "]:cur_latency[" << start_latency
         << "]";
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   // Init preprocessor_options
   radar::PreprocessorOptions preprocessor_options;
   ContiRadar corrected_obstacles;
   radar_preprocessor_->Preprocess(raw_obstacles, preprocessor_options,
                                   &corrected_obstacles);
-  PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "radar_preprocessor");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name,
+                                           "radar_preprocessor");
   timestamp = corrected_obstacles.header().timestamp_sec();
 
   out_message->timestamp_ = timestamp;
@@ -144,7 +148,8 @@ bool RadarDetectionComponent::InternalProc(
     AERROR << "Failed to get radar2novatel trans at time: " << timestamp;
     return true;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "GetSensor2worldTrans");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name,
+                                           "GetSensor2worldTrans");
   Eigen::Matrix4d radar2world_pose = radar_trans.matrix();
   options.detector_options.radar2world_pose = &radar2world_pose;
   Eigen::Matrix4d radar2novatel_trans_m = radar2novatel_trans.matrix();
@@ -155,7 +160,7 @@ bool RadarDetectionComponent::InternalProc(
     AERROR << "Failed to call get_car_speed. [timestamp: " << timestamp;
     // return false;
   }
-  PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "GetCarSpeed");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "GetCarSpeed");
   // Init roi_filter_options
   base::PointD position;
   position.x = radar_trans(0, 3);
@@ -166,7 +171,8 @@ bool RadarDetectionComponent::InternalProc(
     hdmap_input_->GetRoiHDMapStruct(position, radar_forward_distance_,
                                     options.roi_filter_options.roi);
   }
-  PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "GetRoiHDMapStruct");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name,
+                                           "GetRoiHDMapStruct");
   // Init object_filter_options
   // Init track_options
   // Init object_builder_options
@@ -190,7 +196,8 @@ bool RadarDetectionComponent::InternalProc(
   AINFO << "FRAME_STATISTICS:Radar:End:msg_time["
         << in_message->header().timestamp_sec() << "]:cur_time["
         << end_timestamp << "]:cur_latency[" << end_latency << "]";
-  PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name, "radar_perception");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(radar_info_.name,
+                                           "radar_perception");
 
   return true;
 }
@@ -15,16 +15,16 @@
  *****************************************************************************/
 #pragma once
 
-#include <limits>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include <boost/circular_buffer.hpp>
 #include "gflags/gflags.h"
 
 #include "cyber/cyber.h"
+#include "modules/perception/onboard/msg_buffer/msg_ring.h"
 
 namespace apollo {
 namespace perception {
@@ -33,6 +33,10 @@ namespace onboard {
 DECLARE_int32(obs_msg_buffer_size);
 DECLARE_double(obs_buffer_match_precision);
 
+// The subscriber callback appends to a MsgRing, which the lookups read
+// without locking, so they neither wait for the callback nor for each other.
+// Messages are expected in measurement time order, an older message than
+// the latest one is dropped.
 template <class T>
 class MsgBuffer {
  public:
@@ -58,15 +62,15 @@ class MsgBuffer {
 
  private:
   void MsgCallback(const ConstPtr& msg);
+  void LogOutOfRange(double timestamp, MsgRingStatus status);
 
  private:
   std::string node_name_;
   std::unique_ptr<cyber::Node> node_;
   std::shared_ptr<cyber::Reader<T>> msg_subscriber_;
-  std::mutex buffer_mutex_;
 
-  bool init_ = false;
-  boost::circular_buffer<ObjectPair> buffer_queue_;
+  std::atomic<bool> init_{false};
+  MsgRing<T> buffer_queue_;
 };
 
 template <class T>
@@ -79,115 +83,84 @@ void MsgBuffer<T>::Init(const std::string& channel, const std::string& name) {
   }
   node_.reset(apollo::cyber::CreateNode(node_name_).release());
 
+  // resized before the callback may write to it
+  buffer_queue_.Reset(FLAGS_obs_msg_buffer_size);
+
   std::function<void(const ConstPtr&)> register_call =
       std::bind(&MsgBuffer<T>::MsgCallback, this, std::placeholders::_1);
   msg_subscriber_ = node_->CreateReader<T>(channel, register_call);
-
-  std::lock_guard<std::mutex> lock(buffer_mutex_);
-  buffer_queue_.set_capacity(FLAGS_obs_msg_buffer_size);
-  init_ = true;
+  init_.store(true, std::memory_order_release);
 }
 
 template <class T>
 void MsgBuffer<T>::MsgCallback(const ConstPtr& msg) {
-  std::lock_guard<std::mutex> lock(buffer_mutex_);
   double timestamp = msg->measurement_time();
-  buffer_queue_.push_back(std::make_pair(timestamp, msg));
+  if (!buffer_queue_.Push(timestamp, msg)) {
+    AWARN << "Dropped message of " << node_name_ << " at " << timestamp
+          << ", older than the latest one.";
+  }
+}
+
+template <class T>
+void MsgBuffer<T>::LogOutOfRange(const double timestamp,
+                                 const MsgRingStatus status) {
+  double oldest = 0.0;
+  double latest = 0.0;
+  buffer_queue_.Bounds(&oldest, &latest);
+  if (status == MsgRingStatus::EMPTY) {
+    AERROR << "Message buffer is empty.";
+  } else if (status == MsgRingStatus::TOO_EARLY) {
+    AERROR << "Your timestamp (" << timestamp << ") is earlier than the oldest "
+           << "timestamp (" << oldest << ").";
+  } else if (status == MsgRingStatus::TOO_LATE) {
+    AERROR << "Your timestamp (" << timestamp << ") is newer than the latest "
+           << "timestamp (" << latest << ").";
+  }
 }
 
 template <class T>
 int MsgBuffer<T>::LookupNearest(double timestamp, ConstPtr* msg) {
-  std::lock_guard<std::mutex> lock(buffer_mutex_);
-  if (!init_) {
+  if (!init_.load(std::memory_order_acquire)) {
     AERROR << "msg buffer is uninitialized.";
     return false;
   }
-  if (buffer_queue_.empty()) {
-    AERROR << "msg buffer is empty.";
-    return false;
-  }
-  if (buffer_queue_.front().first - FLAGS_obs_buffer_match_precision >
-      timestamp) {
-    AERROR << "Your timestamp (" << timestamp
-           << ") is earlier than the oldest timestamp ("
-           << buffer_queue_.front().first << ").";
-    return false;
-  }
-  if (buffer_queue_.back().first + FLAGS_obs_buffer_match_precision <
-      timestamp) {
-    AERROR << "Your timestamp (" << timestamp
-           << ") is newer than the latest timestamp ("
-           << buffer_queue_.back().first << ").";
+  const MsgRingStatus status = buffer_queue_.LookupNearest(
+      timestamp, FLAGS_obs_buffer_match_precision, msg);
+  if (status != MsgRingStatus::OK) {
+    LogOutOfRange(timestamp, status);
     return false;
   }
-
-  // loop to find nearest
-  double distance = std::numeric_limits<double>::max();
-  int idx = static_cast<int>(buffer_queue_.size()) - 1;
-  for (; idx >= 0; --idx) {
-    double temp_distance = fabs(timestamp - buffer_queue_[idx].first);
-    if (temp_distance >= distance) {
-      break;
-    }
-    distance = temp_distance;
-  }
-  *msg = buffer_queue_[idx + 1].second;
-
   return true;
 }
 
 template <class T>
 int MsgBuffer<T>::LookupLatest(ConstPtr* msg) {
-  std::lock_guard<std::mutex> lock(buffer_mutex_);
-  if (!init_) {
+  if (!init_.load(std::memory_order_acquire)) {
     AERROR << "Message buffer is uninitialized.";
     return false;
   }
-  if (buffer_queue_.empty()) {
+  ObjectPair latest;
+  if (!buffer_queue_.LookupLatest(&latest)) {
     AERROR << "Message buffer is empty.";
     return false;
   }
-  *msg = buffer_queue_.back().second;
+  *msg = latest.second;
   return true;
 }
 
 template <class T>
 int MsgBuffer<T>::LookupPeriod(const double timestamp, const double period,
                                std::vector<ObjectPair>* msgs) {
-  std::lock_guard<std::mutex> lock(buffer_mutex_);
-  if (!init_) {
+  if (!init_.load(std::memory_order_acquire)) {
     AERROR << "Message buffer is uninitialized.";
     return false;
   }
-  if (buffer_queue_.empty()) {
-    AERROR << "Message buffer is empty.";
-    return false;
-  }
-  if (buffer_queue_.front().first - FLAGS_obs_buffer_match_precision >
-      timestamp) {
-    AERROR << "Your timestamp (" << timestamp << ") is earlier than the oldest "
-           << "timestamp (" << buffer_queue_.front().first << ").";
+  const MsgRingStatus status = buffer_queue_.LookupPeriod(
+      timestamp, period, FLAGS_obs_buffer_match_precision, msgs);
+  if (status != MsgRingStatus::OK) {
+    LogOutOfRange(timestamp, status);
     return false;
   }
-  if (buffer_queue_.back().first + FLAGS_obs_buffer_match_precision <
-      timestamp) {
-    AERROR << "Your timestamp (" << timestamp << ") is newer than the latest "
-           << "timestamp (" << buffer_queue_.back().first << ").";
-    return false;
-  }
-
-  const double lower_timestamp = timestamp - period;
-  const double upper_timestamp = timestamp + period;
-  for (const auto& obj_pair : buffer_queue_) {
-    if (obj_pair.first < lower_timestamp) {
-      continue;
-    }
-    if (obj_pair.first > upper_timestamp) {
-      break;
-    }
-    msgs->push_back(obj_pair);
-  }
-
   return true;
 }
 
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+enum class MsgRingStatus { OK, EMPTY, TOO_EARLY, TOO_LATE };
+
+// @brief: the latest capacity messages in timestamp order, appended by a
+//         single writer and looked up by any number of readers without
+//         locks. A reader binary searches the timestamps and checks against
+//         the write counters (a seqlock) that no message it read was
+//         overwritten meanwhile, or reads again. There are more slots than
+//         the capacity, a power of two of them, so that the message being
+//         written is never one a reader may look at, and readers only read
+//         again if the writer wrapped around while they were reading.
+template <class T>
+class MsgRing {
+ public:
+  typedef std::shared_ptr<T const> ConstPtr;
+  typedef std::pair<double, ConstPtr> ObjectPair;
+
+ public:
+  explicit MsgRing(const size_t capacity) { Reset(capacity); }
+  ~MsgRing() = default;
+
+  MsgRing(const MsgRing&) = delete;
+  MsgRing& operator=(const MsgRing&) = delete;
+
+  // drops all messages, must not run along with other calls
+  void Reset(size_t capacity);
+
+  size_t capacity() const { return capacity_; }
+
+  // single writer, fails if the message is older than the latest one
+  bool Push(double timestamp, const ConstPtr& msg);
+
+  // timestamps of the oldest and the latest messages
+  bool Bounds(double* oldest, double* latest) const;
+  bool LookupLatest(ObjectPair* msg) const;
+  // nearest message to timestamp, the latest one of equally near messages.
+  // TOO_EARLY or TOO_LATE when timestamp is more than precision out of the
+  // buffered timestamps
+  MsgRingStatus LookupNearest(double timestamp, double precision,
+                              ConstPtr* msg) const;
+  // appends the messages in [timestamp - period, timestamp + period]
+  MsgRingStatus LookupPeriod(double timestamp, double period,
+                             double precision,
+                             std::vector<ObjectPair>* msgs) const;
+
+ private:
+  struct Slot {
+    std::atomic<double> timestamp{0.0};
+    // accessed with the std::atomic_load/atomic_store overloads
+    ConstPtr msg;
+  };
+
+  // runs read(begin, end) on the messages [begin, end) until no write
+  // overwrote any of them
+  template <class Reader>
+  void Read(const Reader& read) const;
+
+  const Slot& slot(const uint64_t index) const {
+    return slots_[index & slot_mask_];
+  }
+  double Timestamp(const uint64_t index) const {
+    return slot(index).timestamp.load(std::memory_order_relaxed);
+  }
+  ConstPtr Msg(const uint64_t index) const {
+    return std::atomic_load(&slot(index).msg);
+  }
+  // first message in [begin, end) later than timestamp
+  uint64_t UpperBound(uint64_t begin, uint64_t end, double timestamp) const;
+  // first message in [begin, end) not earlier than timestamp
+  uint64_t LowerBound(uint64_t begin, uint64_t end, double timestamp) const;
+
+ private:
+  size_t capacity_ = 0;
+  size_t slot_count_ = 0;
+  uint64_t slot_mask_ = 0;
+  std::unique_ptr<Slot[]> slots_;
+  // messages whose write started, and finished
+  std::atomic<uint64_t> begin_count_{0};
+  std::atomic<uint64_t> end_count_{0};
+};
+
+template <class T>
+void MsgRing<T>::Reset(const size_t capacity) {
+  capacity_ = std::max<size_t>(capacity, 1);
+  slot_count_ = 1;
+  while (slot_count_ <= capacity_) {
+    slot_count_ <<= 1;
+  }
+  slot_mask_ = slot_count_ - 1;
+  slots_.reset(new Slot[slot_count_]);
+  begin_count_.store(0);
+  end_count_.store(0);
+}
+
+template <class T>
+bool MsgRing<T>::Push(const double timestamp, const ConstPtr& msg) {
+  const uint64_t count = end_count_.load(std::memory_order_relaxed);
+  if (count > 0 && timestamp < Timestamp(count - 1)) {
+    return false;
+  }
+  begin_count_.store(count + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  Slot& next = slots_[count & slot_mask_];
+  next.timestamp.store(timestamp, std::memory_order_relaxed);
+  std::atomic_store(&next.msg, msg);
+  end_count_.store(count + 1, std::memory_order_release);
+  return true;
+}
+
+template <class T>
+template <class Reader>
+void MsgRing<T>::Read(const Reader& read) const {
+  while (true) {
+    const uint64_t end = end_count_.load(std::memory_order_acquire);
+    const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+    read(begin, end);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // the write of message n overwrites message n - slot_count_
+    if (begin_count_.load(std::memory_order_relaxed) <= begin + slot_count_) {
+      return;
+    }
+  }
+}
+
+template <class T>
+uint64_t MsgRing<T>::UpperBound(uint64_t begin, uint64_t end,
+                                const double timestamp) const {
+  while (begin < end) {
+    const uint64_t middle = begin + (end - begin) / 2;
+    if (Timestamp(middle) > timestamp) {
+      end = middle;
+    } else {
+      begin = middle + 1;
+    }
+  }
+  return begin;
+}
+
+template <class T>
+uint64_t MsgRing<T>::LowerBound(uint64_t begin, uint64_t end,
+                                const double timestamp) const {
+  while (begin < end) {
+    const uint64_t middle = begin + (end - begin) / 2;
+    if (Timestamp(middle) >= timestamp) {
+      end = middle;
+    } else {
+      begin = middle + 1;
+    }
+  }
+  return begin;
+}
+
+template <class T>
+bool MsgRing<T>::Bounds(double* oldest, double* latest) const {
+  bool found = false;
+  Read([&](const uint64_t begin, const uint64_t end) {
+    found = begin < end;
+    if (found) {
+      *oldest = Timestamp(begin);
+      *latest = Timestamp(end - 1);
+    }
+  });
+  return found;
+}
+
+template <class T>
+bool MsgRing<T>::LookupLatest(ObjectPair* msg) const {
+  bool found = false;
+  Read([&](const uint64_t begin, const uint64_t end) {
+    found = begin < end;
+    if (found) {
+      *msg = std::make_pair(Timestamp(end - 1), Msg(end - 1));
+    }
+  });
+  return found;
+}
+
+template <class T>
+MsgRingStatus MsgRing<T>::LookupNearest(const double timestamp,
+                                        const double precision,
+                                        ConstPtr* msg) const {
+  MsgRingStatus status = MsgRingStatus::EMPTY;
+  Read([&](const uint64_t begin, const uint64_t end) {
+    if (begin == end) {
+      status = MsgRingStatus::EMPTY;
+      return;
+    }
+    if (Timestamp(begin) - precision > timestamp) {
+      status = MsgRingStatus::TOO_EARLY;
+      return;
+    }
+    if (Timestamp(end - 1) + precision < timestamp) {
+      status = MsgRingStatus::TOO_LATE;
+      return;
+    }
+    const uint64_t later = UpperBound(begin, end, timestamp);
+    uint64_t nearest = end - 1;
+    if (later < end) {
+      const double later_timestamp = Timestamp(later);
+      if (later > begin &&
+          timestamp - Timestamp(later - 1) < later_timestamp - timestamp) {
+        nearest = later - 1;
+      } else {
+        nearest = UpperBound(later, end, later_timestamp) - 1;
+      }
+    }
+    *msg = Msg(nearest);
+    status = MsgRingStatus::OK;
+  });
+  return status;
+}
+
+template <class T>
+MsgRingStatus MsgRing<T>::LookupPeriod(const double timestamp,
+                                       const double period,
+                                       const double precision,
+                                       std::vector<ObjectPair>* msgs) const {
+  MsgRingStatus status = MsgRingStatus::EMPTY;
+  const size_t msgs_size = msgs->size();
+  Read([&](const uint64_t begin, const uint64_t end) {
+    msgs->resize(msgs_size);
+    if (begin == end) {
+      status = MsgRingStatus::EMPTY;
+      return;
+    }
+    if (Timestamp(begin) - precision > timestamp) {
+      status = MsgRingStatus::TOO_EARLY;
+      return;
+    }
+    if (Timestamp(end - 1) + precision < timestamp) {
+      status = MsgRingStatus::TOO_LATE;
+      return;
+    }
+    const uint64_t lower = LowerBound(begin, end, timestamp - period);
+    const uint64_t upper = UpperBound(lower, end, timestamp + period);
+    for (uint64_t i = lower; i < upper; ++i) {
+      msgs->emplace_back(Timestamp(i), Msg(i));
+    }
+    status = MsgRingStatus::OK;
+  });
+  return status;
+}
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+// Nearest message lookup of MsgRing against the former MsgBuffer storage, a
+// circular buffer behind a mutex scanned from its latest message. The
+// lookups ask for random timestamps of the buffered messages, while a writer
+// thread appends a message every 100us, far more often than the 100Hz of
+// the localization, to contend with them. Argument 0 is the buffer capacity
+// and argument 1 whether the writer runs. Run with
+// bazel run -c opt //modules/perception/onboard/msg_buffer:msg_ring_benchmark
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <boost/circular_buffer.hpp>
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/onboard/msg_buffer/msg_ring.h"
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+namespace {
+
+constexpr double kMsgPeriod = 0.01;
+constexpr double kPrecision = 0.01;
+
+typedef MsgRing<double>::ConstPtr ConstPtr;
+typedef MsgRing<double>::ObjectPair ObjectPair;
+
+// the former MsgBuffer storage and lookup
+class LockedBuffer {
+ public:
+  explicit LockedBuffer(const size_t capacity) : buffer_queue_(capacity) {}
+
+  bool Push(const double timestamp, const ConstPtr& msg) {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    buffer_queue_.push_back(std::make_pair(timestamp, msg));
+    return true;
+  }
+
+  bool LookupNearest(const double timestamp, ConstPtr* msg) {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    if (buffer_queue_.empty() ||
+        buffer_queue_.front().first - kPrecision > timestamp ||
+        buffer_queue_.back().first + kPrecision < timestamp) {
+      return false;
+    }
+    double distance = std::numeric_limits<double>::max();
+    int idx = static_cast<int>(buffer_queue_.size()) - 1;
+    for (; idx >= 0; --idx) {
+      double temp_distance = fabs(timestamp - buffer_queue_[idx].first);
+      if (temp_distance >= distance) {
+        break;
+      }
+      distance = temp_distance;
+    }
+    *msg = buffer_queue_[idx + 1].second;
+    return true;
+  }
+
+ private:
+  std::mutex buffer_mutex_;
+  boost::circular_buffer<ObjectPair> buffer_queue_;
+};
+
+class RingBuffer {
+ public:
+  explicit RingBuffer(const size_t capacity) : ring_(capacity) {}
+
+  bool Push(const double timestamp, const ConstPtr& msg) {
+    return ring_.Push(timestamp, msg);
+  }
+
+  bool LookupNearest(const double timestamp, ConstPtr* msg) {
+    return ring_.LookupNearest(timestamp, kPrecision, msg) ==
+           MsgRingStatus::OK;
+  }
+
+ private:
+  MsgRing<double> ring_;
+};
+
+template <class Buffer>
+void BM_LookupNearest(benchmark::State& state) {
+  const int capacity = static_cast<int>(state.range(0));
+  Buffer buffer(capacity);
+  // timestamps of the messages are multiples of kMsgPeriod, the written
+  // count is the next one
+  std::atomic<int> count{0};
+  for (; count < capacity; ++count) {
+    buffer.Push(count * kMsgPeriod,
+                std::make_shared<const double>(count * kMsgPeriod));
+  }
+
+  std::atomic<bool> stop{false};
+  std::thread writer;
+  if (state.range(1) != 0) {
+    writer = std::thread([&]() {
+      while (!stop.load()) {
+        const int next = count.load();
+        buffer.Push(next * kMsgPeriod,
+                    std::make_shared<const double>(next * kMsgPeriod));
+        count.store(next + 1);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+  }
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  int64_t found = 0;
+  for (auto _ : state) {
+    // within the older half of the buffer, so that it is not overwritten
+    // before the lookup
+    const double timestamp =
+        (count.load() - capacity * (1.0 - 0.5 * distribution(generator))) *
+        kMsgPeriod;
+    ConstPtr msg;
+    found += buffer.LookupNearest(timestamp, &msg);
+    benchmark::DoNotOptimize(msg);
+  }
+  stop.store(true);
+  if (writer.joinable()) {
+    writer.join();
+  }
+  state.counters["found"] =
+      static_cast<double>(found) / static_cast<double>(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_LookupNearest, LockedBuffer)
+    ->ArgsProduct({{50, 200, 1000}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_LookupNearest, RingBuffer)
+    ->ArgsProduct({{50, 200, 1000}, {0, 1}});
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/onboard/msg_buffer/msg_ring.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+// the messages hold their timestamps
+typedef MsgRing<double> Ring;
+
+bool Push(Ring* ring, const double timestamp) {
+  return ring->Push(timestamp, std::make_shared<const double>(timestamp));
+}
+
+TEST(MsgRingTest, test_lookup_nearest) {
+  Ring ring(4);
+  Ring::ConstPtr msg;
+  EXPECT_EQ(ring.LookupNearest(1.0, 0.01, &msg), MsgRingStatus::EMPTY);
+
+  for (const double timestamp : {1.0, 2.0, 2.0, 3.0, 4.0, 4.0}) {
+    EXPECT_TRUE(Push(&ring, timestamp));
+  }
+  EXPECT_FALSE(Push(&ring, 3.5));
+  // only the latest 4 messages are kept
+  double oldest = 0.0;
+  double latest = 0.0;
+  EXPECT_TRUE(ring.Bounds(&oldest, &latest));
+  EXPECT_DOUBLE_EQ(oldest, 2.0);
+  EXPECT_DOUBLE_EQ(latest, 4.0);
+
+  EXPECT_EQ(ring.LookupNearest(1.98, 0.01, &msg), MsgRingStatus::TOO_EARLY);
+  EXPECT_EQ(ring.LookupNearest(4.02, 0.01, &msg), MsgRingStatus::TOO_LATE);
+  EXPECT_EQ(ring.LookupNearest(1.995, 0.01, &msg), MsgRingStatus::OK);
+  EXPECT_DOUBLE_EQ(*msg, 2.0);
+  EXPECT_EQ(ring.LookupNearest(2.4, 0.01, &msg), MsgRingStatus::OK);
+  EXPECT_DOUBLE_EQ(*msg, 2.0);
+  // ties go to the later message
+  EXPECT_EQ(ring.LookupNearest(3.5, 0.01, &msg), MsgRingStatus::OK);
+  EXPECT_DOUBLE_EQ(*msg, 4.0);
+  EXPECT_EQ(ring.LookupNearest(4.01, 0.01, &msg), MsgRingStatus::OK);
+  EXPECT_DOUBLE_EQ(*msg, 4.0);
+
+  Ring::ObjectPair latest_msg;
+  EXPECT_TRUE(ring.LookupLatest(&latest_msg));
+  EXPECT_DOUBLE_EQ(latest_msg.first, 4.0);
+
+  ring.Reset(2);
+  EXPECT_EQ(ring.capacity(), 2);
+  EXPECT_FALSE(ring.LookupLatest(&latest_msg));
+}
+
+TEST(MsgRingTest, test_lookup_period) {
+  Ring ring(8);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_TRUE(Push(&ring, 0.1 * i));
+  }
+  std::vector<Ring::ObjectPair> msgs;
+  EXPECT_EQ(ring.LookupPeriod(0.5, 0.1, 0.01, &msgs),
+            MsgRingStatus::TOO_EARLY);
+  EXPECT_EQ(ring.LookupPeriod(1.55, 0.11, 0.01, &msgs), MsgRingStatus::OK);
+  ASSERT_EQ(msgs.size(), 2);
+  EXPECT_DOUBLE_EQ(msgs[0].first, 1.5);
+  EXPECT_DOUBLE_EQ(*msgs[1].second, 1.6);
+  // appended to the given messages
+  EXPECT_EQ(ring.LookupPeriod(1.9, 0.25, 0.01, &msgs), MsgRingStatus::OK);
+  ASSERT_EQ(msgs.size(), 5);
+  EXPECT_DOUBLE_EQ(msgs[2].first, 1.7);
+  EXPECT_DOUBLE_EQ(msgs[4].first, 1.9);
+}
+
+TEST(MsgRingTest, test_concurrent_lookup) {
+  const int kMsgCount = 100000;
+  Ring ring(16);
+  Push(&ring, 0.0);
+  std::thread writer([&ring]() {
+    for (int i = 1; i < kMsgCount; ++i) {
+      Push(&ring, static_cast<double>(i));
+    }
+  });
+  // every message found is the nearest one of its timestamp, and still in
+  // the buffer when the lookup started
+  double last_found = 0.0;
+  while (last_found < kMsgCount - 1) {
+    Ring::ObjectPair latest;
+    ASSERT_TRUE(ring.LookupLatest(&latest));
+    ASSERT_DOUBLE_EQ(latest.first, *latest.second);
+    ASSERT_GE(latest.first, last_found);
+    Ring::ConstPtr msg;
+    if (ring.LookupNearest(latest.first - 3.2, 0.0, &msg) ==
+        MsgRingStatus::OK) {
+      ASSERT_DOUBLE_EQ(*msg, latest.first - 3.0);
+    }
+    last_found = latest.first;
+  }
+  writer.join();
+}
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
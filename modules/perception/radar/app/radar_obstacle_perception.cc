@@ -17,6 +17,7 @@
 
 #include "modules/common/util/perf_util.h"
 #include "modules/perception/lib/config_manager/config_manager.h"
+#include "modules/perception/lib/profiler/latency_profiler.h"
 #include "modules/perception/lib/registerer/registerer.h"
 
 using apollo::perception::lib::ConfigManager;
@@ -71,7 +72,7 @@ bool RadarObstaclePerception::Perceive(
     std::vector<base::ObjectPtr>* objects) {
   PERF_FUNCTION();
   const std::string& sensor_name = options.sensor_name;
-  PERF_BLOCK_START();
+  PERCEPTION_PERF_BLOCK_START();
   base::FramePtr detect_frame_ptr(new base::Frame());
 
   if (!detector_->Detect(corrected_obstacles, options.detector_options,
@@ -81,13 +82,13 @@ bool RadarObstaclePerception::Perceive(
   }
   ADEBUG << "Detected frame objects number: "
          << detect_frame_ptr->objects.size();
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "detector");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "detector");
   if (!roi_filter_->RoiFilter(options.roi_filter_options, detect_frame_ptr)) {
     ADEBUG << "All radar objects were filtered out";
   }
   ADEBUG << "RoiFiltered frame objects number: "
          << detect_frame_ptr->objects.size();
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "roi_filter");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "roi_filter");
 
   base::FramePtr tracker_frame_ptr(new base::Frame);
   if (!tracker_->Track(*detect_frame_ptr, options.track_options,
@@ -97,7 +98,7 @@ bool RadarObstaclePerception::Perceive(
   }
   ADEBUG << "tracked frame objects number: "
          << tracker_frame_ptr->objects.size();
-  PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "tracker");
+  PERCEPTION_PERF_BLOCK_END_WITH_INDICATOR(sensor_name, "tracker");
 
   *objects = tracker_frame_ptr->objects;
 
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <utility>
+
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/common/ego_info.h"
 #include "modules/planning/common/frame.h"
 #include "modules/planning/common/history.h"
 #include "modules/planning/common/learning_based_data.h"
+#include "modules/planning/common/obstacle_projection_cache.h"
 #include "modules/planning/common/planning_context.h"
 
 namespace apollo {
@@ -31,7 +34,33 @@ class DependencyInjector {
   DependencyInjector() = default;
   ~DependencyInjector() = default;
 
+  /**
+   * @brief While alive, redirects planning_context() of the given injector
+   * to another context, on the calling thread only. This lets several
+   * reference lines be planned concurrently, each one reading and writing
+   * a private copy of the planning status.
+   */
+  class ScopedPlanningContext {
+   public:
+    ScopedPlanningContext(const DependencyInjector* injector,
+                          PlanningContext* planning_context)
+        : previous_(LocalPlanningContext()) {
+      LocalPlanningContext() = {injector, planning_context};
+    }
+    ~ScopedPlanningContext() { LocalPlanningContext() = previous_; }
+
+    ScopedPlanningContext(const ScopedPlanningContext&) = delete;
+    ScopedPlanningContext& operator=(const ScopedPlanningContext&) = delete;
+
+   private:
+    std::pair<const DependencyInjector*, PlanningContext*> previous_;
+  };
+
   PlanningContext* planning_context() {
+    const auto& local = LocalPlanningContext();
+    if (local.first == this) {
+      return local.second;
+    }
     return &planning_context_;
   }
   FrameHistory* frame_history() {
@@ -49,6 +78,17 @@ class DependencyInjector {
   LearningBasedData* learning_based_data() {
     return &learning_based_data_;
   }
+  ObstacleProjectionCache* obstacle_projection_cache() {
+    return &obstacle_projection_cache_;
+  }
+
+ private:
+  static std::pair<const DependencyInjector*, PlanningContext*>&
+  LocalPlanningContext() {
+    static thread_local std::pair<const DependencyInjector*, PlanningContext*>
+        local_planning_context{nullptr, nullptr};
+    return local_planning_context;
+  }
 
  private:
   PlanningContext planning_context_;
@@ -57,6 +97,7 @@ class DependencyInjector {
   EgoInfo ego_info_;
   apollo::common::VehicleStateProvider vehicle_state_;
   LearningBasedData learning_based_data_;
+  ObstacleProjectionCache obstacle_projection_cache_;
 };
 
 }  // namespace planning
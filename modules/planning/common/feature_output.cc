@@ -71,6 +71,10 @@ void FeatureOutput::WriteLearningData(const std::string& record_file) {
   learning_data_file_index_++;
 }
 
+int FeatureOutput::LearningDataFileIndex() {
+  return learning_data_file_index_;
+}
+
 void FeatureOutput::WriteRemainderiLearningData(
     const std::string& record_file) {
   if (learning_data_.learning_data_frame_size() > 0) {
@@ -64,6 +64,13 @@ class FeatureOutput {
   static void WriteLearningData(const std::string& record_file);
   static void WriteRemainderiLearningData(const std::string& record_file);
 
+  /**
+   * @brief Get the index of the next learning data file, which is the number
+   * of files written since the last reset
+   * @return The index of the next learning data file
+   */
+  static int LearningDataFileIndex();
+
   /**
    * @brief Get the size of learning_data_
    * @return The size of learning_data_
@@ -189,8 +189,12 @@ bool Frame::CreateReferenceLineInfo(
     reference_line_info_.back().SetOffsetToOtherReferenceLine(-offset);
   }
 
+  if (obstacle_projection_cache_ != nullptr) {
+    obstacle_projection_cache_->BeginCycle();
+  }
   bool has_valid_reference_line = false;
   for (auto &ref_info : reference_line_info_) {
+    ref_info.set_obstacle_projection_cache(obstacle_projection_cache_);
     if (!ref_info.Init(obstacles())) {
       AERROR << "Failed to init reference line";
     } else {
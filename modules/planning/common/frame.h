@@ -38,6 +38,7 @@
 #include "modules/planning/common/indexed_queue.h"
 #include "modules/planning/common/local_view.h"
 #include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/obstacle_projection_cache.h"
 #include "modules/planning/common/open_space_info.h"
 #include "modules/planning/common/reference_line_info.h"
 #include "modules/planning/common/trajectory/publishable_trajectory.h"
@@ -182,6 +183,15 @@ class Frame {
     return pad_msg_driving_action_;
   }
 
+  /**
+   * @brief Project the obstacles onto the reference lines with the cache of
+   * the last cycle, if not null. It must be set before Init.
+   */
+  void set_obstacle_projection_cache(
+      ObstacleProjectionCache *obstacle_projection_cache) {
+    obstacle_projection_cache_ = obstacle_projection_cache;
+  }
+
  private:
   common::Status InitFrameData(
       const common::VehicleStateProvider *vehicle_state_provider,
@@ -240,6 +250,8 @@ class Frame {
 
   const ReferenceLineProvider *reference_line_provider_ = nullptr;
 
+  ObstacleProjectionCache *obstacle_projection_cache_ = nullptr;
+
   OpenSpaceInfo open_space_info_;
 
   std::vector<routing::LaneWaypoint> future_route_waypoints_;
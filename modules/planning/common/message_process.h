@@ -71,6 +71,10 @@ class MessageProcess {
 
   void ProcessOfflineData(const std::string& record_file);
 
+  int total_learning_data_frame_num() const {
+    return total_learning_data_frame_num_;
+  }
+
  private:
   struct ADCCurrentInfo {
     std::pair<double, double> adc_cur_position_;
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/obstacle_projection_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/time/clock.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::cyber::Clock;
+
+namespace {
+// margin of the searched s range, for the s along the lanes differing from
+// the s along the smoothed reference line
+constexpr double kSearchRangeMargin = 10.0;
+}  // namespace
+
+double ObstacleProjectionCache::Stats::HitRate() const {
+  const int num_lookups = num_hits + num_misses;
+  return num_lookups > 0 ? static_cast<double>(num_hits) / num_lookups : 0.0;
+}
+
+void ObstacleProjectionCache::BeginCycle() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ADEBUG << "obstacle projection cache hits: "
+         << stats_.num_hits - last_cycle_stats_.num_hits
+         << ", misses: " << stats_.num_misses - last_cycle_stats_.num_misses
+         << ", estimated saved time: "
+         << (stats_.saved_time - last_cycle_stats_.saved_time) * 1000.0
+         << " ms";
+  ++stats_.num_cycles;
+  last_cycle_stats_ = stats_;
+  AINFO_EVERY(100) << "obstacle projection cache hit rate: "
+                   << stats_.HitRate() << ", hits: " << stats_.num_hits
+                   << ", misses: " << stats_.num_misses
+                   << ", estimated saved time per cycle: "
+                   << stats_.saved_time * 1000.0 / stats_.num_cycles << " ms";
+
+  last_projections_.swap(projections_);
+  projections_.clear();
+}
+
+bool ObstacleProjectionCache::GetSLBoundary(const std::string& obstacle_id,
+                                            const ReferenceLine& reference_line,
+                                            const Box2d& box,
+                                            SLBoundary* const sl_boundary) {
+  const double start_time = Clock::NowInSeconds();
+  bool is_hit = false;
+  double start_s = 0.0;
+  double end_s = 0.0;
+  if (GetSearchRange(obstacle_id, reference_line, box, &start_s, &end_s)) {
+    // fails if any projection in the range is at its ends, to search the
+    // whole reference line instead
+    SLBoundary boundary;
+    if (reference_line.GetSLBoundary(box, start_s, end_s, &boundary)) {
+      sl_boundary->Swap(&boundary);
+      is_hit = true;
+    }
+  }
+  if (!is_hit && !reference_line.GetSLBoundary(box, sl_boundary)) {
+    return false;
+  }
+  const double time = Clock::NowInSeconds() - start_time;
+
+  Projection projection;
+  const bool has_projection =
+      GetProjection(reference_line, box, *sl_boundary, &projection);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (has_projection) {
+    projections_[obstacle_id].push_back(std::move(projection));
+  }
+  if (is_hit) {
+    ++stats_.num_hits;
+    stats_.hit_time += time;
+    if (stats_.num_misses > 0) {
+      stats_.saved_time +=
+          std::max(0.0, stats_.miss_time / stats_.num_misses - time);
+    }
+  } else {
+    ++stats_.num_misses;
+    stats_.miss_time += time;
+  }
+  return true;
+}
+
+ObstacleProjectionCache::Stats ObstacleProjectionCache::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+bool ObstacleProjectionCache::GetSearchRange(
+    const std::string& obstacle_id, const ReferenceLine& reference_line,
+    const Box2d& box, double* const start_s, double* const end_s) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto iter = last_projections_.find(obstacle_id);
+  if (iter == last_projections_.end()) {
+    return false;
+  }
+  const auto& lane_segments = reference_line.map_path().lane_segments();
+  for (const auto& projection : iter->second) {
+    const double shift = projection.center.DistanceTo(box.center());
+    if (shift > FLAGS_obstacle_projection_cache_max_shift) {
+      continue;
+    }
+    double accumulated_s = 0.0;
+    for (const auto& lane_segment : lane_segments) {
+      if (lane_segment.lane != nullptr &&
+          lane_segment.lane->id().id() == projection.lane_id &&
+          projection.lane_s >= lane_segment.start_s &&
+          projection.lane_s <= lane_segment.end_s) {
+        const double s =
+            accumulated_s + projection.lane_s - lane_segment.start_s;
+        const double range =
+            box.diagonal() / 2.0 + shift + kSearchRangeMargin;
+        *start_s = std::max(0.0, s - range);
+        *end_s = std::min(reference_line.Length(), s + range);
+        return *start_s < *end_s;
+      }
+      accumulated_s += lane_segment.Length();
+    }
+  }
+  return false;
+}
+
+bool ObstacleProjectionCache::GetProjection(
+    const ReferenceLine& reference_line, const Box2d& box,
+    const SLBoundary& sl_boundary, Projection* const projection) const {
+  const auto& map_path = reference_line.map_path();
+  if (map_path.lane_segments().empty()) {
+    return false;
+  }
+  const double center_s = (sl_boundary.start_s() + sl_boundary.end_s()) / 2.0;
+  const auto lane_index = map_path.GetLaneIndexFromS(center_s);
+  const auto& lane_segment = map_path.lane_segments()[lane_index.id];
+  if (lane_segment.lane == nullptr) {
+    return false;
+  }
+  projection->lane_id = lane_segment.lane->id().id();
+  projection->lane_s = lane_segment.start_s + lane_index.offset;
+  projection->center = box.center();
+  return true;
+}
+
+}  // namespace planning
+}  // namespace apollo
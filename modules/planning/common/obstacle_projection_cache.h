@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/common_msgs/planning_msgs/sl_boundary.pb.h"
+#include "modules/planning/reference_line/reference_line.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class ObstacleProjectionCache
+ * @brief Keeps the projections of the obstacles onto the reference lines of
+ * the last planning cycle. The SL boundary of an obstacle which moved little
+ * since then is searched only around its last projection on the same lane,
+ * instead of along the whole reference line. The whole reference line is
+ * still searched when a projection around the last one is at the ends of
+ * the searched range. The SL boundary found around the last projection may
+ * differ from the one of the whole reference line only when another part of
+ * the reference line, e.g. the other side of a U-turn, is nearer to the
+ * obstacle.
+ */
+class ObstacleProjectionCache {
+ public:
+  struct Stats {
+    // projections searched around the last projection
+    int num_hits = 0;
+    // projections searched along the whole reference line
+    int num_misses = 0;
+    int num_cycles = 0;
+    // seconds spent on the projections
+    double hit_time = 0.0;
+    double miss_time = 0.0;
+    // seconds saved over searching the whole reference line, estimated with
+    // the average time of the misses
+    double saved_time = 0.0;
+
+    double HitRate() const;
+  };
+
+  /**
+   * @brief Start a planning cycle. The projections of the last cycle become
+   * the hints of this cycle, and the older ones are dropped.
+   */
+  void BeginCycle();
+
+  /**
+   * @brief Get the SL boundary of the box of an obstacle on the reference
+   * line, and keep its projection for the next cycle. It is thread safe.
+   */
+  bool GetSLBoundary(const std::string& obstacle_id,
+                     const ReferenceLine& reference_line,
+                     const common::math::Box2d& box,
+                     SLBoundary* const sl_boundary);
+
+  Stats GetStats();
+
+ private:
+  struct Projection {
+    std::string lane_id;
+    // s of the box center on the lane
+    double lane_s = 0.0;
+    common::math::Vec2d center;
+  };
+
+  /**
+   * @brief Find the s range of the reference line to search the box in,
+   * around the last projection of the obstacle on a lane of the reference
+   * line.
+   */
+  bool GetSearchRange(const std::string& obstacle_id,
+                      const ReferenceLine& reference_line,
+                      const common::math::Box2d& box, double* const start_s,
+                      double* const end_s);
+
+  /**
+   * @brief Get the projection of the box center on the lane of the reference
+   * line, to be kept for the next cycle.
+   */
+  bool GetProjection(const ReferenceLine& reference_line,
+                     const common::math::Box2d& box,
+                     const SLBoundary& sl_boundary,
+                     Projection* const projection) const;
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<Projection>> last_projections_;
+  std::unordered_map<std::string, std::vector<Projection>> projections_;
+  Stats stats_;
+  Stats last_cycle_stats_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/obstacle_projection_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+using apollo::hdmap::LaneInfo;
+using apollo::hdmap::LaneInfoConstPtr;
+using apollo::hdmap::LaneSegment;
+
+class ObstacleProjectionCacheTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    FLAGS_obstacle_projection_cache_max_shift = 2.0;
+    // straight lanes "a" and "b" of 100m one after another along x
+    lane_protos_.resize(2);
+    std::vector<LaneSegment> segments;
+    for (int i = 0; i < 2; ++i) {
+      hdmap::Lane& lane = lane_protos_[i];
+      lane.mutable_id()->set_id(std::string(1, static_cast<char>('a' + i)));
+      auto* line_segment =
+          lane.mutable_central_curve()->add_segment()->mutable_line_segment();
+      for (int j = 0; j <= 10; ++j) {
+        auto* point = line_segment->add_point();
+        point->set_x(100.0 * i + 10.0 * j);
+        point->set_y(0.0);
+      }
+      lane.set_length(100.0);
+      auto* left_sample = lane.add_left_sample();
+      left_sample->set_s(0.0);
+      left_sample->set_width(1.75);
+      auto* right_sample = lane.add_right_sample();
+      right_sample->set_s(0.0);
+      right_sample->set_width(1.75);
+      lanes_.emplace_back(new LaneInfo(lane));
+      segments.emplace_back(lanes_.back(), 0.0, 100.0);
+    }
+    reference_line_.reset(new ReferenceLine(hdmap::Path(segments)));
+  }
+
+ protected:
+  // a car of 4m x 2m heading along x
+  static Box2d MakeBox(const double x, const double y) {
+    return Box2d(Vec2d(x, y), 0.0, 4.0, 2.0);
+  }
+
+  void ExpectSameSLBoundary(const SLBoundary& expected,
+                            const SLBoundary& sl_boundary) const {
+    EXPECT_NEAR(expected.start_s(), sl_boundary.start_s(), 1e-6);
+    EXPECT_NEAR(expected.end_s(), sl_boundary.end_s(), 1e-6);
+    EXPECT_NEAR(expected.start_l(), sl_boundary.start_l(), 1e-6);
+    EXPECT_NEAR(expected.end_l(), sl_boundary.end_l(), 1e-6);
+    EXPECT_EQ(expected.boundary_point_size(),
+              sl_boundary.boundary_point_size());
+  }
+
+  // checks the SL boundary from the cache against the one searched along
+  // the whole reference line
+  void GetSLBoundary(const std::string& obstacle_id, const Box2d& box) {
+    SLBoundary sl_boundary;
+    ASSERT_TRUE(cache_.GetSLBoundary(obstacle_id, *reference_line_, box,
+                                     &sl_boundary));
+    SLBoundary expected;
+    ASSERT_TRUE(reference_line_->GetSLBoundary(box, &expected));
+    ExpectSameSLBoundary(expected, sl_boundary);
+  }
+
+  // referred to by lanes_
+  std::vector<hdmap::Lane> lane_protos_;
+  std::vector<LaneInfoConstPtr> lanes_;
+  std::unique_ptr<ReferenceLine> reference_line_;
+  ObstacleProjectionCache cache_;
+};
+
+TEST_F(ObstacleProjectionCacheTest, WindowedSLBoundary) {
+  const Box2d box = MakeBox(50.0, 1.0);
+  SLBoundary expected;
+  ASSERT_TRUE(reference_line_->GetSLBoundary(box, &expected));
+  EXPECT_NEAR(48.0, expected.start_s(), 1e-6);
+  EXPECT_NEAR(52.0, expected.end_s(), 1e-6);
+
+  SLBoundary sl_boundary;
+  EXPECT_TRUE(reference_line_->GetSLBoundary(box, 30.0, 70.0, &sl_boundary));
+  ExpectSameSLBoundary(expected, sl_boundary);
+
+  // the box is not strictly within the range
+  SLBoundary start_boundary;
+  EXPECT_FALSE(
+      reference_line_->GetSLBoundary(box, 50.0, 70.0, &start_boundary));
+  SLBoundary end_boundary;
+  EXPECT_FALSE(
+      reference_line_->GetSLBoundary(box, 30.0, 52.0, &end_boundary));
+  SLBoundary outside_boundary;
+  EXPECT_FALSE(
+      reference_line_->GetSLBoundary(box, 120.0, 150.0, &outside_boundary));
+}
+
+TEST_F(ObstacleProjectionCacheTest, HitsAndMisses) {
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(50.0, 1.0));
+  auto stats = cache_.GetStats();
+  EXPECT_EQ(0, stats.num_hits);
+  EXPECT_EQ(1, stats.num_misses);
+
+  // moved less than the max shift
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(51.0, 1.5));
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(52.5, 1.0));
+  stats = cache_.GetStats();
+  EXPECT_EQ(2, stats.num_hits);
+  EXPECT_EQ(1, stats.num_misses);
+
+  // moved more than the max shift, and a new obstacle
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(55.0, 1.0));
+  GetSLBoundary("2", MakeBox(99.0, -1.0));
+  stats = cache_.GetStats();
+  EXPECT_EQ(2, stats.num_hits);
+  EXPECT_EQ(3, stats.num_misses);
+
+  // only the projections of the last cycle are kept, also across the lanes
+  cache_.BeginCycle();
+  cache_.BeginCycle();
+  GetSLBoundary("2", MakeBox(100.0, -1.0));
+  stats = cache_.GetStats();
+  EXPECT_EQ(2, stats.num_hits);
+  EXPECT_EQ(4, stats.num_misses);
+  EXPECT_EQ(6, stats.num_cycles);
+  EXPECT_DOUBLE_EQ(2.0 / 6.0, stats.HitRate());
+
+  cache_.BeginCycle();
+  GetSLBoundary("2", MakeBox(101.0, -1.0));
+  EXPECT_EQ(3, cache_.GetStats().num_hits);
+}
+
+TEST_F(ObstacleProjectionCacheTest, RangeEndsFallback) {
+  // the rear of the box projects before the start of the reference line, at
+  // the start of the searched range
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(1.0, 1.0));
+  cache_.BeginCycle();
+  GetSLBoundary("1", MakeBox(1.0, 1.0));
+  const auto stats = cache_.GetStats();
+  EXPECT_EQ(0, stats.num_hits);
+  EXPECT_EQ(2, stats.num_misses);
+}
+
+}  // namespace planning
+}  // namespace apollo
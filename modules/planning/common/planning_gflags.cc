@@ -152,6 +152,10 @@ DEFINE_double(look_forward_extend_distance, 50,
 DEFINE_double(reference_line_stitch_overlap_distance, 20,
               "The overlap distance with the existing reference line when "
               "stitching the existing reference line");
+DEFINE_bool(enable_reference_line_smoothing_cache, false,
+            "Reuse the reference lines smoothed in the last cycle for the "
+            "lanes of the route segments they cover, and only smooth the "
+            "newly appended tail when the reference line is not stitched");
 
 DEFINE_bool(enable_smooth_reference_line, true,
             "enable smooth the map reference line");
@@ -324,8 +328,32 @@ DEFINE_bool(enable_sqp_solver, true, "True to enable SQP solver.");
 /// thread pool
 DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
+DEFINE_bool(enable_obstacle_projection_cache, false,
+            "Search the SL boundaries of the obstacles which moved little "
+            "since the last cycle around their last projections on the same "
+            "lanes, instead of along the whole reference line.");
+DEFINE_double(obstacle_projection_cache_max_shift, 2.0,
+              "Max distance in meters an obstacle may move between cycles "
+              "for its last projection to be reused.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
+DEFINE_int32(dp_graph_thread_num, 4,
+             "Number of threads, the planning thread included, sharing the "
+             "rows of each column of the dp graphs when multiple thread is "
+             "enabled.");
+DEFINE_bool(enable_parallel_reference_line_planning, false,
+            "Plan the task list on every candidate reference line "
+            "concurrently instead of one after another.");
+DEFINE_int32(reference_line_planning_thread_num, 2,
+             "Number of worker threads used to plan reference lines "
+             "concurrently, in addition to the planning thread.");
+DEFINE_bool(enable_parallel_path_candidates, false,
+            "Generate the fallback and regular path boundaries, and optimize "
+            "the paths on the candidate path boundaries, concurrently.");
+DEFINE_int32(path_candidate_thread_num, 4,
+             "Number of threads, the planning thread included, sharing the "
+             "candidate path boundaries when they are processed "
+             "concurrently.");
 
 /// Lattice Planner
 DEFINE_double(numerical_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -342,6 +370,14 @@ DEFINE_bool(enable_backup_trajectory, true,
             "If generate backup trajectory when planning fail");
 DEFINE_double(backup_trajectory_cost, 1000.0,
               "Default cost of backup trajectory");
+DEFINE_bool(enable_lattice_batch_evaluation, false,
+            "Combine and check the lattice trajectory pairs in batches of the "
+            "cheapest pairs on several threads instead of one at a time.");
+DEFINE_int32(lattice_evaluation_batch_size, 16,
+             "Number of trajectory pairs combined and checked per batch.");
+DEFINE_int32(lattice_evaluation_thread_num, 4,
+             "Number of threads, the planning thread included, checking a "
+             "batch of lattice trajectory pairs.");
 DEFINE_double(min_velocity_sample_gap, 1.0,
               "Minimal sampling gap for velocity");
 DEFINE_double(lon_collision_buffer, 2.0,
@@ -474,9 +510,18 @@ DEFINE_bool(
 DEFINE_bool(
     enable_parallel_trajectory_smoothing, false,
     "Whether to partition the trajectory first and do smoothing in parallel");
+DEFINE_int32(open_space_smoothing_thread_num, 4,
+             "Number of threads, the planning thread included, sharing the "
+             "partitions of the open space trajectory when the iterative "
+             "anchoring smoother smooths them in parallel.");
 
 DEFINE_bool(enable_osqp_debug, false,
             "True to turn on OSQP verbose debug output in log.");
+DEFINE_bool(enable_piecewise_jerk_workspace_reuse, false,
+            "True to keep the OSQP workspaces of the piecewise jerk path and "
+            "speed optimizers across planning cycles, updating them and warm "
+            "starting from the shifted last solution instead of setting them "
+            "up from scratch.");
 
 DEFINE_bool(export_chart, false, "export chart in planning");
 DEFINE_bool(enable_record_debug, true,
@@ -546,6 +591,9 @@ DEFINE_string(planning_data_dir, "/apollo/modules/planning/data/",
 DEFINE_string(planning_offline_bags, "",
               "a list of source files or directories for offline mode. "
               "The items need to be separated by colon ':'. ");
+DEFINE_int32(planning_offline_learning_worker_num, 1,
+             "number of worker processes the offline records are sharded "
+             "across when generating learning data");
 DEFINE_int32(learning_data_obstacle_history_time_sec, 3.0,
              "time sec (second) of history trajectory points for a obstacle");
 DEFINE_int32(learning_data_frame_num_per_file, 100,
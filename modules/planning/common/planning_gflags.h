@@ -61,6 +61,7 @@ DECLARE_double(rtk_trajectory_resolution);
 DECLARE_bool(enable_reference_line_stitching);
 DECLARE_double(look_forward_extend_distance);
 DECLARE_double(reference_line_stitch_overlap_distance);
+DECLARE_bool(enable_reference_line_smoothing_cache);
 
 DECLARE_bool(enable_smooth_reference_line);
 
@@ -149,7 +150,14 @@ DECLARE_bool(enable_sqp_solver);
 
 /// thread pool
 DECLARE_bool(use_multi_thread_to_add_obstacles);
+DECLARE_bool(enable_obstacle_projection_cache);
+DECLARE_double(obstacle_projection_cache_max_shift);
 DECLARE_bool(enable_multi_thread_in_dp_st_graph);
+DECLARE_int32(dp_graph_thread_num);
+DECLARE_bool(enable_parallel_reference_line_planning);
+DECLARE_int32(reference_line_planning_thread_num);
+DECLARE_bool(enable_parallel_path_candidates);
+DECLARE_int32(path_candidate_thread_num);
 
 DECLARE_double(numerical_epsilon);
 DECLARE_double(default_cruise_speed);
@@ -161,6 +169,9 @@ DECLARE_double(speed_lon_decision_horizon);
 DECLARE_uint64(num_velocity_sample);
 DECLARE_bool(enable_backup_trajectory);
 DECLARE_double(backup_trajectory_cost);
+DECLARE_bool(enable_lattice_batch_evaluation);
+DECLARE_int32(lattice_evaluation_batch_size);
+DECLARE_int32(lattice_evaluation_thread_num);
 DECLARE_double(min_velocity_sample_gap);
 DECLARE_double(lon_collision_buffer);
 DECLARE_double(lat_collision_buffer);
@@ -224,8 +235,10 @@ DECLARE_bool(enable_smoother_failsafe);
 DECLARE_bool(use_s_curve_speed_smooth);
 DECLARE_bool(use_iterative_anchoring_smoother);
 DECLARE_bool(enable_parallel_trajectory_smoothing);
+DECLARE_int32(open_space_smoothing_thread_num);
 
 DECLARE_bool(enable_osqp_debug);
+DECLARE_bool(enable_piecewise_jerk_workspace_reuse);
 DECLARE_bool(export_chart);
 DECLARE_bool(enable_record_debug);
 
@@ -273,6 +286,7 @@ DECLARE_double(buffer_out_routing);
 DECLARE_bool(planning_offline_learning);
 DECLARE_string(planning_data_dir);
 DECLARE_string(planning_offline_bags);
+DECLARE_int32(planning_offline_learning_worker_num);
 DECLARE_int32(learning_data_obstacle_history_time_sec);
 DECLARE_int32(learning_data_frame_num_per_file);
 DECLARE_string(planning_birdview_img_feature_renderer_config_file);
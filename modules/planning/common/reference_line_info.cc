@@ -367,8 +367,14 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
   }
 
   SLBoundary perception_sl;
-  if (!reference_line_.GetSLBoundary(obstacle->PerceptionBoundingBox(),
-                                     &perception_sl)) {
+  const bool has_perception_sl =
+      obstacle_projection_cache_ != nullptr
+          ? obstacle_projection_cache_->GetSLBoundary(
+                obstacle->Id(), reference_line_,
+                obstacle->PerceptionBoundingBox(), &perception_sl)
+          : reference_line_.GetSLBoundary(obstacle->PerceptionBoundingBox(),
+                                          &perception_sl);
+  if (!has_perception_sl) {
     AERROR << "Failed to get sl boundary for obstacle: " << obstacle->Id();
     return mutable_obstacle;
   }
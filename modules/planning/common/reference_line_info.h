@@ -36,6 +36,7 @@
 
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/pnc_map/pnc_map.h"
+#include "modules/planning/common/obstacle_projection_cache.h"
 #include "modules/planning/common/path/path_data.h"
 #include "modules/planning/common/path_boundary.h"
 #include "modules/planning/common/path_decision.h"
@@ -202,6 +203,15 @@ class ReferenceLineInfo {
 
   void set_is_on_reference_line() { is_on_reference_line_ = true; }
 
+  /**
+   * @brief Project the obstacles added by AddObstacles with the cache of the
+   * last cycle, if not null.
+   */
+  void set_obstacle_projection_cache(
+      ObstacleProjectionCache* obstacle_projection_cache) {
+    obstacle_projection_cache_ = obstacle_projection_cache;
+  }
+
   uint32_t GetPriority() const { return reference_line_.GetPriority(); }
 
   void SetPriority(uint32_t priority) { reference_line_.SetPriority(priority); }
@@ -326,6 +336,8 @@ class ReferenceLineInfo {
 
   double offset_to_other_reference_line_ = 0.0;
 
+  ObstacleProjectionCache* obstacle_projection_cache_ = nullptr;
+
   double priority_cost_ = 0.0;
 
   PlanningTarget planning_target_;
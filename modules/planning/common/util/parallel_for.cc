@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/common/util/parallel_for.h"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace planning {
+namespace util {
+
+void ParallelFor(const size_t begin, const size_t end, const size_t num_chunks,
+                 const size_t min_chunk_size,
+                 const std::function<void(size_t, size_t)>& func,
+                 cyber::base::ThreadPool* thread_pool) {
+  if (begin >= end) {
+    return;
+  }
+  const size_t size = end - begin;
+  const size_t max_num_chunks = size / std::max<size_t>(min_chunk_size, 1);
+  const size_t chunks =
+      std::max<size_t>(1, std::min(num_chunks, max_num_chunks));
+  if (chunks == 1 || thread_pool == nullptr) {
+    func(begin, end);
+    return;
+  }
+
+  // the first size % chunks chunks take one more index
+  const size_t chunk_size = size / chunks;
+  const size_t remainder = size % chunks;
+  const auto chunk_begin = [&](const size_t i) {
+    return begin + i * chunk_size + std::min(i, remainder);
+  };
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(chunks - 1);
+  for (size_t i = 1; i < chunks; ++i) {
+    auto future =
+        thread_pool->Enqueue(func, chunk_begin(i), chunk_begin(i + 1));
+    if (future.valid()) {
+      futures.push_back(std::move(future));
+    } else {
+      func(chunk_begin(i), chunk_begin(i + 1));
+    }
+  }
+  func(chunk_begin(0), chunk_begin(1));
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace util
+}  // namespace planning
+}  // namespace apollo
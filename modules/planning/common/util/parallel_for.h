@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "cyber/base/thread_pool.h"
+
+namespace apollo {
+namespace planning {
+namespace util {
+
+/**
+ * @brief Split [begin, end) into at most num_chunks contiguous chunks of at
+ *        least min_chunk_size indices, and call func(chunk_begin, chunk_end)
+ *        on each of them. The first chunk runs on the calling thread and the
+ *        others on thread_pool, or on the calling thread as well if
+ *        thread_pool is null or stopped. Returns once every chunk is done.
+ */
+void ParallelFor(const size_t begin, const size_t end, const size_t num_chunks,
+                 const size_t min_chunk_size,
+                 const std::function<void(size_t, size_t)>& func,
+                 cyber::base::ThreadPool* thread_pool);
+
+}  // namespace util
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/common/util/parallel_for.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+namespace util {
+namespace {
+
+struct Chunk {
+  size_t begin = 0;
+  size_t end = 0;
+  std::thread::id thread_id;
+};
+
+// the chunks func was called on, in index order
+std::vector<Chunk> RunParallelFor(const size_t begin, const size_t end,
+                                  const size_t num_chunks,
+                                  const size_t min_chunk_size,
+                                  cyber::base::ThreadPool* thread_pool) {
+  std::mutex mutex;
+  std::vector<Chunk> chunks;
+  ParallelFor(
+      begin, end, num_chunks, min_chunk_size,
+      [&](const size_t chunk_begin, const size_t chunk_end) {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks.push_back({chunk_begin, chunk_end, std::this_thread::get_id()});
+      },
+      thread_pool);
+  std::sort(chunks.begin(), chunks.end(),
+            [](const Chunk& lhs, const Chunk& rhs) {
+              return lhs.begin < rhs.begin;
+            });
+  return chunks;
+}
+
+typedef std::vector<std::pair<size_t, size_t>> ChunkRanges;
+
+ChunkRanges Ranges(const std::vector<Chunk>& chunks) {
+  ChunkRanges ranges;
+  for (const auto& chunk : chunks) {
+    ranges.emplace_back(chunk.begin, chunk.end);
+  }
+  return ranges;
+}
+
+}  // namespace
+
+TEST(ParallelForTest, Chunking) {
+  cyber::base::ThreadPool thread_pool(3);
+  // the first chunks take the remainder
+  EXPECT_EQ((ChunkRanges{{3, 6}, {6, 9}, {9, 11}, {11, 13}}),
+            Ranges(RunParallelFor(3, 13, 4, 1, &thread_pool)));
+  // no more chunks than indices
+  EXPECT_EQ((ChunkRanges{{0, 1}, {1, 2}}),
+            Ranges(RunParallelFor(0, 2, 4, 1, &thread_pool)));
+  // no chunk smaller than min_chunk_size
+  EXPECT_EQ((ChunkRanges{{0, 5}, {5, 10}}),
+            Ranges(RunParallelFor(0, 10, 4, 4, &thread_pool)));
+  EXPECT_EQ((ChunkRanges{{0, 3}}),
+            Ranges(RunParallelFor(0, 3, 4, 4, &thread_pool)));
+  EXPECT_EQ((ChunkRanges{{0, 10}}),
+            Ranges(RunParallelFor(0, 10, 0, 1, &thread_pool)));
+}
+
+TEST(ParallelForTest, FirstChunkInline) {
+  cyber::base::ThreadPool thread_pool(2);
+  const auto chunks = RunParallelFor(0, 30, 3, 1, &thread_pool);
+  ASSERT_EQ(3, chunks.size());
+  EXPECT_EQ(std::this_thread::get_id(), chunks[0].thread_id);
+  EXPECT_NE(std::this_thread::get_id(), chunks[1].thread_id);
+  EXPECT_NE(std::this_thread::get_id(), chunks[2].thread_id);
+
+  // all on the calling thread without a thread pool
+  const auto inline_chunks = RunParallelFor(0, 30, 3, 1, nullptr);
+  ASSERT_EQ(1, inline_chunks.size());
+  EXPECT_EQ(0, inline_chunks[0].begin);
+  EXPECT_EQ(30, inline_chunks[0].end);
+  EXPECT_EQ(std::this_thread::get_id(), inline_chunks[0].thread_id);
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  cyber::base::ThreadPool thread_pool(2);
+  EXPECT_TRUE(RunParallelFor(5, 5, 4, 1, &thread_pool).empty());
+  EXPECT_TRUE(RunParallelFor(6, 5, 4, 1, &thread_pool).empty());
+  EXPECT_TRUE(RunParallelFor(5, 5, 4, 1, nullptr).empty());
+}
+
+}  // namespace util
+}  // namespace planning
+}  // namespace apollo
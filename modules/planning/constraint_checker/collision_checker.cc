@@ -83,7 +83,7 @@ bool CollisionChecker::InCollision(
 }
 
 bool CollisionChecker::InCollision(
-    const DiscretizedTrajectory& discretized_trajectory) {
+    const DiscretizedTrajectory& discretized_trajectory) const {
   CHECK_LE(discretized_trajectory.NumOfPoints(),
            predicted_bounding_rectangles_.size());
   const auto& vehicle_config =
@@ -41,7 +41,7 @@ class CollisionChecker {
       const ReferenceLineInfo* ptr_reference_line_info,
       const std::shared_ptr<PathTimeGraph>& ptr_path_time_graph);
 
-  bool InCollision(const DiscretizedTrajectory& discretized_trajectory);
+  bool InCollision(const DiscretizedTrajectory& discretized_trajectory) const;
 
   static bool InCollision(const std::vector<const Obstacle*>& obstacles,
                           const DiscretizedTrajectory& ego_trajectory,
@@ -0,0 +1,246 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Replays a corpus of recorded planning inputs through OnLanePlanning,
+ *        without the cyber runtime, one benchmark per frame. A frame is the
+ *        set of <prefix>_chassis.pb.txt, <prefix>_localization.pb.txt and
+ *        <prefix>_prediction.pb.txt files in --benchmark_data_dir, with the
+ *        optional <prefix>_routing.pb.txt and <prefix>_traffic_light.pb.txt,
+ *        as in the integration test data. Each benchmark initializes one
+ *        planner and plans the frame once before timing, so the iterations
+ *        measure OnLanePlanning::RunOnce replanning a frame it planned the
+ *        cycle before. The counters report the percentiles of the latencies
+ *        recorded in ADCTrajectory::latency_stats: per stage (frame init,
+ *        the rest of the cycle and the total), per reference line and per
+ *        task.
+ *        Run with
+ *        bazel run -c opt //modules/planning/integration_tests:planning_regression_benchmark -- \
+ *            --benchmark_out=result.json --benchmark_out_format=json
+ *        and diff the results of two builds with compare.py of the
+ *        benchmark library.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "cyber/time/clock.h"
+#include "modules/common/configs/config_gflags.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/on_lane_planning.h"
+
+DEFINE_string(benchmark_data_dir,
+              "modules/planning/testdata/sunnyvale_loop_test",
+              "the folder of the recorded planning inputs to replay");
+DEFINE_string(benchmark_routing_file, "",
+              "the routing of the frames without <prefix>_routing.pb.txt, "
+              "relative to benchmark_data_dir");
+DEFINE_string(benchmark_planning_config_file,
+              "/apollo/modules/planning/conf/planning_config.pb.txt",
+              "planning config file for the replay");
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::cyber::Clock;
+
+const char kLocalizationSuffix[] = "_localization.pb.txt";
+
+struct ReplayFrame {
+  std::string name;
+  LocalView local_view;
+};
+
+template <typename T>
+bool LoadProto(const std::string& file, std::shared_ptr<T>* message) {
+  auto proto = std::make_shared<T>();
+  if (!cyber::common::GetProtoFromFile(file, proto.get())) {
+    AERROR << "failed to load file: " << file;
+    return false;
+  }
+  *message = std::move(proto);
+  return true;
+}
+
+bool LoadFrame(const std::string& prefix, ReplayFrame* frame) {
+  const std::string path_prefix = FLAGS_benchmark_data_dir + "/" + prefix;
+  LocalView* local_view = &frame->local_view;
+  if (!LoadProto(path_prefix + "_chassis.pb.txt", &local_view->chassis) ||
+      !LoadProto(path_prefix + kLocalizationSuffix,
+                 &local_view->localization_estimate) ||
+      !LoadProto(path_prefix + "_prediction.pb.txt",
+                 &local_view->prediction_obstacles)) {
+    return false;
+  }
+  std::string routing_file = path_prefix + "_routing.pb.txt";
+  if (!cyber::common::PathExists(routing_file)) {
+    routing_file =
+        FLAGS_benchmark_data_dir + "/" + FLAGS_benchmark_routing_file;
+  }
+  if (!LoadProto(routing_file, &local_view->routing)) {
+    return false;
+  }
+  const std::string traffic_light_file = path_prefix + "_traffic_light.pb.txt";
+  if (cyber::common::PathExists(traffic_light_file)) {
+    if (!LoadProto(traffic_light_file, &local_view->traffic_light)) {
+      return false;
+    }
+  } else {
+    local_view->traffic_light =
+        std::make_shared<perception::TrafficLightDetection>();
+  }
+  frame->name = prefix;
+  return true;
+}
+
+std::vector<ReplayFrame> LoadFrames() {
+  std::vector<std::string> prefixes;
+  for (const auto& file : cyber::common::Glob(FLAGS_benchmark_data_dir + "/*" +
+                                              kLocalizationSuffix)) {
+    const std::string file_name = cyber::common::GetFileName(file);
+    prefixes.push_back(file_name.substr(
+        0, file_name.size() - (sizeof(kLocalizationSuffix) - 1)));
+  }
+  std::sort(prefixes.begin(), prefixes.end());
+
+  std::vector<ReplayFrame> frames;
+  for (const auto& prefix : prefixes) {
+    ReplayFrame frame;
+    if (LoadFrame(prefix, &frame)) {
+      frames.push_back(std::move(frame));
+    }
+  }
+  return frames;
+}
+
+void ReportLatencies(
+    const std::map<std::string, std::vector<double>>& latencies_ms,
+    benchmark::State* state) {
+  for (const auto& latencies : latencies_ms) {
+    std::vector<double> sorted_latencies = latencies.second;
+    std::sort(sorted_latencies.begin(), sorted_latencies.end());
+    const auto percentile = [&sorted_latencies](const double p) {
+      return sorted_latencies[static_cast<size_t>(
+          p * static_cast<double>(sorted_latencies.size() - 1))];
+    };
+    state->counters[latencies.first + "/p50_ms"] = percentile(0.5);
+    state->counters[latencies.first + "/p90_ms"] = percentile(0.9);
+    state->counters[latencies.first + "/p99_ms"] = percentile(0.99);
+    state->counters[latencies.first + "/max_ms"] = sorted_latencies.back();
+  }
+}
+
+void RecordLatencies(const LatencyStats& latency_stats,
+                     std::map<std::string, std::vector<double>>* latencies_ms) {
+  (*latencies_ms)["stage/init_frame"].push_back(
+      latency_stats.init_frame_time_ms());
+  (*latencies_ms)["stage/plan"].push_back(latency_stats.total_time_ms() -
+                                          latency_stats.init_frame_time_ms());
+  (*latencies_ms)["stage/total"].push_back(latency_stats.total_time_ms());
+  for (const auto& reference_line_stats :
+       latency_stats.reference_line_stats()) {
+    (*latencies_ms)["reference_line/" + reference_line_stats.id()].push_back(
+        reference_line_stats.time_ms());
+  }
+  for (const auto& task_stats : latency_stats.task_stats()) {
+    (*latencies_ms)["task/" + task_stats.name()].push_back(
+        task_stats.time_ms());
+  }
+}
+
+void BM_ReplayFrame(benchmark::State& state, const ReplayFrame* frame,
+                    const PlanningConfig* config) {
+  auto injector = std::make_shared<DependencyInjector>();
+  OnLanePlanning planning(injector);
+  if (!planning.Init(*config).ok()) {
+    state.SkipWithError("failed to init planning");
+    return;
+  }
+  Clock::SetNowInSeconds(
+      frame->local_view.localization_estimate->header().timestamp_sec());
+  // the first cycle plans from scratch and builds the reference lines
+  ADCTrajectory warm_up_trajectory;
+  planning.RunOnce(frame->local_view, &warm_up_trajectory);
+
+  std::map<std::string, std::vector<double>> latencies_ms;
+  int num_failures = 0;
+  for (auto _ : state) {
+    ADCTrajectory trajectory;
+    const auto start_time = std::chrono::steady_clock::now();
+    planning.RunOnce(frame->local_view, &trajectory);
+    state.SetIterationTime(std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start_time)
+                               .count());
+
+    if (trajectory.header().status().error_code() != common::ErrorCode::OK) {
+      ++num_failures;
+    }
+    RecordLatencies(trajectory.latency_stats(), &latencies_ms);
+  }
+  ReportLatencies(latencies_ms, &state);
+  state.counters["failures"] = num_failures;
+}
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  FLAGS_map_dir = "modules/map/data/sunnyvale_loop";
+  FLAGS_test_base_map_filename = "base_map_test.bin";
+  ::benchmark::Initialize(&argc, argv);
+  ::google::ParseCommandLineFlags(&argc, &argv, true);
+
+  // the frames are independent snapshots planned synchronously
+  FLAGS_enable_reference_line_provider_thread = false;
+  FLAGS_align_prediction_time = false;
+  FLAGS_enable_record_debug = true;
+  FLAGS_planning_test_mode = true;
+  apollo::cyber::Clock::SetMode(apollo::cyber::proto::MODE_MOCK);
+
+  apollo::planning::PlanningConfig config;
+  ACHECK(apollo::cyber::common::GetProtoFromFile(
+      FLAGS_benchmark_planning_config_file, &config))
+      << "failed to load planning config file "
+      << FLAGS_benchmark_planning_config_file;
+
+  const std::vector<apollo::planning::ReplayFrame> frames =
+      apollo::planning::LoadFrames();
+  if (frames.empty()) {
+    AERROR << "no planning inputs found in " << FLAGS_benchmark_data_dir;
+    return 1;
+  }
+  for (const auto& frame : frames) {
+    ::benchmark::RegisterBenchmark(
+        ("BM_ReplayFrame/" + frame.name).c_str(),
+        apollo::planning::BM_ReplayFrame, &frame, &config)
+        ->UseManualTime()
+        ->Unit(::benchmark::kMillisecond);
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -88,6 +88,10 @@ bool BirdviewImgFeatureRenderer::Init(const PlanningSemanticMapConfig& config) {
   std::vector<cv::Mat> merge_imgs = {ego_cur_point_img_, ego_cur_box_img_};
   cv::merge(merge_imgs, stacked_ego_cur_status_img_);
 
+  const cv::Size local_map_size(config_.width(), config_.height());
+  const cv::Point2i ego_local_idx(config_.ego_idx_x(), config_.ego_idx_y());
+  local_map_cropper_.reset(new LocalMapCropper(local_map_size, ego_local_idx));
+
   return true;
 }
 
@@ -604,35 +608,8 @@ bool BirdviewImgFeatureRenderer::CropByPose(const double ego_x,
   cv::Point2i ego_img_idx = GetPointImgIdx(ego_x - map_bottom_left_point_x_,
                                            ego_y - map_bottom_left_point_y_, 0,
                                            base_roadmap_img_.size[0]);
-  if (ego_img_idx.x < 0 || ego_img_idx.x + 1 > base_roadmap_img_.size[1] ||
-      ego_img_idx.y < 0 || ego_img_idx.y + 1 > base_roadmap_img_.size[0]) {
-    AERROR << "ego vehicle position out of bound of base map";
-    return false;
-  }
-
-  const int rough_radius = static_cast<int>(sqrt(
-      config_.height() * config_.height() + config_.width() * config_.width()));
-  if (ego_img_idx.x - rough_radius < 0 || ego_img_idx.y - rough_radius < 0) {
-    AERROR << "cropping out of bound of base map";
-    return false;
-  }
-
-  cv::Rect rough_rect(ego_img_idx.x - rough_radius,
-                      ego_img_idx.y - rough_radius, 2 * rough_radius,
-                      2 * rough_radius);
-  cv::Mat rotation_matrix =
-      cv::getRotationMatrix2D(cv::Point2i(rough_radius, rough_radius),
-                              90.0 - ego_heading * 180.0 / M_PI, 1.0);
-  cv::Mat rotated_mat;
-  cv::warpAffine(base_map(rough_rect), rotated_mat, rotation_matrix,
-                 base_map(rough_rect).size());
-
-  cv::Rect fine_rect(rough_radius - config_.ego_idx_x(),
-                     rough_radius - config_.ego_idx_y(), config_.height(),
-                     config_.width());
-
-  rotated_mat(fine_rect).copyTo(*img_feature);
-  return true;
+  return local_map_cropper_->Crop(base_map, ego_img_idx, ego_heading,
+                                  img_feature);
 }
 
 cv::Point2i BirdviewImgFeatureRenderer::GetPointImgIdx(
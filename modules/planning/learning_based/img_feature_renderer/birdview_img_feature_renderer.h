@@ -21,12 +21,14 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "cyber/common/macros.h"
 #include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/learning_based/img_feature_renderer/local_map_cropper.h"
 #include "modules/planning/proto/learning_data.pb.h"
 #include "modules/planning/proto/planning_semantic_map_config.pb.h"
 #include "opencv2/opencv.hpp"
@@ -293,6 +295,7 @@ class BirdviewImgFeatureRenderer {
   cv::Mat ego_cur_point_img_;
   cv::Mat ego_cur_box_img_;
   cv::Mat stacked_ego_cur_status_img_;
+  std::unique_ptr<LocalMapCropper> local_map_cropper_;
 
   DECLARE_SINGLETON(BirdviewImgFeatureRenderer)
 };
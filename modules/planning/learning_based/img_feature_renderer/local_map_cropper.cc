@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ */
+
+#include "modules/planning/learning_based/img_feature_renderer/local_map_cropper.h"
+
+#include <cmath>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+LocalMapCropper::LocalMapCropper(const cv::Size& local_map_size,
+                                 const cv::Point2i& ego_local_idx)
+    : local_map_size_(local_map_size), ego_local_idx_(ego_local_idx) {
+  radius_ = static_cast<int>(
+      std::sqrt(local_map_size_.height * local_map_size_.height +
+                local_map_size_.width * local_map_size_.width));
+}
+
+bool LocalMapCropper::Crop(const cv::Mat& base_map,
+                           const cv::Point2i& ego_img_idx,
+                           const double ego_heading,
+                           cv::Mat* local_map) const {
+  if (ego_img_idx.x < 0 || ego_img_idx.x + 1 > base_map.cols ||
+      ego_img_idx.y < 0 || ego_img_idx.y + 1 > base_map.rows) {
+    AERROR << "ego vehicle position out of bound of base map";
+    return false;
+  }
+  if (ego_img_idx.x - radius_ < 0 || ego_img_idx.y - radius_ < 0 ||
+      ego_img_idx.x + radius_ > base_map.cols ||
+      ego_img_idx.y + radius_ > base_map.rows) {
+    AERROR << "cropping out of bound of base map";
+    return false;
+  }
+
+  // rotate around ego position, then move it to its place on the local map
+  cv::Mat affine_matrix = cv::getRotationMatrix2D(
+      ego_img_idx, 90.0 - ego_heading * 180.0 / M_PI, 1.0);
+  affine_matrix.at<double>(0, 2) += ego_local_idx_.x - ego_img_idx.x;
+  affine_matrix.at<double>(1, 2) += ego_local_idx_.y - ego_img_idx.y;
+  cv::warpAffine(base_map, *local_map, affine_matrix, local_map_size_);
+  return true;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Crop local maps around the ego pose from a prerendered base map
+ */
+
+#pragma once
+
+#include "opencv2/opencv.hpp"
+
+namespace apollo {
+namespace planning {
+
+class LocalMapCropper {
+ public:
+  /**
+   * @brief Constructor
+   * @param local_map_size size of the local map img
+   * @param ego_local_idx ego position on the local map img
+   */
+  LocalMapCropper(const cv::Size& local_map_size,
+                  const cv::Point2i& ego_local_idx);
+
+  /**
+   * @brief crop the local map around ego position, rotated so that the ego
+   * vehicle faces up, with a single affine warp from the base map straight
+   * into local_map. It keeps no state, so it may be called concurrently.
+   * @param base_map the large map to crop on
+   * @param ego_img_idx ego position on the base map img
+   * @param ego_heading ego heading
+   * @param local_map a pointer to opencv img to render on
+   */
+  bool Crop(const cv::Mat& base_map, const cv::Point2i& ego_img_idx,
+            const double ego_heading, cv::Mat* local_map) const;
+
+ private:
+  cv::Size local_map_size_;
+  cv::Point2i ego_local_idx_;
+  // radius around ego position on the base map covered by the local map
+  int radius_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
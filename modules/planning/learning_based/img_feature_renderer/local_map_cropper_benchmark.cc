@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Compares the render time per frame of the static road map and speed
+ *        limit layers of BirdviewImgFeatureRenderer, with a rotation of a
+ *        rough crop around ego position followed by a fine crop (argument 0),
+ *        as done before LocalMapCropper, and with LocalMapCropper (argument
+ *        1), for a vehicle driving through synthetic base maps. Run with
+ *        bazel run -c opt //modules/planning/learning_based/img_feature_renderer:local_map_cropper_benchmark
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/learning_based/img_feature_renderer/local_map_cropper.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+// same as planning_semantic_map_config.pb.txt
+const cv::Size kLocalMapSize(200, 200);
+const cv::Point2i kEgoLocalIdx(100, 160);
+constexpr int kBaseMapSize = 4000;
+constexpr int kNumFrames = 100;
+
+cv::Mat MakeBaseMap(const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> position(0, kBaseMapSize - 1);
+  std::uniform_int_distribution<int> color(0, 255);
+  cv::Mat base_map(kBaseMapSize, kBaseMapSize, CV_8UC3, cv::Scalar(0, 0, 0));
+  for (int i = 0; i < 2000; ++i) {
+    cv::line(base_map, cv::Point2i(position(rng), position(rng)),
+             cv::Point2i(position(rng), position(rng)),
+             cv::Scalar(color(rng), color(rng), color(rng)), 8);
+  }
+  return base_map;
+}
+
+struct Pose {
+  cv::Point2i img_idx;
+  double heading = 0.0;
+};
+
+// a vehicle driving on a circle around the map center at 0.2m / pixel,
+// 10m/s and 10Hz
+std::vector<Pose> MakePoses() {
+  std::vector<Pose> poses;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const double angle = i * 5.0 / 1000.0;
+    Pose pose;
+    pose.img_idx = cv::Point2i(
+        kBaseMapSize / 2 + static_cast<int>(1000.0 * std::cos(angle)),
+        kBaseMapSize / 2 - static_cast<int>(1000.0 * std::sin(angle)));
+    pose.heading = angle + M_PI_2;
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+// BirdviewImgFeatureRenderer::CropByPose before LocalMapCropper
+void LegacyCrop(const cv::Mat& base_map, const Pose& pose,
+                cv::Mat* local_map) {
+  const int rough_radius = static_cast<int>(
+      std::sqrt(kLocalMapSize.height * kLocalMapSize.height +
+                kLocalMapSize.width * kLocalMapSize.width));
+  cv::Rect rough_rect(pose.img_idx.x - rough_radius,
+                      pose.img_idx.y - rough_radius, 2 * rough_radius,
+                      2 * rough_radius);
+  cv::Mat rotation_matrix =
+      cv::getRotationMatrix2D(cv::Point2i(rough_radius, rough_radius),
+                              90.0 - pose.heading * 180.0 / M_PI, 1.0);
+  cv::Mat rotated_mat;
+  cv::warpAffine(base_map(rough_rect), rotated_mat, rotation_matrix,
+                 base_map(rough_rect).size());
+  cv::Rect fine_rect(rough_radius - kEgoLocalIdx.x,
+                     rough_radius - kEgoLocalIdx.y, kLocalMapSize.width,
+                     kLocalMapSize.height);
+  rotated_mat(fine_rect).copyTo(*local_map);
+}
+
+void BM_StaticLayers(benchmark::State& state) {
+  const bool use_cropper = state.range(0) != 0;
+  const std::vector<Pose> poses = MakePoses();
+  const cv::Mat base_roadmap = MakeBaseMap(0);
+  const cv::Mat base_speedlimit = MakeBaseMap(1);
+  const LocalMapCropper cropper(kLocalMapSize, kEgoLocalIdx);
+  for (auto _ : state) {
+    for (const Pose& pose : poses) {
+      cv::Mat road_map;
+      cv::Mat speed_limit;
+      if (use_cropper) {
+        cropper.Crop(base_roadmap, pose.img_idx, pose.heading, &road_map);
+        cropper.Crop(base_speedlimit, pose.img_idx, pose.heading,
+                     &speed_limit);
+      } else {
+        LegacyCrop(base_roadmap, pose, &road_map);
+        LegacyCrop(base_speedlimit, pose, &speed_limit);
+      }
+      benchmark::DoNotOptimize(road_map.data);
+      benchmark::DoNotOptimize(speed_limit.data);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * poses.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_StaticLayers)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/learning_based/img_feature_renderer/local_map_cropper.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+// same as planning_semantic_map_config.pb.txt
+const cv::Size kLocalMapSize(200, 200);
+const cv::Point2i kEgoLocalIdx(100, 160);
+constexpr int kBaseMapSize = 1500;
+
+// smooth, so that the bilinear interpolation of the two crops differs by
+// little where their sub-pixel positions are rounded differently
+cv::Mat MakeBaseMap() {
+  cv::Mat base_map(kBaseMapSize, kBaseMapSize, CV_8UC3);
+  for (int y = 0; y < kBaseMapSize; ++y) {
+    for (int x = 0; x < kBaseMapSize; ++x) {
+      base_map.at<cv::Vec3b>(y, x) = cv::Vec3b(
+          static_cast<uchar>(128.0 + 100.0 * std::sin(x / 40.0)),
+          static_cast<uchar>(128.0 + 100.0 * std::cos(y / 60.0)),
+          static_cast<uchar>(128.0 + 100.0 * std::sin((x + y) / 80.0)));
+    }
+  }
+  return base_map;
+}
+
+// BirdviewImgFeatureRenderer::CropByPose before LocalMapCropper: a rotation
+// of a rough crop around ego position followed by a fine crop
+void LegacyCrop(const cv::Mat& base_map, const cv::Point2i& ego_img_idx,
+                const double ego_heading, cv::Mat* local_map) {
+  const int rough_radius = static_cast<int>(
+      std::sqrt(kLocalMapSize.height * kLocalMapSize.height +
+                kLocalMapSize.width * kLocalMapSize.width));
+  cv::Rect rough_rect(ego_img_idx.x - rough_radius,
+                      ego_img_idx.y - rough_radius, 2 * rough_radius,
+                      2 * rough_radius);
+  cv::Mat rotation_matrix =
+      cv::getRotationMatrix2D(cv::Point2i(rough_radius, rough_radius),
+                              90.0 - ego_heading * 180.0 / M_PI, 1.0);
+  cv::Mat rotated_mat;
+  cv::warpAffine(base_map(rough_rect), rotated_mat, rotation_matrix,
+                 base_map(rough_rect).size());
+  cv::Rect fine_rect(rough_radius - kEgoLocalIdx.x,
+                     rough_radius - kEgoLocalIdx.y, kLocalMapSize.width,
+                     kLocalMapSize.height);
+  rotated_mat(fine_rect).copyTo(*local_map);
+}
+
+// the largest difference of a pixel channel between the two crops
+double CropDifference(const cv::Mat& base_map, const cv::Point2i& ego_img_idx,
+                      const double ego_heading) {
+  const LocalMapCropper cropper(kLocalMapSize, kEgoLocalIdx);
+  cv::Mat local_map;
+  EXPECT_TRUE(cropper.Crop(base_map, ego_img_idx, ego_heading, &local_map));
+  cv::Mat expected_local_map;
+  LegacyCrop(base_map, ego_img_idx, ego_heading, &expected_local_map);
+  EXPECT_EQ(expected_local_map.size(), local_map.size());
+  EXPECT_EQ(expected_local_map.type(), local_map.type());
+  return cv::norm(expected_local_map, local_map, cv::NORM_INF);
+}
+
+}  // namespace
+
+TEST(LocalMapCropperTest, SameAsLegacyCrop) {
+  const cv::Mat base_map = MakeBaseMap();
+  const cv::Point2i ego_img_idx(700, 800);
+  // the sub-pixel positions are integers when facing along an axis
+  for (const double heading : {0.0, M_PI_2, M_PI, -M_PI_2}) {
+    EXPECT_EQ(0.0, CropDifference(base_map, ego_img_idx, heading));
+  }
+  for (const double heading : {0.3, 2.0, -1.2, -2.9}) {
+    EXPECT_GE(2.0, CropDifference(base_map, ego_img_idx, heading));
+  }
+}
+
+TEST(LocalMapCropperTest, OutOfBound) {
+  const cv::Mat base_map = MakeBaseMap();
+  const LocalMapCropper cropper(kLocalMapSize, kEgoLocalIdx);
+  cv::Mat local_map;
+  EXPECT_FALSE(cropper.Crop(base_map, cv::Point2i(-1, 800), 0.0, &local_map));
+  EXPECT_FALSE(cropper.Crop(base_map, cv::Point2i(700, kBaseMapSize), 0.0,
+                            &local_map));
+  // the local map in any heading is not within the base map
+  EXPECT_FALSE(cropper.Crop(base_map, cv::Point2i(100, 800), 0.0, &local_map));
+  EXPECT_FALSE(cropper.Crop(base_map, cv::Point2i(700, kBaseMapSize - 100),
+                            0.0, &local_map));
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -16,6 +16,8 @@
 
 #include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
 
+#include <algorithm>
+
 #include "cyber/common/log.h"
 #include "modules/planning/common/planning_gflags.h"
 
@@ -24,8 +26,47 @@ namespace planning {
 
 namespace {
 constexpr double kMaxVariableRange = 1.0e10;
+
+// OSQP only reads the upper triangular part of P. The entries below the
+// diagonal are dropped, so that the values given to osqp_update_P map one to
+// one onto the ones stored in the workspace.
+void KeepUpperTriangular(std::vector<c_float>* P_data,
+                         std::vector<c_int>* P_indices,
+                         std::vector<c_int>* P_indptr) {
+  size_t num_kept = 0;
+  size_t column_begin = 0;
+  for (size_t column = 0; column + 1 < P_indptr->size(); ++column) {
+    const size_t column_end = static_cast<size_t>(P_indptr->at(column + 1));
+    for (size_t k = column_begin; k < column_end; ++k) {
+      if (P_indices->at(k) <= static_cast<c_int>(column)) {
+        P_data->at(num_kept) = P_data->at(k);
+        P_indices->at(num_kept) = P_indices->at(k);
+        ++num_kept;
+      }
+    }
+    column_begin = column_end;
+    P_indptr->at(column + 1) = static_cast<c_int>(num_kept);
+  }
+  P_data->resize(num_kept);
+  P_indices->resize(num_kept);
+}
 }  // namespace
 
+void PiecewiseJerkWorkspace::Reset() {
+  if (work_ != nullptr) {
+    osqp_cleanup(work_);
+    work_ = nullptr;
+  }
+  P_data_.clear();
+  P_indices_.clear();
+  P_indptr_.clear();
+  A_data_.clear();
+  A_indices_.clear();
+  A_indptr_.clear();
+  primal_.clear();
+  dual_.clear();
+}
+
 PiecewiseJerkProblem::PiecewiseJerkProblem(
     const size_t num_of_knots, const double delta_s,
     const std::array<double, 3>& x_init) {
@@ -88,6 +129,9 @@ OSQPData* PiecewiseJerkProblem::FormulateProblem() {
 }
 
 bool PiecewiseJerkProblem::Optimize(const int max_iter) {
+  if (workspace_ != nullptr) {
+    return OptimizeWithWorkspace(max_iter);
+  }
   OSQPData* data = FormulateProblem();
 
   OSQPSettings* settings = SolverDefaultSettings();
@@ -116,15 +160,7 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   }
 
   // extract primal results
-  x_.resize(num_of_knots_);
-  dx_.resize(num_of_knots_);
-  ddx_.resize(num_of_knots_);
-  for (size_t i = 0; i < num_of_knots_; ++i) {
-    x_.at(i) = osqp_work->solution->x[i] / scale_factor_[0];
-    dx_.at(i) = osqp_work->solution->x[i + num_of_knots_] / scale_factor_[1];
-    ddx_.at(i) =
-        osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
-  }
+  ExtractSolution(osqp_work->solution->x);
 
   // Cleanup
   osqp_cleanup(osqp_work);
@@ -133,6 +169,178 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   return true;
 }
 
+bool PiecewiseJerkProblem::OptimizeWithWorkspace(const int max_iter) {
+  std::vector<c_float> P_data;
+  std::vector<c_int> P_indices;
+  std::vector<c_int> P_indptr;
+  CalculateKernel(&P_data, &P_indices, &P_indptr);
+  KeepUpperTriangular(&P_data, &P_indices, &P_indptr);
+
+  std::vector<c_float> A_data;
+  std::vector<c_int> A_indices;
+  std::vector<c_int> A_indptr;
+  std::vector<c_float> lower_bounds;
+  std::vector<c_float> upper_bounds;
+  CalculateAffineConstraint(&A_data, &A_indices, &A_indptr, &lower_bounds,
+                            &upper_bounds);
+  CHECK_EQ(lower_bounds.size(), upper_bounds.size());
+
+  std::vector<c_float> q;
+  CalculateOffset(&q);
+
+  PiecewiseJerkWorkspace* workspace = workspace_;
+  if (workspace->work_ != nullptr && P_indices == workspace->P_indices_ &&
+      P_indptr == workspace->P_indptr_ && A_indices == workspace->A_indices_ &&
+      A_indptr == workspace->A_indptr_) {
+    // same sparsity pattern, only the changed values are updated and the KKT
+    // system is refactorized numerically if the matrices changed
+    OSQPWorkspace* work = workspace->work_;
+    const bool is_P_updated = P_data != workspace->P_data_;
+    const bool is_A_updated = A_data != workspace->A_data_;
+    c_int status = 0;
+    if (is_P_updated && is_A_updated) {
+      status = osqp_update_P_A(work, P_data.data(), OSQP_NULL,
+                               static_cast<c_int>(P_data.size()),
+                               A_data.data(), OSQP_NULL,
+                               static_cast<c_int>(A_data.size()));
+    } else if (is_P_updated) {
+      status = osqp_update_P(work, P_data.data(), OSQP_NULL,
+                             static_cast<c_int>(P_data.size()));
+    } else if (is_A_updated) {
+      status = osqp_update_A(work, A_data.data(), OSQP_NULL,
+                             static_cast<c_int>(A_data.size()));
+    }
+    if (status == 0) {
+      status = osqp_update_lin_cost(work, q.data());
+    }
+    if (status == 0) {
+      status = osqp_update_bounds(work, lower_bounds.data(),
+                                  upper_bounds.data());
+    }
+    if (status == 0) {
+      status = osqp_update_max_iter(work, max_iter);
+    }
+    if (status == 0) {
+      WarmStart(workspace);
+      ++workspace->num_updates_;
+    } else {
+      AWARN << "failed to update osqp workspace, status: " << status;
+      workspace->Reset();
+    }
+  } else {
+    workspace->Reset();
+  }
+
+  if (workspace->work_ == nullptr) {
+    // osqp_setup copies the problem data
+    const size_t kernel_dim = 3 * num_of_knots_;
+    const size_t num_affine_constraint = lower_bounds.size();
+    OSQPData data;
+    data.n = kernel_dim;
+    data.m = num_affine_constraint;
+    data.P = csc_matrix(kernel_dim, kernel_dim, P_data.size(), P_data.data(),
+                        P_indices.data(), P_indptr.data());
+    data.q = q.data();
+    data.A = csc_matrix(num_affine_constraint, kernel_dim, A_data.size(),
+                        A_data.data(), A_indices.data(), A_indptr.data());
+    data.l = lower_bounds.data();
+    data.u = upper_bounds.data();
+
+    OSQPSettings* settings = SolverDefaultSettings();
+    settings->max_iter = max_iter;
+    workspace->work_ = osqp_setup(&data, settings);
+    c_free(data.P);
+    c_free(data.A);
+    c_free(settings);
+    if (workspace->work_ == nullptr) {
+      AERROR << "failed to set up osqp workspace";
+      return false;
+    }
+    ++workspace->num_setups_;
+  }
+  workspace->P_data_ = std::move(P_data);
+  workspace->P_indices_ = std::move(P_indices);
+  workspace->P_indptr_ = std::move(P_indptr);
+  workspace->A_data_ = std::move(A_data);
+  workspace->A_indices_ = std::move(A_indices);
+  workspace->A_indptr_ = std::move(A_indptr);
+
+  OSQPWorkspace* work = workspace->work_;
+  osqp_solve(work);
+
+  auto status = work->info->status_val;
+  if (status < 0 || (status != 1 && status != 2)) {
+    AERROR << "failed optimization status:\t" << work->info->status;
+    workspace->Reset();
+    return false;
+  } else if (work->solution == nullptr) {
+    AERROR << "The solution from OSQP is nullptr";
+    workspace->Reset();
+    return false;
+  }
+
+  ExtractSolution(work->solution->x);
+  workspace->primal_.assign(work->solution->x,
+                            work->solution->x + work->data->n);
+  workspace->dual_.assign(work->solution->y,
+                          work->solution->y + work->data->m);
+  return true;
+}
+
+void PiecewiseJerkProblem::WarmStart(PiecewiseJerkWorkspace* workspace) const {
+  // without shift the workspace already starts from the last iterates
+  const size_t n = num_of_knots_;
+  const size_t shift = warm_start_shift_;
+  if (shift == 0 || shift >= n || workspace->primal_.size() != 3 * n) {
+    return;
+  }
+  // the last knot is repeated at the end of the shifted blocks
+  const auto shift_block = [shift](const c_float* block, const size_t size,
+                                   c_float* shifted_block) {
+    for (size_t i = 0; i < size; ++i) {
+      shifted_block[i] = block[std::min(i + shift, size - 1)];
+    }
+  };
+
+  // blocks of x, x' and x'', with x moved onto the initial state
+  std::vector<c_float> primal(3 * n);
+  for (size_t i = 0; i < 3; ++i) {
+    shift_block(workspace->primal_.data() + i * n, n, primal.data() + i * n);
+  }
+  const c_float x_offset = x_init_[0] * scale_factor_[0] - primal[0];
+  for (size_t i = 0; i < n; ++i) {
+    primal[i] += x_offset;
+  }
+
+  // the duals follow the constraints of CalculateAffineConstraint: bounds on
+  // x, x', x'' per knot, jerk and continuity per interval, then x_init
+  const size_t num_of_constraints = 3 * n + 3 * (n - 1) + 3;
+  if (workspace->dual_.size() != num_of_constraints) {
+    osqp_warm_start_x(workspace->work_, primal.data());
+    return;
+  }
+  std::vector<c_float> dual(workspace->dual_);
+  for (size_t i = 0; i < 3; ++i) {
+    shift_block(workspace->dual_.data() + i * n, n, dual.data() + i * n);
+  }
+  for (size_t i = 0; i < 3; ++i) {
+    shift_block(workspace->dual_.data() + 3 * n + i * (n - 1), n - 1,
+                dual.data() + 3 * n + i * (n - 1));
+  }
+  osqp_warm_start(workspace->work_, primal.data(), dual.data());
+}
+
+void PiecewiseJerkProblem::ExtractSolution(const c_float* solution) {
+  x_.resize(num_of_knots_);
+  dx_.resize(num_of_knots_);
+  ddx_.resize(num_of_knots_);
+  for (size_t i = 0; i < num_of_knots_; ++i) {
+    x_.at(i) = solution[i] / scale_factor_[0];
+    dx_.at(i) = solution[i + num_of_knots_] / scale_factor_[1];
+    ddx_.at(i) = solution[i + 2 * num_of_knots_] / scale_factor_[2];
+  }
+}
+
 void PiecewiseJerkProblem::CalculateAffineConstraint(
     std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
     std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -29,6 +30,60 @@
 namespace apollo {
 namespace planning {
 
+/*
+ * @brief:
+ * OSQP workspace of a piecewise jerk problem kept across planning cycles.
+ * The sparsity pattern of a piecewise jerk problem only depends on its
+ * number of knots, so a problem solved with the workspace of a problem of
+ * the same size only updates the matrix values, the bounds and the linear
+ * cost, which skips the allocations and the symbolic factorization of the
+ * KKT system, and is warm started from the last solution. The solver
+ * settings are the ones of the problem which set the workspace up.
+ */
+class PiecewiseJerkWorkspace {
+ public:
+  PiecewiseJerkWorkspace() = default;
+
+  ~PiecewiseJerkWorkspace() { Reset(); }
+
+  PiecewiseJerkWorkspace(const PiecewiseJerkWorkspace&) = delete;
+  PiecewiseJerkWorkspace& operator=(const PiecewiseJerkWorkspace&) = delete;
+
+  /**
+   * @brief Drop the workspace, the next problem is set up from scratch.
+   */
+  void Reset();
+
+  bool IsSetUp() const { return work_ != nullptr; }
+
+  // number of problems which set the workspace up
+  int num_setups() const { return num_setups_; }
+
+  // number of problems which reused the workspace
+  int num_updates() const { return num_updates_; }
+
+ private:
+  friend class PiecewiseJerkProblem;
+
+  OSQPWorkspace* work_ = nullptr;
+
+  // the problem data the workspace holds, in the formulation of
+  // PiecewiseJerkProblem::FormulateProblem
+  std::vector<c_float> P_data_;
+  std::vector<c_int> P_indices_;
+  std::vector<c_int> P_indptr_;
+  std::vector<c_float> A_data_;
+  std::vector<c_int> A_indices_;
+  std::vector<c_int> A_indptr_;
+
+  // primal and dual solution of the last problem
+  std::vector<c_float> primal_;
+  std::vector<c_float> dual_;
+
+  int num_setups_ = 0;
+  int num_updates_ = 0;
+};
+
 /*
  * @brief:
  * This class solve an optimization problem:
@@ -108,6 +163,22 @@ class PiecewiseJerkProblem {
   void set_end_state_ref(const std::array<double, 3>& weight_end_state,
                          const std::array<double, 3>& end_state_ref);
 
+  /**
+   * @brief Solve the next problems with the OSQP workspace kept in workspace,
+   * see PiecewiseJerkWorkspace.
+   *
+   * @param workspace: workspace owned by the caller, nullptr to solve the
+   * problem with a workspace of its own
+   * @param warm_start_shift: number of knots the first knot moved forward
+   * since the last problem solved in workspace. The last solution is shifted
+   * by as many knots to warm start the problem.
+   */
+  void set_workspace(PiecewiseJerkWorkspace* workspace,
+                     const size_t warm_start_shift = 0) {
+    workspace_ = workspace;
+    warm_start_shift_ = warm_start_shift;
+  }
+
   virtual bool Optimize(const int max_iter = 4000);
 
   const std::vector<double>& opt_x() const { return x_; }
@@ -136,6 +207,12 @@ class PiecewiseJerkProblem {
 
   void FreeData(OSQPData* data);
 
+  bool OptimizeWithWorkspace(const int max_iter);
+
+  void WarmStart(PiecewiseJerkWorkspace* workspace) const;
+
+  void ExtractSolution(const c_float* solution);
+
   template <typename T>
   T* CopyData(const std::vector<T>& vec) {
     T* data = new T[vec.size()];
@@ -175,6 +252,9 @@ class PiecewiseJerkProblem {
   bool has_end_state_ref_ = false;
   std::array<double, 3> weight_end_state_ = {{0.0, 0.0, 0.0}};
   std::array<double, 3> end_state_ref_;
+
+  PiecewiseJerkWorkspace* workspace_ = nullptr;
+  size_t warm_start_shift_ = 0;
 };
 
 }  // namespace planning
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Replays sequences of planning cycles of the piecewise jerk path and
+ *        speed problems, closed loop on their own solutions, with a new OSQP
+ *        workspace per problem (argument 0) and with a PiecewiseJerkWorkspace
+ *        kept across the cycles (argument 1). The counters report the
+ *        distribution of the solve time of a single cycle. Run with
+ *        bazel run -c opt //modules/planning/math/piecewise_jerk:piecewise_jerk_problem_benchmark
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_path_problem.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_speed_problem.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+constexpr int kNumCycles = 100;
+constexpr double kCycleTime = 0.1;
+constexpr double kEgoSpeed = 10.0;
+
+// nudging around a vehicle parked on the right side of the lane
+constexpr size_t kNumPathKnots = 160;
+constexpr double kPathDeltaS = 0.5;
+constexpr double kParkedStartS = 60.0;
+constexpr double kParkedEndS = 66.0;
+
+// following a slower vehicle
+constexpr size_t kNumSpeedKnots = 71;
+constexpr double kSpeedDeltaT = 0.1;
+constexpr double kLeaderGap = 40.0;
+constexpr double kLeaderSpeed = 7.0;
+
+void ReportSolveTimes(std::vector<double>* solve_times,
+                      benchmark::State* state) {
+  if (solve_times->empty()) {
+    return;
+  }
+  std::sort(solve_times->begin(), solve_times->end());
+  const auto percentile = [solve_times](const double p) {
+    return solve_times->at(static_cast<size_t>(
+        p * static_cast<double>(solve_times->size() - 1)));
+  };
+  double total_time = 0.0;
+  for (const double solve_time : *solve_times) {
+    total_time += solve_time;
+  }
+  state->counters["mean_us"] = total_time / solve_times->size();
+  state->counters["p50_us"] = percentile(0.5);
+  state->counters["p90_us"] = percentile(0.9);
+  state->counters["p99_us"] = percentile(0.99);
+  state->counters["max_us"] = solve_times->back();
+}
+
+double ElapsedMicroseconds(
+    const std::chrono::steady_clock::time_point& start_time) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+void BM_PathCycles(benchmark::State& state) {
+  const bool reuse_workspace = state.range(0) != 0;
+  const size_t warm_start_shift =
+      static_cast<size_t>(kEgoSpeed * kCycleTime / kPathDeltaS + 0.5);
+  std::vector<double> solve_times;
+  int num_failures = 0;
+  for (auto _ : state) {
+    PiecewiseJerkWorkspace workspace;
+    std::array<double, 3> init_state = {{0.0, 0.0, 0.0}};
+    for (int cycle = 0; cycle < kNumCycles; ++cycle) {
+      const double start_s = cycle * kEgoSpeed * kCycleTime;
+      std::vector<std::pair<double, double>> x_bounds;
+      for (size_t i = 0; i < kNumPathKnots; ++i) {
+        const double s = start_s + static_cast<double>(i) * kPathDeltaS;
+        const double lower_bound =
+            s > kParkedStartS && s < kParkedEndS ? 0.3 : -1.0;
+        x_bounds.emplace_back(lower_bound, 1.0);
+      }
+
+      PiecewiseJerkPathProblem problem(kNumPathKnots, kPathDeltaS,
+                                       init_state);
+      problem.set_weight_x(1.0);
+      problem.set_weight_dx(20.0);
+      problem.set_weight_ddx(1000.0);
+      problem.set_weight_dddx(50000.0);
+      problem.set_scale_factor({{1.0, 10.0, 100.0}});
+      problem.set_end_state_ref({{1000.0, 0.0, 0.0}}, {{0.0, 0.0, 0.0}});
+      problem.set_x_bounds(std::move(x_bounds));
+      problem.set_dx_bounds(-2.0, 2.0);
+      problem.set_ddx_bounds(-0.2, 0.2);
+      problem.set_dddx_bound(0.1);
+      if (reuse_workspace) {
+        problem.set_workspace(&workspace, cycle > 0 ? warm_start_shift : 0);
+      }
+
+      const auto start_time = std::chrono::steady_clock::now();
+      const bool success = problem.Optimize(4000);
+      solve_times.push_back(ElapsedMicroseconds(start_time));
+      if (!success) {
+        ++num_failures;
+        continue;
+      }
+      init_state = {{problem.opt_x()[warm_start_shift],
+                     problem.opt_dx()[warm_start_shift],
+                     problem.opt_ddx()[warm_start_shift]}};
+    }
+  }
+  ReportSolveTimes(&solve_times, &state);
+  state.counters["failures"] = num_failures;
+}
+
+void BM_SpeedCycles(benchmark::State& state) {
+  const bool reuse_workspace = state.range(0) != 0;
+  const size_t warm_start_shift =
+      static_cast<size_t>(kCycleTime / kSpeedDeltaT + 0.5);
+  std::vector<double> solve_times;
+  int num_failures = 0;
+  for (auto _ : state) {
+    PiecewiseJerkWorkspace workspace;
+    std::array<double, 3> init_state = {{0.0, kEgoSpeed, 0.0}};
+    double gap = kLeaderGap;
+    for (int cycle = 0; cycle < kNumCycles; ++cycle) {
+      std::vector<std::pair<double, double>> x_bounds;
+      std::vector<double> x_ref;
+      for (size_t i = 0; i < kNumSpeedKnots; ++i) {
+        const double t = static_cast<double>(i) * kSpeedDeltaT;
+        x_bounds.emplace_back(0.0,
+                              std::max(0.0, gap + kLeaderSpeed * t - 8.0));
+        x_ref.push_back(kEgoSpeed * t);
+      }
+
+      PiecewiseJerkSpeedProblem problem(kNumSpeedKnots, kSpeedDeltaT,
+                                        init_state);
+      problem.set_weight_ddx(1.0);
+      problem.set_weight_dddx(3.0);
+      problem.set_x_bounds(std::move(x_bounds));
+      problem.set_dx_bounds(0.0, std::max(15.0, init_state[1]));
+      problem.set_ddx_bounds(-6.0, 2.0);
+      problem.set_dddx_bound(-4.0, 2.0);
+      problem.set_dx_ref(10.0, kEgoSpeed);
+      problem.set_x_ref(10.0, std::move(x_ref));
+      if (reuse_workspace) {
+        problem.set_workspace(&workspace, cycle > 0 ? warm_start_shift : 0);
+      }
+
+      const auto start_time = std::chrono::steady_clock::now();
+      const bool success = problem.Optimize();
+      solve_times.push_back(ElapsedMicroseconds(start_time));
+      if (!success) {
+        ++num_failures;
+        gap += (kLeaderSpeed - init_state[1]) * kCycleTime;
+        continue;
+      }
+      const double travelled_s = problem.opt_x()[warm_start_shift];
+      gap += kLeaderSpeed * kCycleTime - travelled_s;
+      init_state = {{0.0, problem.opt_dx()[warm_start_shift],
+                     problem.opt_ddx()[warm_start_shift]}};
+    }
+  }
+  ReportSolveTimes(&solve_times, &state);
+  state.counters["failures"] = num_failures;
+}
+
+}  // namespace
+
+BENCHMARK(BM_PathCycles)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SpeedCycles)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
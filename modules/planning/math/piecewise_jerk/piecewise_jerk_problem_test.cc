@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_path_problem.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+constexpr double kDeltaS = 0.5;
+constexpr int kMaxIter = 100000;
+constexpr double kTolerance = 1e-3;
+
+// solved to a tight tolerance, so that the solutions of a problem solved from
+// scratch and with a reused workspace can be compared
+class PiecewiseJerkTestProblem : public PiecewiseJerkPathProblem {
+ public:
+  PiecewiseJerkTestProblem(const size_t num_of_knots,
+                           const std::array<double, 3>& x_init)
+      : PiecewiseJerkPathProblem(num_of_knots, kDeltaS, x_init) {}
+
+ protected:
+  OSQPSettings* SolverDefaultSettings() override {
+    OSQPSettings* settings = PiecewiseJerkPathProblem::SolverDefaultSettings();
+    settings->eps_abs = 1e-6;
+    settings->eps_rel = 1e-6;
+    return settings;
+  }
+};
+
+// nudging around an obstacle on the right of the lane, from start_knot on
+std::unique_ptr<PiecewiseJerkProblem> MakeProblem(
+    const size_t num_of_knots, const size_t start_knot,
+    const std::array<double, 3>& x_init) {
+  std::unique_ptr<PiecewiseJerkProblem> problem(
+      new PiecewiseJerkTestProblem(num_of_knots, x_init));
+  std::vector<std::pair<double, double>> x_bounds;
+  for (size_t i = 0; i < num_of_knots; ++i) {
+    const double s = static_cast<double>(start_knot + i) * kDeltaS;
+    x_bounds.emplace_back(s > 10.0 && s < 13.0 ? 0.5 : -1.75, 1.75);
+  }
+  problem->set_x_bounds(std::move(x_bounds));
+  problem->set_dx_bounds(-2.0, 2.0);
+  problem->set_ddx_bounds(-0.5, 0.5);
+  problem->set_dddx_bound(1.0);
+  problem->set_weight_x(1.0);
+  problem->set_weight_dx(10.0);
+  problem->set_weight_ddx(100.0);
+  problem->set_weight_dddx(1000.0);
+  problem->set_end_state_ref({{10.0, 10.0, 10.0}}, {{0.0, 0.0, 0.0}});
+  return problem;
+}
+
+// solves the problem with the workspace, and checks the solution against the
+// one of the same problem solved from scratch
+void ExpectSameSolution(const size_t num_of_knots, const size_t start_knot,
+                        const std::array<double, 3>& x_init,
+                        const size_t warm_start_shift,
+                        PiecewiseJerkWorkspace* workspace,
+                        std::array<double, 3>* next_x_init) {
+  auto problem = MakeProblem(num_of_knots, start_knot, x_init);
+  problem->set_workspace(workspace, warm_start_shift);
+  ASSERT_TRUE(problem->Optimize(kMaxIter));
+  EXPECT_TRUE(workspace->IsSetUp());
+
+  auto expected_problem = MakeProblem(num_of_knots, start_knot, x_init);
+  ASSERT_TRUE(expected_problem->Optimize(kMaxIter));
+  ASSERT_EQ(expected_problem->opt_x().size(), problem->opt_x().size());
+  for (size_t i = 0; i < num_of_knots; ++i) {
+    EXPECT_NEAR(expected_problem->opt_x()[i], problem->opt_x()[i], kTolerance);
+    EXPECT_NEAR(expected_problem->opt_dx()[i], problem->opt_dx()[i],
+                kTolerance);
+    EXPECT_NEAR(expected_problem->opt_ddx()[i], problem->opt_ddx()[i],
+                kTolerance);
+  }
+  if (next_x_init != nullptr) {
+    // the state a few knots ahead, off the solution by a tracking error
+    *next_x_init = {{problem->opt_x()[4] + 0.05, problem->opt_dx()[4],
+                     problem->opt_ddx()[4]}};
+  }
+}
+
+}  // namespace
+
+TEST(PiecewiseJerkProblemTest, WorkspaceReuse) {
+  PiecewiseJerkWorkspace workspace;
+  EXPECT_FALSE(workspace.IsSetUp());
+  std::array<double, 3> x_init = {{0.0, 0.0, 0.0}};
+  ExpectSameSolution(60, 0, x_init, 0, &workspace, &x_init);
+  EXPECT_EQ(1, workspace.num_setups());
+  EXPECT_EQ(0, workspace.num_updates());
+
+  // moved forward by 4 knots, warm started from the shifted solution
+  for (size_t start_knot = 4; start_knot <= 16; start_knot += 4) {
+    ExpectSameSolution(60, start_knot, x_init, 4, &workspace, &x_init);
+  }
+  EXPECT_EQ(1, workspace.num_setups());
+  EXPECT_EQ(4, workspace.num_updates());
+
+  // the same problem again, warm started from its own solution
+  ExpectSameSolution(60, 16, x_init, 0, &workspace, nullptr);
+  EXPECT_EQ(1, workspace.num_setups());
+  EXPECT_EQ(5, workspace.num_updates());
+
+  // a shift beyond the problem size warm starts from the last iterates
+  ExpectSameSolution(60, 16, x_init, 60, &workspace, nullptr);
+  EXPECT_EQ(6, workspace.num_updates());
+
+  workspace.Reset();
+  EXPECT_FALSE(workspace.IsSetUp());
+}
+
+TEST(PiecewiseJerkProblemTest, WorkspaceResize) {
+  PiecewiseJerkWorkspace workspace;
+  std::array<double, 3> x_init = {{0.0, 0.0, 0.0}};
+  ExpectSameSolution(60, 0, x_init, 0, &workspace, &x_init);
+
+  // a problem of another size sets the workspace up again
+  ExpectSameSolution(40, 4, x_init, 4, &workspace, &x_init);
+  EXPECT_EQ(2, workspace.num_setups());
+  EXPECT_EQ(0, workspace.num_updates());
+
+  ExpectSameSolution(40, 8, x_init, 4, &workspace, nullptr);
+  EXPECT_EQ(2, workspace.num_setups());
+  EXPECT_EQ(1, workspace.num_updates());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -170,6 +170,10 @@ Status OnLanePlanning::InitFrame(const uint32_t sequence_num,
   if (frame_ == nullptr) {
     return Status(ErrorCode::PLANNING_ERROR, "Fail to init frame: nullptr.");
   }
+  if (FLAGS_enable_obstacle_projection_cache) {
+    frame_->set_obstacle_projection_cache(
+        injector_->obstacle_projection_cache());
+  }
 
   // Get the parking space information from routing request of local view.
   auto& routing_request = local_view_.routing->routing_request();
@@ -347,8 +351,14 @@ void OnLanePlanning::RunOnce(const LocalView& local_view,
   if (FLAGS_enable_record_debug) {
     frame_->RecordInputDebug(ptr_trajectory_pb->mutable_debug());
   }
+  // on the system clock like total_time_ms, as the cyber clock does not move
+  // in mock mode
+  const double init_frame_end_system_timestamp =
+      std::chrono::duration<double>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
   ptr_trajectory_pb->mutable_latency_stats()->set_init_frame_time_ms(
-      Clock::NowInSeconds() - start_timestamp);
+      (init_frame_end_system_timestamp - start_system_timestamp) * 1000);
 
   if (!status.ok()) {
     AERROR << status.ToString();
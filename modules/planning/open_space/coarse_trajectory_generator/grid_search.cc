@@ -27,6 +27,8 @@ GridSearch::GridSearch(const PlannerOpenSpaceConfig& open_space_conf) {
   xy_grid_resolution_ =
       open_space_conf.warm_start_config().grid_a_star_xy_resolution();
   node_radius_ = open_space_conf.warm_start_config().node_radius();
+  distance_field_resolution_ =
+      open_space_conf.warm_start_config().distance_field_resolution();
 }
 
 double GridSearch::EuclidDistance(const double x1, const double y1,
@@ -44,11 +46,20 @@ bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
   if (obstacles_linesegments_vec_.empty()) {
     return true;
   }
+  const common::math::Vec2d node_xy(
+      node_grid_x * xy_grid_resolution_ + XYbounds_[0],
+      node_grid_y * xy_grid_resolution_ + XYbounds_[2]);
+  // the field gives a lower bound of the clearance, so only a node it clears
+  // skips the exact check
+  if (obstacle_distance_field_ != nullptr &&
+      obstacle_distance_field_->DistanceTo(node_xy.x(), node_xy.y()) >=
+          node_radius_) {
+    return true;
+  }
   for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
     for (const common::math::LineSegment2d& linesegment :
          obstacle_linesegments) {
-      if (linesegment.DistanceTo({node->GetGridX(), node->GetGridY()}) <
-          node_radius_) {
+      if (linesegment.DistanceTo(node_xy) < node_radius_) {
         return false;
       }
     }
@@ -56,6 +67,25 @@ bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
   return true;
 }
 
+bool GridSearch::LoadObstacles(
+    const std::vector<double>& XYbounds,
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec) {
+  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
+  obstacle_distance_field_ = nullptr;
+  if (obstacles_linesegments_vec.empty()) {
+    return true;
+  }
+  // grown by one grid so that the nodes on XYbounds keep their clearance
+  if (!local_distance_field_.Build(XYbounds, obstacles_linesegments_vec,
+                                   distance_field_resolution_,
+                                   node_radius_ + xy_grid_resolution_)) {
+    return false;
+  }
+  obstacle_distance_field_ = &local_distance_field_;
+  return true;
+}
+
 std::vector<std::shared_ptr<Node2d>> GridSearch::GenerateNextNodes(
     std::shared_ptr<Node2d> current_node) {
   double current_node_x = current_node->GetGridX();
@@ -116,7 +146,9 @@ bool GridSearch::GenerateAStarPath(
   std::shared_ptr<Node2d> end_node =
       std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
   std::shared_ptr<Node2d> final_node_ = nullptr;
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
+  if (!LoadObstacles(XYbounds_, obstacles_linesegments_vec)) {
+    return false;
+  }
   open_set.emplace(start_node->GetIndex(), start_node);
   open_pq.emplace(start_node->GetIndex(), start_node->GetCost());
 
@@ -166,6 +198,24 @@ bool GridSearch::GenerateDpMap(
     const double ex, const double ey, const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec) {
+  if (!LoadObstacles(XYbounds, obstacles_linesegments_vec)) {
+    return false;
+  }
+  return SearchDpMap(ex, ey, XYbounds);
+}
+
+bool GridSearch::GenerateDpMap(
+    const double ex, const double ey, const std::vector<double>& XYbounds,
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec,
+    const ObstacleDistanceField& obstacle_distance_field) {
+  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
+  obstacle_distance_field_ = &obstacle_distance_field;
+  return SearchDpMap(ex, ey, XYbounds);
+}
+
+bool GridSearch::SearchDpMap(const double ex, const double ey,
+                             const std::vector<double>& XYbounds) {
   std::priority_queue<std::pair<std::string, double>,
                       std::vector<std::pair<std::string, double>>, cmp>
       open_pq;
@@ -177,7 +227,6 @@ bool GridSearch::GenerateDpMap(
   max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
   std::shared_ptr<Node2d> end_node =
       std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
   open_set.emplace(end_node->GetIndex(), end_node);
   open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
 
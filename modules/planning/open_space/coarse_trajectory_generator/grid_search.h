@@ -31,6 +31,7 @@
 #include "absl/strings/str_cat.h"
 #include "cyber/common/log.h"
 #include "modules/common/math/line_segment2d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
 #include "modules/planning/proto/planner_open_space_config.pb.h"
 
 namespace apollo {
@@ -115,6 +116,13 @@ class GridSearch {
       const double ex, const double ey, const std::vector<double>& XYbounds,
       const std::vector<std::vector<common::math::LineSegment2d>>&
           obstacles_linesegments_vec);
+  // generate the dp map on a prebuilt distance field of the obstacles, which
+  // has to cover XYbounds and outlive the following CheckDpMap() calls
+  bool GenerateDpMap(
+      const double ex, const double ey, const std::vector<double>& XYbounds,
+      const std::vector<std::vector<common::math::LineSegment2d>>&
+          obstacles_linesegments_vec,
+      const ObstacleDistanceField& obstacle_distance_field);
   double CheckDpMap(const double sx, const double sy);
 
  private:
@@ -123,11 +131,20 @@ class GridSearch {
   std::vector<std::shared_ptr<Node2d>> GenerateNextNodes(
       std::shared_ptr<Node2d> node);
   bool CheckConstraints(std::shared_ptr<Node2d> node);
+  // Dijkstra from {ex, ey} on the obstacles of obstacle_distance_field_
+  bool SearchDpMap(const double ex, const double ey,
+                   const std::vector<double>& XYbounds);
+  // build local_distance_field_ of the obstacles and check against it
+  bool LoadObstacles(
+      const std::vector<double>& XYbounds,
+      const std::vector<std::vector<common::math::LineSegment2d>>&
+          obstacles_linesegments_vec);
   void LoadGridAStarResult(GridAStartResult* result);
 
  private:
   double xy_grid_resolution_ = 0.0;
   double node_radius_ = 0.0;
+  double distance_field_resolution_ = 0.0;
   std::vector<double> XYbounds_;
   double max_grid_x_ = 0.0;
   double max_grid_y_ = 0.0;
@@ -136,6 +153,10 @@ class GridSearch {
   std::shared_ptr<Node2d> final_node_;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
+  // quick accept of the node clearance before the exact check against
+  // obstacles_linesegments_vec_, nullptr if there is no obstacle
+  const ObstacleDistanceField* obstacle_distance_field_ = nullptr;
+  ObstacleDistanceField local_distance_field_;
 
   struct cmp {
     bool operator()(const std::pair<std::string, double>& left,
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    auto* warm_start_config =
+        planner_open_space_config_.mutable_warm_start_config();
+    warm_start_config->set_grid_a_star_xy_resolution(0.5);
+    warm_start_config->set_node_radius(0.5);
+    warm_start_config->set_distance_field_resolution(0.1);
+
+    // a corridor along y = 0, 2 * 0.52m wide, between x 2.2m and 7.8m.
+    // Only the nodes on y = 0 clear the walls by node_radius, by 0.02m,
+    // which is less than the error of the distance field.
+    const double half_width = 0.52;
+    for (const double x : {2.2, 7.8}) {
+      obstacles_linesegments_vec_.push_back(
+          {LineSegment2d({x, half_width}, {x, XYbounds_[3]}),
+           LineSegment2d({x, -half_width}, {x, XYbounds_[2]})});
+    }
+    obstacles_linesegments_vec_.push_back(
+        {LineSegment2d({2.2, half_width}, {7.8, half_width}),
+         LineSegment2d({2.2, -half_width}, {7.8, -half_width})});
+  }
+
+ protected:
+  PlannerOpenSpaceConfig planner_open_space_config_;
+  std::vector<double> XYbounds_ = {0.0, 10.0, -2.0, 2.0};
+  std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec_;
+};
+
+TEST_F(GridSearchTest, NarrowCorridorDpMap) {
+  GridSearch grid_search(planner_open_space_config_);
+  ASSERT_TRUE(grid_search.GenerateDpMap(9.0, 0.0, XYbounds_,
+                                        obstacles_linesegments_vec_));
+  EXPECT_NEAR(8.0, grid_search.CheckDpMap(1.0, 0.0), 1e-6);
+  // in the wall
+  EXPECT_TRUE(std::isinf(grid_search.CheckDpMap(5.0, 0.5)));
+
+  // on a prebuilt field, as hybrid A* does
+  ObstacleDistanceField obstacle_distance_field;
+  ASSERT_TRUE(obstacle_distance_field.Build(
+      XYbounds_, obstacles_linesegments_vec_, 0.1, 2.0));
+  GridSearch prebuilt_grid_search(planner_open_space_config_);
+  ASSERT_TRUE(prebuilt_grid_search.GenerateDpMap(
+      9.0, 0.0, XYbounds_, obstacles_linesegments_vec_,
+      obstacle_distance_field));
+  EXPECT_NEAR(8.0, prebuilt_grid_search.CheckDpMap(1.0, 0.0), 1e-6);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -46,6 +46,8 @@ HybridAStar::HybridAStar(const PlannerOpenSpaceConfig& open_space_conf) {
   step_size_ = planner_open_space_config_.warm_start_config().step_size();
   xy_grid_resolution_ =
       planner_open_space_config_.warm_start_config().xy_grid_resolution();
+  distance_field_resolution_ = planner_open_space_config_.warm_start_config()
+                                   .distance_field_resolution();
   delta_t_ = planner_open_space_config_.delta_t();
   traj_forward_penalty_ =
       planner_open_space_config_.warm_start_config().traj_forward_penalty();
@@ -93,15 +95,27 @@ HybridAStar::HybridAStar(const PlannerOpenSpaceConfig& open_space_conf) {
           .max_acc_jerk();
 }
 
-bool HybridAStar::AnalyticExpansion(std::shared_ptr<Node3d> current_node) {
-  std::shared_ptr<ReedSheppPath> reeds_shepp_to_check =
-      std::make_shared<ReedSheppPath>();
-  if (!reed_shepp_generator_->ShortestRSP(current_node, end_node_,
-                                          reeds_shepp_to_check)) {
+Node3d* HybridAStar::NewNode() {
+  if (node_pool_size_ == node_pool_.size()) {
+    node_pool_.emplace_back(0.0, 0.0, 0.0);
+  }
+  return &node_pool_[node_pool_size_];
+}
+
+size_t HybridAStar::CommitNode() {
+  CHECK_LT(node_pool_size_, node_pool_.size());
+  return node_pool_size_++;
+}
+
+bool HybridAStar::AnalyticExpansion(const Node3d* current_node) {
+  if (!reed_shepp_generator_->ShortestRSP(*current_node, *end_node_,
+                                          reeds_shepp_to_check_.get())) {
     AERROR << "ShortestRSP failed";
     return false;
   }
-  if (!RSPCheck(reeds_shepp_to_check)) {
+  const ReedSheppPath& reeds_shepp_to_check = *reeds_shepp_to_check_;
+  Node3d* rsp_node = NewNode();
+  if (!RSPCheck(reeds_shepp_to_check, rsp_node)) {
     return false;
   }
 
@@ -114,40 +128,39 @@ bool HybridAStar::AnalyticExpansion(std::shared_ptr<Node3d> current_node) {
                 pow((current_node->GetY() - end_node_->GetY()), 2));
   AINFO << "delta phi" << current_node->GetPhi() - end_node_->GetPhi();
   AINFO << "reed shepp set_type,gear,length";
-  for (size_t i = 0; i < reeds_shepp_to_check->segs_types.size(); i++) {
-    AINFO << reeds_shepp_to_check->segs_types[i] << ", "
-          << reeds_shepp_to_check->gear[i] << ","
-          << reeds_shepp_to_check->segs_lengths[i];
-  }
-  AINFO << reeds_shepp_to_check->x.front() << ","
-        << reeds_shepp_to_check->y.front();
-  AINFO << reeds_shepp_to_check->x.back() << ","
-        << reeds_shepp_to_check->y.back();
+  for (size_t i = 0; i < reeds_shepp_to_check.segs_types.size(); i++) {
+    AINFO << reeds_shepp_to_check.segs_types[i] << ", "
+          << reeds_shepp_to_check.gear[i] << ","
+          << reeds_shepp_to_check.segs_lengths[i];
+  }
+  AINFO << reeds_shepp_to_check.x.front() << ","
+        << reeds_shepp_to_check.y.front();
+  AINFO << reeds_shepp_to_check.x.back() << ","
+        << reeds_shepp_to_check.y.back();
   // load the whole RSP as nodes and add to the close set
-  final_node_ = LoadRSPinCS(reeds_shepp_to_check, current_node);
+  final_node_ = LoadRSPinCS(current_node);
   return true;
 }
 
-bool HybridAStar::RSPCheck(
-    const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end) {
-  std::shared_ptr<Node3d> node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
-  return ValidityCheck(node);
+bool HybridAStar::RSPCheck(const ReedSheppPath& reeds_shepp_to_end,
+                           Node3d* rsp_node) {
+  rsp_node->Reset(reeds_shepp_to_end.x, reeds_shepp_to_end.y,
+                  reeds_shepp_to_end.phi, XYbounds_,
+                  planner_open_space_config_);
+  return ValidityCheck(*rsp_node);
 }
 
-bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
-  CHECK_NOTNULL(node);
-  CHECK_GT(node->GetStepSize(), 0U);
+bool HybridAStar::ValidityCheck(const Node3d& node) {
+  CHECK_GT(node.GetStepSize(), 0U);
 
   if (obstacles_linesegments_vec_.empty()) {
     return true;
   }
 
-  size_t node_step_size = node->GetStepSize();
-  const auto& traversed_x = node->GetXs();
-  const auto& traversed_y = node->GetYs();
-  const auto& traversed_phi = node->GetPhis();
+  size_t node_step_size = node.GetStepSize();
+  const auto& traversed_x = node.GetXs();
+  const auto& traversed_y = node.GetYs();
+  const auto& traversed_phi = node.GetPhis();
 
   // The first {x, y, phi} is collision free unless they are start and end
   // configuration of search problem
@@ -165,6 +178,9 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
     }
     Box2d bounding_box = Node3d::GetBoundingBox(
         vehicle_param_, traversed_x[i], traversed_y[i], traversed_phi[i]);
+    if (obstacle_distance_field_->IsCollisionFree(bounding_box)) {
+      continue;
+    }
     for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
       for (const common::math::LineSegment2d& linesegment :
            obstacle_linesegments) {
@@ -181,19 +197,18 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
   return true;
 }
 
-std::shared_ptr<Node3d> HybridAStar::LoadRSPinCS(
-    const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
-    std::shared_ptr<Node3d> current_node) {
-  std::shared_ptr<Node3d> end_node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
+const Node3d* HybridAStar::LoadRSPinCS(const Node3d* current_node) {
+  // the Reeds Shepp path has been loaded into the pending node by RSPCheck
+  const size_t end_node_id = CommitNode();
+  Node3d* end_node = &node_pool_[end_node_id];
   end_node->SetPre(current_node);
-  close_set_.emplace(end_node->GetIndex(), end_node);
+  close_set_.emplace(end_node->GetIndex(), end_node_id);
   return end_node;
 }
 
-std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
-    std::shared_ptr<Node3d> current_node, size_t next_node_index) {
+bool HybridAStar::Next_node_generator(const Node3d* current_node,
+                                      size_t next_node_index,
+                                      Node3d* next_node) {
   double steering = 0.0;
   double traveled_distance = 0.0;
   if (next_node_index < static_cast<double>(next_node_num_) / 2) {
@@ -213,81 +228,80 @@ std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
   // take above motion primitive to generate a curve driving the car to a
   // different grid
   double arc = std::sqrt(2) * xy_grid_resolution_;
-  std::vector<double> intermediate_x;
-  std::vector<double> intermediate_y;
-  std::vector<double> intermediate_phi;
+  intermediate_x_.clear();
+  intermediate_y_.clear();
+  intermediate_phi_.clear();
   double last_x = current_node->GetX();
   double last_y = current_node->GetY();
   double last_phi = current_node->GetPhi();
-  intermediate_x.push_back(last_x);
-  intermediate_y.push_back(last_y);
-  intermediate_phi.push_back(last_phi);
+  intermediate_x_.push_back(last_x);
+  intermediate_y_.push_back(last_y);
+  intermediate_phi_.push_back(last_phi);
   for (size_t i = 0; i < arc / step_size_; ++i) {
     const double next_x = last_x + traveled_distance * std::cos(last_phi);
     const double next_y = last_y + traveled_distance * std::sin(last_phi);
     const double next_phi = common::math::NormalizeAngle(
         last_phi +
         traveled_distance / vehicle_param_.wheel_base() * std::tan(steering));
-    intermediate_x.push_back(next_x);
-    intermediate_y.push_back(next_y);
-    intermediate_phi.push_back(next_phi);
+    intermediate_x_.push_back(next_x);
+    intermediate_y_.push_back(next_y);
+    intermediate_phi_.push_back(next_phi);
     last_x = next_x;
     last_y = next_y;
     last_phi = next_phi;
   }
   // check if the vehicle runs outside of XY boundary
-  if (intermediate_x.back() > XYbounds_[1] ||
-      intermediate_x.back() < XYbounds_[0] ||
-      intermediate_y.back() > XYbounds_[3] ||
-      intermediate_y.back() < XYbounds_[2]) {
-    return nullptr;
-  }
-  std::shared_ptr<Node3d> next_node = std::shared_ptr<Node3d>(
-      new Node3d(intermediate_x, intermediate_y, intermediate_phi, XYbounds_,
-                 planner_open_space_config_));
+  if (intermediate_x_.back() > XYbounds_[1] ||
+      intermediate_x_.back() < XYbounds_[0] ||
+      intermediate_y_.back() > XYbounds_[3] ||
+      intermediate_y_.back() < XYbounds_[2]) {
+    return false;
+  }
+  next_node->Reset(intermediate_x_, intermediate_y_, intermediate_phi_,
+                   XYbounds_, planner_open_space_config_);
   next_node->SetPre(current_node);
   next_node->SetDirec(traveled_distance > 0.0);
   next_node->SetSteer(steering);
-  return next_node;
+  return true;
 }
 
-void HybridAStar::CalculateNodeCost(std::shared_ptr<Node3d> current_node,
-                                    std::shared_ptr<Node3d> next_node) {
-  next_node->SetTrajCost(current_node->GetTrajCost() +
-                         TrajCost(current_node, next_node));
+void HybridAStar::CalculateNodeCost(const Node3d& current_node,
+                                    Node3d* next_node) {
+  next_node->SetTrajCost(current_node.GetTrajCost() +
+                         TrajCost(current_node, *next_node));
   // evaluate heuristic cost
   double optimal_path_cost = 0.0;
-  optimal_path_cost += HoloObstacleHeuristic(next_node);
+  optimal_path_cost += HoloObstacleHeuristic(*next_node);
   next_node->SetHeuCost(optimal_path_cost);
 }
 
-double HybridAStar::TrajCost(std::shared_ptr<Node3d> current_node,
-                             std::shared_ptr<Node3d> next_node) {
+double HybridAStar::TrajCost(const Node3d& current_node,
+                             const Node3d& next_node) {
   // evaluate cost on the trajectory and add current cost
   double piecewise_cost = 0.0;
-  if (next_node->GetDirec()) {
-    piecewise_cost += static_cast<double>(next_node->GetStepSize() - 1) *
+  if (next_node.GetDirec()) {
+    piecewise_cost += static_cast<double>(next_node.GetStepSize() - 1) *
                       step_size_ * traj_forward_penalty_;
   } else {
-    piecewise_cost += static_cast<double>(next_node->GetStepSize() - 1) *
+    piecewise_cost += static_cast<double>(next_node.GetStepSize() - 1) *
                       step_size_ * traj_back_penalty_;
   }
-  if (current_node->GetDirec() != next_node->GetDirec()) {
+  if (current_node.GetDirec() != next_node.GetDirec()) {
     piecewise_cost += traj_gear_switch_penalty_;
   }
-  piecewise_cost += traj_steer_penalty_ * std::abs(next_node->GetSteer());
+  piecewise_cost += traj_steer_penalty_ * std::abs(next_node.GetSteer());
   piecewise_cost += traj_steer_change_penalty_ *
-                    std::abs(next_node->GetSteer() - current_node->GetSteer());
+                    std::abs(next_node.GetSteer() - current_node.GetSteer());
   return piecewise_cost;
 }
 
-double HybridAStar::HoloObstacleHeuristic(std::shared_ptr<Node3d> next_node) {
-  return grid_a_star_heuristic_generator_->CheckDpMap(next_node->GetX(),
-                                                      next_node->GetY());
+double HybridAStar::HoloObstacleHeuristic(const Node3d& next_node) {
+  return grid_a_star_heuristic_generator_->CheckDpMap(next_node.GetX(),
+                                                      next_node.GetY());
 }
 
 bool HybridAStar::GetResult(HybridAStartResult* result) {
-  std::shared_ptr<Node3d> current_node = final_node_;
+  const Node3d* current_node = final_node_;
   std::vector<double> hybrid_a_x;
   std::vector<double> hybrid_a_y;
   std::vector<double> hybrid_a_phi;
@@ -696,7 +710,12 @@ bool HybridAStar::Plan(
   open_set_.clear();
   close_set_.clear();
   open_pq_ = decltype(open_pq_)();
+  node_pool_size_ = 0;
+  start_node_ = nullptr;
   final_node_ = nullptr;
+  expanded_node_num_ = 0;
+  explored_node_num_ = 0;
+  search_time_ = 0.0;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec;
   for (const auto& obstacle_vertices : obstacles_vertices_vec) {
@@ -710,6 +729,23 @@ bool HybridAStar::Plan(
     obstacles_linesegments_vec.emplace_back(obstacle_linesegments);
   }
   obstacles_linesegments_vec_ = std::move(obstacles_linesegments_vec);
+  // The field is rebuilt in place unless a smoother still holds the last one.
+  if (obstacle_distance_field_ == nullptr ||
+      obstacle_distance_field_.use_count() > 1) {
+    obstacle_distance_field_ = std::make_shared<ObstacleDistanceField>();
+  }
+  // grown by the vehicle size so that any box within XYbounds can be cleared
+  const double field_max_distance = std::max(
+      0.5 * std::hypot(vehicle_param_.length(), vehicle_param_.width()),
+      planner_open_space_config_.warm_start_config().node_radius() +
+          planner_open_space_config_.warm_start_config()
+              .grid_a_star_xy_resolution());
+  if (!obstacle_distance_field_->Build(XYbounds, obstacles_linesegments_vec_,
+                                       distance_field_resolution_,
+                                       field_max_distance)) {
+    AERROR << "failed to build the obstacle distance field";
+    return false;
+  }
   std::stringstream ssm;
   ssm << "roi boundary" << std::endl;
   for (auto vec : obstacles_linesegments_vec_) {
@@ -749,40 +785,43 @@ bool HybridAStar::Plan(
   ssm << XYbounds[2] << ", " << XYbounds[3] << std::endl;
   XYbounds_ = XYbounds;
   // load nodes and obstacles
-  start_node_.reset(
-      new Node3d({sx}, {sy}, {sphi}, XYbounds_, planner_open_space_config_));
+  Node3d* start_node = NewNode();
+  start_node->Reset({sx}, {sy}, {sphi}, XYbounds_, planner_open_space_config_);
+  const size_t start_node_id = CommitNode();
+  start_node_ = start_node;
   end_node_.reset(
       new Node3d({ex}, {ey}, {ephi}, XYbounds_, planner_open_space_config_));
   AINFO << "start node" << sx << "," << sy << "," << sphi;
   AINFO << "end node " << ex << "," << ey << "," << ephi;
-  if (!ValidityCheck(start_node_)) {
+  if (!ValidityCheck(*start_node_)) {
     AERROR << "start_node in collision with obstacles";
     AERROR << start_node_->GetX() << "," << start_node_->GetY() << ","
            << start_node_->GetPhi();
     AERROR << ssm.str();
     return false;
   }
-  if (!ValidityCheck(end_node_)) {
+  if (!ValidityCheck(*end_node_)) {
     AERROR << "end_node in collision with obstacles";
     return false;
   }
   double map_time = Clock::NowInSeconds();
   grid_a_star_heuristic_generator_->GenerateDpMap(ex, ey, XYbounds_,
-                                                  obstacles_linesegments_vec_);
+                                                  obstacles_linesegments_vec_,
+                                                  *obstacle_distance_field_);
   ADEBUG << "map time " << Clock::NowInSeconds() - map_time;
   // load open set, pq
-  open_set_.emplace(start_node_->GetIndex(), start_node_);
-  open_pq_.emplace(start_node_->GetIndex(), start_node_->GetCost());
+  open_set_.emplace(start_node_->GetIndex(), start_node_id);
+  open_pq_.emplace(start_node_id, start_node_->GetCost());
   // Hybrid A* begins
-  size_t explored_node_num = 0;
   double astar_start_time = Clock::NowInSeconds();
   double heuristic_time = 0.0;
   double rs_time = 0.0;
   while (!open_pq_.empty()) {
     // take out the lowest cost neighboring node
-    const std::string current_id = open_pq_.top().first;
+    const size_t current_id = open_pq_.top().first;
     open_pq_.pop();
-    std::shared_ptr<Node3d> current_node = open_set_[current_id];
+    const Node3d* current_node = &node_pool_[current_id];
+    ++expanded_node_num_;
     // check if an analystic curve could be connected from current
     // configuration to the end configuration without collision. if so, search
     // ends.
@@ -792,32 +831,34 @@ bool HybridAStar::Plan(
     }
     const double rs_end_time = Clock::NowInSeconds();
     rs_time += rs_end_time - rs_start_time;
-    close_set_.emplace(current_node->GetIndex(), current_node);
+    close_set_.emplace(current_node->GetIndex(), current_id);
     for (size_t i = 0; i < next_node_num_; ++i) {
-      std::shared_ptr<Node3d> next_node = Next_node_generator(current_node, i);
+      Node3d* next_node = NewNode();
       // boundary check failure handle
-      if (next_node == nullptr) {
+      if (!Next_node_generator(current_node, i, next_node)) {
         continue;
       }
-      // check if the node is already in the close set
-      if (close_set_.find(next_node->GetIndex()) != close_set_.end()) {
+      // check if the node is already in the close set, or already reached
+      // through another open node, before paying for the collision check
+      if (close_set_.find(next_node->GetIndex()) != close_set_.end() ||
+          open_set_.find(next_node->GetIndex()) != open_set_.end()) {
         continue;
       }
       // collision check
-      if (!ValidityCheck(next_node)) {
+      if (!ValidityCheck(*next_node)) {
         continue;
       }
-      if (open_set_.find(next_node->GetIndex()) == open_set_.end()) {
-        explored_node_num++;
-        const double start_time = Clock::NowInSeconds();
-        CalculateNodeCost(current_node, next_node);
-        const double end_time = Clock::NowInSeconds();
-        heuristic_time += end_time - start_time;
-        open_set_.emplace(next_node->GetIndex(), next_node);
-        open_pq_.emplace(next_node->GetIndex(), next_node->GetCost());
-      }
+      explored_node_num_++;
+      const double start_time = Clock::NowInSeconds();
+      CalculateNodeCost(*current_node, next_node);
+      const double end_time = Clock::NowInSeconds();
+      heuristic_time += end_time - start_time;
+      const size_t next_node_id = CommitNode();
+      open_set_.emplace(next_node->GetIndex(), next_node_id);
+      open_pq_.emplace(next_node_id, next_node->GetCost());
     }
   }
+  search_time_ = Clock::NowInSeconds() - astar_start_time;
   if (final_node_ == nullptr) {
     AERROR << "Hybrid A searching return null ptr(open_set ran out)";
     AINFO << ssm.str();
@@ -827,7 +868,8 @@ bool HybridAStar::Plan(
     AERROR << "GetResult failed";
     return false;
   }
-  ADEBUG << "explored node num is " << explored_node_num;
+  ADEBUG << "expanded node num is " << expanded_node_num_;
+  ADEBUG << "explored node num is " << explored_node_num_;
   ADEBUG << "heuristic time is " << heuristic_time;
   ADEBUG << "reed shepp time is " << rs_time;
   ADEBUG << "hybrid astar total time is "
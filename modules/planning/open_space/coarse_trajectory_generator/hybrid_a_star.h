@@ -21,9 +21,9 @@
 #pragma once
 
 #include <algorithm>
+#include <deque>
 #include <memory>
 #include <queue>
-#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -40,6 +40,7 @@
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/reeds_shepp_path.h"
 
 namespace apollo {
@@ -66,24 +67,34 @@ class HybridAStar {
             HybridAStartResult* result);
   bool TrajectoryPartition(const HybridAStartResult& result,
                            std::vector<HybridAStartResult>* partitioned_result);
+  // statistics of the last search
+  size_t GetExpandedNodeNum() const { return expanded_node_num_; }
+  size_t GetExploredNodeNum() const { return explored_node_num_; }
+  double GetSearchTime() const { return search_time_; }
+  // distance field of the obstacles of the last Plan() call, to be shared
+  // with the trajectory smoothers of the same planning cycle
+  std::shared_ptr<const ObstacleDistanceField> GetObstacleDistanceField()
+      const {
+    return obstacle_distance_field_;
+  }
 
  private:
-  bool AnalyticExpansion(std::shared_ptr<Node3d> current_node);
+  // returns the pending slot of node_pool_, which only becomes part of the
+  // search once CommitNode() is called
+  Node3d* NewNode();
+  size_t CommitNode();
+  bool AnalyticExpansion(const Node3d* current_node);
   // check collision and validity
-  bool ValidityCheck(std::shared_ptr<Node3d> node);
+  bool ValidityCheck(const Node3d& node);
   // check Reeds Shepp path collision and validity
-  bool RSPCheck(const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end);
+  bool RSPCheck(const ReedSheppPath& reeds_shepp_to_end, Node3d* rsp_node);
   // load the whole RSP as nodes and add to the close set
-  std::shared_ptr<Node3d> LoadRSPinCS(
-      const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
-      std::shared_ptr<Node3d> current_node);
-  std::shared_ptr<Node3d> Next_node_generator(
-      std::shared_ptr<Node3d> current_node, size_t next_node_index);
-  void CalculateNodeCost(std::shared_ptr<Node3d> current_node,
-                         std::shared_ptr<Node3d> next_node);
-  double TrajCost(std::shared_ptr<Node3d> current_node,
-                  std::shared_ptr<Node3d> next_node);
-  double HoloObstacleHeuristic(std::shared_ptr<Node3d> next_node);
+  const Node3d* LoadRSPinCS(const Node3d* current_node);
+  bool Next_node_generator(const Node3d* current_node,
+                           size_t next_node_index, Node3d* next_node);
+  void CalculateNodeCost(const Node3d& current_node, Node3d* next_node);
+  double TrajCost(const Node3d& current_node, const Node3d& next_node);
+  double HoloObstacleHeuristic(const Node3d& next_node);
   bool GetResult(HybridAStartResult* result);
   bool GetTemporalProfile(HybridAStartResult* result);
   bool GenerateSpeedAcceleration(HybridAStartResult* result);
@@ -97,6 +108,7 @@ class HybridAStar {
   double max_steer_angle_ = 0.0;
   double step_size_ = 0.0;
   double xy_grid_resolution_ = 0.0;
+  double distance_field_resolution_ = 0.0;
   double delta_t_ = 0.0;
   double traj_forward_penalty_ = 0.0;
   double traj_back_penalty_ = 0.0;
@@ -119,23 +131,41 @@ class HybridAStar {
   double max_reverse_acc_ = 0.0;
   double max_acc_jerk_ = 0.0;
   std::vector<double> XYbounds_;
-  std::shared_ptr<Node3d> start_node_;
+  const Node3d* start_node_ = nullptr;
   std::shared_ptr<Node3d> end_node_;
-  std::shared_ptr<Node3d> final_node_;
+  const Node3d* final_node_ = nullptr;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
+  std::shared_ptr<ObstacleDistanceField> obstacle_distance_field_;
+
+  // Arena of the search nodes, addressed by their position. Slots are
+  // recycled across Plan() calls so that their traversed states keep their
+  // capacity, and std::deque keeps pre node pointers valid while it grows.
+  std::deque<Node3d> node_pool_;
+  size_t node_pool_size_ = 0;
 
   struct cmp {
-    bool operator()(const std::pair<std::string, double>& left,
-                    const std::pair<std::string, double>& right) const {
+    bool operator()(const std::pair<size_t, double>& left,
+                    const std::pair<size_t, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  // node positions in node_pool_ ordered by cost
+  std::priority_queue<std::pair<size_t, double>,
+                      std::vector<std::pair<size_t, double>>, cmp>
       open_pq_;
-  std::unordered_map<std::string, std::shared_ptr<Node3d>> open_set_;
-  std::unordered_map<std::string, std::shared_ptr<Node3d>> close_set_;
+  // grid index to node position in node_pool_
+  std::unordered_map<uint64_t, size_t> open_set_;
+  std::unordered_map<uint64_t, size_t> close_set_;
+  // scratch buffers of Next_node_generator
+  std::vector<double> intermediate_x_;
+  std::vector<double> intermediate_y_;
+  std::vector<double> intermediate_phi_;
+  std::shared_ptr<ReedSheppPath> reeds_shepp_to_check_ =
+      std::make_shared<ReedSheppPath>();
+  size_t expanded_node_num_ = 0;
+  size_t explored_node_num_ = 0;
+  double search_time_ = 0.0;
   std::unique_ptr<ReedShepp> reed_shepp_generator_;
   std::unique_ptr<GridSearch> grid_a_star_heuristic_generator_;
 };
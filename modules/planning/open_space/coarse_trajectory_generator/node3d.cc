@@ -20,8 +20,6 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
 
-#include "absl/strings/str_cat.h"
-
 namespace apollo {
 namespace planning {
 
@@ -43,21 +41,11 @@ Node3d::Node3d(double x, double y, double phi,
   y_ = y;
   phi_ = phi;
 
-  x_grid_ = static_cast<int>(
-      (x_ - XYbounds[0]) /
-      open_space_conf.warm_start_config().xy_grid_resolution());
-  y_grid_ = static_cast<int>(
-      (y_ - XYbounds[2]) /
-      open_space_conf.warm_start_config().xy_grid_resolution());
-  phi_grid_ = static_cast<int>(
-      (phi_ - (-M_PI)) /
-      open_space_conf.warm_start_config().phi_grid_resolution());
-
   traversed_x_.push_back(x);
   traversed_y_.push_back(y);
   traversed_phi_.push_back(phi);
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  ComputeGridIndex(XYbounds, open_space_conf);
 }
 
 Node3d::Node3d(const std::vector<double>& traversed_x,
@@ -65,6 +53,14 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
                const std::vector<double>& traversed_phi,
                const std::vector<double>& XYbounds,
                const PlannerOpenSpaceConfig& open_space_conf) {
+  Reset(traversed_x, traversed_y, traversed_phi, XYbounds, open_space_conf);
+}
+
+void Node3d::Reset(const std::vector<double>& traversed_x,
+                   const std::vector<double>& traversed_y,
+                   const std::vector<double>& traversed_phi,
+                   const std::vector<double>& XYbounds,
+                   const PlannerOpenSpaceConfig& open_space_conf) {
   CHECK_EQ(XYbounds.size(), 4U)
       << "XYbounds size is not 4, but" << XYbounds.size();
   CHECK_EQ(traversed_x.size(), traversed_y.size());
@@ -74,6 +70,23 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
   y_ = traversed_y.back();
   phi_ = traversed_phi.back();
 
+  // copy assignment keeps the capacity of recycled nodes
+  traversed_x_ = traversed_x;
+  traversed_y_ = traversed_y;
+  traversed_phi_ = traversed_phi;
+
+  ComputeGridIndex(XYbounds, open_space_conf);
+  step_size_ = traversed_x.size();
+
+  traj_cost_ = 0.0;
+  heuristic_cost_ = 0.0;
+  pre_node_ = nullptr;
+  steering_ = 0.0;
+  direction_ = true;
+}
+
+void Node3d::ComputeGridIndex(const std::vector<double>& XYbounds,
+                              const PlannerOpenSpaceConfig& open_space_conf) {
   // XYbounds in xmin, xmax, ymin, ymax
   x_grid_ = static_cast<int>(
       (x_ - XYbounds[0]) /
@@ -84,13 +97,7 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
   phi_grid_ = static_cast<int>(
       (phi_ - (-M_PI)) /
       open_space_conf.warm_start_config().phi_grid_resolution());
-
-  traversed_x_ = traversed_x;
-  traversed_y_ = traversed_y;
-  traversed_phi_ = traversed_phi;
-
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
-  step_size_ = traversed_x.size();
+  index_ = ComputeIndex(x_grid_, y_grid_, phi_grid_);
 }
 
 Box2d Node3d::GetBoundingBox(const common::VehicleParam& vehicle_param_,
@@ -109,8 +116,13 @@ bool Node3d::operator==(const Node3d& right) const {
   return right.GetIndex() == index_;
 }
 
-std::string Node3d::ComputeStringIndex(int x_grid, int y_grid, int phi_grid) {
-  return absl::StrCat(x_grid, "_", y_grid, "_", phi_grid);
+uint64_t Node3d::ComputeIndex(int x_grid, int y_grid, int phi_grid) {
+  // 21 bits per dimension, far more cells than any open space ROI holds.
+  // Negative grids of nodes outside XYbounds wrap around within their bits.
+  constexpr uint64_t kGridMask = (1ULL << 21) - 1;
+  return ((static_cast<uint64_t>(x_grid) & kGridMask) << 42) |
+         ((static_cast<uint64_t>(y_grid) & kGridMask) << 21) |
+         (static_cast<uint64_t>(phi_grid) & kGridMask);
 }
 
 }  // namespace planning
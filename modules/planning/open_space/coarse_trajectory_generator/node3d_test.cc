@@ -60,5 +60,60 @@ TEST_F(Node3dTest, GetBoundingBox) {
   ASSERT_EQ(test_box.width(), gold_box.width());
 }
 
+TEST_F(Node3dTest, GridIndex) {
+  PlannerOpenSpaceConfig open_space_conf;
+  open_space_conf.mutable_warm_start_config()->set_xy_grid_resolution(0.5);
+  open_space_conf.mutable_warm_start_config()->set_phi_grid_resolution(0.1);
+  const std::vector<double> XYbounds = {-10.0, 10.0, -10.0, 10.0};
+  Node3d node(1.2, -3.4, 0.5, XYbounds, open_space_conf);
+  EXPECT_EQ(node.GetGridX(), 22);
+  EXPECT_EQ(node.GetGridY(), 13);
+  EXPECT_EQ(node.GetGridPhi(), 36);
+
+  // same grid, different continuous state
+  Node3d same_grid(1.4, -3.2, 0.55, XYbounds, open_space_conf);
+  EXPECT_EQ(node.GetIndex(), same_grid.GetIndex());
+  EXPECT_TRUE(node == same_grid);
+  // every dimension contributes to the index
+  EXPECT_NE(node.GetIndex(),
+            Node3d(1.6, -3.4, 0.5, XYbounds, open_space_conf).GetIndex());
+  EXPECT_NE(node.GetIndex(),
+            Node3d(1.2, -3.6, 0.5, XYbounds, open_space_conf).GetIndex());
+  EXPECT_NE(node.GetIndex(),
+            Node3d(1.2, -3.4, 0.65, XYbounds, open_space_conf).GetIndex());
+}
+
+TEST_F(Node3dTest, Reset) {
+  PlannerOpenSpaceConfig open_space_conf;
+  open_space_conf.mutable_warm_start_config()->set_xy_grid_resolution(0.5);
+  open_space_conf.mutable_warm_start_config()->set_phi_grid_resolution(0.1);
+  const std::vector<double> XYbounds = {-10.0, 10.0, -10.0, 10.0};
+  Node3d pre_node(0.0, 0.0, 0.0, XYbounds, open_space_conf);
+  Node3d node({0.0, 0.5}, {0.0, 0.1}, {0.0, 0.2}, XYbounds, open_space_conf);
+  node.SetPre(&pre_node);
+  node.SetTrajCost(3.0);
+  node.SetHeuCost(4.0);
+  node.SetDirec(false);
+  node.SetSteer(0.3);
+  EXPECT_EQ(node.GetStepSize(), 2U);
+  EXPECT_EQ(node.GetPreNode(), &pre_node);
+  EXPECT_DOUBLE_EQ(node.GetCost(), 7.0);
+
+  node.Reset({1.0, 1.5, 2.0}, {1.0, 1.0, 1.0}, {0.1, 0.1, 0.1}, XYbounds,
+             open_space_conf);
+  const Node3d gold_node({1.0, 1.5, 2.0}, {1.0, 1.0, 1.0}, {0.1, 0.1, 0.1},
+                         XYbounds, open_space_conf);
+  EXPECT_EQ(node.GetIndex(), gold_node.GetIndex());
+  EXPECT_EQ(node.GetStepSize(), 3U);
+  EXPECT_DOUBLE_EQ(node.GetX(), 2.0);
+  EXPECT_DOUBLE_EQ(node.GetY(), 1.0);
+  EXPECT_DOUBLE_EQ(node.GetPhi(), 0.1);
+  EXPECT_EQ(node.GetXs(), gold_node.GetXs());
+  EXPECT_EQ(node.GetPreNode(), nullptr);
+  EXPECT_DOUBLE_EQ(node.GetCost(), 0.0);
+  EXPECT_TRUE(node.GetDirec());
+  EXPECT_DOUBLE_EQ(node.GetSteer(), 0.0);
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,240 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::LineSegment2d;
+
+namespace {
+// distance, in cells, of the cells without any occupied cell. It is kept
+// finite so that the envelope intersections never compute inf - inf.
+constexpr double kUnoccupied = 1.0e10;
+// slack on the discretization error against the rounding in the
+// rasterization and the tolerance of Box2d::HasOverlap
+constexpr double kDistanceSlack = 1.0e-6;
+}  // namespace
+
+bool ObstacleDistanceField::Build(
+    const std::vector<double>& XYbounds,
+    const std::vector<std::vector<LineSegment2d>>& obstacles_linesegments_vec,
+    const double resolution, const double max_distance) {
+  distance_.clear();
+  if (XYbounds.size() != 4 || XYbounds[0] > XYbounds[1] ||
+      XYbounds[2] > XYbounds[3]) {
+    AERROR << "invalid XYbounds for the obstacle distance field";
+    return false;
+  }
+  if (resolution <= 0.0 || max_distance < 0.0) {
+    AERROR << "invalid obstacle distance field resolution " << resolution
+           << " or max distance " << max_distance;
+    return false;
+  }
+
+  resolution_ = resolution;
+  // the query point and the points of the segments are each within
+  // sqrt(2) / 2 * resolution of the center of their cell
+  max_error_ = std::sqrt(2.0) * resolution_ + kDistanceSlack;
+  x_min_ = XYbounds[0] - max_distance;
+  y_min_ = XYbounds[2] - max_distance;
+  num_x_ = std::max(1, static_cast<int>(std::ceil(
+                           (XYbounds[1] + max_distance - x_min_) /
+                           resolution_)));
+  num_y_ = std::max(1, static_cast<int>(std::ceil(
+                           (XYbounds[3] + max_distance - y_min_) /
+                           resolution_)));
+  x_max_ = x_min_ + num_x_ * resolution_;
+  y_max_ = y_min_ + num_y_ * resolution_;
+
+  distance_.assign(static_cast<size_t>(num_x_) * num_y_, kUnoccupied);
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+    for (const LineSegment2d& linesegment : obstacle_linesegments) {
+      RasterizeLineSegment(linesegment);
+    }
+  }
+
+  // The squared euclidean distance transform is separable. Along the
+  // columns it reduces to the distance to the closest occupied cell, swept
+  // forth and back over whole rows to stay cache friendly.
+  const size_t num_x = static_cast<size_t>(num_x_);
+  for (int iy = 1; iy < num_y_; ++iy) {
+    double* row = distance_.data() + iy * num_x;
+    const double* last_row = row - num_x;
+    for (size_t ix = 0; ix < num_x; ++ix) {
+      row[ix] = std::min(row[ix], last_row[ix] + 1.0);
+    }
+  }
+  for (int iy = num_y_ - 2; iy >= 0; --iy) {
+    double* row = distance_.data() + iy * num_x;
+    const double* next_row = row + num_x;
+    for (size_t ix = 0; ix < num_x; ++ix) {
+      row[ix] = std::min(row[ix], next_row[ix] + 1.0);
+    }
+  }
+  for (double& distance : distance_) {
+    distance *= distance;
+  }
+  for (int iy = 0; iy < num_y_; ++iy) {
+    DistanceTransform1d(num_x_, distance_.data() + iy * num_x);
+  }
+  return true;
+}
+
+double ObstacleDistanceField::DistanceTo(const double x, const double y) const {
+  if (distance_.empty()) {
+    return 0.0;
+  }
+  // obstacles out of the grid are at least as far as the grid border
+  const double border_distance = std::min(std::min(x - x_min_, x_max_ - x),
+                                          std::min(y - y_min_, y_max_ - y));
+  if (border_distance <= 0.0) {
+    return 0.0;
+  }
+  const int ix =
+      std::min(static_cast<int>((x - x_min_) / resolution_), num_x_ - 1);
+  const int iy =
+      std::min(static_cast<int>((y - y_min_) / resolution_), num_y_ - 1);
+  const double distance =
+      std::sqrt(distance_[static_cast<size_t>(iy) * num_x_ + ix]) *
+          resolution_ -
+      max_error_;
+  return std::max(0.0, std::min(distance, border_distance));
+}
+
+bool ObstacleDistanceField::IsCollisionFree(const Box2d& box) const {
+  const bool along_length = box.length() >= box.width();
+  const double long_side = along_length ? box.length() : box.width();
+  const double short_side = along_length ? box.width() : box.length();
+  const int num_discs =
+      short_side > 0.0
+          ? std::max(1, static_cast<int>(std::ceil(long_side / short_side)))
+          : 1;
+  const double step = long_side / num_discs;
+  const double radius = 0.5 * std::hypot(step, short_side);
+  const double unit_x = along_length ? box.cos_heading() : -box.sin_heading();
+  const double unit_y = along_length ? box.sin_heading() : box.cos_heading();
+  for (int i = 0; i < num_discs; ++i) {
+    const double offset = (i + 0.5) * step - 0.5 * long_side;
+    if (DistanceTo(box.center_x() + offset * unit_x,
+                   box.center_y() + offset * unit_y) <= radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ObstacleDistanceField::RasterizeLineSegment(
+    const LineSegment2d& linesegment) {
+  // Mark every cell whose closure intersects the segment, column by column,
+  // so that each point of the segment is within sqrt(2) / 2 * resolution of
+  // an occupied cell center.
+  const double start_x = linesegment.start().x();
+  const double start_y = linesegment.start().y();
+  const double dx = linesegment.end().x() - start_x;
+  const double dy = linesegment.end().y() - start_y;
+  const double seg_x_min = std::min(start_x, start_x + dx);
+  const double seg_x_max = std::max(start_x, start_x + dx);
+  if (seg_x_max < x_min_ || seg_x_min > x_max_) {
+    return;
+  }
+  // clamped before the casts as the segments may be far out of the grid
+  const int ix_begin = static_cast<int>(
+      std::max(0.0, std::floor((seg_x_min - x_min_) / resolution_)));
+  const int ix_end = static_cast<int>(std::min<double>(
+      num_x_ - 1, std::floor((seg_x_max - x_min_) / resolution_)));
+  for (int ix = ix_begin; ix <= ix_end; ++ix) {
+    double t_begin = 0.0;
+    double t_end = 1.0;
+    if (std::abs(dx) > std::numeric_limits<double>::epsilon()) {
+      const double column_x_min = x_min_ + ix * resolution_;
+      const double t_a = (column_x_min - start_x) / dx;
+      const double t_b = (column_x_min + resolution_ - start_x) / dx;
+      t_begin = std::max(t_begin, std::min(t_a, t_b));
+      t_end = std::min(t_end, std::max(t_a, t_b));
+      if (t_begin > t_end) {
+        continue;
+      }
+    }
+    const double y_a = start_y + t_begin * dy;
+    const double y_b = start_y + t_end * dy;
+    const double column_y_min = std::min(y_a, y_b);
+    const double column_y_max = std::max(y_a, y_b);
+    if (column_y_max < y_min_ || column_y_min > y_max_) {
+      continue;
+    }
+    const int iy_begin = static_cast<int>(
+        std::max(0.0, std::floor((column_y_min - y_min_) / resolution_)));
+    const int iy_end = static_cast<int>(std::min<double>(
+        num_y_ - 1, std::floor((column_y_max - y_min_) / resolution_)));
+    for (int iy = iy_begin; iy <= iy_end; ++iy) {
+      distance_[static_cast<size_t>(iy) * num_x_ + ix] = 0.0;
+    }
+  }
+}
+
+void ObstacleDistanceField::DistanceTransform1d(const int n, double* data) {
+  envelope_values_.assign(data, data + n);
+  envelope_vertices_.resize(n);
+  envelope_boundaries_.resize(n + 1);
+  const auto& f = envelope_values_;
+  auto& v = envelope_vertices_;
+  auto& z = envelope_boundaries_;
+  // abscissa where the parabolas rooted at q and p intersect
+  const auto intersection = [&f](const int q, const int p) {
+    return ((f[q] + q * q) - (f[p] + p * p)) / (2.0 * (q - p));
+  };
+
+  int k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<double>::infinity();
+  z[1] = std::numeric_limits<double>::infinity();
+  for (int q = 1; q < n; ++q) {
+    double s = intersection(q, v[k]);
+    while (s <= z[k]) {
+      --k;
+      s = intersection(q, v[k]);
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<double>::infinity();
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < q) {
+      ++k;
+    }
+    const double offset = q - v[k];
+    data[q] = offset * offset + f[v[k]];
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Euclidean distance field of the open space obstacles. The obstacle
+ *        line segments are rasterized on a regular grid once per planning
+ *        cycle, and an exact distance transform of that grid answers
+ *        clearance queries in O(1).
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/line_segment2d.h"
+
+namespace apollo {
+namespace planning {
+
+class ObstacleDistanceField {
+ public:
+  ObstacleDistanceField() = default;
+  ~ObstacleDistanceField() = default;
+
+  /**
+   * @brief Build the field of the obstacles over XYbounds, i.e. {xmin, xmax,
+   *        ymin, ymax}, grown by max_distance on each side. Obstacles outside
+   *        of the grown bounds are ignored, so DistanceTo() is only capped
+   *        by max_distance inside XYbounds.
+   * @param resolution The size of a grid cell.
+   */
+  bool Build(const std::vector<double>& XYbounds,
+             const std::vector<std::vector<common::math::LineSegment2d>>&
+                 obstacles_linesegments_vec,
+             const double resolution, const double max_distance);
+
+  bool IsBuilt() const { return !distance_.empty(); }
+
+  /**
+   * @brief Get a lower bound of the distance from {x, y} to the closest
+   *        obstacle segment, 0 out of the grid. The distance between cell
+   *        centers is within sqrt(2) * resolution of the exact distance and
+   *        that much is subtracted from it, so the bound is within
+   *        2 * sqrt(2) * resolution of the exact distance capped by
+   *        max_distance.
+   */
+  double DistanceTo(const double x, const double y) const;
+
+  /**
+   * @brief Check if the box is guaranteed to be away from every obstacle
+   *        segment. The box is covered by discs along its longer side, and
+   *        the check passes if the clearance of each disc center exceeds
+   *        the disc radius. A false result is inconclusive and should be
+   *        resolved by an exact overlap test.
+   */
+  bool IsCollisionFree(const common::math::Box2d& box) const;
+
+  double resolution() const { return resolution_; }
+  int num_x() const { return num_x_; }
+  int num_y() const { return num_y_; }
+
+ private:
+  void RasterizeLineSegment(const common::math::LineSegment2d& linesegment);
+
+  // Felzenszwalb and Huttenlocher's lower envelope of parabolas on the n
+  // squared distances of a row
+  void DistanceTransform1d(const int n, double* data);
+
+ private:
+  double x_min_ = 0.0;
+  double x_max_ = 0.0;
+  double y_min_ = 0.0;
+  double y_max_ = 0.0;
+  double resolution_ = 0.0;
+  // largest error of the distance between cell centers, sqrt(2) *
+  // resolution, which DistanceTo() subtracts
+  double max_error_ = 0.0;
+  int num_x_ = 0;
+  int num_y_ = 0;
+  // squared distance in cells of each cell center to the closest occupied
+  // cell center, row major with num_x_ cells per row
+  std::vector<double> distance_;
+
+  // scratch buffers of DistanceTransform1d
+  std::vector<double> envelope_values_;
+  std::vector<int> envelope_vertices_;
+  std::vector<double> envelope_boundaries_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Compares the exact open space collision and clearance checks against
+ *        every obstacle segment with the queries on ObstacleDistanceField. The
+ *        argument of every benchmark is the number of parked vehicles in a
+ *        60m x 40m parking lot, each contributing four segments. Run with
+ *        bazel run -c opt //modules/planning/open_space/coarse_trajectory_generator:obstacle_distance_field_benchmark
+ */
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+const std::vector<double> kXYbounds = {-30.0, 30.0, -20.0, 20.0};
+constexpr double kResolution = 0.1;
+constexpr double kMaxDistance = 3.0;
+constexpr int kNumQueries = 1024;
+
+// Vehicles parked side by side in rows of 2.5m wide slots, with 6m wide
+// aisles between the rows.
+std::vector<std::vector<LineSegment2d>> MakeParkingLot(const int num_vehicles) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+  std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec;
+  for (int i = 0; i < num_vehicles; ++i) {
+    const int slot = i % 24;
+    const int row = i / 24;
+    const Vec2d center(kXYbounds[0] + 1.25 + 2.5 * slot + jitter(rng),
+                       kXYbounds[2] + 2.5 + 11.0 * (row % 4) + jitter(rng));
+    const Box2d box(center, M_PI_2 + jitter(rng), 4.8, 1.9);
+    const auto corners = box.GetAllCorners();
+    std::vector<LineSegment2d> obstacle_linesegments;
+    for (size_t j = 0; j < corners.size(); ++j) {
+      obstacle_linesegments.emplace_back(corners[j],
+                                         corners[(j + 1) % corners.size()]);
+    }
+    obstacles_linesegments_vec.push_back(std::move(obstacle_linesegments));
+  }
+  return obstacles_linesegments_vec;
+}
+
+std::vector<Box2d> MakeEgoBoxes() {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> x(kXYbounds[0], kXYbounds[1]);
+  std::uniform_real_distribution<double> y(kXYbounds[2], kXYbounds[3]);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < kNumQueries; ++i) {
+    boxes.emplace_back(Vec2d(x(rng), y(rng)), heading(rng), 4.9, 2.1);
+  }
+  return boxes;
+}
+
+bool HasOverlap(
+    const std::vector<std::vector<LineSegment2d>>& obstacles_linesegments_vec,
+    const Box2d& box) {
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+    for (const LineSegment2d& linesegment : obstacle_linesegments) {
+      if (box.HasOverlap(linesegment)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void BM_BuildDistanceField(benchmark::State& state) {
+  const auto obstacles = MakeParkingLot(static_cast<int>(state.range(0)));
+  ObstacleDistanceField field;
+  for (auto _ : state) {
+    field.Build(kXYbounds, obstacles, kResolution, kMaxDistance);
+    benchmark::ClobberMemory();
+  }
+  state.counters["cells"] = field.num_x() * field.num_y();
+}
+
+void BM_BoxCollisionExact(benchmark::State& state) {
+  const auto obstacles = MakeParkingLot(static_cast<int>(state.range(0)));
+  const auto boxes = MakeEgoBoxes();
+  for (auto _ : state) {
+    int num_collisions = 0;
+    for (const Box2d& box : boxes) {
+      num_collisions += HasOverlap(obstacles, box);
+    }
+    benchmark::DoNotOptimize(num_collisions);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+// the quick accept of the field, resolved by the exact check when it fails
+void BM_BoxCollisionField(benchmark::State& state) {
+  const auto obstacles = MakeParkingLot(static_cast<int>(state.range(0)));
+  const auto boxes = MakeEgoBoxes();
+  ObstacleDistanceField field;
+  field.Build(kXYbounds, obstacles, kResolution, kMaxDistance);
+  int num_accepted = 0;
+  for (const Box2d& box : boxes) {
+    num_accepted += field.IsCollisionFree(box);
+  }
+  for (auto _ : state) {
+    int num_collisions = 0;
+    for (const Box2d& box : boxes) {
+      num_collisions +=
+          !field.IsCollisionFree(box) && HasOverlap(obstacles, box);
+    }
+    benchmark::DoNotOptimize(num_collisions);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+  state.counters["accept_ratio"] =
+      static_cast<double>(num_accepted) / kNumQueries;
+}
+
+void BM_ClearanceExact(benchmark::State& state) {
+  const auto obstacles = MakeParkingLot(static_cast<int>(state.range(0)));
+  const auto boxes = MakeEgoBoxes();
+  for (auto _ : state) {
+    for (const Box2d& box : boxes) {
+      double distance = std::numeric_limits<double>::infinity();
+      for (const auto& obstacle_linesegments : obstacles) {
+        for (const LineSegment2d& linesegment : obstacle_linesegments) {
+          distance = std::min(distance, linesegment.DistanceTo(box.center()));
+        }
+      }
+      benchmark::DoNotOptimize(distance);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+void BM_ClearanceField(benchmark::State& state) {
+  const auto obstacles = MakeParkingLot(static_cast<int>(state.range(0)));
+  const auto boxes = MakeEgoBoxes();
+  ObstacleDistanceField field;
+  field.Build(kXYbounds, obstacles, kResolution, kMaxDistance);
+  for (auto _ : state) {
+    for (const Box2d& box : boxes) {
+      benchmark::DoNotOptimize(
+          field.DistanceTo(box.center_x(), box.center_y()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+}  // namespace
+
+BENCHMARK(BM_BuildDistanceField)->RangeMultiplier(4)->Range(8, 96);
+BENCHMARK(BM_BoxCollisionExact)->RangeMultiplier(4)->Range(8, 96);
+BENCHMARK(BM_BoxCollisionField)->RangeMultiplier(4)->Range(8, 96);
+BENCHMARK(BM_ClearanceExact)->RangeMultiplier(4)->Range(8, 96);
+BENCHMARK(BM_ClearanceField)->RangeMultiplier(4)->Range(8, 96);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
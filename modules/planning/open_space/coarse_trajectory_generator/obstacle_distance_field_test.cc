@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
+
+#include <limits>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+std::vector<std::vector<LineSegment2d>> RandomObstacles(const int num_obstacles,
+                                                        std::mt19937* rng) {
+  std::uniform_real_distribution<double> position(-12.0, 12.0);
+  std::uniform_real_distribution<double> offset(-3.0, 3.0);
+  std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec;
+  for (int i = 0; i < num_obstacles; ++i) {
+    Vec2d vertice(position(*rng), position(*rng));
+    std::vector<LineSegment2d> obstacle_linesegments;
+    for (int j = 0; j < 3; ++j) {
+      const Vec2d next_vertice = vertice + Vec2d(offset(*rng), offset(*rng));
+      obstacle_linesegments.emplace_back(vertice, next_vertice);
+      vertice = next_vertice;
+    }
+    obstacles_linesegments_vec.push_back(std::move(obstacle_linesegments));
+  }
+  // axis aligned segments on the grid lines
+  obstacles_linesegments_vec.push_back(
+      {LineSegment2d({-5.0, 2.0}, {5.0, 2.0}),
+       LineSegment2d({3.0, -6.0}, {3.0, 6.0})});
+  return obstacles_linesegments_vec;
+}
+
+double ExactDistanceTo(
+    const std::vector<std::vector<LineSegment2d>>& obstacles_linesegments_vec,
+    const Vec2d& point) {
+  double distance = std::numeric_limits<double>::infinity();
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+    for (const LineSegment2d& linesegment : obstacle_linesegments) {
+      distance = std::min(distance, linesegment.DistanceTo(point));
+    }
+  }
+  return distance;
+}
+
+bool HasOverlap(
+    const std::vector<std::vector<LineSegment2d>>& obstacles_linesegments_vec,
+    const Box2d& box) {
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+    for (const LineSegment2d& linesegment : obstacle_linesegments) {
+      if (box.HasOverlap(linesegment)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(ObstacleDistanceFieldTest, Build) {
+  ObstacleDistanceField field;
+  EXPECT_FALSE(field.IsBuilt());
+  EXPECT_DOUBLE_EQ(field.DistanceTo(0.0, 0.0), 0.0);
+  EXPECT_FALSE(field.Build({1.0, -1.0, 0.0, 1.0}, {}, 0.1, 1.0));
+  EXPECT_FALSE(field.Build({-1.0, 1.0, -1.0, 1.0}, {}, 0.0, 1.0));
+  EXPECT_FALSE(field.IsBuilt());
+
+  ASSERT_TRUE(field.Build({-1.0, 1.0, -2.0, 2.0}, {}, 0.1, 1.0));
+  EXPECT_TRUE(field.IsBuilt());
+  EXPECT_EQ(field.num_x(), 40);
+  EXPECT_EQ(field.num_y(), 60);
+  // without obstacles the distance is capped by the grid border
+  EXPECT_NEAR(field.DistanceTo(0.0, 0.0), 2.0, 1e-9);
+  EXPECT_NEAR(field.DistanceTo(0.5, 1.9), 1.1, 1e-9);
+  EXPECT_DOUBLE_EQ(field.DistanceTo(2.5, 0.0), 0.0);
+}
+
+TEST(ObstacleDistanceFieldTest, DistanceTo) {
+  std::mt19937 rng(12345);
+  const std::vector<double> XYbounds = {-15.0, 15.0, -10.0, 10.0};
+  const auto obstacles_linesegments_vec = RandomObstacles(20, &rng);
+  const double resolution = 0.1;
+  const double max_distance = 3.0;
+  ObstacleDistanceField field;
+  ASSERT_TRUE(field.Build(XYbounds, obstacles_linesegments_vec, resolution,
+                          max_distance));
+
+  std::uniform_real_distribution<double> x(XYbounds[0], XYbounds[1]);
+  std::uniform_real_distribution<double> y(XYbounds[2], XYbounds[3]);
+  for (int i = 0; i < 2000; ++i) {
+    const Vec2d point(x(rng), y(rng));
+    const double exact_distance =
+        ExactDistanceTo(obstacles_linesegments_vec, point);
+    const double distance = field.DistanceTo(point.x(), point.y());
+    // a lower bound within 2 * sqrt(2) * resolution of the capped distance
+    EXPECT_LE(distance, exact_distance);
+    EXPECT_GE(distance, std::min(exact_distance, max_distance) -
+                            2.0 * std::sqrt(2.0) * resolution - 1e-6);
+  }
+}
+
+TEST(ObstacleDistanceFieldTest, IsCollisionFree) {
+  std::mt19937 rng(23456);
+  const std::vector<double> XYbounds = {-15.0, 15.0, -10.0, 10.0};
+  const auto obstacles_linesegments_vec = RandomObstacles(10, &rng);
+  ObstacleDistanceField field;
+  ASSERT_TRUE(field.Build(XYbounds, obstacles_linesegments_vec, 0.1, 3.0));
+
+  std::uniform_real_distribution<double> x(XYbounds[0], XYbounds[1]);
+  std::uniform_real_distribution<double> y(XYbounds[2], XYbounds[3]);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  int num_collision_free = 0;
+  for (int i = 0; i < 2000; ++i) {
+    const Box2d box({x(rng), y(rng)}, heading(rng), 4.9, 2.1);
+    if (field.IsCollisionFree(box)) {
+      ++num_collision_free;
+      EXPECT_FALSE(HasOverlap(obstacles_linesegments_vec, box));
+    }
+    // boxes wider than long are covered along their width
+    const Box2d rotated_box(box.center(), box.heading(), 2.1, 4.9);
+    if (field.IsCollisionFree(rotated_box)) {
+      EXPECT_FALSE(HasOverlap(obstacles_linesegments_vec, rotated_box));
+    }
+  }
+  EXPECT_GT(num_collision_free, 0);
+}
+
+}  // namespace planning
+}  // namespace apollo
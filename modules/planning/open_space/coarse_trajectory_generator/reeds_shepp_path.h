@@ -67,24 +67,23 @@ class ReedShepp {
   bool ShortestRSP(const std::shared_ptr<Node3d> start_node,
                    const std::shared_ptr<Node3d> end_node,
                    std::shared_ptr<ReedSheppPath> optimal_path);
+  bool ShortestRSP(const Node3d& start_node, const Node3d& end_node,
+                   ReedSheppPath* optimal_path);
 
  protected:
   // Generate all possible combination of movement primitives by Reed Shepp and
   // interpolate them
-  bool GenerateRSPs(const std::shared_ptr<Node3d> start_node,
-                    const std::shared_ptr<Node3d> end_node,
+  bool GenerateRSPs(const Node3d& start_node, const Node3d& end_node,
                     std::vector<ReedSheppPath>* all_possible_paths);
   // Set the general profile of the movement primitives
-  bool GenerateRSP(const std::shared_ptr<Node3d> start_node,
-                   const std::shared_ptr<Node3d> end_node,
+  bool GenerateRSP(const Node3d& start_node, const Node3d& end_node,
                    std::vector<ReedSheppPath>* all_possible_paths);
   // Set the general profile of the movement primitives, parallel implementation
-  bool GenerateRSPPar(const std::shared_ptr<Node3d> start_node,
-                      const std::shared_ptr<Node3d> end_node,
+  bool GenerateRSPPar(const Node3d& start_node, const Node3d& end_node,
                       std::vector<ReedSheppPath>* all_possible_paths);
   // Set local exact configurations profile of each movement primitive
-  bool GenerateLocalConfigurations(const std::shared_ptr<Node3d> start_node,
-                                   const std::shared_ptr<Node3d> end_node,
+  bool GenerateLocalConfigurations(const Node3d& start_node,
+                                   const Node3d& end_node,
                                    ReedSheppPath* shortest_path);
   // Interpolation usde in GenetateLocalConfiguration
   void Interpolation(const int index, const double pd, const char m,
@@ -17,9 +17,15 @@
 /**
  * @file
  **/
+#include "modules/planning/open_space/tools/distance_approach_problem_wrapper.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
 #include "cyber/common/file.h"
+#include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/open_space/coarse_trajectory_generator/hybrid_a_star.h"
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_problem.h"
 #include "modules/planning/open_space/trajectory_smoother/dual_variable_warm_start_problem.h"
 
@@ -28,186 +34,6 @@ namespace planning {
 
 using apollo::common::math::Vec2d;
 
-class ObstacleContainer {
- public:
-  ObstacleContainer() = default;
-
-  bool VPresentationObstacle(
-      const double* ROI_distance_approach_parking_boundary) {
-    obstacles_num_ = 4;
-    obstacles_edges_num_.resize(4, 1);
-    obstacles_edges_num_ << 2, 1, 2, 1;
-    size_t index = 0;
-    for (size_t i = 0; i < obstacles_num_; i++) {
-      std::vector<Vec2d> vertices_cw;
-      for (int j = 0; j < obstacles_edges_num_(i, 0) + 1; j++) {
-        Vec2d vertice =
-            Vec2d(ROI_distance_approach_parking_boundary[index],
-                  ROI_distance_approach_parking_boundary[index + 1]);
-        index += 2;
-        vertices_cw.emplace_back(vertice);
-      }
-      obstacles_vertices_vec_.emplace_back(vertices_cw);
-    }
-    return true;
-  }
-
-  bool HPresentationObstacle() {
-    obstacles_A_ = Eigen::MatrixXd::Zero(obstacles_edges_num_.sum(), 2);
-    obstacles_b_ = Eigen::MatrixXd::Zero(obstacles_edges_num_.sum(), 1);
-    // vertices using H-representation
-    if (!ObsHRep(obstacles_num_, obstacles_edges_num_, obstacles_vertices_vec_,
-                 &obstacles_A_, &obstacles_b_)) {
-      AINFO << "Fail to present obstacle in hyperplane";
-      return false;
-    }
-    return true;
-  }
-
-  bool ObsHRep(const size_t obstacles_num,
-               const Eigen::MatrixXi& obstacles_edges_num,
-               const std::vector<std::vector<Vec2d>>& obstacles_vertices_vec,
-               Eigen::MatrixXd* A_all, Eigen::MatrixXd* b_all) {
-    if (obstacles_num != obstacles_vertices_vec.size()) {
-      AINFO << "obstacles_num != obstacles_vertices_vec.size()";
-      return false;
-    }
-
-    A_all->resize(obstacles_edges_num.sum(), 2);
-    b_all->resize(obstacles_edges_num.sum(), 1);
-
-    int counter = 0;
-    double kEpsilon = 1.0e-5;
-    // start building H representation
-    for (size_t i = 0; i < obstacles_num; ++i) {
-      size_t current_vertice_num = obstacles_edges_num(i, 0);
-      Eigen::MatrixXd A_i(current_vertice_num, 2);
-      Eigen::MatrixXd b_i(current_vertice_num, 1);
-
-      // take two subsequent vertices, and computer hyperplane
-      for (size_t j = 0; j < current_vertice_num; ++j) {
-        Vec2d v1 = obstacles_vertices_vec[i][j];
-        Vec2d v2 = obstacles_vertices_vec[i][j + 1];
-
-        Eigen::MatrixXd A_tmp(2, 1), b_tmp(1, 1), ab(2, 1);
-        // find hyperplane passing through v1 and v2
-        if (std::abs(v1.x() - v2.x()) < kEpsilon) {
-          if (v2.y() < v1.y()) {
-            A_tmp << 1, 0;
-            b_tmp << v1.x();
-          } else {
-            A_tmp << -1, 0;
-            b_tmp << -v1.x();
-          }
-        } else if (std::abs(v1.y() - v2.y()) < kEpsilon) {
-          if (v1.x() < v2.x()) {
-            A_tmp << 0, 1;
-            b_tmp << v1.y();
-          } else {
-            A_tmp << 0, -1;
-            b_tmp << -v1.y();
-          }
-        } else {
-          Eigen::MatrixXd tmp1(2, 2);
-          tmp1 << v1.x(), 1, v2.x(), 1;
-          Eigen::MatrixXd tmp2(2, 1);
-          tmp2 << v1.y(), v2.y();
-          ab = tmp1.inverse() * tmp2;
-          double a = ab(0, 0);
-          double b = ab(1, 0);
-
-          if (v1.x() < v2.x()) {
-            A_tmp << -a, 1;
-            b_tmp << b;
-          } else {
-            A_tmp << a, -1;
-            b_tmp << -b;
-          }
-        }
-
-        // store vertices
-        A_i.block(j, 0, 1, 2) = A_tmp.transpose();
-        b_i.block(j, 0, 1, 1) = b_tmp;
-      }
-
-      A_all->block(counter, 0, A_i.rows(), 2) = A_i;
-      b_all->block(counter, 0, b_i.rows(), 1) = b_i;
-      counter += static_cast<int>(current_vertice_num);
-    }
-    return true;
-  }
-
-  void AddObstacle(const double* ROI_distance_approach_parking_boundary) {
-    // the obstacles are hard coded into vertice sets of 3, 2, 3, 2
-    if (!(VPresentationObstacle(ROI_distance_approach_parking_boundary) &&
-          HPresentationObstacle())) {
-      AINFO << "obstacle presentation fails";
-    }
-  }
-
-  const std::vector<std::vector<Vec2d>>& GetObstacleVec() const {
-    return obstacles_vertices_vec_;
-  }
-  const Eigen::MatrixXd& GetAMatrix() const { return obstacles_A_; }
-  const Eigen::MatrixXd& GetbMatrix() const { return obstacles_b_; }
-  size_t GetObstaclesNum() const { return obstacles_num_; }
-  const Eigen::MatrixXi& GetObstaclesEdgesNum() const {
-    return obstacles_edges_num_;
-  }
-
- private:
-  size_t obstacles_num_ = 0;
-  Eigen::MatrixXi obstacles_edges_num_;
-  std::vector<std::vector<Vec2d>> obstacles_vertices_vec_;
-  Eigen::MatrixXd obstacles_A_;
-  Eigen::MatrixXd obstacles_b_;
-};
-
-class ResultContainer {
- public:
-  ResultContainer() = default;
-  void LoadHybridAResult() {
-    x_ = std::move(result_.x);
-    y_ = std::move(result_.y);
-    phi_ = std::move(result_.phi);
-    v_ = std::move(result_.v);
-    a_ = std::move(result_.a);
-    steer_ = std::move(result_.steer);
-  }
-  std::vector<double>* GetX() { return &x_; }
-  std::vector<double>* GetY() { return &y_; }
-  std::vector<double>* GetPhi() { return &phi_; }
-  std::vector<double>* GetV() { return &v_; }
-  std::vector<double>* GetA() { return &a_; }
-  std::vector<double>* GetSteer() { return &steer_; }
-  HybridAStartResult* PrepareHybridAResult() { return &result_; }
-  Eigen::MatrixXd* PrepareStateResult() { return &state_result_ds_; }
-  Eigen::MatrixXd* PrepareControlResult() { return &control_result_ds_; }
-  Eigen::MatrixXd* PrepareTimeResult() { return &time_result_ds_; }
-  Eigen::MatrixXd* PrepareLResult() { return &dual_l_result_ds_; }
-  Eigen::MatrixXd* PrepareNResult() { return &dual_n_result_ds_; }
-  double* GetHybridTime() { return &hybrid_time_; }
-  double* GetDualTime() { return &dual_time_; }
-  double* GetIpoptTime() { return &ipopt_time_; }
-
- private:
-  HybridAStartResult result_;
-  std::vector<double> x_;
-  std::vector<double> y_;
-  std::vector<double> phi_;
-  std::vector<double> v_;
-  std::vector<double> a_;
-  std::vector<double> steer_;
-  Eigen::MatrixXd state_result_ds_;
-  Eigen::MatrixXd control_result_ds_;
-  Eigen::MatrixXd time_result_ds_;
-  Eigen::MatrixXd dual_l_result_ds_;
-  Eigen::MatrixXd dual_n_result_ds_;
-  double hybrid_time_;
-  double dual_time_;
-  double ipopt_time_;
-};
-
 extern "C" {
 HybridAStar* CreateHybridAPtr() {
   apollo::planning::PlannerOpenSpaceConfig planner_open_space_config_;
@@ -369,8 +195,8 @@ bool DistanceSmoothing(
   Eigen::MatrixXd s_warm_up =
       Eigen::MatrixXd::Zero(obstacles.GetObstaclesNum(), horizon_ + 1);
 
-  DualVariableWarmStartProblem* dual_variable_warm_start_ptr =
-      new DualVariableWarmStartProblem(planner_open_space_config);
+  std::unique_ptr<DualVariableWarmStartProblem> dual_variable_warm_start_ptr(
+      new DualVariableWarmStartProblem(planner_open_space_config));
 
   const auto t1 = std::chrono::system_clock::now();
   if (FLAGS_use_dual_variable_warm_start) {
@@ -394,8 +220,8 @@ bool DistanceSmoothing(
   const auto t2 = std::chrono::system_clock::now();
   dual_time = std::chrono::duration<double>(t2 - t1).count() * 1000;
 
-  DistanceApproachProblem* distance_approach_ptr =
-      new DistanceApproachProblem(planner_open_space_config);
+  std::unique_ptr<DistanceApproachProblem> distance_approach_ptr(
+      new DistanceApproachProblem(planner_open_space_config));
 
   bool status = distance_approach_ptr->Solve(
       x0, xF, last_time_u, horizon_, ts_, ego_, xWS, uWS, l_warm_up, n_warm_up,
@@ -417,6 +243,18 @@ bool DistancePlan(HybridAStar* hybridA_ptr, ObstacleContainer* obstacles_ptr,
                   ResultContainer* result_ptr, double sx, double sy,
                   double sphi, double ex, double ey, double ephi,
                   double* XYbounds) {
+  std::string flag_file_path = "/apollo/modules/planning/conf/planning.conf";
+  google::SetCommandLineOption("flagfile", flag_file_path.c_str());
+
+  return DistancePlanWithCurrentFlags(hybridA_ptr, obstacles_ptr, result_ptr,
+                                      sx, sy, sphi, ex, ey, ephi, XYbounds);
+}
+
+bool DistancePlanWithCurrentFlags(HybridAStar* hybridA_ptr,
+                                  ObstacleContainer* obstacles_ptr,
+                                  ResultContainer* result_ptr, double sx,
+                                  double sy, double sphi, double ex, double ey,
+                                  double ephi, double* XYbounds) {
   apollo::planning::PlannerOpenSpaceConfig planner_open_space_config_;
   ACHECK(apollo::cyber::common::GetProtoFromFile(
       FLAGS_planner_open_space_config_filename, &planner_open_space_config_))
@@ -429,9 +267,6 @@ bool DistancePlan(HybridAStar* hybridA_ptr, ObstacleContainer* obstacles_ptr,
   double dual_total = 0.0;
   double ipopt_total = 0.0;
 
-  std::string flag_file_path = "/apollo/modules/planning/conf/planning.conf";
-  google::SetCommandLineOption("flagfile", flag_file_path.c_str());
-
   HybridAStartResult hybrid_astar_result;
   std::vector<double> XYbounds_(XYbounds, XYbounds + 4);
 
@@ -463,43 +298,13 @@ bool DistancePlan(HybridAStar* hybridA_ptr, ObstacleContainer* obstacles_ptr,
     time_result_ds_vec.resize(size);
     dual_l_result_ds_vec.resize(size);
     dual_n_result_ds_vec.resize(size);
-    std::vector<std::future<bool>> results;
-
-    // In parallel
-    // TODO(Jinyun): fix memory issue
-    // for (size_t i = 0; i < size; ++i) {
-    //   double piece_wise_sx = partition_trajectories[i].x.front();
-    //   double piece_wise_sy = partition_trajectories[i].y.front();
-    //   double piece_wise_sphi = partition_trajectories[i].phi.front();
-    //   double piece_wise_ex = partition_trajectories[i].x.back();
-    //   double piece_wise_ey = partition_trajectories[i].y.back();
-    //   double piece_wise_ephi = partition_trajectories[i].phi.back();
-    //   auto* ith_trajectories = &partition_trajectories[i];
-    //   auto* ith_state_result = &state_result_ds_vec[i];
-    //   auto* ith_control_result = &control_result_ds_vec[i];
-    //   auto* ith_time_result = &time_result_ds_vec[i];
-    //   auto* ith_dual_l_result = &dual_l_result_ds_vec[i];
-    //   auto* ith_dual_n_result = &dual_n_result_ds_vec[i];
-    //   results.push_back(
-    //       cyber::Async(&DistanceSmoothing,
-    //       std::ref(planner_open_space_config_),
-    //                    std::ref(*obstacles_ptr), piece_wise_sx,
-    //                    piece_wise_sy, piece_wise_sphi, piece_wise_ex,
-    //                    piece_wise_ey, piece_wise_ephi, std::ref(XYbounds_),
-    //                    ith_trajectories, ith_state_result,
-    //                    ith_control_result, ith_time_result,
-    //                    ith_dual_l_result, ith_dual_n_result));
-    // }
-    // for (auto& result : results) {
-    //   if (!result.get()) {
-    //     AERROR << "Failure in a piece of trajectory.";
-    //     return false;
-    //   }
-    // }
-
-    // In for loop
-    double dual_tmp = 0.0;
-    double ipopt_tmp = 0.0;
+
+    // The IPOPT solves of the distance approach share the process wide state
+    // of MUMPS and of the ADOL-C tapes, so the partitions are smoothed one
+    // after another.
+    std::vector<double> dual_time_vec(size, 0.0);
+    std::vector<double> ipopt_time_vec(size, 0.0);
+    std::vector<int> is_smoothed(size, 0);
     for (size_t i = 0; i < size; ++i) {
       double piece_wise_sx = partition_trajectories[i].x.front();
       double piece_wise_sy = partition_trajectories[i].y.front();
@@ -507,23 +312,26 @@ bool DistancePlan(HybridAStar* hybridA_ptr, ObstacleContainer* obstacles_ptr,
       double piece_wise_ex = partition_trajectories[i].x.back();
       double piece_wise_ey = partition_trajectories[i].y.back();
       double piece_wise_ephi = partition_trajectories[i].phi.back();
+      is_smoothed[i] = DistanceSmoothing(
+          planner_open_space_config_, *obstacles_ptr, piece_wise_sx,
+          piece_wise_sy, piece_wise_sphi, piece_wise_ex, piece_wise_ey,
+          piece_wise_ephi, XYbounds_, &partition_trajectories[i],
+          &state_result_ds_vec[i], &control_result_ds_vec[i],
+          &time_result_ds_vec[i], &dual_l_result_ds_vec[i],
+          &dual_n_result_ds_vec[i], dual_time_vec[i], ipopt_time_vec[i]);
+    }
 
+    for (size_t i = 0; i < size; ++i) {
       if (planner_open_space_config_.enable_check_parallel_trajectory()) {
         AINFO << "trajectory idx: " << i;
         AINFO << "trajectory pt number: " << partition_trajectories[i].x.size();
       }
-
-      if (!DistanceSmoothing(planner_open_space_config_, *obstacles_ptr,
-                             piece_wise_sx, piece_wise_sy, piece_wise_sphi,
-                             piece_wise_ex, piece_wise_ey, piece_wise_ephi,
-                             XYbounds_, &partition_trajectories[i],
-                             &state_result_ds_vec[i], &control_result_ds_vec[i],
-                             &time_result_ds_vec[i], &dual_l_result_ds_vec[i],
-                             &dual_n_result_ds_vec[i], dual_tmp, ipopt_tmp)) {
+      if (!is_smoothed[i]) {
+        AERROR << "Failure in a piece of trajectory.";
         return false;
       }
-      dual_total += dual_tmp;
-      ipopt_total += ipopt_tmp;
+      dual_total += dual_time_vec[i];
+      ipopt_total += ipopt_time_vec[i];
     }
 
     // Retrieve result in one single trajectory
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Hybrid A* warm start followed by the distance approach smoother,
+ *        driven through the C interface used by the python visualization
+ *        tools. The argument is 0 to smooth the whole trajectory in one
+ *        problem, or 1 to smooth the partitions of the trajectory one after
+ *        another as FLAGS_enable_parallel_trajectory_smoothing does.
+ *        BM_DistanceApproachMode solves the whole trajectory with the
+ *        DistanceApproachMode given as argument, e.g. the ADOL-C taped
+ *        DISTANCE_APPROACH_IPOPT (0) and DISTANCE_APPROACH_IPOPT_FIXED_TS (2)
+ *        against the analytic DISTANCE_APPROACH_IPOPT_SPARSE (6).
+ *        Run from the apollo root, as the wrapper loads
+ *        FLAGS_planner_open_space_config_filename:
+ *        bazel run -c opt //modules/planning/open_space/tools:distance_approach_problem_wrapper_benchmark
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/open_space/tools/distance_approach_problem_wrapper.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+struct ParkingScenario {
+  double sx;
+  double sy;
+  double sphi;
+  double ex;
+  double ey;
+  double ephi;
+  std::vector<double> XYbounds;
+  // {x, y} vertices of the four boundaries around the parking space, with 3,
+  // 2, 3 and 2 vertices as expected by AddObstacle
+  std::vector<double> parking_boundary;
+};
+
+// Backward parking into space 11543 of sunnyvale_with_two_offices, the same
+// scenario as the distance_approach_visualizer of
+// modules/tools/open_space_visualization
+const ParkingScenario kBackwardParking = {
+    -8.0,
+    4.0,
+    0.0,
+    1.359,
+    -3.86443643718,
+    1.581,
+    {-13.6406951857, 16.3591910364, -5.15258191624, 5.61797800844},
+    {-13.6407054776, 0.0140634663703, 0.0, 0.0, 0.0515703622475,
+     -5.15258191624, 0.0515703622475, -5.15258191624, 2.8237895441,
+     -5.15306980547, 2.8237895441, -5.15306980547, 2.7184833539,
+     -0.0398078878812, 16.3592013995, -0.011889513383, 16.3591910364,
+     5.60414234644, -13.6406951857, 5.61797800844}};
+
+// Parallel parking into an 8m long, 2.5m deep space along the curb
+const ParkingScenario kParallelParking = {
+    -6.0,
+    3.0,
+    0.0,
+    2.577,
+    -1.25,
+    0.0,
+    {-15.0, 20.0, -2.5, 6.0},
+    {-15.0, 0.0, 0.0, 0.0, 0.0, -2.5, 0.0, -2.5, 8.0, -2.5, 8.0, -2.5, 8.0,
+     0.0, 20.0, 0.0, 20.0, 6.0, -15.0, 6.0}};
+
+void RunDistanceApproachParking(benchmark::State* state,
+                                const ParkingScenario& scenario) {
+  std::unique_ptr<HybridAStar> planner(CreateHybridAPtr());
+  std::unique_ptr<ObstacleContainer> obstacles(DistanceCreateObstaclesPtr());
+  AddObstacle(obstacles.get(), scenario.parking_boundary.data());
+  std::vector<double> XYbounds = scenario.XYbounds;
+
+  double hybrid_time = 0.0;
+  double dual_time = 0.0;
+  double ipopt_time = 0.0;
+  for (auto _ : *state) {
+    std::unique_ptr<ResultContainer> result(DistanceCreateResultPtr());
+    if (!DistancePlanWithCurrentFlags(
+            planner.get(), obstacles.get(), result.get(), scenario.sx,
+            scenario.sy, scenario.sphi, scenario.ex, scenario.ey,
+            scenario.ephi, XYbounds.data())) {
+      state->SkipWithError("Distance approach failed to plan");
+      break;
+    }
+    hybrid_time += *result->GetHybridTime();
+    dual_time += *result->GetDualTime();
+    ipopt_time += *result->GetIpoptTime();
+  }
+  // the dual and ipopt times are summed over the partitions
+  state->counters["hybrid_ms"] =
+      benchmark::Counter(hybrid_time, benchmark::Counter::kAvgIterations);
+  state->counters["dual_ms"] =
+      benchmark::Counter(dual_time, benchmark::Counter::kAvgIterations);
+  state->counters["ipopt_ms"] =
+      benchmark::Counter(ipopt_time, benchmark::Counter::kAvgIterations);
+}
+
+void BM_DistanceApproachParking(benchmark::State& state,
+                                const ParkingScenario& scenario) {
+  FLAGS_enable_parallel_trajectory_smoothing = state.range(0) > 0;
+  RunDistanceApproachParking(&state, scenario);
+}
+
+void BM_DistanceApproachMode(benchmark::State& state,
+                             const ParkingScenario& scenario) {
+  // the wrapper reloads the open space config from its file on every plan,
+  // so the mode is set on a copy of the config file
+  const std::string config_filename = FLAGS_planner_open_space_config_filename;
+  PlannerOpenSpaceConfig planner_open_space_config;
+  if (!cyber::common::GetProtoFromFile(config_filename,
+                                       &planner_open_space_config)) {
+    state.SkipWithError("Failed to load the open space config");
+    return;
+  }
+  planner_open_space_config.mutable_distance_approach_config()
+      ->set_distance_approach_mode(
+          static_cast<DistanceApproachMode>(state.range(0)));
+  const std::string mode_config_filename =
+      "/tmp/distance_approach_mode_" + std::to_string(state.range(0)) +
+      ".pb.txt";
+  if (!cyber::common::SetProtoToASCIIFile(planner_open_space_config,
+                                          mode_config_filename)) {
+    state.SkipWithError("Failed to write the open space config");
+    return;
+  }
+
+  FLAGS_enable_parallel_trajectory_smoothing = false;
+  FLAGS_planner_open_space_config_filename = mode_config_filename;
+  RunDistanceApproachParking(&state, scenario);
+  FLAGS_planner_open_space_config_filename = config_filename;
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_DistanceApproachParking, backward, kBackwardParking)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DistanceApproachParking, parallel, kParallelParking)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DistanceApproachMode, backward, kBackwardParking)
+    ->Arg(DISTANCE_APPROACH_IPOPT)
+    ->Arg(DISTANCE_APPROACH_IPOPT_FIXED_TS)
+    ->Arg(DISTANCE_APPROACH_IPOPT_SPARSE)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DistanceApproachMode, parallel, kParallelParking)
+    ->Arg(DISTANCE_APPROACH_IPOPT)
+    ->Arg(DISTANCE_APPROACH_IPOPT_FIXED_TS)
+    ->Arg(DISTANCE_APPROACH_IPOPT_SPARSE)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
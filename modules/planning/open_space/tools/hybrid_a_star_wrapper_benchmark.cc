@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Hybrid A* parking benchmark driven through the C interface used by
+ *        the python visualization tools. Each iteration is a full Plan()
+ *        call; "expansions/s" only counts the time spent in the search loop.
+ *        Run from the apollo root, as the wrapper loads
+ *        FLAGS_planner_open_space_config_filename:
+ *        bazel run -c opt //modules/planning/open_space/tools:hybrid_a_star_wrapper_benchmark
+ */
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/open_space/tools/hybrid_a_star_wrapper.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+struct ParkingScenario {
+  double sx;
+  double sy;
+  double sphi;
+  double ex;
+  double ey;
+  double ephi;
+  std::vector<double> XYbounds;
+  // obstacles as polylines of {x, y} vertices
+  std::vector<std::vector<std::pair<double, double>>> obstacles;
+};
+
+// Backward parking into space 11543 of sunnyvale_with_two_offices, the same
+// scenario as modules/tools/open_space_visualization/hybrid_a_star_visualizer
+const ParkingScenario kBackwardParking = {
+    -8.0,
+    4.0,
+    0.0,
+    1.359,
+    -3.86443643718,
+    1.581,
+    {-13.6406951857, 16.3591910364, -5.15258191624, 5.61797800844},
+    {{{-13.6407054776, 0.0140634663703},
+      {0.0, 0.0},
+      {0.0515703622475, -5.15258191624}},
+     {{0.0515703622475, -5.15258191624}, {2.8237895441, -5.15306980547}},
+     {{2.8237895441, -5.15306980547},
+      {2.7184833539, -0.0398078878812},
+      {16.3592013995, -0.011889513383}},
+     {{16.3591910364, 5.60414234644}, {-13.6406951857, 5.61797800844}}}};
+
+// Parallel parking into an 8m long, 2.5m deep space along the curb
+const ParkingScenario kParallelParking = {
+    -6.0,
+    3.0,
+    0.0,
+    2.577,
+    -1.25,
+    0.0,
+    {-15.0, 20.0, -2.5, 6.0},
+    {{{-15.0, 0.0}, {0.0, 0.0}, {0.0, -2.5}},
+     {{0.0, -2.5}, {8.0, -2.5}},
+     {{8.0, -2.5}, {8.0, 0.0}, {20.0, 0.0}},
+     {{20.0, 6.0}, {-15.0, 6.0}}}};
+
+void BM_HybridAStarParking(benchmark::State& state,
+                           const ParkingScenario& scenario) {
+  std::unique_ptr<HybridAStar> planner(CreatePlannerPtr());
+  std::unique_ptr<HybridAObstacleContainer> obstacles(CreateObstaclesPtr());
+  std::unique_ptr<HybridAResultContainer> result(CreateResultPtr());
+  for (const auto& obstacle : scenario.obstacles) {
+    std::vector<double> obstacle_x;
+    std::vector<double> obstacle_y;
+    for (const auto& vertice : obstacle) {
+      obstacle_x.push_back(vertice.first);
+      obstacle_y.push_back(vertice.second);
+    }
+    AddVirtualObstacle(obstacles.get(), obstacle_x.data(), obstacle_y.data(),
+                       static_cast<int>(obstacle.size()));
+  }
+  std::vector<double> XYbounds = scenario.XYbounds;
+
+  size_t expanded_node_num = 0;
+  double search_time = 0.0;
+  for (auto _ : state) {
+    if (!Plan(planner.get(), obstacles.get(), result.get(), scenario.sx,
+              scenario.sy, scenario.sphi, scenario.ex, scenario.ey,
+              scenario.ephi, XYbounds.data())) {
+      state.SkipWithError("Hybrid A* failed to find a path");
+      break;
+    }
+    expanded_node_num += planner->GetExpandedNodeNum();
+    search_time += planner->GetSearchTime();
+  }
+  state.counters["expansions"] =
+      static_cast<double>(planner->GetExpandedNodeNum());
+  state.counters["search_ms"] = benchmark::Counter(
+      search_time * 1000.0, benchmark::Counter::kAvgIterations);
+  if (search_time > 0.0) {
+    state.counters["expansions/s"] =
+        static_cast<double>(expanded_node_num) / search_time;
+  }
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_HybridAStarParking, backward, kBackwardParking)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_HybridAStarParking, parallel, kParallelParking)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
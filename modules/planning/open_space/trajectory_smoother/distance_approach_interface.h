@@ -20,12 +20,6 @@
 
 #pragma once
 
-#include <adolc/adolc.h>
-#include <adolc/adolc_openmp.h>
-#include <adolc/adolc_sparse.h>
-#include <adolc/adouble.h>
-#include <omp.h>
-
 #include <coin/IpTNLP.hpp>
 #include <coin/IpTypes.hpp>
 
@@ -39,11 +33,6 @@
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/proto/planner_open_space_config.pb.h"
 
-#define tag_f 1
-#define tag_g 2
-#define tag_L 3
-#define HPOFF 30
-
 namespace apollo {
 namespace planning {
 
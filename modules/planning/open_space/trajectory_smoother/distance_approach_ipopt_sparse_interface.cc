@@ -0,0 +1,1106 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_sparse_interface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kInfinity = 2e19;
+
+// variables of a step of the dynamics
+constexpr int kPhi = 0;
+constexpr int kV = 1;
+constexpr int kSteer = 2;
+constexpr int kA = 3;
+constexpr int kT = 4;
+constexpr int kStepVariables = 5;
+
+// Second order bicycle model step of DistanceApproachIPOPTInterface, with
+// h = ts * t,
+//   x' = x + f * cos(theta)
+//   y' = y + f * sin(theta)
+//   phi' = phi + f * k
+//   v' = v + h * a
+// where f = h * (v + 0.5 * h * a), theta = phi + 0.5 * h * v * k and
+// k = tan(steer) / wheelbase, and their derivatives with respect to
+// {phi, v, steer, a, t}.
+struct BicycleStep {
+  double f = 0.0;
+  double df[kStepVariables] = {};
+  double ddf[kStepVariables][kStepVariables] = {};
+  double theta = 0.0;
+  double dtheta[kStepVariables] = {};
+  double ddtheta[kStepVariables][kStepVariables] = {};
+  double k = 0.0;
+  double dk[kStepVariables] = {};
+  double ddk[kStepVariables][kStepVariables] = {};
+};
+
+void ComputeBicycleStep(const double phi, const double v, const double steer,
+                        const double a, const double t, const double ts,
+                        const double wheelbase, BicycleStep* step) {
+  const double h = ts * t;
+  const double tan_steer = std::tan(steer);
+  const double sec2_steer = 1.0 + tan_steer * tan_steer;
+  const double c = 0.5 * ts / wheelbase;
+
+  step->f = h * (v + 0.5 * h * a);
+  step->df[kV] = h;
+  step->df[kA] = 0.5 * h * h;
+  step->df[kT] = ts * (v + h * a);
+  step->ddf[kV][kT] = step->ddf[kT][kV] = ts;
+  step->ddf[kA][kT] = step->ddf[kT][kA] = ts * h;
+  step->ddf[kT][kT] = ts * ts * a;
+
+  step->theta = phi + c * t * v * tan_steer;
+  step->dtheta[kPhi] = 1.0;
+  step->dtheta[kV] = c * t * tan_steer;
+  step->dtheta[kSteer] = c * t * v * sec2_steer;
+  step->dtheta[kT] = c * v * tan_steer;
+  step->ddtheta[kV][kSteer] = step->ddtheta[kSteer][kV] = c * t * sec2_steer;
+  step->ddtheta[kV][kT] = step->ddtheta[kT][kV] = c * tan_steer;
+  step->ddtheta[kSteer][kT] = step->ddtheta[kT][kSteer] = c * v * sec2_steer;
+  step->ddtheta[kSteer][kSteer] = 2.0 * c * t * v * sec2_steer * tan_steer;
+
+  step->k = tan_steer / wheelbase;
+  step->dk[kSteer] = sec2_steer / wheelbase;
+  step->ddk[kSteer][kSteer] = 2.0 * sec2_steer * tan_steer / wheelbase;
+}
+
+}  // namespace
+
+DistanceApproachIPOPTSparseInterface::DistanceApproachIPOPTSparseInterface(
+    const size_t horizon, const double ts, const Eigen::MatrixXd& ego,
+    const Eigen::MatrixXd& xWS, const Eigen::MatrixXd& uWS,
+    const Eigen::MatrixXd& l_warm_up, const Eigen::MatrixXd& n_warm_up,
+    const Eigen::MatrixXd& x0, const Eigen::MatrixXd& xf,
+    const Eigen::MatrixXd& last_time_u, const std::vector<double>& XYbounds,
+    const Eigen::MatrixXi& obstacles_edges_num, const size_t obstacles_num,
+    const Eigen::MatrixXd& obstacles_A, const Eigen::MatrixXd& obstacles_b,
+    const PlannerOpenSpaceConfig& planner_open_space_config)
+    : ts_(ts),
+      ego_(ego),
+      xWS_(xWS),
+      uWS_(uWS),
+      l_warm_up_(l_warm_up),
+      n_warm_up_(n_warm_up),
+      x0_(x0),
+      xf_(xf),
+      last_time_u_(last_time_u),
+      XYbounds_(XYbounds),
+      obstacles_edges_num_(obstacles_edges_num),
+      obstacles_A_(obstacles_A),
+      obstacles_b_(obstacles_b) {
+  ACHECK(horizon < std::numeric_limits<int>::max())
+      << "Invalid cast on horizon in open space planner";
+  horizon_ = static_cast<int>(horizon);
+  ACHECK(obstacles_num < std::numeric_limits<int>::max())
+      << "Invalid cast on obstacles_num in open space planner";
+
+  obstacles_num_ = static_cast<int>(obstacles_num);
+  w_ev_ = ego_(1, 0) + ego_(3, 0);
+  l_ev_ = ego_(0, 0) + ego_(2, 0);
+  g_ = {l_ev_ / 2, w_ev_ / 2, l_ev_ / 2, w_ev_ / 2};
+  offset_ = (ego_(0, 0) + ego_(2, 0)) / 2 - ego_(2, 0);
+  obstacles_edges_sum_ = obstacles_edges_num_.sum();
+  state_result_ = Eigen::MatrixXd::Zero(4, horizon_ + 1);
+  dual_l_result_ = Eigen::MatrixXd::Zero(obstacles_edges_sum_, horizon_ + 1);
+  dual_n_result_ = Eigen::MatrixXd::Zero(4 * obstacles_num_, horizon_ + 1);
+  control_result_ = Eigen::MatrixXd::Zero(2, horizon_);
+  time_result_ = Eigen::MatrixXd::Zero(1, horizon_);
+  state_start_index_ = 0;
+  control_start_index_ = 4 * (horizon_ + 1);
+  time_start_index_ = control_start_index_ + 2 * horizon_;
+  l_start_index_ = time_start_index_ + (horizon_ + 1);
+  n_start_index_ = l_start_index_ + obstacles_edges_sum_ * (horizon_ + 1);
+
+  distance_approach_config_ =
+      planner_open_space_config.distance_approach_config();
+  weight_state_x_ = distance_approach_config_.weight_x();
+  weight_state_y_ = distance_approach_config_.weight_y();
+  weight_state_phi_ = distance_approach_config_.weight_phi();
+  weight_state_v_ = distance_approach_config_.weight_v();
+  weight_input_steer_ = distance_approach_config_.weight_steer();
+  weight_input_a_ = distance_approach_config_.weight_a();
+  weight_rate_steer_ = distance_approach_config_.weight_steer_rate();
+  weight_rate_a_ = distance_approach_config_.weight_a_rate();
+  weight_stitching_steer_ = distance_approach_config_.weight_steer_stitching();
+  weight_stitching_a_ = distance_approach_config_.weight_a_stitching();
+  weight_first_order_time_ =
+      distance_approach_config_.weight_first_order_time();
+  weight_second_order_time_ =
+      distance_approach_config_.weight_second_order_time();
+  min_safety_distance_ = distance_approach_config_.min_safety_distance();
+  max_steer_angle_ =
+      vehicle_param_.max_steer_angle() / vehicle_param_.steer_ratio();
+  max_speed_forward_ = distance_approach_config_.max_speed_forward();
+  max_speed_reverse_ = distance_approach_config_.max_speed_reverse();
+  max_acceleration_forward_ =
+      distance_approach_config_.max_acceleration_forward();
+  max_acceleration_reverse_ =
+      distance_approach_config_.max_acceleration_reverse();
+  min_time_sample_scaling_ =
+      distance_approach_config_.min_time_sample_scaling();
+  max_time_sample_scaling_ =
+      distance_approach_config_.max_time_sample_scaling();
+  max_steer_rate_ =
+      vehicle_param_.max_steer_angle_rate() / vehicle_param_.steer_ratio();
+  use_fix_time_ = distance_approach_config_.use_fix_time();
+  wheelbase_ = vehicle_param_.wheel_base();
+  enable_constraint_check_ =
+      distance_approach_config_.enable_constraint_check();
+}
+
+bool DistanceApproachIPOPTSparseInterface::get_nlp_info(
+    int& n, int& m, int& nnz_jac_g, int& nnz_h_lag,
+    IndexStyleEnum& index_style) {
+  // n1 : states variables, 4 * (N+1)
+  const int n1 = 4 * (horizon_ + 1);
+  // n2 : control inputs variables
+  const int n2 = 2 * horizon_;
+  // n3 : sampling time variables
+  const int n3 = horizon_ + 1;
+  // n4 : dual multiplier associated with obstacle shape
+  lambda_horizon_ = obstacles_edges_sum_ * (horizon_ + 1);
+  // n5 : dual multipier associated with car shape, obstacles_num*4 * (N+1)
+  miu_horizon_ = obstacles_num_ * 4 * (horizon_ + 1);
+
+  // m1 : dynamics constatins
+  const int m1 = 4 * horizon_;
+  // m2 : control rate constraints (only steering)
+  const int m2 = horizon_;
+  // m3 : sampling time equality constraints
+  const int m3 = horizon_;
+  // m4 : obstacle constraints
+  const int m4 = 4 * obstacles_num_ * (horizon_ + 1);
+
+  num_of_variables_ = n1 + n2 + n3 + lambda_horizon_ + miu_horizon_;
+  num_of_constraints_ =
+      m1 + m2 + m3 + m4 + (num_of_variables_ - (horizon_ + 1) + 2);
+
+  n = num_of_variables_;
+  m = num_of_constraints_;
+
+  RecordSparsity();
+  nnz_jac_g = static_cast<int>(jac_rows_.size());
+  nnz_h_lag = static_cast<int>(hess_rows_.size());
+  ADEBUG << "num_of_variables_: " << n << ", num_of_constraints_: " << m
+         << ", nnz_jac_g: " << nnz_jac_g << ", nnz_h_lag: " << nnz_h_lag;
+
+  index_style = IndexStyleEnum::C_STYLE;
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::get_bounds_info(int n, double* x_l,
+                                                           double* x_u, int m,
+                                                           double* g_l,
+                                                           double* g_u) {
+  ACHECK(XYbounds_.size() == 4)
+      << "XYbounds_ size is not 4, but" << XYbounds_.size();
+
+  // Variables: states, controls and sample times are bounded through the
+  // constraints, the lagrange multipliers are non negative
+  std::fill(x_l, x_l + l_start_index_, -kInfinity);
+  std::fill(x_l + l_start_index_, x_l + n, 0.0);
+  std::fill(x_u, x_u + n, kInfinity);
+
+  // 1. dynamics constraints 4 * [0, horizons-1]
+  int constraint_index = 0;
+  for (int i = 0; i < 4 * horizon_; ++i) {
+    g_l[constraint_index] = 0.0;
+    g_u[constraint_index] = 0.0;
+    ++constraint_index;
+  }
+
+  // 2. Control rate limit constraints, only on the steering
+  for (int i = 0; i < horizon_; ++i) {
+    g_l[constraint_index] = -max_steer_rate_;
+    g_u[constraint_index] = max_steer_rate_;
+    ++constraint_index;
+  }
+
+  // 3. Time constraints 1 * [0, horizons-1]
+  for (int i = 0; i < horizon_; ++i) {
+    g_l[constraint_index] = 0.0;
+    g_u[constraint_index] = 0.0;
+    ++constraint_index;
+  }
+
+  // 4. Obstacle constraints, [0, horizon_] * [0, obstacles_num_-1] * 4
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < obstacles_num_; ++j) {
+      // a. norm(A'*lambda) <= 1
+      g_l[constraint_index] = -kInfinity;
+      g_u[constraint_index] = 1.0;
+
+      // b. G'*mu + R'*A*lambda = 0
+      g_l[constraint_index + 1] = 0.0;
+      g_u[constraint_index + 1] = 0.0;
+      g_l[constraint_index + 2] = 0.0;
+      g_u[constraint_index + 2] = 0.0;
+
+      // c. -g'*mu + (A*t - b)*lambda > min_safety_distance_
+      g_l[constraint_index + 3] = min_safety_distance_;
+      g_u[constraint_index + 3] = kInfinity;
+      constraint_index += 4;
+    }
+  }
+
+  // 5. variable bounds as constraints
+  for (int i = 0; i < 4; ++i) {
+    g_l[constraint_index + i] = x0_(i, 0);
+    g_u[constraint_index + i] = x0_(i, 0);
+  }
+  constraint_index += 4;
+
+  for (int i = 1; i < horizon_; ++i) {
+    g_l[constraint_index] = XYbounds_[0];
+    g_u[constraint_index] = XYbounds_[1];
+    g_l[constraint_index + 1] = XYbounds_[2];
+    g_u[constraint_index + 1] = XYbounds_[3];
+    g_l[constraint_index + 2] = -max_speed_reverse_;
+    g_u[constraint_index + 2] = max_speed_forward_;
+    constraint_index += 3;
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    g_l[constraint_index + i] = xf_(i, 0);
+    g_u[constraint_index + i] = xf_(i, 0);
+  }
+  constraint_index += 4;
+
+  for (int i = 0; i < horizon_; ++i) {
+    g_l[constraint_index] = -max_steer_angle_;
+    g_u[constraint_index] = max_steer_angle_;
+    g_l[constraint_index + 1] = -max_acceleration_reverse_;
+    g_u[constraint_index + 1] = max_acceleration_forward_;
+    constraint_index += 2;
+  }
+
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    g_l[constraint_index] = use_fix_time_ ? 1.0 : min_time_sample_scaling_;
+    g_u[constraint_index] = use_fix_time_ ? 1.0 : max_time_sample_scaling_;
+    ++constraint_index;
+  }
+
+  for (int i = 0; i < lambda_horizon_ + miu_horizon_; ++i) {
+    g_l[constraint_index] = 0.0;
+    g_u[constraint_index] = kInfinity;
+    ++constraint_index;
+  }
+
+  CHECK_EQ(constraint_index, m);
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::get_starting_point(
+    int n, bool init_x, double* x, bool init_z, double* z_L, double* z_U, int m,
+    bool init_lambda, double* lambda) {
+  ACHECK(init_x) << "Warm start init_x setting failed";
+
+  CHECK_EQ(horizon_, uWS_.cols());
+  CHECK_EQ(horizon_ + 1, xWS_.cols());
+
+  // 1. state variables 4 * (horizon_ + 1)
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      x[state_start_index_ + i * 4 + j] = xWS_(j, i);
+    }
+  }
+
+  // 2. control variables, 2 * horizon_
+  for (int i = 0; i < horizon_; ++i) {
+    x[control_start_index_ + i * 2] = uWS_(0, i);
+    x[control_start_index_ + i * 2 + 1] = uWS_(1, i);
+  }
+
+  // 3. time scale variables, horizon_ + 1
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    x[time_start_index_ + i] =
+        0.5 * (min_time_sample_scaling_ + max_time_sample_scaling_);
+  }
+
+  // 4. lagrange constraint l, obstacles_edges_sum_ * (horizon_+1)
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < obstacles_edges_sum_; ++j) {
+      x[l_start_index_ + i * obstacles_edges_sum_ + j] = l_warm_up_(j, i);
+    }
+  }
+
+  // 5. lagrange constraint n, 4*obstacles_num * (horizon_+1)
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < 4 * obstacles_num_; ++j) {
+      x[n_start_index_ + i * 4 * obstacles_num_ + j] = n_warm_up_(j, i);
+    }
+  }
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_f(int n, const double* x,
+                                                  bool new_x,
+                                                  double& obj_value) {
+  obj_value = 0.0;
+  // 1. state deviations from the warm start
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const double x_diff = x[state_index] - xWS_(0, i);
+    const double y_diff = x[state_index + 1] - xWS_(1, i);
+    const double phi_diff = x[state_index + 2] - xWS_(2, i);
+    const double v = x[state_index + 3];
+    obj_value += weight_state_x_ * x_diff * x_diff +
+                 weight_state_y_ * y_diff * y_diff +
+                 weight_state_phi_ * phi_diff * phi_diff +
+                 weight_state_v_ * v * v;
+  }
+
+  // 2. control inputs
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    obj_value +=
+        weight_input_steer_ * x[control_index] * x[control_index] +
+        weight_input_a_ * x[control_index + 1] * x[control_index + 1];
+  }
+
+  // 3. input rates from the stitching point
+  const double stitching_inv_dt = 1.0 / (x[time_start_index_] * ts_);
+  const double stitching_steer_rate =
+      (x[control_start_index_] - last_time_u_(0, 0)) * stitching_inv_dt;
+  const double stitching_a_rate =
+      (x[control_start_index_ + 1] - last_time_u_(1, 0)) * stitching_inv_dt;
+  obj_value +=
+      weight_stitching_steer_ * stitching_steer_rate * stitching_steer_rate +
+      weight_stitching_a_ * stitching_a_rate * stitching_a_rate;
+
+  // 4. input rates, [0, horizon_ - 2]
+  for (int i = 0; i < horizon_ - 1; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const double inv_dt = 1.0 / (x[time_start_index_ + i + 1] * ts_);
+    const double steer_rate =
+        (x[control_index + 2] - x[control_index]) * inv_dt;
+    const double a_rate =
+        (x[control_index + 3] - x[control_index + 1]) * inv_dt;
+    obj_value += weight_rate_steer_ * steer_rate * steer_rate +
+                 weight_rate_a_ * a_rate * a_rate;
+  }
+
+  // 5. total time
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const double t = x[time_start_index_ + i];
+    obj_value +=
+        weight_first_order_time_ * t + weight_second_order_time_ * t * t;
+  }
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_grad_f(int n, const double* x,
+                                                       bool new_x,
+                                                       double* grad_f) {
+  std::fill(grad_f, grad_f + n, 0.0);
+  // 1. state deviations from the warm start
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    grad_f[state_index] = 2.0 * weight_state_x_ * (x[state_index] - xWS_(0, i));
+    grad_f[state_index + 1] =
+        2.0 * weight_state_y_ * (x[state_index + 1] - xWS_(1, i));
+    grad_f[state_index + 2] =
+        2.0 * weight_state_phi_ * (x[state_index + 2] - xWS_(2, i));
+    grad_f[state_index + 3] = 2.0 * weight_state_v_ * x[state_index + 3];
+  }
+
+  // 2. control inputs
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    grad_f[control_index] = 2.0 * weight_input_steer_ * x[control_index];
+    grad_f[control_index + 1] = 2.0 * weight_input_a_ * x[control_index + 1];
+  }
+
+  // w * (du / (t * ts))^2, of gradient 2 * w * du / (t * ts)^2 along the
+  // inputs and -2 * w * du^2 / (t * ts)^2 / t along t
+  const auto add_rate_gradient = [&](const double weight, const double du,
+                                     const int u_a_index, const int u_b_index,
+                                     const int t_index) {
+    const double t = x[t_index];
+    const double inv_dt2 = 1.0 / (t * t * ts_ * ts_);
+    grad_f[u_b_index] += 2.0 * weight * du * inv_dt2;
+    if (u_a_index >= 0) {
+      grad_f[u_a_index] -= 2.0 * weight * du * inv_dt2;
+    }
+    grad_f[t_index] -= 2.0 * weight * du * du * inv_dt2 / t;
+  };
+
+  // 3. input rates from the stitching point
+  add_rate_gradient(weight_stitching_steer_,
+                    x[control_start_index_] - last_time_u_(0, 0), -1,
+                    control_start_index_, time_start_index_);
+  add_rate_gradient(weight_stitching_a_,
+                    x[control_start_index_ + 1] - last_time_u_(1, 0), -1,
+                    control_start_index_ + 1, time_start_index_);
+
+  // 4. input rates, [0, horizon_ - 2]
+  for (int i = 0; i < horizon_ - 1; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i + 1;
+    add_rate_gradient(weight_rate_steer_,
+                      x[control_index + 2] - x[control_index], control_index,
+                      control_index + 2, time_index);
+    add_rate_gradient(weight_rate_a_,
+                      x[control_index + 3] - x[control_index + 1],
+                      control_index + 1, control_index + 3, time_index);
+  }
+
+  // 5. total time
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int time_index = time_start_index_ + i;
+    grad_f[time_index] += weight_first_order_time_ +
+                          2.0 * weight_second_order_time_ * x[time_index];
+  }
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_g(int n, const double* x,
+                                                  bool new_x, int m,
+                                                  double* g) {
+  int constraint_index = 0;
+  BicycleStep step;
+
+  // 1. dynamics constraints 4 * [0, horizons-1]
+  for (int i = 0; i < horizon_; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i;
+    ComputeBicycleStep(x[state_index + 2], x[state_index + 3],
+                       x[control_index], x[control_index + 1], x[time_index],
+                       ts_, wheelbase_, &step);
+    g[constraint_index] =
+        x[state_index + 4] - (x[state_index] + step.f * std::cos(step.theta));
+    g[constraint_index + 1] =
+        x[state_index + 5] -
+        (x[state_index + 1] + step.f * std::sin(step.theta));
+    g[constraint_index + 2] =
+        x[state_index + 6] - (x[state_index + 2] + step.f * step.k);
+    g[constraint_index + 3] =
+        x[state_index + 7] -
+        (x[state_index + 3] + ts_ * x[time_index] * x[control_index + 1]);
+    constraint_index += 4;
+  }
+
+  // 2. steering rate constraints, the first one from the stitching point
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const double last_steer =
+        i == 0 ? last_time_u_(0, 0) : x[control_index - 2];
+    g[constraint_index] = (x[control_index] - last_steer) /
+                          x[time_start_index_ + i] / ts_;
+    ++constraint_index;
+  }
+
+  // 3. time constraints 1 * [0, horizons-1]
+  for (int i = 0; i < horizon_; ++i) {
+    g[constraint_index] =
+        x[time_start_index_ + i + 1] - x[time_start_index_ + i];
+    ++constraint_index;
+  }
+
+  // 4. obstacle constraints, [0, horizon_] * [0, obstacles_num_-1] * 4
+  int l_index = l_start_index_;
+  int n_index = n_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const double cos_phi = std::cos(x[state_index + 2]);
+    const double sin_phi = std::sin(x[state_index + 2]);
+    int edges_counter = 0;
+    for (int j = 0; j < obstacles_num_; ++j) {
+      const int current_edges_num = obstacles_edges_num_(j, 0);
+      double tmp1 = 0.0;
+      double tmp2 = 0.0;
+      double tmp4 = 0.0;
+      for (int k = 0; k < current_edges_num; ++k) {
+        tmp1 += obstacles_A_(edges_counter + k, 0) * x[l_index + k];
+        tmp2 += obstacles_A_(edges_counter + k, 1) * x[l_index + k];
+        tmp4 += obstacles_b_(edges_counter + k, 0) * x[l_index + k];
+      }
+      double tmp3 = 0.0;
+      for (int k = 0; k < 4; ++k) {
+        tmp3 -= g_[k] * x[n_index + k];
+      }
+
+      // norm(A* lambda) <= 1
+      g[constraint_index] = tmp1 * tmp1 + tmp2 * tmp2;
+      // G' * mu + R' * lambda == 0
+      g[constraint_index + 1] =
+          x[n_index] - x[n_index + 2] + cos_phi * tmp1 + sin_phi * tmp2;
+      g[constraint_index + 2] =
+          x[n_index + 1] - x[n_index + 3] - sin_phi * tmp1 + cos_phi * tmp2;
+      //  -g'*mu + (A*t - b)*lambda > 0
+      g[constraint_index + 3] =
+          tmp3 + (x[state_index] + cos_phi * offset_) * tmp1 +
+          (x[state_index + 1] + sin_phi * offset_) * tmp2 - tmp4;
+
+      edges_counter += current_edges_num;
+      l_index += current_edges_num;
+      n_index += 4;
+      constraint_index += 4;
+    }
+  }
+
+  // 5. variable bounds as constraints
+  for (int i = 0; i < 4; ++i) {
+    g[constraint_index + i] = x[state_start_index_ + i];
+  }
+  constraint_index += 4;
+  for (int i = 1; i < horizon_; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    g[constraint_index] = x[state_index];
+    g[constraint_index + 1] = x[state_index + 1];
+    g[constraint_index + 2] = x[state_index + 3];
+    constraint_index += 3;
+  }
+  for (int i = 0; i < 4; ++i) {
+    g[constraint_index + i] = x[state_start_index_ + 4 * horizon_ + i];
+  }
+  constraint_index += 4;
+  for (int i = control_start_index_; i < time_start_index_ + horizon_ + 1;
+       ++i) {
+    g[constraint_index] = x[i];
+    ++constraint_index;
+  }
+  for (int i = l_start_index_; i < n; ++i) {
+    g[constraint_index] = x[i];
+    ++constraint_index;
+  }
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::check_g(int n, const double* x,
+                                                   int m, const double* g) {
+  std::vector<double> x_l(n);
+  std::vector<double> x_u(n);
+  std::vector<double> g_l(m);
+  std::vector<double> g_u(m);
+  get_bounds_info(n, x_l.data(), x_u.data(), m, g_l.data(), g_u.data());
+
+  const double delta_v = 1e-4;
+  for (int idx = 0; idx < n; ++idx) {
+    if (x[idx] > x_u[idx] + delta_v || x[idx] < x_l[idx] - delta_v) {
+      AINFO << "x idx unfeasible: " << idx << ", x: " << x[idx]
+            << ", lower: " << x_l[idx] << ", upper: " << x_u[idx];
+    }
+  }
+  for (int idx = 0; idx < m; ++idx) {
+    if (g[idx] > g_u[idx] + delta_v || g[idx] < g_l[idx] - delta_v) {
+      AINFO << "constrains idx unfeasible: " << idx << ", g: " << g[idx]
+            << ", lower: " << g_l[idx] << ", upper: " << g_u[idx];
+    }
+  }
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_jac_g(int n, const double* x,
+                                                      bool new_x, int m,
+                                                      int nele_jac, int* iRow,
+                                                      int* jCol,
+                                                      double* values) {
+  CHECK_EQ(static_cast<size_t>(nele_jac), jac_rows_.size());
+  if (values == nullptr) {
+    std::copy(jac_rows_.begin(), jac_rows_.end(), iRow);
+    std::copy(jac_cols_.begin(), jac_cols_.end(), jCol);
+    return true;
+  }
+  values_ = values;
+  entry_index_ = 0;
+  EvalJacobian(x);
+  values_ = nullptr;
+  return true;
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_jac_g_ser(
+    int n, const double* x, bool new_x, int m, int nele_jac, int* iRow,
+    int* jCol, double* values) {
+  return eval_jac_g(n, x, new_x, m, nele_jac, iRow, jCol, values);
+}
+
+bool DistanceApproachIPOPTSparseInterface::eval_h(
+    int n, const double* x, bool new_x, double obj_factor, int m,
+    const double* lambda, bool new_lambda, int nele_hess, int* iRow, int* jCol,
+    double* values) {
+  CHECK_EQ(static_cast<size_t>(nele_hess), hess_rows_.size());
+  if (values == nullptr) {
+    std::copy(hess_rows_.begin(), hess_rows_.end(), iRow);
+    std::copy(hess_cols_.begin(), hess_cols_.end(), jCol);
+    return true;
+  }
+  std::fill(values, values + nele_hess, 0.0);
+  values_ = values;
+  entry_index_ = 0;
+  EvalHessian(x, obj_factor, lambda);
+  values_ = nullptr;
+  return true;
+}
+
+void DistanceApproachIPOPTSparseInterface::finalize_solution(
+    Ipopt::SolverReturn status, int n, const double* x, const double* z_L,
+    const double* z_U, int m, const double* g, const double* lambda,
+    double obj_value, const Ipopt::IpoptData* ip_data,
+    Ipopt::IpoptCalculatedQuantities* ip_cq) {
+  // enable_constraint_check_: for debug only
+  if (enable_constraint_check_) {
+    ADEBUG << "final resolution constraint checking";
+    check_g(n, x, m, g);
+  }
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      state_result_(j, i) = x[state_start_index_ + 4 * i + j];
+    }
+    for (int j = 0; j < obstacles_edges_sum_; ++j) {
+      dual_l_result_(j, i) = x[l_start_index_ + i * obstacles_edges_sum_ + j];
+    }
+    for (int j = 0; j < 4 * obstacles_num_; ++j) {
+      dual_n_result_(j, i) = x[n_start_index_ + i * 4 * obstacles_num_ + j];
+    }
+  }
+  for (int i = 0; i < horizon_; ++i) {
+    control_result_(0, i) = x[control_start_index_ + 2 * i];
+    control_result_(1, i) = x[control_start_index_ + 2 * i + 1];
+    time_result_(0, i) = ts_ * x[time_start_index_ + i];
+  }
+  state_result_.col(0) = x0_.col(0);
+  state_result_.col(horizon_) = xf_.col(0);
+}
+
+void DistanceApproachIPOPTSparseInterface::get_optimization_results(
+    Eigen::MatrixXd* state_result, Eigen::MatrixXd* control_result,
+    Eigen::MatrixXd* time_result, Eigen::MatrixXd* dual_l_result,
+    Eigen::MatrixXd* dual_n_result) const {
+  *state_result = state_result_;
+  *control_result = control_result_;
+  *time_result = time_result_;
+  *dual_l_result = dual_l_result_;
+  *dual_n_result = dual_n_result_;
+}
+
+void DistanceApproachIPOPTSparseInterface::EvalJacobian(const double* x) {
+  int constraint_index = 0;
+  BicycleStep step;
+
+  // 1. dynamics constraints 4 * [0, horizons-1]
+  for (int i = 0; i < horizon_; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i;
+    const int step_indices[kStepVariables] = {state_index + 2, state_index + 3,
+                                              control_index, control_index + 1,
+                                              time_index};
+    ComputeBicycleStep(x[state_index + 2], x[state_index + 3],
+                       x[control_index], x[control_index + 1], x[time_index],
+                       ts_, wheelbase_, &step);
+    const double cos_theta = std::cos(step.theta);
+    const double sin_theta = std::sin(step.theta);
+
+    // x' - x - f * cos(theta)
+    AddJacobian(constraint_index, state_index, -1.0);
+    AddJacobian(constraint_index, state_index + 4, 1.0);
+    for (int z = 0; z < kStepVariables; ++z) {
+      AddJacobian(constraint_index, step_indices[z],
+                  -step.df[z] * cos_theta +
+                      step.f * sin_theta * step.dtheta[z]);
+    }
+    // y' - y - f * sin(theta)
+    AddJacobian(constraint_index + 1, state_index + 1, -1.0);
+    AddJacobian(constraint_index + 1, state_index + 5, 1.0);
+    for (int z = 0; z < kStepVariables; ++z) {
+      AddJacobian(constraint_index + 1, step_indices[z],
+                  -step.df[z] * sin_theta -
+                      step.f * cos_theta * step.dtheta[z]);
+    }
+    // phi' - phi - f * k
+    AddJacobian(constraint_index + 2, state_index + 6, 1.0);
+    for (int z = 0; z < kStepVariables; ++z) {
+      AddJacobian(constraint_index + 2, step_indices[z],
+                  (z == kPhi ? -1.0 : 0.0) - step.df[z] * step.k -
+                      step.f * step.dk[z]);
+    }
+    // v' - v - ts * t * a
+    AddJacobian(constraint_index + 3, state_index + 3, -1.0);
+    AddJacobian(constraint_index + 3, state_index + 7, 1.0);
+    AddJacobian(constraint_index + 3, control_index + 1,
+                -ts_ * x[time_index]);
+    AddJacobian(constraint_index + 3, time_index, -ts_ * x[control_index + 1]);
+    constraint_index += 4;
+  }
+
+  // 2. steering rate constraints, (steer - last_steer) / (t * ts)
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i;
+    const double t = x[time_index];
+    const double inv_dt = 1.0 / (t * ts_);
+    const double last_steer =
+        i == 0 ? last_time_u_(0, 0) : x[control_index - 2];
+    if (i > 0) {
+      AddJacobian(constraint_index, control_index - 2, -inv_dt);
+    }
+    AddJacobian(constraint_index, control_index, inv_dt);
+    AddJacobian(constraint_index, time_index,
+                -(x[control_index] - last_steer) * inv_dt / t);
+    ++constraint_index;
+  }
+
+  // 3. time constraints 1 * [0, horizons-1]
+  for (int i = 0; i < horizon_; ++i) {
+    AddJacobian(constraint_index, time_start_index_ + i, -1.0);
+    AddJacobian(constraint_index, time_start_index_ + i + 1, 1.0);
+    ++constraint_index;
+  }
+
+  // 4. obstacle constraints, [0, horizon_] * [0, obstacles_num_-1] * 4
+  int l_index = l_start_index_;
+  int n_index = n_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const double cos_phi = std::cos(x[state_index + 2]);
+    const double sin_phi = std::sin(x[state_index + 2]);
+    const double center_x = x[state_index] + cos_phi * offset_;
+    const double center_y = x[state_index + 1] + sin_phi * offset_;
+    int edges_counter = 0;
+    for (int j = 0; j < obstacles_num_; ++j) {
+      const int current_edges_num = obstacles_edges_num_(j, 0);
+      double tmp1 = 0.0;
+      double tmp2 = 0.0;
+      for (int k = 0; k < current_edges_num; ++k) {
+        tmp1 += obstacles_A_(edges_counter + k, 0) * x[l_index + k];
+        tmp2 += obstacles_A_(edges_counter + k, 1) * x[l_index + k];
+      }
+
+      // norm(A* lambda) <= 1
+      for (int k = 0; k < current_edges_num; ++k) {
+        AddJacobian(constraint_index, l_index + k,
+                    2.0 * tmp1 * obstacles_A_(edges_counter + k, 0) +
+                        2.0 * tmp2 * obstacles_A_(edges_counter + k, 1));
+      }
+
+      // G' * mu + R' * lambda == 0
+      AddJacobian(constraint_index + 1, state_index + 2,
+                  -sin_phi * tmp1 + cos_phi * tmp2);
+      for (int k = 0; k < current_edges_num; ++k) {
+        AddJacobian(constraint_index + 1, l_index + k,
+                    cos_phi * obstacles_A_(edges_counter + k, 0) +
+                        sin_phi * obstacles_A_(edges_counter + k, 1));
+      }
+      AddJacobian(constraint_index + 1, n_index, 1.0);
+      AddJacobian(constraint_index + 1, n_index + 2, -1.0);
+
+      AddJacobian(constraint_index + 2, state_index + 2,
+                  -cos_phi * tmp1 - sin_phi * tmp2);
+      for (int k = 0; k < current_edges_num; ++k) {
+        AddJacobian(constraint_index + 2, l_index + k,
+                    -sin_phi * obstacles_A_(edges_counter + k, 0) +
+                        cos_phi * obstacles_A_(edges_counter + k, 1));
+      }
+      AddJacobian(constraint_index + 2, n_index + 1, 1.0);
+      AddJacobian(constraint_index + 2, n_index + 3, -1.0);
+
+      //  -g'*mu + (A*t - b)*lambda > 0
+      AddJacobian(constraint_index + 3, state_index, tmp1);
+      AddJacobian(constraint_index + 3, state_index + 1, tmp2);
+      AddJacobian(constraint_index + 3, state_index + 2,
+                  offset_ * (-sin_phi * tmp1 + cos_phi * tmp2));
+      for (int k = 0; k < current_edges_num; ++k) {
+        AddJacobian(constraint_index + 3, l_index + k,
+                    center_x * obstacles_A_(edges_counter + k, 0) +
+                        center_y * obstacles_A_(edges_counter + k, 1) -
+                        obstacles_b_(edges_counter + k, 0));
+      }
+      for (int k = 0; k < 4; ++k) {
+        AddJacobian(constraint_index + 3, n_index + k, -g_[k]);
+      }
+
+      edges_counter += current_edges_num;
+      l_index += current_edges_num;
+      n_index += 4;
+      constraint_index += 4;
+    }
+  }
+
+  // 5. variable bounds as constraints
+  for (int i = 0; i < 4; ++i) {
+    AddJacobian(constraint_index, state_start_index_ + i, 1.0);
+    ++constraint_index;
+  }
+  for (int i = 1; i < horizon_; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    AddJacobian(constraint_index, state_index, 1.0);
+    AddJacobian(constraint_index + 1, state_index + 1, 1.0);
+    AddJacobian(constraint_index + 2, state_index + 3, 1.0);
+    constraint_index += 3;
+  }
+  for (int i = 0; i < 4; ++i) {
+    AddJacobian(constraint_index, state_start_index_ + 4 * horizon_ + i, 1.0);
+    ++constraint_index;
+  }
+  for (int i = control_start_index_; i < time_start_index_ + horizon_ + 1;
+       ++i) {
+    AddJacobian(constraint_index, i, 1.0);
+    ++constraint_index;
+  }
+  for (int i = l_start_index_; i < num_of_variables_; ++i) {
+    AddJacobian(constraint_index, i, 1.0);
+    ++constraint_index;
+  }
+}
+
+void DistanceApproachIPOPTSparseInterface::EvalHessian(
+    const double* x, const double obj_factor, const double* lambda) {
+  // 1. objective
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    AddHessian(state_index, state_index,
+               2.0 * obj_factor * weight_state_x_);
+    AddHessian(state_index + 1, state_index + 1,
+               2.0 * obj_factor * weight_state_y_);
+    AddHessian(state_index + 2, state_index + 2,
+               2.0 * obj_factor * weight_state_phi_);
+    AddHessian(state_index + 3, state_index + 3,
+               2.0 * obj_factor * weight_state_v_);
+  }
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    AddHessian(control_index, control_index,
+               2.0 * obj_factor * weight_input_steer_);
+    AddHessian(control_index + 1, control_index + 1,
+               2.0 * obj_factor * weight_input_a_);
+  }
+  AddRateHessian(weight_stitching_steer_,
+                 x[control_start_index_] - last_time_u_(0, 0), -1,
+                 control_start_index_, time_start_index_,
+                 x[time_start_index_], obj_factor);
+  AddRateHessian(weight_stitching_a_,
+                 x[control_start_index_ + 1] - last_time_u_(1, 0), -1,
+                 control_start_index_ + 1, time_start_index_,
+                 x[time_start_index_], obj_factor);
+  for (int i = 0; i < horizon_ - 1; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i + 1;
+    AddRateHessian(weight_rate_steer_, x[control_index + 2] - x[control_index],
+                   control_index, control_index + 2, time_index, x[time_index],
+                   obj_factor);
+    AddRateHessian(weight_rate_a_, x[control_index + 3] - x[control_index + 1],
+                   control_index + 1, control_index + 3, time_index,
+                   x[time_index], obj_factor);
+  }
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int time_index = time_start_index_ + i;
+    AddHessian(time_index, time_index,
+               2.0 * obj_factor * weight_second_order_time_);
+  }
+
+  // 2. dynamics constraints
+  int constraint_index = 0;
+  BicycleStep step;
+  for (int i = 0; i < horizon_; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i;
+    const int step_indices[kStepVariables] = {state_index + 2, state_index + 3,
+                                              control_index, control_index + 1,
+                                              time_index};
+    ComputeBicycleStep(x[state_index + 2], x[state_index + 3],
+                       x[control_index], x[control_index + 1], x[time_index],
+                       ts_, wheelbase_, &step);
+    const double cos_theta = std::cos(step.theta);
+    const double sin_theta = std::sin(step.theta);
+    const double lambda_x = lambda[constraint_index];
+    const double lambda_y = lambda[constraint_index + 1];
+    const double lambda_phi = lambda[constraint_index + 2];
+    const double lambda_v = lambda[constraint_index + 3];
+    for (int z = 0; z < kStepVariables; ++z) {
+      for (int w = 0; w <= z; ++w) {
+        // second derivatives of f * cos(theta), f * sin(theta) and f * k
+        const double dtheta2 =
+            step.dtheta[z] * step.dtheta[w];
+        const double df_dtheta =
+            step.df[z] * step.dtheta[w] + step.df[w] * step.dtheta[z];
+        const double ddx = step.ddf[z][w] * cos_theta - df_dtheta * sin_theta -
+                           step.f * (cos_theta * dtheta2 +
+                                     sin_theta * step.ddtheta[z][w]);
+        const double ddy = step.ddf[z][w] * sin_theta + df_dtheta * cos_theta +
+                           step.f * (-sin_theta * dtheta2 +
+                                     cos_theta * step.ddtheta[z][w]);
+        const double ddphi = step.ddf[z][w] * step.k +
+                             step.df[z] * step.dk[w] +
+                             step.df[w] * step.dk[z] + step.f * step.ddk[z][w];
+        double value = -lambda_x * ddx - lambda_y * ddy - lambda_phi * ddphi;
+        if (z == kT && w == kA) {
+          value -= lambda_v * ts_;
+        }
+        AddHessian(step_indices[z], step_indices[w], value);
+      }
+    }
+    constraint_index += 4;
+  }
+
+  // 3. steering rate constraints
+  for (int i = 0; i < horizon_; ++i) {
+    const int control_index = control_start_index_ + 2 * i;
+    const int time_index = time_start_index_ + i;
+    const double t = x[time_index];
+    const double inv_dt = 1.0 / (t * ts_);
+    const double last_steer =
+        i == 0 ? last_time_u_(0, 0) : x[control_index - 2];
+    const double steer_diff = x[control_index] - last_steer;
+    const double lambda_rate = lambda[constraint_index];
+    if (i > 0) {
+      AddHessian(time_index, control_index - 2, lambda_rate * inv_dt / t);
+    }
+    AddHessian(time_index, control_index, -lambda_rate * inv_dt / t);
+    AddHessian(time_index, time_index,
+               2.0 * lambda_rate * steer_diff * inv_dt / (t * t));
+    ++constraint_index;
+  }
+
+  // the time constraints are linear
+  constraint_index += horizon_;
+
+  // 4. obstacle constraints
+  int l_index = l_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const int state_index = state_start_index_ + 4 * i;
+    const double cos_phi = std::cos(x[state_index + 2]);
+    const double sin_phi = std::sin(x[state_index + 2]);
+    int edges_counter = 0;
+    for (int j = 0; j < obstacles_num_; ++j) {
+      const int current_edges_num = obstacles_edges_num_(j, 0);
+      double tmp1 = 0.0;
+      double tmp2 = 0.0;
+      for (int k = 0; k < current_edges_num; ++k) {
+        tmp1 += obstacles_A_(edges_counter + k, 0) * x[l_index + k];
+        tmp2 += obstacles_A_(edges_counter + k, 1) * x[l_index + k];
+      }
+      const double lambda_norm = lambda[constraint_index];
+      const double lambda_rx = lambda[constraint_index + 1];
+      const double lambda_ry = lambda[constraint_index + 2];
+      const double lambda_distance = lambda[constraint_index + 3];
+
+      for (int k = 0; k < current_edges_num; ++k) {
+        const double a_k0 = obstacles_A_(edges_counter + k, 0);
+        const double a_k1 = obstacles_A_(edges_counter + k, 1);
+        for (int p = 0; p <= k; ++p) {
+          AddHessian(l_index + k, l_index + p,
+                     2.0 * lambda_norm *
+                         (a_k0 * obstacles_A_(edges_counter + p, 0) +
+                          a_k1 * obstacles_A_(edges_counter + p, 1)));
+        }
+        AddHessian(l_index + k, state_index, lambda_distance * a_k0);
+        AddHessian(l_index + k, state_index + 1, lambda_distance * a_k1);
+        AddHessian(
+            l_index + k, state_index + 2,
+            (lambda_rx + lambda_distance * offset_) *
+                    (-sin_phi * a_k0 + cos_phi * a_k1) -
+                lambda_ry * (cos_phi * a_k0 + sin_phi * a_k1));
+      }
+      AddHessian(state_index + 2, state_index + 2,
+                 -(lambda_rx + lambda_distance * offset_) *
+                         (cos_phi * tmp1 + sin_phi * tmp2) +
+                     lambda_ry * (sin_phi * tmp1 - cos_phi * tmp2));
+
+      edges_counter += current_edges_num;
+      l_index += current_edges_num;
+      constraint_index += 4;
+    }
+  }
+  // the variable bounds are linear
+}
+
+void DistanceApproachIPOPTSparseInterface::AddJacobian(const int row,
+                                                       const int col,
+                                                       const double value) {
+  if (is_recording_) {
+    jac_rows_.push_back(row);
+    jac_cols_.push_back(col);
+    return;
+  }
+  values_[entry_index_++] = value;
+}
+
+void DistanceApproachIPOPTSparseInterface::AddHessian(int row, int col,
+                                                      const double value) {
+  if (!is_recording_) {
+    values_[hess_slots_[entry_index_++]] += value;
+    return;
+  }
+  if (row < col) {
+    std::swap(row, col);
+  }
+  const int64_t position = static_cast<int64_t>(row) * num_of_variables_ + col;
+  auto iter = hess_slot_by_position_.find(position);
+  if (iter == hess_slot_by_position_.end()) {
+    iter = hess_slot_by_position_
+               .emplace(position, static_cast<int>(hess_rows_.size()))
+               .first;
+    hess_rows_.push_back(row);
+    hess_cols_.push_back(col);
+  }
+  hess_slots_.push_back(iter->second);
+}
+
+void DistanceApproachIPOPTSparseInterface::AddRateHessian(
+    const double weight, const double u_diff, const int u_a_index,
+    const int u_b_index, const int t_index, const double t,
+    const double obj_factor) {
+  const double scale = obj_factor * weight / (t * t * ts_ * ts_);
+  AddHessian(u_b_index, u_b_index, 2.0 * scale);
+  AddHessian(t_index, u_b_index, -4.0 * scale * u_diff / t);
+  AddHessian(t_index, t_index, 6.0 * scale * u_diff * u_diff / (t * t));
+  if (u_a_index >= 0) {
+    AddHessian(u_a_index, u_a_index, 2.0 * scale);
+    AddHessian(u_b_index, u_a_index, -2.0 * scale);
+    AddHessian(t_index, u_a_index, 4.0 * scale * u_diff / t);
+  }
+}
+
+void DistanceApproachIPOPTSparseInterface::RecordSparsity() {
+  std::vector<double> x(num_of_variables_, 0.0);
+  std::vector<double> lambda(num_of_constraints_, 0.0);
+  get_starting_point(num_of_variables_, true, x.data(), false, nullptr,
+                     nullptr, num_of_constraints_, false, nullptr);
+
+  jac_rows_.clear();
+  jac_cols_.clear();
+  hess_rows_.clear();
+  hess_cols_.clear();
+  hess_slots_.clear();
+  is_recording_ = true;
+  EvalJacobian(x.data());
+  EvalHessian(x.data(), 1.0, lambda.data());
+  is_recording_ = false;
+  hess_slot_by_position_.clear();
+}
+
+}  // namespace planning
+}  // namespace apollo
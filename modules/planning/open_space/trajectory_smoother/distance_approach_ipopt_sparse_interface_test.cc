@@ -0,0 +1,227 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+#include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_sparse_interface.h"
+
+#include "cyber/common/file.h"
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+class DistanceApproachIPOPTSparseInterfaceTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    FLAGS_planner_open_space_config_filename =
+        "/apollo/modules/planning/testdata/conf/"
+        "open_space_standard_parking_lot.pb.txt";
+    ACHECK(apollo::cyber::common::GetProtoFromFile(
+        FLAGS_planner_open_space_config_filename, &planner_open_space_config_))
+        << "Failed to load open space config file "
+        << FLAGS_planner_open_space_config_filename;
+
+    ProblemSetup();
+  }
+
+ protected:
+  void ProblemSetup();
+
+  // a point away from the warm start, with sample times in [0.8, 1.2]
+  std::vector<double> PerturbedPoint() const;
+
+ protected:
+  size_t horizon_ = 43;
+  size_t obstacles_num_ = 4;
+  double ts_ = 0.5;
+  Eigen::MatrixXd ego_ = Eigen::MatrixXd::Ones(4, 1);
+  Eigen::MatrixXd x0_ = Eigen::MatrixXd::Ones(4, 1);
+  Eigen::MatrixXd xf_ = 10 * Eigen::MatrixXd::Ones(4, 1);
+  Eigen::MatrixXd last_time_u_ = Eigen::MatrixXd::Zero(2, 1);
+  std::vector<double> XYbounds_ = {1.0, 1.0, 1.0, 1.0};
+  Eigen::MatrixXd xWS_ = Eigen::MatrixXd::Ones(4, 44);
+  Eigen::MatrixXd uWS_ = Eigen::MatrixXd::Ones(2, 43);
+  Eigen::MatrixXi obstacles_edges_num_;  // {2, 1, 2, 1}
+  size_t obstacles_edges_sum_;
+  Eigen::MatrixXd obstacles_A_ = Eigen::MatrixXd::Ones(6, 2);
+  Eigen::MatrixXd obstacles_b_ = Eigen::MatrixXd::Ones(6, 1);
+  std::unique_ptr<DistanceApproachIPOPTSparseInterface> ptop_ = nullptr;
+  PlannerOpenSpaceConfig planner_open_space_config_;
+  int n_ = 0;
+  int m_ = 0;
+  int nnz_jac_g_ = 0;
+  int nnz_h_lag_ = 0;
+};
+
+void DistanceApproachIPOPTSparseInterfaceTest::ProblemSetup() {
+  obstacles_edges_num_ = Eigen::MatrixXi(obstacles_num_, 1);
+  obstacles_edges_num_ << 2, 1, 2, 1;
+  obstacles_edges_sum_ = obstacles_edges_num_.sum();
+  Eigen::MatrixXd l_warm_up_ =
+      Eigen::MatrixXd::Ones(obstacles_edges_sum_, horizon_ + 1);
+  Eigen::MatrixXd n_warm_up_ =
+      Eigen::MatrixXd::Ones(4 * obstacles_num_, horizon_ + 1);
+  ptop_.reset(new DistanceApproachIPOPTSparseInterface(
+      horizon_, ts_, ego_, xWS_, uWS_, l_warm_up_, n_warm_up_, x0_, xf_,
+      last_time_u_, XYbounds_, obstacles_edges_num_, obstacles_num_,
+      obstacles_A_, obstacles_b_, planner_open_space_config_));
+  Ipopt::TNLP::IndexStyleEnum index_style;
+  ptop_->get_nlp_info(n_, m_, nnz_jac_g_, nnz_h_lag_, index_style);
+}
+
+std::vector<double> DistanceApproachIPOPTSparseInterfaceTest::PerturbedPoint()
+    const {
+  std::vector<double> x(n_);
+  for (int i = 0; i < n_; ++i) {
+    x[i] = 0.5 * std::sin(0.7 * i) + 0.1;
+  }
+  const int time_start_index = 4 * (horizon_ + 1) + 2 * horizon_;
+  for (size_t i = 0; i < horizon_ + 1; ++i) {
+    x[time_start_index + i] = 1.0 + 0.2 * std::cos(1.3 * i);
+  }
+  return x;
+}
+
+TEST_F(DistanceApproachIPOPTSparseInterfaceTest, get_nlp_info) {
+  EXPECT_EQ(n_, 1274);
+  EXPECT_EQ(m_, 2194);
+  EXPECT_GT(nnz_jac_g_, 0);
+  EXPECT_GT(nnz_h_lag_, 0);
+}
+
+TEST_F(DistanceApproachIPOPTSparseInterfaceTest, eval_f) {
+  std::vector<double> x(n_, 1.2);
+  double obj_value = 0.0;
+  EXPECT_TRUE(ptop_->eval_f(n_, x.data(), true, obj_value));
+  EXPECT_DOUBLE_EQ(obj_value, 1443.3600000000008) << "eval_f: " << obj_value;
+}
+
+TEST_F(DistanceApproachIPOPTSparseInterfaceTest, eval_grad_f) {
+  const std::vector<double> x = PerturbedPoint();
+  std::vector<double> grad_f(n_);
+  EXPECT_TRUE(ptop_->eval_grad_f(n_, x.data(), true, grad_f.data()));
+
+  const double delta = 1e-6;
+  for (int i = 0; i < n_; ++i) {
+    std::vector<double> x_forward = x;
+    std::vector<double> x_backward = x;
+    x_forward[i] += delta;
+    x_backward[i] -= delta;
+    double obj_forward = 0.0;
+    double obj_backward = 0.0;
+    ptop_->eval_f(n_, x_forward.data(), true, obj_forward);
+    ptop_->eval_f(n_, x_backward.data(), true, obj_backward);
+    EXPECT_NEAR(grad_f[i], (obj_forward - obj_backward) / (2.0 * delta), 1e-5)
+        << "variable " << i;
+  }
+}
+
+TEST_F(DistanceApproachIPOPTSparseInterfaceTest, eval_jac_g) {
+  const std::vector<double> x = PerturbedPoint();
+  std::vector<int> rows(nnz_jac_g_);
+  std::vector<int> cols(nnz_jac_g_);
+  std::vector<double> values(nnz_jac_g_);
+  EXPECT_TRUE(ptop_->eval_jac_g(n_, x.data(), true, m_, nnz_jac_g_,
+                                rows.data(), cols.data(), nullptr));
+  EXPECT_TRUE(ptop_->eval_jac_g(n_, x.data(), true, m_, nnz_jac_g_, nullptr,
+                                nullptr, values.data()));
+  Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(m_, n_);
+  for (int k = 0; k < nnz_jac_g_; ++k) {
+    jacobian(rows[k], cols[k]) += values[k];
+  }
+
+  const double delta = 1e-6;
+  std::vector<double> g_forward(m_);
+  std::vector<double> g_backward(m_);
+  for (int i = 0; i < n_; ++i) {
+    std::vector<double> x_forward = x;
+    std::vector<double> x_backward = x;
+    x_forward[i] += delta;
+    x_backward[i] -= delta;
+    ptop_->eval_g(n_, x_forward.data(), true, m_, g_forward.data());
+    ptop_->eval_g(n_, x_backward.data(), true, m_, g_backward.data());
+    for (int j = 0; j < m_; ++j) {
+      EXPECT_NEAR(jacobian(j, i),
+                  (g_forward[j] - g_backward[j]) / (2.0 * delta), 1e-5)
+          << "constraint " << j << ", variable " << i;
+    }
+  }
+}
+
+TEST_F(DistanceApproachIPOPTSparseInterfaceTest, eval_h) {
+  const std::vector<double> x = PerturbedPoint();
+  const double obj_factor = 0.8;
+  std::vector<double> lambda(m_);
+  for (int j = 0; j < m_; ++j) {
+    lambda[j] = std::cos(0.3 * j);
+  }
+  std::vector<int> rows(nnz_h_lag_);
+  std::vector<int> cols(nnz_h_lag_);
+  std::vector<double> values(nnz_h_lag_);
+  EXPECT_TRUE(ptop_->eval_h(n_, x.data(), true, obj_factor, m_, lambda.data(),
+                            true, nnz_h_lag_, rows.data(), cols.data(),
+                            nullptr));
+  EXPECT_TRUE(ptop_->eval_h(n_, x.data(), true, obj_factor, m_, lambda.data(),
+                            true, nnz_h_lag_, nullptr, nullptr,
+                            values.data()));
+  Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(n_, n_);
+  for (int k = 0; k < nnz_h_lag_; ++k) {
+    ASSERT_GE(rows[k], cols[k]);
+    hessian(rows[k], cols[k]) += values[k];
+  }
+
+  // gradient of the lagrangian
+  std::vector<int> jac_rows(nnz_jac_g_);
+  std::vector<int> jac_cols(nnz_jac_g_);
+  ptop_->eval_jac_g(n_, x.data(), true, m_, nnz_jac_g_, jac_rows.data(),
+                    jac_cols.data(), nullptr);
+  const auto lagrangian_gradient = [&](const std::vector<double>& point) {
+    std::vector<double> grad_f(n_);
+    std::vector<double> jac_values(nnz_jac_g_);
+    ptop_->eval_grad_f(n_, point.data(), true, grad_f.data());
+    ptop_->eval_jac_g(n_, point.data(), true, m_, nnz_jac_g_, nullptr,
+                      nullptr, jac_values.data());
+    Eigen::VectorXd gradient(n_);
+    for (int i = 0; i < n_; ++i) {
+      gradient[i] = obj_factor * grad_f[i];
+    }
+    for (int k = 0; k < nnz_jac_g_; ++k) {
+      gradient[jac_cols[k]] += lambda[jac_rows[k]] * jac_values[k];
+    }
+    return gradient;
+  };
+
+  const double delta = 1e-6;
+  for (int i = 0; i < n_; ++i) {
+    std::vector<double> x_forward = x;
+    std::vector<double> x_backward = x;
+    x_forward[i] += delta;
+    x_backward[i] -= delta;
+    const Eigen::VectorXd column =
+        (lagrangian_gradient(x_forward) - lagrangian_gradient(x_backward)) /
+        (2.0 * delta);
+    // only the lower left triangle is stored
+    for (int j = i; j < n_; ++j) {
+      EXPECT_NEAR(hessian(j, i), column[j], 1e-4)
+          << "entry " << j << ", " << i;
+    }
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -36,6 +36,7 @@
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_interface.h"
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_relax_end_interface.h"
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_relax_end_slack_interface.h"
+#include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_sparse_interface.h"
 
 namespace apollo {
 namespace planning {
@@ -57,6 +57,7 @@ IterativeAnchoringSmoother::IterativeAnchoringSmoother(
 bool IterativeAnchoringSmoother::Smooth(
     const Eigen::MatrixXd& xWS, const double init_a, const double init_v,
     const std::vector<std::vector<Vec2d>>& obstacles_vertices_vec,
+    const ObstacleDistanceField* obstacle_distance_field,
     DiscretizedTrajectory* discretized_trajectory) {
   if (xWS.cols() < 2) {
     AERROR << "reference points size smaller than two, smoother early "
@@ -81,6 +82,7 @@ bool IterativeAnchoringSmoother::Smooth(
     obstacles_linesegments_vec.emplace_back(obstacle_linesegments);
   }
   obstacles_linesegments_vec_ = std::move(obstacles_linesegments_vec);
+  obstacle_distance_field_ = obstacle_distance_field;
 
   // Interpolate the traj
   DiscretizedPath warm_start_path;
@@ -306,6 +308,10 @@ bool IterativeAnchoringSmoother::ReAnchoring(
                        path_points->at(j).y() +
                            center_shift_distance_ * std::sin(heading)},
                       heading, ego_length_, ego_width_);
+        if (obstacle_distance_field_ != nullptr &&
+            obstacle_distance_field_->IsCollisionFree(ego_box)) {
+          continue;
+        }
         for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
           for (const LineSegment2d& linesegment : obstacle_linesegments) {
             if (ego_box.HasOverlap(linesegment)) {
@@ -406,11 +412,17 @@ bool IterativeAnchoringSmoother::GenerateInitialBounds(
   // TODO(Jinyun): refine obstacle formulation and speed it up
   for (const auto& path_point : path_points) {
     double min_bound = std::numeric_limits<double>::infinity();
-    for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
-      for (const LineSegment2d& linesegment : obstacle_linesegments) {
-        min_bound =
-            std::min(min_bound,
-                     linesegment.DistanceTo({path_point.x(), path_point.y()}));
+    if (obstacle_distance_field_ != nullptr) {
+      // a slightly conservative bound, capped by the extent of the field
+      min_bound =
+          obstacle_distance_field_->DistanceTo(path_point.x(), path_point.y());
+    } else {
+      for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
+        for (const LineSegment2d& linesegment : obstacle_linesegments) {
+          min_bound = std::min(
+              min_bound,
+              linesegment.DistanceTo({path_point.x(), path_point.y()}));
+        }
       }
     }
     min_bound -= vehicle_shortest_dimension;
@@ -511,6 +523,10 @@ bool IterativeAnchoringSmoother::CheckCollisionAvoidance(
         {path_points[i].x() + center_shift_distance_ * std::cos(heading),
          path_points[i].y() + center_shift_distance_ * std::sin(heading)},
         heading, ego_length_, ego_width_);
+    if (obstacle_distance_field_ != nullptr &&
+        obstacle_distance_field_->IsCollisionFree(ego_box)) {
+      continue;
+    }
 
     bool is_colliding = false;
     for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
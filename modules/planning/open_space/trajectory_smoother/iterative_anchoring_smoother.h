@@ -32,6 +32,7 @@
 #include "modules/planning/common/speed/speed_data.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
 #include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/obstacle_distance_field.h"
 #include "modules/planning/proto/planner_open_space_config.pb.h"
 
 namespace apollo {
@@ -43,10 +44,13 @@ class IterativeAnchoringSmoother {
 
   ~IterativeAnchoringSmoother() = default;
 
+  // obstacle_distance_field, of the same obstacles as
+  // obstacles_vertices_vec, speeds up the collision checks if not nullptr
   bool Smooth(const Eigen::MatrixXd& xWS, const double init_a,
               const double init_v,
               const std::vector<std::vector<common::math::Vec2d>>&
                   obstacles_vertices_vec,
+              const ObstacleDistanceField* obstacle_distance_field,
               DiscretizedTrajectory* discretized_trajectory);
 
  private:
@@ -103,6 +107,9 @@ class IterativeAnchoringSmoother {
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
 
+  // only valid within Smooth()
+  const ObstacleDistanceField* obstacle_distance_field_ = nullptr;
+
   std::vector<size_t> input_colliding_point_index_;
 
   bool enforce_initial_kappa_ = true;
@@ -14,8 +14,20 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <utility>
+
 #include <boost/filesystem.hpp>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "cyber/common/file.h"
 #include "modules/common/configs/config_gflags.h"
@@ -29,6 +41,266 @@
 namespace apollo {
 namespace planning {
 
+namespace {
+
+// sent as is from a worker process to the parent through a pipe, followed by
+// the number of learning data files written for each record of the worker
+struct WorkerStats {
+  int num_records = 0;
+  int num_frames = 0;
+  double elapsed_sec = 0.0;
+  // in kilobytes
+  long peak_rss = 0;  // NOLINT
+};
+
+double FramesPerSecond(const WorkerStats& stats) {
+  return stats.elapsed_sec > 0.0 ? stats.num_frames / stats.elapsed_sec : 0.0;
+}
+
+// Assign the records to the workers largest first, each one to the worker
+// with the fewest bytes so far, to balance the processing time. A shard
+// holds the indices of its records in records, in increasing order, so that
+// a worker processes its records in the order of a single process run.
+std::vector<std::vector<size_t>> ShardRecords(
+    const std::vector<std::string>& records, const int num_workers) {
+  std::vector<std::pair<uintmax_t, size_t>> sized_records;
+  for (size_t i = 0; i < records.size(); ++i) {
+    boost::system::error_code ec;
+    const uintmax_t size = boost::filesystem::file_size(records[i], ec);
+    sized_records.emplace_back(ec ? 0 : size, i);
+  }
+  std::stable_sort(sized_records.begin(), sized_records.end(),
+                   [](const std::pair<uintmax_t, size_t>& a,
+                      const std::pair<uintmax_t, size_t>& b) {
+                     return a.first > b.first;
+                   });
+
+  using WorkerLoad = std::pair<uintmax_t, int>;
+  std::priority_queue<WorkerLoad, std::vector<WorkerLoad>,
+                      std::greater<WorkerLoad>>
+      loads;
+  for (int i = 0; i < num_workers; ++i) {
+    loads.emplace(0, i);
+  }
+  std::vector<std::vector<size_t>> shards(num_workers);
+  for (const auto& sized_record : sized_records) {
+    WorkerLoad load = loads.top();
+    loads.pop();
+    shards[load.second].push_back(sized_record.second);
+    load.first += sized_record.first;
+    loads.push(load);
+  }
+  for (auto& shard : shards) {
+    std::sort(shard.begin(), shard.end());
+  }
+  return shards;
+}
+
+// num_files gets the number of learning data files written for each record
+WorkerStats ProcessRecords(const PlanningConfig& planning_config,
+                           const std::vector<std::string>& records,
+                           const int worker_id, std::vector<int>* num_files) {
+  WorkerStats stats;
+  num_files->assign(records.size(), 0);
+  MessageProcess message_process;
+  if (!message_process.Init(planning_config)) {
+    return stats;
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    AINFO << "\tWorker " << worker_id << " processing: [ " << i + 1 << " / "
+          << records.size() << " ]: " << records[i];
+    // frames are written out every FLAGS_learning_data_frame_num_per_file
+    // frames while the record is processed
+    const int file_index = FeatureOutput::LearningDataFileIndex();
+    message_process.ProcessOfflineData(records[i]);
+    FeatureOutput::WriteRemainderiLearningData(records[i]);
+    (*num_files)[i] = FeatureOutput::LearningDataFileIndex() - file_index;
+    ++stats.num_records;
+  }
+  stats.num_frames = message_process.total_learning_data_frame_num();
+  message_process.Close();
+
+  stats.elapsed_sec = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start_time)
+                          .count();
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    stats.peak_rss = usage.ru_maxrss;
+  }
+  AINFO << "Worker " << worker_id << ": " << stats.num_records
+        << " records, " << stats.num_frames << " frames in "
+        << stats.elapsed_sec << " sec, " << FramesPerSecond(stats)
+        << " frames/s, peak RSS " << stats.peak_rss / 1024 << " MB";
+  return stats;
+}
+
+bool WriteAll(const int fd, const void* buffer, const size_t size) {
+  const char* data = reinterpret_cast<const char*>(buffer);
+  size_t written = 0;
+  while (written < size) {
+    const ssize_t n = write(fd, data + written, size - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    written += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool ReadAll(const int fd, void* buffer, const size_t size) {
+  char* data = reinterpret_cast<char*>(buffer);
+  size_t read_size = 0;
+  while (read_size < size) {
+    const ssize_t n = read(fd, data + read_size, size - read_size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    read_size += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+std::string WorkerDataDir(const std::string& data_dir, const size_t worker) {
+  return absl::StrCat(data_dir, "/worker_", worker);
+}
+
+// Each worker is a process of its own, as MessageProcess and FeatureOutput
+// keep their state in globals, and writes its learning data files into a
+// directory of its own under FLAGS_planning_data_dir. num_files gets the
+// number of files each record was written to, -1 if its worker failed.
+std::vector<WorkerStats> RunWorkers(
+    const PlanningConfig& planning_config,
+    const std::vector<std::string>& records,
+    const std::vector<std::vector<size_t>>& shards,
+    std::vector<int>* num_files) {
+  num_files->assign(records.size(), -1);
+  const std::string data_dir = FLAGS_planning_data_dir;
+  std::vector<size_t> workers;
+  std::vector<pid_t> pids;
+  std::vector<int> fds;
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    if (shards[i].empty()) {
+      continue;
+    }
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+      AERROR << "Failed to create the pipe of worker " << i;
+      continue;
+    }
+    const pid_t pid = fork();
+    if (pid < 0) {
+      AERROR << "Failed to fork worker " << i;
+      close(pipe_fds[0]);
+      close(pipe_fds[1]);
+      continue;
+    }
+    if (pid == 0) {
+      close(pipe_fds[0]);
+      FLAGS_planning_data_dir = WorkerDataDir(data_dir, i);
+      bool success = cyber::common::EnsureDirectory(FLAGS_planning_data_dir);
+      std::vector<std::string> shard_records;
+      for (const size_t index : shards[i]) {
+        shard_records.push_back(records[index]);
+      }
+      std::vector<int> shard_num_files;
+      const WorkerStats stats =
+          success ? ProcessRecords(planning_config, shard_records,
+                                   static_cast<int>(i), &shard_num_files)
+                  : WorkerStats();
+      success = success && WriteAll(pipe_fds[1], &stats, sizeof(stats)) &&
+                WriteAll(pipe_fds[1], shard_num_files.data(),
+                         sizeof(int) * shard_num_files.size());
+      close(pipe_fds[1]);
+      google::FlushLogFiles(google::GLOG_INFO);
+      _exit(success ? 0 : 1);
+    }
+    close(pipe_fds[1]);
+    workers.push_back(i);
+    pids.push_back(pid);
+    fds.push_back(pipe_fds[0]);
+  }
+
+  std::vector<WorkerStats> worker_stats;
+  for (std::size_t i = 0; i < pids.size(); ++i) {
+    const std::vector<size_t>& shard = shards[workers[i]];
+    WorkerStats stats;
+    std::vector<int> shard_num_files(shard.size());
+    const bool has_stats =
+        ReadAll(fds[i], &stats, sizeof(stats)) &&
+        ReadAll(fds[i], shard_num_files.data(),
+                sizeof(int) * shard_num_files.size());
+    close(fds[i]);
+    int status = 0;
+    while (waitpid(pids[i], &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!has_stats || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      AERROR << "Worker process " << pids[i] << " failed, its output is left "
+             << "in " << WorkerDataDir(data_dir, workers[i]);
+      continue;
+    }
+    for (size_t j = 0; j < shard.size(); ++j) {
+      (*num_files)[shard[j]] = shard_num_files[j];
+    }
+    worker_stats.push_back(stats);
+  }
+  return worker_stats;
+}
+
+// Move the learning data files of the workers into FLAGS_planning_data_dir,
+// numbered as a single process run numbers them: across the records in
+// order. The records of a failed worker are skipped.
+void MergeWorkerData(const std::vector<std::string>& records,
+                     const std::vector<std::vector<size_t>>& shards,
+                     const std::vector<int>& num_files) {
+  const std::string& data_dir = FLAGS_planning_data_dir;
+  std::vector<size_t> worker_of_record(records.size());
+  for (size_t i = 0; i < shards.size(); ++i) {
+    for (const size_t index : shards[i]) {
+      worker_of_record[index] = i;
+    }
+  }
+  // the index of the next file of each worker, and of the merged files
+  std::vector<int> worker_file_index(shards.size(), 0);
+  int file_index = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (num_files[i] < 0) {
+      continue;
+    }
+    const size_t worker = worker_of_record[i];
+    std::string file_name =
+        records[i].substr(records[i].find_last_of("/") + 1);
+    file_name = file_name.empty() ? "00000" : file_name;
+    for (int j = 0; j < num_files[i]; ++j) {
+      const std::string worker_file =
+          absl::StrCat(WorkerDataDir(data_dir, worker), "/", file_name, ".",
+                       worker_file_index[worker]++, ".bin");
+      const std::string merged_file = absl::StrCat(
+          data_dir, "/", file_name, ".", file_index++, ".bin");
+      boost::system::error_code ec;
+      boost::filesystem::rename(worker_file, merged_file, ec);
+      if (ec) {
+        AERROR << "Failed to move " << worker_file << " to " << merged_file
+               << ": " << ec.message();
+      }
+    }
+  }
+  for (size_t i = 0; i < shards.size(); ++i) {
+    // only removes the directories left empty
+    boost::system::error_code ec;
+    boost::filesystem::remove(WorkerDataDir(data_dir, i), ec);
+  }
+}
+
+}  // namespace
+
 void GenerateLearningData() {
   AINFO << "map_dir: " << FLAGS_map_dir;
   if (FLAGS_planning_offline_bags.empty()) {
@@ -47,11 +319,7 @@ void GenerateLearningData() {
       cyber::common::GetProtoFromFile(planning_config_file, &planning_config))
       << "failed to load planning config file " << planning_config_file;
 
-  MessageProcess message_process;
-  if (!message_process.Init(planning_config)) {
-    return;
-  }
-
+  std::vector<std::string> records;
   const std::vector<std::string> inputs =
       absl::StrSplit(FLAGS_planning_offline_bags, ':');
   for (const auto& input : inputs) {
@@ -60,14 +328,40 @@ void GenerateLearningData() {
     std::sort(offline_bags.begin(), offline_bags.end());
     AINFO << "For input " << input << ", found " << offline_bags.size()
           << " rosbags to process";
-    for (std::size_t i = 0; i < offline_bags.size(); ++i) {
-      AINFO << "\tProcessing: [ " << i + 1 << " / " << offline_bags.size()
-            << " ]: " << offline_bags[i];
-      message_process.ProcessOfflineData(offline_bags[i]);
-      FeatureOutput::WriteRemainderiLearningData(offline_bags[i]);
-    }
+    records.insert(records.end(), offline_bags.begin(), offline_bags.end());
   }
-  message_process.Close();
+
+  const int num_workers = std::min(
+      std::max(1, FLAGS_planning_offline_learning_worker_num),
+      static_cast<int>(records.size()));
+  if (num_workers <= 1) {
+    std::vector<int> num_files;
+    ProcessRecords(planning_config, records, 0, &num_files);
+    return;
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const std::vector<std::vector<size_t>> shards =
+      ShardRecords(records, num_workers);
+  std::vector<int> num_files;
+  const std::vector<WorkerStats> worker_stats =
+      RunWorkers(planning_config, records, shards, &num_files);
+  MergeWorkerData(records, shards, num_files);
+  const double elapsed_sec = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start_time)
+                                 .count();
+  WorkerStats total;
+  for (const auto& stats : worker_stats) {
+    total.num_records += stats.num_records;
+    total.num_frames += stats.num_frames;
+    total.peak_rss = std::max(total.peak_rss, stats.peak_rss);
+  }
+  total.elapsed_sec = elapsed_sec;
+  AINFO << worker_stats.size() << " / " << num_workers << " workers done: "
+        << total.num_records << " / " << records.size() << " records, "
+        << total.num_frames << " frames in " << elapsed_sec << " sec, "
+        << FramesPerSecond(total) << " frames/s, max worker peak RSS "
+        << total.peak_rss / 1024 << " MB";
 }
 
 }  // namespace planning
@@ -20,6 +20,7 @@
 
 #include "modules/planning/planner/lattice/lattice_planner.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -31,6 +32,7 @@
 #include "modules/common/math/cartesian_frenet_conversion.h"
 #include "modules/common/math/path_matcher.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/util/parallel_for.h"
 #include "modules/planning/constraint_checker/collision_checker.h"
 #include "modules/planning/constraint_checker/constraint_checker.h"
 #include "modules/planning/lattice/behavior/path_time_graph.h"
@@ -54,6 +56,20 @@ using apollo::cyber::Clock;
 
 namespace {
 
+// the combined trajectory of a pair and the outcome of its checks
+struct CandidateTrajectory {
+  DiscretizedTrajectory trajectory;
+  ConstraintChecker::Result constraint_result =
+      ConstraintChecker::Result::VALID;
+  bool in_collision = false;
+};
+
+cyber::base::ThreadPool* LatticeEvaluationThreadPool() {
+  static cyber::base::ThreadPool thread_pool(
+      std::max(1, FLAGS_lattice_evaluation_thread_num - 1));
+  return &thread_pool;
+}
+
 std::vector<PathPoint> ToDiscretizedReferenceLine(
     const std::vector<ReferencePoint>& ref_points) {
   double s = 0.0;
@@ -234,104 +250,153 @@ Status LatticePlanner::PlanOnReferenceLine(
 
   size_t num_lattice_traj = 0;
 
-  while (trajectory_evaluator.has_more_trajectory_pairs()) {
-    double trajectory_pair_cost =
-        trajectory_evaluator.top_trajectory_pair_cost();
-    auto trajectory_pair = trajectory_evaluator.next_top_trajectory_pair();
-
-    // combine two 1d trajectories to one 2d trajectory
-    auto combined_trajectory = TrajectoryCombiner::Combine(
-        *ptr_reference_line, *trajectory_pair.first, *trajectory_pair.second,
-        planning_init_point.relative_time());
-
-    // check longitudinal and lateral acceleration
-    // considering trajectory curvatures
-    auto result = ConstraintChecker::ValidTrajectory(combined_trajectory);
-    if (result != ConstraintChecker::Result::VALID) {
-      ++combined_constraint_failure_count;
-
-      switch (result) {
-        case ConstraintChecker::Result::LON_VELOCITY_OUT_OF_BOUND:
-          lon_vel_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::LON_ACCELERATION_OUT_OF_BOUND:
-          lon_acc_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::LON_JERK_OUT_OF_BOUND:
-          lon_jerk_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::CURVATURE_OUT_OF_BOUND:
-          curvature_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::LAT_ACCELERATION_OUT_OF_BOUND:
-          lat_acc_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::LAT_JERK_OUT_OF_BOUND:
-          lat_jerk_failure_count += 1;
-          break;
-        case ConstraintChecker::Result::VALID:
-        default:
-          // Intentional empty
-          break;
-      }
-      continue;
+  // The cheapest pairs are popped in batches, combined and checked on
+  // several threads, and then scanned in order of cost, so that the chosen
+  // trajectory is the one the one-pair-at-a-time search would choose.
+  const size_t batch_size =
+      FLAGS_enable_lattice_batch_evaluation
+          ? static_cast<size_t>(
+                std::max(1, FLAGS_lattice_evaluation_batch_size))
+          : 1;
+  auto* thread_pool = batch_size > 1 ? LatticeEvaluationThreadPool() : nullptr;
+  const size_t num_threads =
+      static_cast<size_t>(std::max(1, FLAGS_lattice_evaluation_thread_num));
+  std::vector<std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>>
+      trajectory_pairs;
+  std::vector<double> trajectory_pair_costs;
+  std::vector<CandidateTrajectory> candidates;
+  bool has_trajectory = false;
+
+  while (!has_trajectory && trajectory_evaluator.has_more_trajectory_pairs()) {
+    trajectory_pairs.clear();
+    trajectory_pair_costs.clear();
+    while (trajectory_pairs.size() < batch_size &&
+           trajectory_evaluator.has_more_trajectory_pairs()) {
+      trajectory_pair_costs.push_back(
+          trajectory_evaluator.top_trajectory_pair_cost());
+      trajectory_pairs.push_back(
+          trajectory_evaluator.next_top_trajectory_pair());
     }
 
-    // check collision with other obstacles
-    if (collision_checker.InCollision(combined_trajectory)) {
-      ++collision_failure_count;
-      continue;
-    }
+    candidates.clear();
+    candidates.resize(trajectory_pairs.size());
+    util::ParallelFor(
+        0, trajectory_pairs.size(), num_threads, 1,
+        [&](const size_t begin, const size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            auto& candidate = candidates[i];
+            // combine two 1d trajectories to one 2d trajectory
+            candidate.trajectory = TrajectoryCombiner::Combine(
+                *ptr_reference_line, *trajectory_pairs[i].first,
+                *trajectory_pairs[i].second,
+                planning_init_point.relative_time());
+            // check longitudinal and lateral acceleration
+            // considering trajectory curvatures
+            candidate.constraint_result =
+                ConstraintChecker::ValidTrajectory(candidate.trajectory);
+            // check collision with other obstacles
+            candidate.in_collision =
+                candidate.constraint_result ==
+                    ConstraintChecker::Result::VALID &&
+                collision_checker.InCollision(candidate.trajectory);
+          }
+        },
+        thread_pool);
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const double trajectory_pair_cost = trajectory_pair_costs[i];
+      const auto& trajectory_pair = trajectory_pairs[i];
+      const auto& combined_trajectory = candidates[i].trajectory;
+
+      const auto result = candidates[i].constraint_result;
+      if (result != ConstraintChecker::Result::VALID) {
+        ++combined_constraint_failure_count;
+
+        switch (result) {
+          case ConstraintChecker::Result::LON_VELOCITY_OUT_OF_BOUND:
+            lon_vel_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::LON_ACCELERATION_OUT_OF_BOUND:
+            lon_acc_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::LON_JERK_OUT_OF_BOUND:
+            lon_jerk_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::CURVATURE_OUT_OF_BOUND:
+            curvature_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::LAT_ACCELERATION_OUT_OF_BOUND:
+            lat_acc_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::LAT_JERK_OUT_OF_BOUND:
+            lat_jerk_failure_count += 1;
+            break;
+          case ConstraintChecker::Result::VALID:
+          default:
+            // Intentional empty
+            break;
+        }
+        continue;
+      }
 
-    // put combine trajectory into debug data
-    const auto& combined_trajectory_points = combined_trajectory;
-    num_lattice_traj += 1;
-    reference_line_info->SetTrajectory(combined_trajectory);
-    reference_line_info->SetCost(reference_line_info->PriorityCost() +
-                                 trajectory_pair_cost);
-    reference_line_info->SetDrivable(true);
+      if (candidates[i].in_collision) {
+        ++collision_failure_count;
+        continue;
+      }
 
-    // Print the chosen end condition and start condition
-    ADEBUG << "Starting Lon. State: s = " << init_s[0] << " ds = " << init_s[1]
-           << " dds = " << init_s[2];
-    // cast
-    auto lattice_traj_ptr =
-        std::dynamic_pointer_cast<LatticeTrajectory1d>(trajectory_pair.first);
-    if (!lattice_traj_ptr) {
-      ADEBUG << "Dynamically casting trajectory1d ptr. failed.";
-    }
+      // put combine trajectory into debug data
+      const auto& combined_trajectory_points = combined_trajectory;
+      num_lattice_traj += 1;
+      reference_line_info->SetTrajectory(combined_trajectory);
+      reference_line_info->SetCost(reference_line_info->PriorityCost() +
+                                   trajectory_pair_cost);
+      reference_line_info->SetDrivable(true);
 
-    if (lattice_traj_ptr->has_target_position()) {
-      ADEBUG << "Ending Lon. State s = " << lattice_traj_ptr->target_position()
-             << " ds = " << lattice_traj_ptr->target_velocity()
-             << " t = " << lattice_traj_ptr->target_time();
-    }
+      // Print the chosen end condition and start condition
+      ADEBUG << "Starting Lon. State: s = " << init_s[0]
+             << " ds = " << init_s[1] << " dds = " << init_s[2];
+      // cast
+      auto lattice_traj_ptr =
+          std::dynamic_pointer_cast<LatticeTrajectory1d>(trajectory_pair.first);
+      if (!lattice_traj_ptr) {
+        ADEBUG << "Dynamically casting trajectory1d ptr. failed.";
+      }
 
-    ADEBUG << "InputPose";
-    ADEBUG << "XY: " << planning_init_point.ShortDebugString();
-    ADEBUG << "S: (" << init_s[0] << ", " << init_s[1] << "," << init_s[2]
-           << ")";
-    ADEBUG << "L: (" << init_d[0] << ", " << init_d[1] << "," << init_d[2]
-           << ")";
-
-    ADEBUG << "Reference_line_priority_cost = "
-           << reference_line_info->PriorityCost();
-    ADEBUG << "Total_Trajectory_Cost = " << trajectory_pair_cost;
-    ADEBUG << "OutputTrajectory";
-    for (uint i = 0; i < 10; ++i) {
-      ADEBUG << combined_trajectory_points[i].ShortDebugString();
-    }
+      if (lattice_traj_ptr->has_target_position()) {
+        ADEBUG << "Ending Lon. State s = "
+               << lattice_traj_ptr->target_position()
+               << " ds = " << lattice_traj_ptr->target_velocity()
+               << " t = " << lattice_traj_ptr->target_time();
+      }
+
+      ADEBUG << "InputPose";
+      ADEBUG << "XY: " << planning_init_point.ShortDebugString();
+      ADEBUG << "S: (" << init_s[0] << ", " << init_s[1] << "," << init_s[2]
+             << ")";
+      ADEBUG << "L: (" << init_d[0] << ", " << init_d[1] << "," << init_d[2]
+             << ")";
+
+      ADEBUG << "Reference_line_priority_cost = "
+             << reference_line_info->PriorityCost();
+      ADEBUG << "Total_Trajectory_Cost = " << trajectory_pair_cost;
+      ADEBUG << "OutputTrajectory";
+      for (uint i = 0; i < 10; ++i) {
+        ADEBUG << combined_trajectory_points[i].ShortDebugString();
+      }
 
-    break;
-    /*
-    auto combined_trajectory_path =
-        ptr_debug->mutable_planning_data()->add_trajectory_path();
-    for (uint i = 0; i < combined_trajectory_points.size(); ++i) {
-      combined_trajectory_path->add_trajectory_point()->CopyFrom(
-          combined_trajectory_points[i]);
+      has_trajectory = true;
+      break;
+      /*
+      auto combined_trajectory_path =
+          ptr_debug->mutable_planning_data()->add_trajectory_path();
+      for (uint i = 0; i < combined_trajectory_points.size(); ++i) {
+        combined_trajectory_path->add_trajectory_point()->CopyFrom(
+            combined_trajectory_points[i]);
+      }
+      combined_trajectory_path->set_lattice_trajectory_cost(
+          trajectory_pair_cost);
+      */
     }
-    combined_trajectory_path->set_lattice_trajectory_cost(trajectory_pair_cost);
-    */
   }
 
   ADEBUG << "Trajectory_Evaluation_Time = "
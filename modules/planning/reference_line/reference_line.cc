@@ -48,6 +48,74 @@ using apollo::common::math::Vec2d;
 using apollo::common::util::DistanceXY;
 using apollo::hdmap::InterpolatedIndex;
 
+namespace {
+
+// The boundary points are the corners of the box, and the midpoints of its
+// edges which are outside of the polygon of the projected corners. xy_to_sl
+// logs its own failures.
+template <typename XYToSLFunc>
+bool GetBoxSLBoundary(const common::math::Box2d& box,
+                      const XYToSLFunc& xy_to_sl,
+                      SLBoundary* const sl_boundary) {
+  double start_s(std::numeric_limits<double>::max());
+  double end_s(std::numeric_limits<double>::lowest());
+  double start_l(std::numeric_limits<double>::max());
+  double end_l(std::numeric_limits<double>::lowest());
+  std::vector<common::math::Vec2d> corners;
+  box.GetAllCorners(&corners);
+
+  // The order must be counter-clockwise
+  std::vector<SLPoint> sl_corners;
+  for (const auto& point : corners) {
+    SLPoint sl_point;
+    if (!xy_to_sl(point, &sl_point)) {
+      return false;
+    }
+    sl_corners.push_back(std::move(sl_point));
+  }
+
+  for (size_t i = 0; i < corners.size(); ++i) {
+    auto index0 = i;
+    auto index1 = (i + 1) % corners.size();
+    const auto& p0 = corners[index0];
+    const auto& p1 = corners[index1];
+
+    const auto p_mid = (p0 + p1) * 0.5;
+    SLPoint sl_point_mid;
+    if (!xy_to_sl(p_mid, &sl_point_mid)) {
+      return false;
+    }
+
+    Vec2d v0(sl_corners[index1].s() - sl_corners[index0].s(),
+             sl_corners[index1].l() - sl_corners[index0].l());
+
+    Vec2d v1(sl_point_mid.s() - sl_corners[index0].s(),
+             sl_point_mid.l() - sl_corners[index0].l());
+
+    *sl_boundary->add_boundary_point() = sl_corners[index0];
+
+    // sl_point is outside of polygon; add to the vertex list
+    if (v0.CrossProd(v1) < 0.0) {
+      *sl_boundary->add_boundary_point() = sl_point_mid;
+    }
+  }
+
+  for (const auto& sl_point : sl_boundary->boundary_point()) {
+    start_s = std::fmin(start_s, sl_point.s());
+    end_s = std::fmax(end_s, sl_point.s());
+    start_l = std::fmin(start_l, sl_point.l());
+    end_l = std::fmax(end_l, sl_point.l());
+  }
+
+  sl_boundary->set_start_s(start_s);
+  sl_boundary->set_end_s(end_s);
+  sl_boundary->set_start_l(start_l);
+  sl_boundary->set_end_l(end_l);
+  return true;
+}
+
+}  // namespace
+
 ReferenceLine::ReferenceLine(
     const std::vector<ReferencePoint>& reference_points)
     : reference_points_(reference_points),
@@ -662,65 +730,47 @@ bool ReferenceLine::GetApproximateSLBoundary(
 
 bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
                                   SLBoundary* const sl_boundary) const {
-  double start_s(std::numeric_limits<double>::max());
-  double end_s(std::numeric_limits<double>::lowest());
-  double start_l(std::numeric_limits<double>::max());
-  double end_l(std::numeric_limits<double>::lowest());
-  std::vector<common::math::Vec2d> corners;
-  box.GetAllCorners(&corners);
-
-  // The order must be counter-clockwise
-  std::vector<SLPoint> sl_corners;
-  for (const auto& point : corners) {
-    SLPoint sl_point;
-    if (!XYToSL(point, &sl_point)) {
-      AERROR << "Failed to get projection for point: " << point.DebugString()
-             << " on reference line.";
-      return false;
-    }
-    sl_corners.push_back(std::move(sl_point));
-  }
-
-  for (size_t i = 0; i < corners.size(); ++i) {
-    auto index0 = i;
-    auto index1 = (i + 1) % corners.size();
-    const auto& p0 = corners[index0];
-    const auto& p1 = corners[index1];
-
-    const auto p_mid = (p0 + p1) * 0.5;
-    SLPoint sl_point_mid;
-    if (!XYToSL(p_mid, &sl_point_mid)) {
-      AERROR << "Failed to get projection for point: " << p_mid.DebugString()
-             << " on reference line.";
-      return false;
-    }
-
-    Vec2d v0(sl_corners[index1].s() - sl_corners[index0].s(),
-             sl_corners[index1].l() - sl_corners[index0].l());
-
-    Vec2d v1(sl_point_mid.s() - sl_corners[index0].s(),
-             sl_point_mid.l() - sl_corners[index0].l());
-
-    *sl_boundary->add_boundary_point() = sl_corners[index0];
-
-    // sl_point is outside of polygon; add to the vertex list
-    if (v0.CrossProd(v1) < 0.0) {
-      *sl_boundary->add_boundary_point() = sl_point_mid;
-    }
-  }
-
-  for (const auto& sl_point : sl_boundary->boundary_point()) {
-    start_s = std::fmin(start_s, sl_point.s());
-    end_s = std::fmax(end_s, sl_point.s());
-    start_l = std::fmin(start_l, sl_point.l());
-    end_l = std::fmax(end_l, sl_point.l());
-  }
+  return GetBoxSLBoundary(
+      box,
+      [this](const Vec2d& xy_point, SLPoint* const sl_point) {
+        if (!XYToSL(xy_point, sl_point)) {
+          AERROR << "Failed to get projection for point: "
+                 << xy_point.DebugString() << " on reference line.";
+          return false;
+        }
+        return true;
+      },
+      sl_boundary);
+}
 
-  sl_boundary->set_start_s(start_s);
-  sl_boundary->set_end_s(end_s);
-  sl_boundary->set_start_l(start_l);
-  sl_boundary->set_end_l(end_l);
-  return true;
+bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
+                                  const double start_s, const double end_s,
+                                  SLBoundary* const sl_boundary) const {
+  return GetBoxSLBoundary(
+      box,
+      [this, start_s, end_s](const Vec2d& xy_point, SLPoint* const sl_point) {
+        double s = 0.0;
+        double l = 0.0;
+        double distance = 0.0;
+        if (!map_path_.GetProjectionWithHueristicParams(xy_point, start_s,
+                                                        end_s, &s, &l,
+                                                        &distance)) {
+          AERROR << "Cannot get projection point from path.";
+          return false;
+        }
+        // the nearest point in the range is at its ends when the nearest
+        // point of the reference line may be outside of it
+        if (s <= start_s || s >= end_s) {
+          ADEBUG << "Projection of point: " << xy_point.DebugString()
+                 << " at the end of s range [" << start_s << ", " << end_s
+                 << "].";
+          return false;
+        }
+        sl_point->set_s(s);
+        sl_point->set_l(l);
+        return true;
+      },
+      sl_boundary);
 }
 
 std::vector<hdmap::LaneSegment> ReferenceLine::GetLaneSegments(
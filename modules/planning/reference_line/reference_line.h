@@ -107,6 +107,16 @@ class ReferenceLine {
                                 SLBoundary* const sl_boundary) const;
   bool GetSLBoundary(const common::math::Box2d& box,
                      SLBoundary* const sl_boundary) const;
+  /**
+   * @brief Same as GetSLBoundary, but the projections onto the reference line
+   * are only searched between start_s and end_s. It fails if any of them is
+   * not strictly between start_s and end_s, as the nearest point of the
+   * reference line may then be outside of the range. Otherwise the result is
+   * the same as GetSLBoundary, unless another part of the reference line
+   * outside of the range, e.g. the other side of a U-turn, is nearer.
+   */
+  bool GetSLBoundary(const common::math::Box2d& box, const double start_s,
+                     const double end_s, SLBoundary* const sl_boundary) const;
   bool GetSLBoundary(const hdmap::Polygon& polygon,
                      SLBoundary* const sl_boundary) const;
 
@@ -55,6 +55,13 @@ using apollo::hdmap::MapPathPoint;
 using apollo::hdmap::PncMap;
 using apollo::hdmap::RouteSegments;
 
+double ReferenceLineProvider::SmoothingCacheStats::HitRate() const {
+  const int num_lookups = num_hits + num_partial_hits + num_misses;
+  return num_lookups > 0
+             ? static_cast<double>(num_hits + num_partial_hits) / num_lookups
+             : 0.0;
+}
+
 ReferenceLineProvider::~ReferenceLineProvider() {}
 
 ReferenceLineProvider::ReferenceLineProvider(
@@ -210,6 +217,12 @@ void ReferenceLineProvider::GenerateThread() {
   }
 }
 
+ReferenceLineProvider::SmoothingCacheStats
+ReferenceLineProvider::GetSmoothingCacheStats() {
+  std::lock_guard<std::mutex> lock(smoothing_cache_stats_mutex_);
+  return smoothing_cache_stats_;
+}
+
 double ReferenceLineProvider::LastTimeDelay() {
   if (FLAGS_enable_reference_line_provider_thread &&
       !FLAGS_use_navigation_mode) {
@@ -581,22 +594,8 @@ bool ReferenceLineProvider::CreateReferenceLine(
     return false;
   }
   if (is_new_routing || !FLAGS_enable_reference_line_stitching) {
-    for (auto iter = segments->begin(); iter != segments->end();) {
-      reference_lines->emplace_back();
-      if (!SmoothRouteSegment(*iter, &reference_lines->back())) {
-        AERROR << "Failed to create reference line from route segments";
-        reference_lines->pop_back();
-        iter = segments->erase(iter);
-      } else {
-        common::SLPoint sl;
-        if (!reference_lines->back().XYToSL(vehicle_state, &sl)) {
-          AWARN << "Failed to project point: {" << vehicle_state.x() << ","
-                << vehicle_state.y() << "} to stitched reference line";
-        }
-        Shrink(sl, &reference_lines->back(), &(*iter));
-        ++iter;
-      }
-    }
+    SmoothRouteSegments(vehicle_state, is_new_routing, reference_lines,
+                        segments);
     return true;
   } else {  // stitching reference line
     for (auto iter = segments->begin(); iter != segments->end();) {
@@ -874,6 +873,217 @@ bool ReferenceLineProvider::SmoothRouteSegment(const RouteSegments &segments,
   return SmoothReferenceLine(ReferenceLine(path), reference_line);
 }
 
+void ReferenceLineProvider::SmoothRouteSegments(
+    const common::VehicleState &vehicle_state, const bool is_new_routing,
+    std::list<ReferenceLine> *reference_lines,
+    std::list<hdmap::RouteSegments> *segments) {
+  if (is_new_routing) {
+    smoothing_cache_.clear();
+  }
+  std::vector<SmoothingCacheEntry> smoothing_cache;
+  for (auto iter = segments->begin(); iter != segments->end();) {
+    reference_lines->emplace_back();
+    const bool is_smoothed =
+        FLAGS_enable_reference_line_smoothing_cache
+            ? SmoothRouteSegmentWithCache(*iter, &reference_lines->back())
+            : SmoothRouteSegment(*iter, &reference_lines->back());
+    if (!is_smoothed) {
+      AERROR << "Failed to create reference line from route segments";
+      reference_lines->pop_back();
+      iter = segments->erase(iter);
+    } else {
+      if (FLAGS_enable_reference_line_smoothing_cache) {
+        smoothing_cache.emplace_back();
+        smoothing_cache.back().segments = *iter;
+        smoothing_cache.back().reference_line = reference_lines->back();
+      }
+      common::SLPoint sl;
+      if (!reference_lines->back().XYToSL(vehicle_state, &sl)) {
+        AWARN << "Failed to project point: {" << vehicle_state.x() << ","
+              << vehicle_state.y() << "} to stitched reference line";
+      }
+      Shrink(sl, &reference_lines->back(), &(*iter));
+      ++iter;
+    }
+  }
+  smoothing_cache_ = std::move(smoothing_cache);
+}
+
+double ReferenceLineProvider::CoveredLength(
+    const RouteSegments &cached_segments, const RouteSegments &segments) {
+  if (cached_segments.empty() || segments.empty()) {
+    return 0.0;
+  }
+  const LaneWaypoint first_waypoint = segments.FirstWaypoint();
+  auto cached_iter = cached_segments.begin();
+  while (cached_iter != cached_segments.end() &&
+         !RouteSegments::WithinLaneSegment(*cached_iter, first_waypoint)) {
+    ++cached_iter;
+  }
+  double covered_length = 0.0;
+  for (auto iter = segments.begin();
+       iter != segments.end() && cached_iter != cached_segments.end();
+       ++iter, ++cached_iter) {
+    if (iter->lane->id().id() != cached_iter->lane->id().id()) {
+      return 0.0;
+    }
+    const double end_s = std::min(iter->end_s, cached_iter->end_s);
+    covered_length += std::max(0.0, end_s - iter->start_s);
+    if (end_s < iter->end_s) {
+      break;
+    }
+  }
+  return covered_length;
+}
+
+bool ReferenceLineProvider::CutReferenceLine(const RouteSegments &segments,
+                                             const double end_s,
+                                             ReferenceLine *reference_line) {
+  LaneWaypoint start_waypoint;
+  LaneWaypoint end_waypoint;
+  if (!segments.GetWaypoint(0.0, &start_waypoint) ||
+      !segments.GetWaypoint(end_s, &end_waypoint)) {
+    return false;
+  }
+  common::SLPoint start_sl;
+  common::SLPoint end_sl;
+  if (!reference_line->XYToSL(
+          start_waypoint.lane->GetSmoothPoint(start_waypoint.s), &start_sl) ||
+      !reference_line->XYToSL(
+          end_waypoint.lane->GetSmoothPoint(end_waypoint.s), &end_sl)) {
+    return false;
+  }
+  const double start_s = std::max(0.0, start_sl.s());
+  return reference_line->Segment(start_s, 0.0, end_sl.s() - start_s);
+}
+
+bool ReferenceLineProvider::SmoothRouteSegmentWithCache(
+    const RouteSegments &segments, ReferenceLine *reference_line) {
+  const double start_time = Clock::NowInSeconds();
+  const double length = RouteSegments::Length(segments);
+  // the cached reference line covering the longest prefix of segments
+  const SmoothingCacheEntry *cached = nullptr;
+  double covered_length = 0.0;
+  for (const auto &entry : smoothing_cache_) {
+    const double entry_covered_length = CoveredLength(entry.segments, segments);
+    if (entry_covered_length > covered_length) {
+      covered_length = entry_covered_length;
+      cached = &entry;
+    }
+  }
+
+  static constexpr double kCoveredLengthEpsilon = 1e-3;
+  const double overlap_distance = FLAGS_reference_line_stitch_overlap_distance;
+  const bool is_cached =
+      cached != nullptr && covered_length > overlap_distance;
+  bool is_hit = false;
+  bool is_partial_hit = false;
+  if (cached != nullptr && covered_length > length - kCoveredLengthEpsilon) {
+    *reference_line = cached->reference_line;
+    is_hit = CutReferenceLine(segments, length, reference_line);
+  } else if (is_cached) {
+    // re-smooth the overlap with the cached reference line together with the
+    // new tail, as the end of a smoothed reference line is pinned to the raw
+    // one
+    ReferenceLine prefix_ref(cached->reference_line);
+    RouteSegments tail_segments = segments;
+    const double tail_start_s = covered_length - overlap_distance;
+    if (CutReferenceLine(segments, covered_length, &prefix_ref) &&
+        tail_segments.Shrink(tail_start_s, 0.0, length - tail_start_s)) {
+      hdmap::Path tail_path(tail_segments);
+      is_partial_hit = SmoothTailReferenceLine(
+                           prefix_ref, ReferenceLine(tail_path),
+                           reference_line) &&
+                       reference_line->Stitch(prefix_ref);
+    }
+    if (!is_partial_hit) {
+      AWARN << "Failed to stitch smoothed tail to cached reference line";
+    }
+  }
+  const bool is_smoothed = is_hit || is_partial_hit ||
+                           SmoothRouteSegment(segments, reference_line);
+  const double smoothing_time = Clock::NowInSeconds() - start_time;
+
+  std::lock_guard<std::mutex> lock(smoothing_cache_stats_mutex_);
+  auto &stats = smoothing_cache_stats_;
+  stats.smoothing_time += smoothing_time;
+  if (is_hit || is_partial_hit) {
+    if (is_hit) {
+      ++stats.num_hits;
+    } else {
+      ++stats.num_partial_hits;
+    }
+    if (full_smoothing_length_ > 0.0) {
+      stats.saved_time += std::max(
+          0.0, full_smoothing_time_ / full_smoothing_length_ * length -
+                   smoothing_time);
+    }
+  } else {
+    ++stats.num_misses;
+    if (is_smoothed && !is_cached) {
+      full_smoothing_length_ += length;
+      full_smoothing_time_ += smoothing_time;
+    }
+  }
+  ADEBUG << "route segments " << segments.Id() << " of length " << length
+         << " covered by cached reference line for " << covered_length
+         << ", smoothed in " << smoothing_time * 1000.0 << " ms";
+  AINFO_EVERY(100) << "reference line smoothing cache hit rate: "
+                   << stats.HitRate() << ", hits: " << stats.num_hits
+                   << ", partial hits: " << stats.num_partial_hits
+                   << ", misses: " << stats.num_misses
+                   << ", smoothing time: " << stats.smoothing_time
+                   << " s, estimated saved time: " << stats.saved_time
+                   << " s";
+  return is_smoothed;
+}
+
+bool ReferenceLineProvider::SmoothTailReferenceLine(
+    const ReferenceLine &prefix_ref, const ReferenceLine &raw_ref,
+    ReferenceLine *reference_line) {
+  if (!FLAGS_enable_smooth_reference_line) {
+    *reference_line = raw_ref;
+    return true;
+  }
+  std::vector<AnchorPoint> anchor_points;
+  GetAnchorPoints(raw_ref, &anchor_points);
+  // pin the anchor points on the first half of the overlap to prefix_ref,
+  // and let the smoother blend into the tail over the second half
+  const double fixed_length =
+      0.5 * FLAGS_reference_line_stitch_overlap_distance;
+  for (auto &point : anchor_points) {
+    if (point.path_point.s() > fixed_length) {
+      break;
+    }
+    common::SLPoint sl_point;
+    if (!prefix_ref.XYToSL(point.path_point, &sl_point)) {
+      continue;
+    }
+    if (sl_point.s() < 0 || sl_point.s() > prefix_ref.Length()) {
+      continue;
+    }
+    auto prefix_ref_point = prefix_ref.GetReferencePoint(sl_point.s());
+    point.path_point.set_x(prefix_ref_point.x());
+    point.path_point.set_y(prefix_ref_point.y());
+    point.path_point.set_z(0.0);
+    point.path_point.set_theta(prefix_ref_point.heading());
+    point.longitudinal_bound = 1e-6;
+    point.lateral_bound = 1e-6;
+    point.enforced = true;
+  }
+
+  smoother_->SetAnchorPoints(anchor_points);
+  if (!smoother_->Smooth(raw_ref, reference_line)) {
+    AERROR << "Failed to smooth tail reference line with anchor points";
+    return false;
+  }
+  if (!IsReferenceLineSmoothValid(raw_ref, *reference_line)) {
+    AERROR << "The smoothed reference line error is too large";
+    return false;
+  }
+  return true;
+}
+
 bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
     const ReferenceLine &prefix_ref, const ReferenceLine &raw_ref,
     ReferenceLine *reference_line) {
@@ -33,6 +33,8 @@
 #include "modules/common_msgs/planning_msgs/navigation.pb.h"
 #include "modules/planning/proto/planning_config.pb.h"
 
+#include "gtest/gtest_prod.h"
+
 #include "cyber/cyber.h"
 #include "modules/common/util/factory.h"
 #include "modules/common/util/util.h"
@@ -87,6 +89,28 @@ class ReferenceLineProvider {
 
   bool UpdatedReferenceLine() { return is_reference_line_updated_.load(); }
 
+  /**
+   * @brief Statistics of the smoothing cache, see
+   * FLAGS_enable_reference_line_smoothing_cache.
+   */
+  struct SmoothingCacheStats {
+    // route segments fully covered by a cached reference line
+    int num_hits = 0;
+    // route segments whose newly appended tail is smoothed and stitched
+    int num_partial_hits = 0;
+    // route segments smoothed from scratch
+    int num_misses = 0;
+    // seconds spent on smoothing route segments
+    double smoothing_time = 0.0;
+    // seconds saved over smoothing every route segment from scratch,
+    // estimated with the smoothing time per meter of the misses
+    double saved_time = 0.0;
+
+    double HitRate() const;
+  };
+
+  SmoothingCacheStats GetSmoothingCacheStats();
+
  private:
   /**
    * @brief Use PncMap to create reference line and the corresponding segments
@@ -128,6 +152,36 @@ class ReferenceLineProvider {
   bool SmoothRouteSegment(const hdmap::RouteSegments& segments,
                           ReferenceLine* reference_line);
 
+  /**
+   * @brief Smooth each of the route segments and shrink it around the
+   * vehicle, erasing the segments failed to smooth. The smoothed reference
+   * lines replace the smoothing cache, which is dropped first on a new
+   * routing.
+   */
+  void SmoothRouteSegments(const common::VehicleState& vehicle_state,
+                           const bool is_new_routing,
+                           std::list<ReferenceLine>* reference_lines,
+                           std::list<hdmap::RouteSegments>* segments);
+
+  /**
+   * @brief Smooth the route segments with the reference lines smoothed in the
+   * last cycle. The part of the segments covered by a cached reference line
+   * on the same lanes is reused, and only the newly appended tail is smoothed
+   * and stitched to it.
+   */
+  bool SmoothRouteSegmentWithCache(const hdmap::RouteSegments& segments,
+                                   ReferenceLine* reference_line);
+
+  /**
+   * @brief Smooth the tail raw_ref which starts on prefix_ref. The anchor
+   * points on the first half of the stitching overlap are moved onto
+   * prefix_ref and enforced, so that the smoothed tail joins prefix_ref
+   * without a kink.
+   */
+  bool SmoothTailReferenceLine(const ReferenceLine& prefix_ref,
+                               const ReferenceLine& raw_ref,
+                               ReferenceLine* reference_line);
+
   /**
    * @brief This function creates a smoothed forward reference line
    * based on the given segments.
@@ -155,6 +209,22 @@ class ReferenceLineProvider {
   bool Shrink(const common::SLPoint& sl, ReferenceLine* ref,
               hdmap::RouteSegments* segments);
 
+  /**
+   * @brief Length of the prefix of segments which runs along the lanes of
+   * cached_segments. It is 0 if segments do not start on cached_segments or
+   * leave their lanes before the end of cached_segments.
+   */
+  static double CoveredLength(const hdmap::RouteSegments& cached_segments,
+                              const hdmap::RouteSegments& segments);
+
+  /**
+   * @brief Cut reference_line, which covers the lanes of segments up to end_s
+   * along them, to the part from the start of segments to end_s.
+   */
+  static bool CutReferenceLine(const hdmap::RouteSegments& segments,
+                               const double end_s,
+                               ReferenceLine* reference_line);
+
  private:
   bool is_initialized_ = false;
   std::atomic<bool> is_stop_{false};
@@ -183,11 +253,30 @@ class ReferenceLineProvider {
   std::queue<std::list<ReferenceLine>> reference_line_history_;
   std::queue<std::list<hdmap::RouteSegments>> route_segments_history_;
 
+  struct SmoothingCacheEntry {
+    hdmap::RouteSegments segments;
+    // the smoothed reference line of segments, before shrinking
+    ReferenceLine reference_line;
+  };
+  // reference lines smoothed in the last cycle, only accessed by the thread
+  // creating the reference lines
+  std::vector<SmoothingCacheEntry> smoothing_cache_;
+  std::mutex smoothing_cache_stats_mutex_;
+  SmoothingCacheStats smoothing_cache_stats_;
+  // length and time of the route segments smoothed from scratch
+  double full_smoothing_length_ = 0.0;
+  double full_smoothing_time_ = 0.0;
+
   std::future<void> task_future_;
 
   std::atomic<bool> is_reference_line_updated_{true};
 
   const common::VehicleStateProvider* vehicle_state_provider_ = nullptr;
+
+  friend class ReferenceLineProviderTest;
+  FRIEND_TEST(ReferenceLineProviderTest, CoveredLength);
+  FRIEND_TEST(ReferenceLineProviderTest, CutReferenceLine);
+  FRIEND_TEST(ReferenceLineProviderTest, SmoothingCache);
 };
 
 }  // namespace planning
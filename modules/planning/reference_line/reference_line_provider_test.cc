@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/reference_line/reference_line_provider.h"
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::hdmap::LaneInfo;
+using apollo::hdmap::LaneInfoConstPtr;
+using apollo::hdmap::RouteSegments;
+
+class ReferenceLineProviderTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    FLAGS_enable_smooth_reference_line = false;
+    FLAGS_enable_reference_line_smoothing_cache = true;
+    // straight lanes "a", "b" and "c" of 100m one after another along x
+    lane_protos_.resize(3);
+    for (int i = 0; i < 3; ++i) {
+      hdmap::Lane& lane = lane_protos_[i];
+      lane.mutable_id()->set_id(std::string(1, static_cast<char>('a' + i)));
+      auto* line_segment =
+          lane.mutable_central_curve()->add_segment()->mutable_line_segment();
+      for (int j = 0; j <= 10; ++j) {
+        auto* point = line_segment->add_point();
+        point->set_x(100.0 * i + 10.0 * j);
+        point->set_y(0.0);
+      }
+      lane.set_length(100.0);
+      auto* left_sample = lane.add_left_sample();
+      left_sample->set_s(0.0);
+      left_sample->set_width(1.75);
+      auto* right_sample = lane.add_right_sample();
+      right_sample->set_s(0.0);
+      right_sample->set_width(1.75);
+      lanes_.emplace_back(new LaneInfo(lane));
+    }
+  }
+
+ protected:
+  // route segments along lanes_[first_lane], lanes_[first_lane + 1], ...
+  // from start_s on the first lane to end_s on the last one
+  RouteSegments MakeSegments(const int first_lane, const int last_lane,
+                             const double start_s, const double end_s) const {
+    RouteSegments segments;
+    for (int i = first_lane; i <= last_lane; ++i) {
+      segments.emplace_back(lanes_[i], i == first_lane ? start_s : 0.0,
+                            i == last_lane ? end_s : 100.0);
+    }
+    return segments;
+  }
+
+  common::VehicleState MakeVehicleState(const double x) const {
+    common::VehicleState vehicle_state;
+    vehicle_state.set_x(x);
+    vehicle_state.set_y(0.0);
+    return vehicle_state;
+  }
+
+  // smooth segments in a planning cycle, and check the reference line
+  // before shrinking against the raw one
+  void Smooth(const RouteSegments& segments, const bool is_new_routing) {
+    std::list<ReferenceLine> reference_lines;
+    std::list<RouteSegments> route_segments = {segments};
+    provider_.SmoothRouteSegments(MakeVehicleState(30.0), is_new_routing,
+                                  &reference_lines, &route_segments);
+    EXPECT_EQ(1, reference_lines.size());
+    ASSERT_EQ(1, provider_.smoothing_cache_.size());
+    ExpectSameReferenceLine(ReferenceLine(hdmap::Path(segments)),
+                            provider_.smoothing_cache_.front().reference_line);
+  }
+
+  void ExpectSameReferenceLine(const ReferenceLine& expected,
+                               const ReferenceLine& reference_line) const {
+    EXPECT_NEAR(expected.Length(), reference_line.Length(), 1e-3);
+    for (double s = 0.0; s < expected.Length(); s += 10.0) {
+      const auto expected_point = expected.GetReferencePoint(s);
+      const auto point = reference_line.GetReferencePoint(s);
+      EXPECT_NEAR(expected_point.x(), point.x(), 1e-3);
+      EXPECT_NEAR(expected_point.y(), point.y(), 1e-3);
+    }
+  }
+
+  // referred to by lanes_
+  std::vector<hdmap::Lane> lane_protos_;
+  std::vector<LaneInfoConstPtr> lanes_;
+  ReferenceLineProvider provider_;
+};
+
+TEST_F(ReferenceLineProviderTest, CoveredLength) {
+  const RouteSegments cached = MakeSegments(0, 1, 0.0, 100.0);
+  // a prefix ending before the cached segments
+  EXPECT_NEAR(140.0, ReferenceLineProvider::CoveredLength(
+                         cached, MakeSegments(0, 1, 20.0, 60.0)),
+              1e-6);
+  // extended beyond the cached segments
+  EXPECT_NEAR(180.0, ReferenceLineProvider::CoveredLength(
+                         cached, MakeSegments(0, 2, 20.0, 50.0)),
+              1e-6);
+  // starting on a later cached lane
+  EXPECT_NEAR(90.0, ReferenceLineProvider::CoveredLength(
+                        cached, MakeSegments(1, 2, 10.0, 50.0)),
+              1e-6);
+  // not starting on the cached segments
+  EXPECT_DOUBLE_EQ(0.0, ReferenceLineProvider::CoveredLength(
+                            cached, MakeSegments(2, 2, 0.0, 50.0)));
+  EXPECT_DOUBLE_EQ(0.0, ReferenceLineProvider::CoveredLength(
+                            MakeSegments(0, 1, 50.0, 100.0),
+                            MakeSegments(0, 1, 20.0, 100.0)));
+  // leaving the cached lanes
+  RouteSegments other_lane = MakeSegments(0, 0, 20.0, 100.0);
+  other_lane.emplace_back(lanes_[2], 0.0, 50.0);
+  EXPECT_DOUBLE_EQ(0.0,
+                   ReferenceLineProvider::CoveredLength(cached, other_lane));
+  EXPECT_DOUBLE_EQ(0.0, ReferenceLineProvider::CoveredLength(
+                            RouteSegments(), MakeSegments(0, 1, 0.0, 100.0)));
+}
+
+TEST_F(ReferenceLineProviderTest, CutReferenceLine) {
+  const RouteSegments cached = MakeSegments(0, 1, 0.0, 100.0);
+  const RouteSegments segments = MakeSegments(0, 1, 10.0, 50.0);
+  const hdmap::Path path(cached);
+  ReferenceLine reference_line(path);
+  EXPECT_TRUE(ReferenceLineProvider::CutReferenceLine(segments, 100.0,
+                                                      &reference_line));
+  EXPECT_NEAR(100.0, reference_line.Length(), 1e-3);
+  EXPECT_NEAR(10.0, reference_line.reference_points().front().x(), 1e-3);
+  EXPECT_NEAR(110.0, reference_line.reference_points().back().x(), 1e-3);
+
+  // beyond the end of segments
+  ReferenceLine other_reference_line(path);
+  EXPECT_FALSE(ReferenceLineProvider::CutReferenceLine(
+      segments, 150.0, &other_reference_line));
+}
+
+TEST_F(ReferenceLineProviderTest, SmoothingCache) {
+  Smooth(MakeSegments(0, 1, 0.0, 100.0), true);
+  auto stats = provider_.GetSmoothingCacheStats();
+  EXPECT_EQ(0, stats.num_hits);
+  EXPECT_EQ(0, stats.num_partial_hits);
+  EXPECT_EQ(1, stats.num_misses);
+
+  // moved forward within the cached reference line
+  const RouteSegments shifted = MakeSegments(0, 1, 20.0, 100.0);
+  Smooth(shifted, false);
+  stats = provider_.GetSmoothingCacheStats();
+  EXPECT_EQ(1, stats.num_hits);
+  EXPECT_EQ(1, stats.num_misses);
+
+  // extended beyond the cached reference line by more than the overlap
+  const RouteSegments extended = MakeSegments(0, 2, 20.0, 50.0);
+  ASSERT_GT(180.0, FLAGS_reference_line_stitch_overlap_distance);
+  Smooth(extended, false);
+  stats = provider_.GetSmoothingCacheStats();
+  EXPECT_EQ(1, stats.num_hits);
+  EXPECT_EQ(1, stats.num_partial_hits);
+  EXPECT_EQ(1, stats.num_misses);
+
+  // a new routing invalidates the cache
+  Smooth(extended, true);
+  stats = provider_.GetSmoothingCacheStats();
+  EXPECT_EQ(1, stats.num_hits);
+  EXPECT_EQ(1, stats.num_partial_hits);
+  EXPECT_EQ(2, stats.num_misses);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRate());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -97,6 +97,26 @@ Stage::StageStatus LaneFollowStage::Process(
   ADEBUG << "Number of reference lines:\t"
          << frame->mutable_reference_line_info()->size();
 
+  // In concurrent mode the reference lines are planned up front, up to the
+  // first one taken; the loop below then picks it as in sequential mode.
+  const bool is_concurrent = CanPlanReferenceLinesConcurrently(*frame);
+  std::vector<Status> concurrent_status;
+  if (is_concurrent) {
+    concurrent_status = PlanOnReferenceLinesConcurrently(
+        frame,
+        [&](const std::vector<Task*>& task_list,
+            ReferenceLineInfo* reference_line_info) {
+          return PlanOnReferenceLine(task_list, planning_start_point, frame,
+                                     reference_line_info);
+        },
+        [&](ReferenceLineInfo* reference_line_info) {
+          return !reference_line_info->IsChangeLanePath() ||
+                 IsLaneChangeAccepted(reference_line_info);
+        });
+  }
+
+  std::vector<ReferenceLineInfo*> planned_reference_line_infos;
+  std::vector<double> time_diff_ms;
   unsigned int count = 0;
 
   for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
@@ -112,19 +132,24 @@ Stage::StageStatus LaneFollowStage::Process(
       break;
     }
 
-    auto cur_status =
-        PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
+    Status cur_status;
+    if (is_concurrent) {
+      cur_status = concurrent_status[count - 1];
+    } else {
+      const double start_timestamp = Clock::NowInSeconds();
+      cur_status = PlanOnReferenceLine(planning_start_point, frame,
+                                       &reference_line_info);
+      planned_reference_line_infos.push_back(&reference_line_info);
+      time_diff_ms.push_back((Clock::NowInSeconds() - start_timestamp) *
+                             1000);
+    }
 
     if (cur_status.ok()) {
       if (reference_line_info.IsChangeLanePath()) {
         ADEBUG << "reference line is lane change ref.";
         ADEBUG << "FLAGS_enable_smarter_lane_change: "
                << FLAGS_enable_smarter_lane_change;
-        if (reference_line_info.Cost() < kStraightForwardLineCost &&
-            (LaneChangeDecider::IsClearToChangeLane(&reference_line_info) ||
-             FLAGS_enable_smarter_lane_change)) {
-          // If the path and speed optimization succeed on target lane while
-          // under smart lane-change or IsClearToChangeLane under older version
+        if (IsLaneChangeAccepted(&reference_line_info)) {
           has_drivable_reference_line = true;
           reference_line_info.SetDrivable(true);
           LaneChangeDecider::UpdatePreparationDistance(
@@ -146,13 +171,35 @@ Stage::StageStatus LaneFollowStage::Process(
     }
   }
 
+  if (!is_concurrent) {
+    RecordReferenceLineStats(planned_reference_line_infos, time_diff_ms,
+                             false);
+  }
+
   return has_drivable_reference_line ? StageStatus::RUNNING
                                      : StageStatus::ERROR;
 }
 
+bool LaneFollowStage::IsLaneChangeAccepted(
+    ReferenceLineInfo* reference_line_info) const {
+  // If the path and speed optimization succeed on target lane while
+  // under smart lane-change or IsClearToChangeLane under older version
+  return reference_line_info->Cost() < kStraightForwardLineCost &&
+         (LaneChangeDecider::IsClearToChangeLane(reference_line_info) ||
+          FLAGS_enable_smarter_lane_change);
+}
+
 Status LaneFollowStage::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
+  return PlanOnReferenceLine(task_list_, planning_start_point, frame,
+                             reference_line_info);
+}
+
+Status LaneFollowStage::PlanOnReferenceLine(
+    const std::vector<Task*>& task_list,
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info) {
   if (!reference_line_info->IsChangeLanePath()) {
     reference_line_info->AddCost(kStraightForwardLineCost);
   }
@@ -161,10 +208,10 @@ Status LaneFollowStage::PlanOnReferenceLine(
          << reference_line_info->IsChangeLanePath();
 
   auto ret = Status::OK();
-  for (auto* task : task_list_) {
+  for (auto* task : task_list) {
     const double start_timestamp = Clock::NowInSeconds();
 
-    ret = task->Execute(frame, reference_line_info);
+    ret = ExecuteTask(task, frame, reference_line_info);
 
     const double end_timestamp = Clock::NowInSeconds();
     const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
@@ -187,6 +234,12 @@ Status LaneFollowStage::PlanOnReferenceLine(
     //        << reference_line_info->IsChangeLanePath();
   }
 
+  // no fallback for a reference line given up since an earlier one is taken
+  if (IsReferenceLinePlanningCancelled(reference_line_info)) {
+    return Status(ErrorCode::PLANNING_ERROR,
+                  "reference line planning cancelled");
+  }
+
   RecordObstacleDebugInfo(reference_line_info);
 
   // check path and speed results for path or speed fallback
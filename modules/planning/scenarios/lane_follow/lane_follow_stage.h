@@ -53,6 +53,11 @@ class LaneFollowStage : public Stage {
       const common::TrajectoryPoint& planning_start_point, Frame* frame,
       ReferenceLineInfo* reference_line_info);
 
+  common::Status PlanOnReferenceLine(
+      const std::vector<Task*>& task_list,
+      const common::TrajectoryPoint& planning_start_point, Frame* frame,
+      ReferenceLineInfo* reference_line_info);
+
   void PlanFallbackTrajectory(
       const common::TrajectoryPoint& planning_start_point, Frame* frame,
       ReferenceLineInfo* reference_line_info);
@@ -70,6 +75,12 @@ class LaneFollowStage : public Stage {
   void RecordObstacleDebugInfo(ReferenceLineInfo* reference_line_info);
 
  private:
+  /**
+   * @brief Whether a successfully planned lane change reference line may be
+   * taken.
+   */
+  bool IsLaneChangeAccepted(ReferenceLineInfo* reference_line_info) const;
+
   ScenarioConfig config_;
   std::unique_ptr<Stage> stage_;
 };
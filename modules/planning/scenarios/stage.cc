@@ -20,11 +20,15 @@
 
 #include "modules/planning/scenarios/stage.h"
 
+#include <algorithm>
+#include <future>
 #include <unordered_map>
 #include <utility>
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/time/clock.h"
 #include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/common/speed_profile_generator.h"
 #include "modules/planning/common/trajectory/publishable_trajectory.h"
 #include "modules/planning/tasks/task_factory.h"
@@ -39,6 +43,51 @@ namespace {
 // constexpr double kPathOptimizationFallbackCost = 2e4;
 constexpr double kSpeedOptimizationFallbackCost = 2e4;
 // constexpr double kStraightForwardLineCost = 10.0;
+
+// Tasks which may plan several reference lines of a frame at the same time.
+// Besides their reference line info, they only write to the planning context,
+// of which each reference line planned concurrently has a copy, and to the
+// obstacle projection cache, which has a lock. They read the frame, its
+// obstacles and the other reference lines, the frame history, the history,
+// the ego info, the vehicle state and the learning based data, none of which
+// a task of the list writes while the lines are planned. LANE_CHANGE_DECIDER
+// is one of them as long as it does not reorder the reference lines.
+bool IsReferenceLineTask(const TaskConfig::TaskType task_type) {
+  switch (task_type) {
+    case TaskConfig::LANE_CHANGE_DECIDER:
+    case TaskConfig::PATH_LANE_BORROW_DECIDER:
+    case TaskConfig::PATH_BOUNDS_DECIDER:
+    case TaskConfig::PIECEWISE_JERK_PATH_OPTIMIZER:
+    case TaskConfig::PATH_ASSESSMENT_DECIDER:
+    case TaskConfig::PATH_DECIDER:
+    case TaskConfig::ST_BOUNDS_DECIDER:
+    case TaskConfig::SPEED_BOUNDS_PRIORI_DECIDER:
+    case TaskConfig::SPEED_BOUNDS_FINAL_DECIDER:
+    case TaskConfig::SPEED_HEURISTIC_OPTIMIZER:
+    case TaskConfig::SPEED_DECIDER:
+    case TaskConfig::PIECEWISE_JERK_SPEED_OPTIMIZER:
+    case TaskConfig::PIECEWISE_JERK_NONLINEAR_SPEED_OPTIMIZER:
+    case TaskConfig::RSS_DECIDER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Tasks which keep static state shared by all their instances, across
+// reference lines and frames. RULE_BASED_STOP_DECIDER also adds stop
+// obstacles to the frame, which no reference line task reads.
+bool IsSerializedTask(const TaskConfig::TaskType task_type) {
+  return task_type == TaskConfig::PATH_REUSE_DECIDER ||
+         task_type == TaskConfig::PATH_REFERENCE_DECIDER ||
+         task_type == TaskConfig::RULE_BASED_STOP_DECIDER;
+}
+
+cyber::base::ThreadPool* ReferenceLinePlanningThreadPool() {
+  static cyber::base::ThreadPool thread_pool(
+      std::max(1, FLAGS_reference_line_planning_thread_num));
+  return &thread_pool;
+}
 }  // namespace
 
 Stage::Stage(const ScenarioConfig::StageConfig& config,
@@ -52,25 +101,32 @@ Stage::Stage(const ScenarioConfig::StageConfig& config,
 
   name_ = StageType_Name(config_.stage_type());
   next_stage_ = config_.stage_type();
+  task_list_ = CreateTaskList(&tasks_);
+}
+
+std::vector<Task*> Stage::CreateTaskList(
+    std::map<TaskConfig::TaskType, std::unique_ptr<Task>>* tasks) const {
   std::unordered_map<TaskConfig::TaskType, const TaskConfig*, std::hash<int>>
       config_map;
   for (const auto& task_config : config_.task_config()) {
     config_map[task_config.task_type()] = &task_config;
   }
+  std::vector<Task*> task_list;
   for (int i = 0; i < config_.task_type_size(); ++i) {
     auto task_type = config_.task_type(i);
     ACHECK(config_map.find(task_type) != config_map.end())
         << "Task: " << TaskConfig::TaskType_Name(task_type)
         << " used but not configured";
-    auto iter = tasks_.find(task_type);
-    if (iter == tasks_.end()) {
+    auto iter = tasks->find(task_type);
+    if (iter == tasks->end()) {
       auto ptr = TaskFactory::CreateTask(*config_map[task_type], injector_);
-      task_list_.push_back(ptr.get());
-      tasks_[task_type] = std::move(ptr);
+      task_list.push_back(ptr.get());
+      (*tasks)[task_type] = std::move(ptr);
     } else {
-      task_list_.push_back(iter->second.get());
+      task_list.push_back(iter->second.get());
     }
   }
+  return task_list;
 }
 
 const std::string& Stage::Name() const { return name_; }
@@ -133,6 +189,168 @@ bool Stage::ExecuteTaskOnReferenceLine(
   return true;
 }
 
+bool Stage::CanPlanReferenceLinesConcurrently(const Frame& frame) const {
+  if (!FLAGS_enable_parallel_reference_line_planning ||
+      frame.reference_line_info().size() < 2) {
+    return false;
+  }
+  // The reference lines after the first one are only planned when it is a
+  // lane change, otherwise they would be planned for nothing.
+  if (!frame.reference_line_info().front().IsChangeLanePath()) {
+    return false;
+  }
+  // The lane change urgency check of RuleBasedStopDecider reads the results
+  // of the other reference lines.
+  if (FLAGS_enable_lane_change_urgency_checking &&
+      FindTask(TaskConfig::RULE_BASED_STOP_DECIDER) != nullptr) {
+    return false;
+  }
+  for (const auto* task : task_list_) {
+    const auto task_type = task->Config().task_type();
+    if (!IsReferenceLineTask(task_type) && !IsSerializedTask(task_type)) {
+      ADEBUG << "Task " << task->Name()
+             << " can not plan reference lines concurrently";
+      return false;
+    }
+    if (task_type == TaskConfig::LANE_CHANGE_DECIDER) {
+      const auto& lane_change_decider_config =
+          task->Config().lane_change_decider_config();
+      if (lane_change_decider_config.enable_prioritize_change_lane() ||
+          lane_change_decider_config.reckless_change_lane()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<common::Status> Stage::PlanOnReferenceLinesConcurrently(
+    Frame* frame, const ReferenceLinePlanner& planner,
+    const ReferenceLineSelector& selector) {
+  concurrent_reference_line_infos_.clear();
+  for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+    concurrent_reference_line_infos_.push_back(&reference_line_info);
+  }
+  const size_t num_reference_lines = concurrent_reference_line_infos_.size();
+  while (concurrent_task_lists_.size() + 1 < num_reference_lines) {
+    concurrent_tasks_.emplace_back();
+    concurrent_task_lists_.push_back(
+        CreateTaskList(&concurrent_tasks_.back()));
+  }
+  concurrent_planning_contexts_.assign(num_reference_lines,
+                                       *injector_->planning_context());
+  concurrent_reference_line_states_.assign(num_reference_lines,
+                                           ReferenceLineState::PLANNING);
+
+  std::vector<common::Status> statuses(num_reference_lines);
+  std::vector<double> time_diff_ms(num_reference_lines, 0.0);
+  auto plan_on_reference_line = [&](const size_t index) {
+    DependencyInjector::ScopedPlanningContext scoped_planning_context(
+        injector_.get(), &concurrent_planning_contexts_[index]);
+    auto* reference_line_info = concurrent_reference_line_infos_[index];
+    const double start_timestamp = Clock::NowInSeconds();
+    statuses[index] = planner(
+        index == 0 ? task_list_ : concurrent_task_lists_[index - 1],
+        reference_line_info);
+    time_diff_ms[index] = (Clock::NowInSeconds() - start_timestamp) * 1000;
+    const bool is_taken = statuses[index].ok() && selector(reference_line_info);
+    {
+      std::lock_guard<std::mutex> lock(reference_line_mutex_);
+      concurrent_reference_line_states_[index] =
+          is_taken ? ReferenceLineState::TAKEN : ReferenceLineState::NOT_TAKEN;
+    }
+    reference_line_cv_.notify_all();
+  };
+
+  // The pool runs its tasks in order, so that a reference line never waits
+  // for one queued after it. Lines the pool refuses run after the first one.
+  auto* thread_pool = ReferenceLinePlanningThreadPool();
+  std::vector<std::future<void>> futures;
+  std::vector<size_t> inline_indices;
+  for (size_t i = 1; i < num_reference_lines; ++i) {
+    auto future = thread_pool->Enqueue(plan_on_reference_line, i);
+    if (future.valid()) {
+      futures.push_back(std::move(future));
+    } else {
+      inline_indices.push_back(i);
+    }
+  }
+  plan_on_reference_line(0);
+  for (const size_t index : inline_indices) {
+    plan_on_reference_line(index);
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  size_t committed_index = num_reference_lines - 1;
+  for (size_t i = 0; i < num_reference_lines; ++i) {
+    if (concurrent_reference_line_states_[i] == ReferenceLineState::TAKEN) {
+      committed_index = i;
+      break;
+    }
+  }
+  *injector_->planning_context() =
+      concurrent_planning_contexts_[committed_index];
+
+  RecordReferenceLineStats(concurrent_reference_line_infos_, time_diff_ms,
+                           true);
+  concurrent_reference_line_infos_.clear();
+  concurrent_reference_line_states_.clear();
+  return statuses;
+}
+
+bool Stage::IsReferenceLinePlanningCancelled(
+    const ReferenceLineInfo* reference_line_info) {
+  const size_t index = ConcurrentReferenceLineIndex(reference_line_info);
+  if (index >= concurrent_reference_line_infos_.size()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(reference_line_mutex_);
+  return IsEarlierReferenceLineTaken(index);
+}
+
+common::Status Stage::ExecuteTask(Task* task, Frame* frame,
+                                  ReferenceLineInfo* reference_line_info) {
+  const size_t index = ConcurrentReferenceLineIndex(reference_line_info);
+  if (index > 0 && index < concurrent_reference_line_infos_.size()) {
+    std::unique_lock<std::mutex> lock(reference_line_mutex_);
+    if (IsSerializedTask(task->Config().task_type())) {
+      reference_line_cv_.wait(lock, [this, index]() {
+        return IsEarlierReferenceLineTaken(index) ||
+               AreEarlierReferenceLinesPlanned(index);
+      });
+    }
+    if (IsEarlierReferenceLineTaken(index)) {
+      return common::Status(common::ErrorCode::PLANNING_ERROR,
+                            "reference line planning cancelled");
+    }
+  }
+  return task->Execute(frame, reference_line_info);
+}
+
+size_t Stage::ConcurrentReferenceLineIndex(
+    const ReferenceLineInfo* reference_line_info) const {
+  return std::find(concurrent_reference_line_infos_.begin(),
+                   concurrent_reference_line_infos_.end(),
+                   reference_line_info) -
+         concurrent_reference_line_infos_.begin();
+}
+
+bool Stage::IsEarlierReferenceLineTaken(const size_t index) const {
+  return std::find(concurrent_reference_line_states_.begin(),
+                   concurrent_reference_line_states_.begin() + index,
+                   ReferenceLineState::TAKEN) !=
+         concurrent_reference_line_states_.begin() + index;
+}
+
+bool Stage::AreEarlierReferenceLinesPlanned(const size_t index) const {
+  return std::find(concurrent_reference_line_states_.begin(),
+                   concurrent_reference_line_states_.begin() + index,
+                   ReferenceLineState::PLANNING) ==
+         concurrent_reference_line_states_.begin() + index;
+}
+
 bool Stage::ExecuteTaskOnReferenceLineForOnlineLearning(
     const common::TrajectoryPoint& planning_start_point, Frame* frame) {
   // online learning mode
@@ -236,6 +454,25 @@ void Stage::RecordDebugInfo(ReferenceLineInfo* reference_line_info,
   ptr_stats->set_time_ms(time_diff_ms);
 }
 
+void Stage::RecordReferenceLineStats(
+    const std::vector<ReferenceLineInfo*>& reference_line_infos,
+    const std::vector<double>& time_diff_ms, const bool is_concurrent) {
+  if (!FLAGS_enable_record_debug) {
+    ADEBUG << "Skip record debug info";
+    return;
+  }
+  for (size_t i = 0; i < reference_line_infos.size(); ++i) {
+    auto* ptr_stats = reference_line_infos[i]
+                          ->mutable_latency_stats()
+                          ->add_reference_line_stats();
+    ptr_stats->set_id(reference_line_infos[i]->Lanes().Id());
+    ptr_stats->set_is_change_lane_path(
+        reference_line_infos[i]->IsChangeLanePath());
+    ptr_stats->set_time_ms(i < time_diff_ms.size() ? time_diff_ms[i] : 0.0);
+    ptr_stats->set_is_concurrent(is_concurrent);
+  }
+}
+
 }  // namespace scenario
 }  // namespace planning
 }  // namespace apollo
@@ -20,8 +20,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -81,9 +84,57 @@ class Stage {
   StageType NextStage() const { return next_stage_; }
 
  protected:
+  /**
+   * @brief Runs a task list on one reference line and returns the status.
+   */
+  using ReferenceLinePlanner = std::function<common::Status(
+      const std::vector<Task*>& task_list,
+      ReferenceLineInfo* reference_line_info)>;
+
   bool ExecuteTaskOnReferenceLine(
       const common::TrajectoryPoint& planning_start_point, Frame* frame);
 
+  /**
+   * @brief Whether a reference line planned with a status ok is taken, in
+   * which case the reference lines after it are not planned.
+   */
+  using ReferenceLineSelector =
+      std::function<bool(ReferenceLineInfo* reference_line_info)>;
+
+  /**
+   * @brief Whether the reference lines of the frame may be planned by
+   * PlanOnReferenceLinesConcurrently(): only when every task of the stage
+   * is known to plan one reference line without touching the others.
+   */
+  bool CanPlanReferenceLinesConcurrently(const Frame& frame) const;
+
+  /**
+   * @brief Plans the reference lines of the frame at the same time, the
+   * first one on the calling thread and the others on a bounded worker pool,
+   * each with its own task instances and its own copy of the planning
+   * context taken at the start of the frame.
+   *
+   * The tasks see the reference lines the way a sequential loop which stops
+   * at the first taken line does: a reference line stops at its next task
+   * once a line before it is taken, and tasks with static state run on a
+   * reference line only after every line before it finished, none of them
+   * taken. The planning context of the first taken line, or of the last
+   * line if none is taken, becomes the current one.
+   *
+   * @return The status of each reference line, in the order of
+   * frame->reference_line_info(). Lines which were stopped have an error.
+   */
+  std::vector<common::Status> PlanOnReferenceLinesConcurrently(
+      Frame* frame, const ReferenceLinePlanner& planner,
+      const ReferenceLineSelector& selector);
+
+  /**
+   * @brief Whether the planning of the reference line was stopped by
+   * PlanOnReferenceLinesConcurrently() since a line before it was taken.
+   */
+  bool IsReferenceLinePlanningCancelled(
+      const ReferenceLineInfo* reference_line_info);
+
   bool ExecuteTaskOnReferenceLineForOnlineLearning(
       const common::TrajectoryPoint& planning_start_point, Frame* frame);
 
@@ -94,6 +145,25 @@ class Stage {
   void RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                        const std::string& name, const double time_diff_ms);
 
+  /**
+   * @brief Executes a task on a reference line, in the order described by
+   * PlanOnReferenceLinesConcurrently() when called from its planner.
+   */
+  common::Status ExecuteTask(Task* task, Frame* frame,
+                             ReferenceLineInfo* reference_line_info);
+
+  /**
+   * @brief Records the planning time of each reference line in its own
+   * latency stats.
+   */
+  void RecordReferenceLineStats(
+      const std::vector<ReferenceLineInfo*>& reference_line_infos,
+      const std::vector<double>& time_diff_ms, const bool is_concurrent);
+
+ private:
+  std::vector<Task*> CreateTaskList(
+      std::map<TaskConfig::TaskType, std::unique_ptr<Task>>* tasks) const;
+
  protected:
   std::map<TaskConfig::TaskType, std::unique_ptr<Task>> tasks_;
   std::vector<Task*> task_list_;
@@ -102,6 +172,30 @@ class Stage {
   void* context_ = nullptr;
   std::string name_;
   std::shared_ptr<DependencyInjector> injector_;
+
+ private:
+  enum class ReferenceLineState { PLANNING, TAKEN, NOT_TAKEN };
+
+  // Index of the reference line in concurrent_reference_line_infos_, or
+  // the number of lines if it is not planned concurrently.
+  size_t ConcurrentReferenceLineIndex(
+      const ReferenceLineInfo* reference_line_info) const;
+  // Must be called with reference_line_mutex_ held.
+  bool IsEarlierReferenceLineTaken(const size_t index) const;
+  bool AreEarlierReferenceLinesPlanned(const size_t index) const;
+
+  // Task instances of the reference lines planned after the first one,
+  // which always runs with task_list_.
+  std::vector<std::map<TaskConfig::TaskType, std::unique_ptr<Task>>>
+      concurrent_tasks_;
+  std::vector<std::vector<Task*>> concurrent_task_lists_;
+  std::vector<PlanningContext> concurrent_planning_contexts_;
+  // Set while PlanOnReferenceLinesConcurrently() runs, the states are
+  // guarded by reference_line_mutex_.
+  std::vector<ReferenceLineInfo*> concurrent_reference_line_infos_;
+  std::vector<ReferenceLineState> concurrent_reference_line_states_;
+  std::mutex reference_line_mutex_;
+  std::condition_variable reference_line_cv_;
 };
 
 #define DECLARE_STAGE(NAME, CONTEXT)                          \
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/scenarios/stage.h"
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+namespace scenario {
+
+using apollo::common::Status;
+
+namespace {
+
+constexpr double kTakenCost = 10.0;
+
+TaskConfig MakeTaskConfig(const TaskConfig::TaskType task_type) {
+  TaskConfig config;
+  config.set_task_type(task_type);
+  return config;
+}
+
+// Writes the id of its reference line to the planning context and adds the
+// cost configured for it, after sleeping for the given time.
+class FakeReferenceLineTask : public Task {
+ public:
+  FakeReferenceLineTask(const std::shared_ptr<DependencyInjector>& injector,
+                        const double cost, const int sleep_ms)
+      : Task(MakeTaskConfig(TaskConfig::PATH_BOUNDS_DECIDER), injector),
+        cost_(cost),
+        sleep_ms_(sleep_ms) {}
+
+  Status Execute(Frame* frame,
+                 ReferenceLineInfo* reference_line_info) override {
+    Task::Execute(frame, reference_line_info);
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+    injector_->planning_context()
+        ->mutable_planning_status()
+        ->mutable_change_lane()
+        ->set_path_id(reference_line_info->Lanes().Id());
+    reference_line_info->AddCost(cost_);
+    return Status::OK();
+  }
+
+ private:
+  double cost_ = 0.0;
+  int sleep_ms_ = 0;
+};
+
+// Keeps static state like PathReuseDecider: logs its reference lines and
+// adds the number of lines it saw before as cost.
+class FakeSerializedTask : public Task {
+ public:
+  explicit FakeSerializedTask(
+      const std::shared_ptr<DependencyInjector>& injector)
+      : Task(MakeTaskConfig(TaskConfig::PATH_REUSE_DECIDER), injector) {}
+
+  Status Execute(Frame* frame,
+                 ReferenceLineInfo* reference_line_info) override {
+    Task::Execute(frame, reference_line_info);
+    reference_line_info->AddCost(static_cast<double>(log_.size()));
+    log_.push_back(reference_line_info->Lanes().Id());
+    return Status::OK();
+  }
+
+  static std::vector<std::string> log_;
+};
+
+std::vector<std::string> FakeSerializedTask::log_;
+
+class TestStage : public Stage {
+ public:
+  TestStage(const ScenarioConfig::StageConfig& config,
+            const std::shared_ptr<DependencyInjector>& injector)
+      : Stage(config, injector) {}
+
+  StageStatus Process(const common::TrajectoryPoint& planning_init_point,
+                      Frame* frame) override {
+    return StageStatus::RUNNING;
+  }
+
+  void SetTaskList(const std::vector<Task*>& task_list) {
+    task_list_ = task_list;
+  }
+
+  using Stage::CanPlanReferenceLinesConcurrently;
+  using Stage::ExecuteTask;
+  using Stage::IsReferenceLinePlanningCancelled;
+  using Stage::PlanOnReferenceLinesConcurrently;
+};
+
+struct PlanningResult {
+  std::vector<bool> is_ok;
+  std::vector<double> costs;
+  std::vector<std::string> serialized_log;
+  std::string committed_path_id;
+};
+
+}  // namespace
+
+class StageTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    FLAGS_enable_parallel_reference_line_planning = true;
+    config_.set_stage_type(StageType::LANE_FOLLOW_DEFAULT_STAGE);
+    injector_ = std::make_shared<DependencyInjector>();
+    stage_.reset(new TestStage(config_, injector_));
+  }
+
+ protected:
+  // Reference lines "0", "1", ... with the given costs, the first one a
+  // lane change unless told otherwise and the others not.
+  void AddReferenceLines(const std::vector<double>& costs, Frame* frame,
+                         const bool is_first_lane_change = true) {
+    for (size_t i = 0; i < costs.size(); ++i) {
+      hdmap::RouteSegments segments;
+      segments.SetId(std::to_string(i));
+      segments.SetIsOnSegment(i > 0 || !is_first_lane_change);
+      frame->mutable_reference_line_info()->emplace_back(
+          common::VehicleState(), common::TrajectoryPoint(), ReferenceLine(),
+          segments);
+      // the first reference line is the slowest one to plan
+      tasks_.emplace_back();
+      tasks_.back().emplace_back(
+          new FakeReferenceLineTask(injector_, costs[i], i == 0 ? 20 : 0));
+      tasks_.back().emplace_back(new FakeSerializedTask(injector_));
+      tasks_.back().emplace_back(
+          new FakeReferenceLineTask(injector_, 0.0, 0));
+    }
+  }
+
+  Status PlanOnReferenceLine(Frame* frame,
+                             ReferenceLineInfo* reference_line_info) {
+    const int index = std::stoi(reference_line_info->Lanes().Id());
+    for (const auto& task : tasks_[index]) {
+      const auto ret =
+          stage_->ExecuteTask(task.get(), frame, reference_line_info);
+      if (!ret.ok()) {
+        return ret;
+      }
+    }
+    if (stage_->IsReferenceLinePlanningCancelled(reference_line_info)) {
+      return Status(common::ErrorCode::PLANNING_ERROR, "cancelled");
+    }
+    return Status::OK();
+  }
+
+  PlanningResult Plan(const std::vector<double>& costs,
+                      const bool is_concurrent) {
+    FakeSerializedTask::log_.clear();
+    tasks_.clear();
+    injector_->planning_context()->Clear();
+    Frame frame(1);
+    AddReferenceLines(costs, &frame);
+    auto is_taken = [](ReferenceLineInfo* reference_line_info) {
+      return reference_line_info->Cost() < kTakenCost;
+    };
+
+    PlanningResult result;
+    if (is_concurrent) {
+      EXPECT_TRUE(stage_->CanPlanReferenceLinesConcurrently(frame));
+      const auto statuses = stage_->PlanOnReferenceLinesConcurrently(
+          &frame,
+          [&](const std::vector<Task*>& task_list,
+              ReferenceLineInfo* reference_line_info) {
+            return PlanOnReferenceLine(&frame, reference_line_info);
+          },
+          is_taken);
+      // as the stage picks the reference line, up to the taken one
+      auto iter = frame.mutable_reference_line_info()->begin();
+      for (const auto& status : statuses) {
+        result.is_ok.push_back(status.ok());
+        result.costs.push_back(iter->Cost());
+        if (status.ok() && is_taken(&*iter)) {
+          break;
+        }
+        ++iter;
+      }
+    } else {
+      for (auto& reference_line_info : *frame.mutable_reference_line_info()) {
+        const auto status = PlanOnReferenceLine(&frame, &reference_line_info);
+        result.is_ok.push_back(status.ok());
+        result.costs.push_back(reference_line_info.Cost());
+        if (status.ok() && is_taken(&reference_line_info)) {
+          break;
+        }
+      }
+    }
+    result.serialized_log = FakeSerializedTask::log_;
+    result.committed_path_id = injector_->planning_context()
+                                   ->planning_status()
+                                   .change_lane()
+                                   .path_id();
+    return result;
+  }
+
+  void ExpectSameResults(const std::vector<double>& costs) {
+    const PlanningResult serial = Plan(costs, false);
+    const PlanningResult concurrent = Plan(costs, true);
+    EXPECT_EQ(serial.is_ok, concurrent.is_ok);
+    EXPECT_EQ(serial.costs, concurrent.costs);
+    EXPECT_EQ(serial.serialized_log, concurrent.serialized_log);
+    EXPECT_EQ(serial.committed_path_id, concurrent.committed_path_id);
+  }
+
+  ScenarioConfig::StageConfig config_;
+  std::shared_ptr<DependencyInjector> injector_;
+  std::unique_ptr<TestStage> stage_;
+  std::vector<std::vector<std::unique_ptr<Task>>> tasks_;
+};
+
+TEST_F(StageTest, CanPlanReferenceLinesConcurrently) {
+  Frame frame(1);
+  AddReferenceLines({20.0, 0.0}, &frame);
+  EXPECT_TRUE(stage_->CanPlanReferenceLinesConcurrently(frame));
+
+  FLAGS_enable_parallel_reference_line_planning = false;
+  EXPECT_FALSE(stage_->CanPlanReferenceLinesConcurrently(frame));
+  FLAGS_enable_parallel_reference_line_planning = true;
+
+  // reference line tasks and serialized tasks only
+  FakeSerializedTask serialized_task(injector_);
+  Task lane_change_task(MakeTaskConfig(TaskConfig::LANE_CHANGE_DECIDER),
+                        injector_);
+  stage_->SetTaskList({&lane_change_task, &serialized_task});
+  EXPECT_TRUE(stage_->CanPlanReferenceLinesConcurrently(frame));
+
+  Task learning_task(MakeTaskConfig(TaskConfig::LEARNING_MODEL_INFERENCE_TASK),
+                     injector_);
+  stage_->SetTaskList({&lane_change_task, &learning_task});
+  EXPECT_FALSE(stage_->CanPlanReferenceLinesConcurrently(frame));
+
+  // a lane change decider which reorders the reference lines
+  TaskConfig prioritize_config =
+      MakeTaskConfig(TaskConfig::LANE_CHANGE_DECIDER);
+  prioritize_config.mutable_lane_change_decider_config()
+      ->set_enable_prioritize_change_lane(true);
+  Task prioritize_task(prioritize_config, injector_);
+  stage_->SetTaskList({&prioritize_task});
+  EXPECT_FALSE(stage_->CanPlanReferenceLinesConcurrently(frame));
+  stage_->SetTaskList({});
+
+  // the first reference line is taken unless it is a lane change
+  Frame lane_follow_frame(2);
+  AddReferenceLines({0.0, 0.0}, &lane_follow_frame, false);
+  EXPECT_FALSE(stage_->CanPlanReferenceLinesConcurrently(lane_follow_frame));
+}
+
+TEST_F(StageTest, LaneChangeRejected) {
+  ExpectSameResults({20.0, 0.0});
+  const PlanningResult result = Plan({20.0, 0.0}, true);
+  EXPECT_EQ(result.serialized_log, std::vector<std::string>({"0", "1"}));
+  EXPECT_EQ(result.committed_path_id, "1");
+}
+
+TEST_F(StageTest, LaneChangeTaken) {
+  ExpectSameResults({0.0, 0.0});
+  // the second reference line is given up before its serialized task
+  const PlanningResult result = Plan({0.0, 0.0}, true);
+  EXPECT_EQ(result.is_ok, std::vector<bool>({true}));
+  EXPECT_EQ(result.serialized_log, std::vector<std::string>({"0"}));
+  EXPECT_EQ(result.committed_path_id, "0");
+}
+
+TEST_F(StageTest, NoReferenceLineTaken) {
+  ExpectSameResults({20.0, 20.0, 20.0});
+  const PlanningResult result = Plan({20.0, 20.0, 20.0}, true);
+  EXPECT_EQ(result.serialized_log,
+            std::vector<std::string>({"0", "1", "2"}));
+  EXPECT_EQ(result.committed_path_id, "2");
+}
+
+}  // namespace scenario
+}  // namespace planning
+}  // namespace apollo
@@ -24,13 +24,16 @@
 
 #include "absl/strings/str_cat.h"
 
+#include "cyber/time/clock.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/util/point_factory.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/path_boundary.h"
 #include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/util/parallel_for.h"
 #include "modules/planning/tasks/deciders/utils/path_decider_obstacle_utils.h"
+#include "modules/planning/tasks/utils/path_candidate_thread_pool.h"
 
 namespace apollo {
 namespace planning {
@@ -38,6 +41,7 @@ namespace planning {
 using apollo::common::ErrorCode;
 using apollo::common::Status;
 using apollo::common::VehicleConfigHelper;
+using apollo::cyber::Clock;
 using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::JunctionInfo;
 
@@ -72,43 +76,40 @@ Status PathBoundsDecider::Process(
   // Initialization.
   InitPathBoundsDecider(*frame, *reference_line_info);
 
+  // Without pull-over and lane-change, the fallback and the regular path
+  // boundaries are independent of each other.
+  auto* pull_over_status = injector_->planning_context()
+                               ->mutable_planning_status()
+                               ->mutable_pull_over();
+  const bool plan_pull_over_path = pull_over_status->plan_pull_over_path();
+  if (FLAGS_enable_parallel_path_candidates && !plan_pull_over_path &&
+      !(FLAGS_enable_smarter_lane_change &&
+        reference_line_info->IsChangeLanePath())) {
+    return GenerateCandidatePathBoundsConcurrently(reference_line_info);
+  }
+
   // Generate the fallback path boundary.
   PathBound fallback_path_bound;
+  double start_time = Clock::NowInSeconds();
   Status ret =
       GenerateFallbackPathBound(*reference_line_info, &fallback_path_bound);
+  RecordCandidateDebugInfo("fallback", Clock::NowInSeconds() - start_time,
+                           false, reference_line_info);
+  ret = AddFallbackPathBoundary(ret, fallback_path_bound,
+                                &candidate_path_boundaries);
   if (!ret.ok()) {
-    ADEBUG << "Cannot generate a fallback path bound.";
-    return Status(ErrorCode::PLANNING_ERROR, ret.error_message());
-  }
-  if (fallback_path_bound.empty()) {
-    const std::string msg = "Failed to get a valid fallback path boundary";
-    AERROR << msg;
-    return Status(ErrorCode::PLANNING_ERROR, msg);
-  }
-  if (!fallback_path_bound.empty()) {
-    CHECK_LE(adc_frenet_l_, std::get<2>(fallback_path_bound[0]));
-    CHECK_GE(adc_frenet_l_, std::get<1>(fallback_path_bound[0]));
-  }
-  // Update the fallback path boundary into the reference_line_info.
-  std::vector<std::pair<double, double>> fallback_path_bound_pair;
-  for (size_t i = 0; i < fallback_path_bound.size(); ++i) {
-    fallback_path_bound_pair.emplace_back(std::get<1>(fallback_path_bound[i]),
-                                          std::get<2>(fallback_path_bound[i]));
+    return ret;
   }
-  candidate_path_boundaries.emplace_back(std::get<0>(fallback_path_bound[0]),
-                                         kPathBoundsDeciderResolution,
-                                         fallback_path_bound_pair);
-  candidate_path_boundaries.back().set_label("fallback");
 
   // If pull-over is requested, generate pull-over path boundary.
-  auto* pull_over_status = injector_->planning_context()
-                               ->mutable_planning_status()
-                               ->mutable_pull_over();
-  const bool plan_pull_over_path = pull_over_status->plan_pull_over_path();
   if (plan_pull_over_path) {
     PathBound pull_over_path_bound;
+    start_time = Clock::NowInSeconds();
     Status ret = GeneratePullOverPathBound(*frame, *reference_line_info,
                                            &pull_over_path_bound);
+    RecordCandidateDebugInfo("regular/pullover",
+                             Clock::NowInSeconds() - start_time, false,
+                             reference_line_info);
     if (!ret.ok()) {
       AWARN << "Cannot generate a pullover path bound, do regular planning.";
     } else {
@@ -152,8 +153,12 @@ Status PathBoundsDecider::Process(
   if (FLAGS_enable_smarter_lane_change &&
       reference_line_info->IsChangeLanePath()) {
     PathBound lanechange_path_bound;
+    start_time = Clock::NowInSeconds();
     Status ret = GenerateLaneChangePathBound(*reference_line_info,
                                              &lanechange_path_bound);
+    RecordCandidateDebugInfo("regular/lanechange",
+                             Clock::NowInSeconds() - start_time, false,
+                             reference_line_info);
     if (!ret.ok()) {
       ADEBUG << "Cannot generate a lane-change path bound.";
       return Status(ErrorCode::PLANNING_ERROR, ret.error_message());
@@ -188,74 +193,27 @@ Status PathBoundsDecider::Process(
     return Status::OK();
   }
 
-  // Generate regular path boundaries.
-  std::vector<LaneBorrowInfo> lane_borrow_info_list;
-  lane_borrow_info_list.push_back(LaneBorrowInfo::NO_BORROW);
-
-  if (reference_line_info->is_path_lane_borrow()) {
-    const auto& path_decider_status =
-        injector_->planning_context()->planning_status().path_decider();
-    for (const auto& lane_borrow_direction :
-         path_decider_status.decided_side_pass_direction()) {
-      if (lane_borrow_direction == PathDeciderStatus::LEFT_BORROW) {
-        lane_borrow_info_list.push_back(LaneBorrowInfo::LEFT_BORROW);
-      } else if (lane_borrow_direction == PathDeciderStatus::RIGHT_BORROW) {
-        lane_borrow_info_list.push_back(LaneBorrowInfo::RIGHT_BORROW);
-      }
-    }
-  }
-
   // Try every possible lane-borrow option:
   // PathBound regular_self_path_bound;
   // bool exist_self_path_bound = false;
-  for (const auto& lane_borrow_info : lane_borrow_info_list) {
+  for (const auto& lane_borrow_info :
+       GetLaneBorrowInfoList(*reference_line_info)) {
     PathBound regular_path_bound;
     std::string blocking_obstacle_id = "";
     std::string borrow_lane_type = "";
+    start_time = Clock::NowInSeconds();
     Status ret = GenerateRegularPathBound(
         *reference_line_info, lane_borrow_info, &regular_path_bound,
         &blocking_obstacle_id, &borrow_lane_type);
+    RecordCandidateDebugInfo(
+        RegularPathLabel(lane_borrow_info, borrow_lane_type),
+        Clock::NowInSeconds() - start_time, false, reference_line_info);
     if (!ret.ok()) {
       continue;
     }
-    if (regular_path_bound.empty()) {
-      continue;
-    }
-    // disable this change when not extending lane bounds to include adc
-    if (config_.path_bounds_decider_config()
-            .is_extend_lane_bounds_to_include_adc()) {
-      CHECK_LE(adc_frenet_l_, std::get<2>(regular_path_bound[0]));
-      CHECK_GE(adc_frenet_l_, std::get<1>(regular_path_bound[0]));
-    }
-
-    // Update the path boundary into the reference_line_info.
-    std::vector<std::pair<double, double>> regular_path_bound_pair;
-    for (size_t i = 0; i < regular_path_bound.size(); ++i) {
-      regular_path_bound_pair.emplace_back(std::get<1>(regular_path_bound[i]),
-                                           std::get<2>(regular_path_bound[i]));
-    }
-    candidate_path_boundaries.emplace_back(std::get<0>(regular_path_bound[0]),
-                                           kPathBoundsDeciderResolution,
-                                           regular_path_bound_pair);
-    std::string path_label = "";
-    switch (lane_borrow_info) {
-      case LaneBorrowInfo::LEFT_BORROW:
-        path_label = "left";
-        break;
-      case LaneBorrowInfo::RIGHT_BORROW:
-        path_label = "right";
-        break;
-      default:
-        path_label = "self";
-        // exist_self_path_bound = true;
-        // regular_self_path_bound = regular_path_bound;
-        break;
-    }
-    // RecordDebugInfo(regular_path_bound, "", reference_line_info);
-    candidate_path_boundaries.back().set_label(
-        absl::StrCat("regular/", path_label, "/", borrow_lane_type));
-    candidate_path_boundaries.back().set_blocking_obstacle_id(
-        blocking_obstacle_id);
+    AddRegularPathBoundary(lane_borrow_info, regular_path_bound,
+                           blocking_obstacle_id, borrow_lane_type,
+                           &candidate_path_boundaries);
   }
 
   // Remove redundant boundaries.
@@ -268,6 +226,183 @@ Status PathBoundsDecider::Process(
   return Status::OK();
 }
 
+Status PathBoundsDecider::GenerateCandidatePathBoundsConcurrently(
+    ReferenceLineInfo* const reference_line_info) {
+  const auto lane_borrow_info_list =
+      GetLaneBorrowInfoList(*reference_line_info);
+
+  // The first candidate is the fallback path bound, and the others are the
+  // regular path bounds of the lane-borrow options.
+  struct CandidatePathBound {
+    PathBound path_bound;
+    std::string blocking_obstacle_id;
+    std::string borrow_lane_type;
+    Status status;
+    double time = 0.0;
+  };
+  std::vector<CandidatePathBound> candidates(lane_borrow_info_list.size() +
+                                             1);
+  const size_t num_threads =
+      static_cast<size_t>(std::max(1, FLAGS_path_candidate_thread_num));
+  util::ParallelFor(
+      0, candidates.size(), num_threads, 1,
+      [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          auto& candidate = candidates[i];
+          const double start_time = Clock::NowInSeconds();
+          candidate.status =
+              i == 0 ? GenerateFallbackPathBound(*reference_line_info,
+                                                 &candidate.path_bound)
+                     : GenerateRegularPathBound(
+                           *reference_line_info, lane_borrow_info_list[i - 1],
+                           &candidate.path_bound,
+                           &candidate.blocking_obstacle_id,
+                           &candidate.borrow_lane_type);
+          candidate.time = Clock::NowInSeconds() - start_time;
+        }
+      },
+      PathCandidateThreadPool());
+
+  std::vector<PathBoundary> candidate_path_boundaries;
+  RecordCandidateDebugInfo("fallback", candidates[0].time, true,
+                           reference_line_info);
+  const Status ret = AddFallbackPathBoundary(
+      candidates[0].status, candidates[0].path_bound,
+      &candidate_path_boundaries);
+  if (!ret.ok()) {
+    return ret;
+  }
+  for (size_t i = 1; i < candidates.size(); ++i) {
+    const auto& candidate = candidates[i];
+    const auto& lane_borrow_info = lane_borrow_info_list[i - 1];
+    RecordCandidateDebugInfo(
+        RegularPathLabel(lane_borrow_info, candidate.borrow_lane_type),
+        candidate.time, true, reference_line_info);
+    if (!candidate.status.ok()) {
+      continue;
+    }
+    AddRegularPathBoundary(lane_borrow_info, candidate.path_bound,
+                           candidate.blocking_obstacle_id,
+                           candidate.borrow_lane_type,
+                           &candidate_path_boundaries);
+  }
+
+  reference_line_info->SetCandidatePathBoundaries(
+      std::move(candidate_path_boundaries));
+  ADEBUG << "Completed regular and fallback path boundaries generation "
+            "concurrently.";
+  return Status::OK();
+}
+
+std::vector<PathBoundsDecider::LaneBorrowInfo>
+PathBoundsDecider::GetLaneBorrowInfoList(
+    const ReferenceLineInfo& reference_line_info) {
+  std::vector<LaneBorrowInfo> lane_borrow_info_list;
+  lane_borrow_info_list.push_back(LaneBorrowInfo::NO_BORROW);
+
+  if (reference_line_info.is_path_lane_borrow()) {
+    const auto& path_decider_status =
+        injector_->planning_context()->planning_status().path_decider();
+    for (const auto& lane_borrow_direction :
+         path_decider_status.decided_side_pass_direction()) {
+      if (lane_borrow_direction == PathDeciderStatus::LEFT_BORROW) {
+        lane_borrow_info_list.push_back(LaneBorrowInfo::LEFT_BORROW);
+      } else if (lane_borrow_direction == PathDeciderStatus::RIGHT_BORROW) {
+        lane_borrow_info_list.push_back(LaneBorrowInfo::RIGHT_BORROW);
+      }
+    }
+  }
+  return lane_borrow_info_list;
+}
+
+Status PathBoundsDecider::AddFallbackPathBoundary(
+    const Status& status, const PathBound& fallback_path_bound,
+    std::vector<PathBoundary>* const candidate_path_boundaries) {
+  if (!status.ok()) {
+    ADEBUG << "Cannot generate a fallback path bound.";
+    return Status(ErrorCode::PLANNING_ERROR, status.error_message());
+  }
+  if (fallback_path_bound.empty()) {
+    const std::string msg = "Failed to get a valid fallback path boundary";
+    AERROR << msg;
+    return Status(ErrorCode::PLANNING_ERROR, msg);
+  }
+  CHECK_LE(adc_frenet_l_, std::get<2>(fallback_path_bound[0]));
+  CHECK_GE(adc_frenet_l_, std::get<1>(fallback_path_bound[0]));
+  // Update the fallback path boundary into the reference_line_info.
+  std::vector<std::pair<double, double>> fallback_path_bound_pair;
+  for (size_t i = 0; i < fallback_path_bound.size(); ++i) {
+    fallback_path_bound_pair.emplace_back(std::get<1>(fallback_path_bound[i]),
+                                          std::get<2>(fallback_path_bound[i]));
+  }
+  candidate_path_boundaries->emplace_back(std::get<0>(fallback_path_bound[0]),
+                                          kPathBoundsDeciderResolution,
+                                          fallback_path_bound_pair);
+  candidate_path_boundaries->back().set_label("fallback");
+  return Status::OK();
+}
+
+void PathBoundsDecider::AddRegularPathBoundary(
+    const LaneBorrowInfo& lane_borrow_info,
+    const PathBound& regular_path_bound,
+    const std::string& blocking_obstacle_id,
+    const std::string& borrow_lane_type,
+    std::vector<PathBoundary>* const candidate_path_boundaries) {
+  if (regular_path_bound.empty()) {
+    return;
+  }
+  // disable this change when not extending lane bounds to include adc
+  if (config_.path_bounds_decider_config()
+          .is_extend_lane_bounds_to_include_adc()) {
+    CHECK_LE(adc_frenet_l_, std::get<2>(regular_path_bound[0]));
+    CHECK_GE(adc_frenet_l_, std::get<1>(regular_path_bound[0]));
+  }
+
+  // Update the path boundary into the reference_line_info.
+  std::vector<std::pair<double, double>> regular_path_bound_pair;
+  for (size_t i = 0; i < regular_path_bound.size(); ++i) {
+    regular_path_bound_pair.emplace_back(std::get<1>(regular_path_bound[i]),
+                                         std::get<2>(regular_path_bound[i]));
+  }
+  candidate_path_boundaries->emplace_back(std::get<0>(regular_path_bound[0]),
+                                          kPathBoundsDeciderResolution,
+                                          regular_path_bound_pair);
+  // RecordDebugInfo(regular_path_bound, "", reference_line_info);
+  candidate_path_boundaries->back().set_label(
+      RegularPathLabel(lane_borrow_info, borrow_lane_type));
+  candidate_path_boundaries->back().set_blocking_obstacle_id(
+      blocking_obstacle_id);
+}
+
+std::string PathBoundsDecider::RegularPathLabel(
+    const LaneBorrowInfo& lane_borrow_info,
+    const std::string& borrow_lane_type) const {
+  std::string path_label = "";
+  switch (lane_borrow_info) {
+    case LaneBorrowInfo::LEFT_BORROW:
+      path_label = "left";
+      break;
+    case LaneBorrowInfo::RIGHT_BORROW:
+      path_label = "right";
+      break;
+    default:
+      path_label = "self";
+      break;
+  }
+  return absl::StrCat("regular/", path_label, "/", borrow_lane_type);
+}
+
+void PathBoundsDecider::RecordCandidateDebugInfo(
+    const std::string& path_label, const double time, const bool is_concurrent,
+    ReferenceLineInfo* const reference_line_info) {
+  auto* path_candidate = reference_line_info->mutable_debug()
+                             ->mutable_planning_data()
+                             ->add_path_candidate();
+  path_candidate->set_label(path_label);
+  path_candidate->set_bound_time_ms(time * 1000.0);
+  path_candidate->set_is_bound_concurrent(is_concurrent);
+}
+
 void PathBoundsDecider::InitPathBoundsDecider(
     const Frame& frame, const ReferenceLineInfo& reference_line_info) {
   const ReferenceLine& reference_line = reference_line_info.reference_line();
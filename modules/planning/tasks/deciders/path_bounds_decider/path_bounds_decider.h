@@ -31,6 +31,7 @@
 
 #include "modules/planning/proto/planning_config.pb.h"
 
+#include "modules/planning/common/path_boundary.h"
 #include "modules/planning/tasks/deciders/decider.h"
 
 namespace apollo {
@@ -118,6 +119,47 @@ class PathBoundsDecider : public Decider {
       const ReferenceLineInfo& reference_line_info,
       std::vector<std::tuple<double, double, double>>* const path_bound);
 
+  /** @brief Generate the fallback path boundary and the regular path
+   *   boundaries of every lane-borrow option concurrently, and set them in
+   *   the same order as the sequential generation does. It is only used
+   *   without pull-over and lane-change, as the fallback and the regular
+   *   path bounds only read the state of the decider.
+   * @param reference_line_info
+   * @return common::Status
+   */
+  common::Status GenerateCandidatePathBoundsConcurrently(
+      ReferenceLineInfo* const reference_line_info);
+
+  std::vector<LaneBorrowInfo> GetLaneBorrowInfoList(
+      const ReferenceLineInfo& reference_line_info);
+
+  /** @brief Check the fallback path bound and add it to the candidates.
+   * @param status: the status of the fallback path bound generation.
+   */
+  common::Status AddFallbackPathBoundary(
+      const common::Status& status,
+      const std::vector<std::tuple<double, double, double>>&
+          fallback_path_bound,
+      std::vector<PathBoundary>* const candidate_path_boundaries);
+
+  void AddRegularPathBoundary(
+      const LaneBorrowInfo& lane_borrow_info,
+      const std::vector<std::tuple<double, double, double>>&
+          regular_path_bound,
+      const std::string& blocking_obstacle_id,
+      const std::string& borrow_lane_type,
+      std::vector<PathBoundary>* const candidate_path_boundaries);
+
+  std::string RegularPathLabel(const LaneBorrowInfo& lane_borrow_info,
+                               const std::string& borrow_lane_type) const;
+
+  /** @brief Record the time spent generating a candidate path bound into
+   *   the planning debug.
+   */
+  void RecordCandidateDebugInfo(const std::string& path_label,
+                                const double time, const bool is_concurrent,
+                                ReferenceLineInfo* const reference_line_info);
+
   common::Status GeneratePullOverPathBound(
       const Frame& frame, const ReferenceLineInfo& reference_line_info,
       std::vector<std::tuple<double, double, double>>* const path_bound);
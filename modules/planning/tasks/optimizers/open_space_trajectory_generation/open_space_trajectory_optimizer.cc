@@ -20,8 +20,11 @@
 
 #include "modules/planning/tasks/optimizers/open_space_trajectory_generation/open_space_trajectory_optimizer.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "modules/planning/common/util/parallel_for.h"
+
 namespace apollo {
 namespace planning {
 
@@ -29,6 +32,29 @@ using apollo::common::ErrorCode;
 using apollo::common::Status;
 using apollo::common::math::Vec2d;
 
+namespace {
+cyber::base::ThreadPool* OpenSpaceSmoothingThreadPool() {
+  static cyber::base::ThreadPool thread_pool(
+      std::max(1, FLAGS_open_space_smoothing_thread_num - 1));
+  return &thread_pool;
+}
+
+// The IPOPT solves share the process wide state of MUMPS and of the ADOL-C
+// tapes, so only the iterative anchoring smoother, when its path smoother
+// does not run IPOPT, smooths the partitions in parallel.
+bool IsParallelSmoother(const OpenSpaceTrajectoryOptimizerConfig& config) {
+  if (config.trajectory_smoother() !=
+      OpenSpaceTrajectoryOptimizerConfig::ITERATIVE_ANCHORING_SMOOTHER) {
+    return false;
+  }
+  const auto& fem_pos_config = config.planner_open_space_config()
+                                   .iterative_anchoring_smoother_config()
+                                   .fem_pos_deviation_smoother_config();
+  return !fem_pos_config.apply_curvature_constraint() ||
+         fem_pos_config.use_sqp();
+}
+}  // namespace
+
 OpenSpaceTrajectoryOptimizer::OpenSpaceTrajectoryOptimizer(
     const OpenSpaceTrajectoryOptimizerConfig& config)
     : config_(config) {
@@ -46,7 +72,7 @@ OpenSpaceTrajectoryOptimizer::OpenSpaceTrajectoryOptimizer(
       new DistanceApproachProblem(config.planner_open_space_config()));
 
   // Initialize iterative anchoring smoother config class pointer
-  iterative_anchoring_smoother_.reset(
+  iterative_anchoring_smoothers_.emplace_back(
       new IterativeAnchoringSmoother(config.planner_open_space_config()));
 }
 
@@ -147,7 +173,8 @@ Status OpenSpaceTrajectoryOptimizer::Plan(
     dual_l_result_ds_vec.resize(size);
     dual_n_result_ds_vec.resize(size);
 
-    // In for loop
+    std::vector<Eigen::MatrixXd> last_time_u_vec(size);
+    std::vector<double> init_v_vec(size, 0.0);
     ADEBUG << "Trajectories size in smoother is " << size;
     for (size_t i = 0; i < size; ++i) {
       LoadHybridAstarResultInEigen(&partition_trajectories[i], &xWS_vec[i],
@@ -162,33 +189,48 @@ Status OpenSpaceTrajectoryOptimizer::Plan(
               << xWS_vec[i].col(xWS_vec[i].cols() - 1).transpose();
       }
 
-      Eigen::MatrixXd last_time_u(2, 1);
-      double init_v = 0.0;
       // Stitching point control and velocity is set for first piece of
       // trajectories. In the next ones, control and velocity are assumed to be
       // zero as the next trajectories always start from vehicle static state
+      last_time_u_vec[i].resize(2, 1);
       if (i == 0) {
         const double init_steer = trajectory_stitching_point.steer();
         const double init_a = trajectory_stitching_point.a();
-        last_time_u << init_steer, init_a;
-        init_v = trajectory_stitching_point.v();
+        last_time_u_vec[i] << init_steer, init_a;
+        init_v_vec[i] = trajectory_stitching_point.v();
       } else {
-        last_time_u << 0.0, 0.0;
-        init_v = 0.0;
+        last_time_u_vec[i] << 0.0, 0.0;
+        init_v_vec[i] = 0.0;
+      }
+    }
+
+    // The iterative anchoring smoother keeps the state of its last problem,
+    // so every partition gets its own one.
+    if (config_.trajectory_smoother() ==
+        OpenSpaceTrajectoryOptimizerConfig::ITERATIVE_ANCHORING_SMOOTHER) {
+      while (iterative_anchoring_smoothers_.size() < size) {
+        iterative_anchoring_smoothers_.emplace_back(
+            new IterativeAnchoringSmoother(
+                config_.planner_open_space_config()));
       }
+    }
+
+    // The partitions are independent problems, smoothed in parallel when the
+    // smoother allows it
+    std::vector<int> is_smoothed(size, 0);
+    const auto smooth_partition = [&](const size_t i) {
+      const Eigen::MatrixXd& last_time_u = last_time_u_vec[i];
+      const double init_v = init_v_vec[i];
       // TODO(Jinyun): Further testing
       const auto smoother_start_timestamp = std::chrono::system_clock::now();
       switch (config_.trajectory_smoother()) {
         case OpenSpaceTrajectoryOptimizerConfig::ITERATIVE_ANCHORING_SMOOTHER: {
           if (!GenerateDecoupledTraj(
-                  xWS_vec[i], last_time_u(1, 0), init_v, obstacles_vertices_vec,
+                  iterative_anchoring_smoothers_[i].get(), xWS_vec[i],
+                  last_time_u(1, 0), init_v, obstacles_vertices_vec,
                   &state_result_ds_vec[i], &control_result_ds_vec[i],
                   &time_result_ds_vec[i])) {
-            AERROR << "Smoother fail at " << i << "th trajectory";
-            AERROR << i << "th trajectory size is " << xWS_vec[i].cols();
-            return Status(
-                ErrorCode::PLANNING_ERROR,
-                "iterative anchoring smoothing problem failed to solve");
+            return;
           }
           break;
         }
@@ -203,14 +245,7 @@ Status OpenSpaceTrajectoryOptimizer::Plan(
                   init_v, &state_result_ds_vec[i], &control_result_ds_vec[i],
                   &time_result_ds_vec[i], &l_warm_up_vec[i], &n_warm_up_vec[i],
                   &dual_l_result_ds_vec[i], &dual_n_result_ds_vec[i])) {
-            AERROR << "Smoother fail at " << i
-                   << "th trajectory with index starts from 0";
-            AERROR << i << "th trajectory size is " << xWS_vec[i].cols();
-            AERROR << "State matrix: " << xWS_vec[i];
-            AERROR << "Control matrix: " << uWS_vec[i];
-            return Status(
-                ErrorCode::PLANNING_ERROR,
-                "distance approach smoothing problem failed to solve");
+            return;
           }
           const auto end_system_timestamp =
               std::chrono::duration<double>(
@@ -238,6 +273,7 @@ Status OpenSpaceTrajectoryOptimizer::Plan(
           break;
         }
       }
+      is_smoothed[i] = 1;
       const auto smoother_end_timestamp = std::chrono::system_clock::now();
       std::chrono::duration<double> smoother_diff =
           smoother_end_timestamp - smoother_start_timestamp;
@@ -247,6 +283,39 @@ Status OpenSpaceTrajectoryOptimizer::Plan(
       ADEBUG << "The " << i << "th trajectory pre-smoothing size is "
              << xWS_vec[i].cols() << "; post-smoothing size is "
              << state_result_ds_vec[i].cols();
+    };
+    const size_t num_threads =
+        IsParallelSmoother(config_)
+            ? static_cast<size_t>(
+                  std::max(1, FLAGS_open_space_smoothing_thread_num))
+            : 1;
+    util::ParallelFor(
+        0, size, num_threads, 1,
+        [&smooth_partition](const size_t begin, const size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            smooth_partition(i);
+          }
+        },
+        num_threads > 1 ? OpenSpaceSmoothingThreadPool() : nullptr);
+
+    for (size_t i = 0; i < size; ++i) {
+      if (is_smoothed[i]) {
+        continue;
+      }
+      if (config_.trajectory_smoother() ==
+          OpenSpaceTrajectoryOptimizerConfig::ITERATIVE_ANCHORING_SMOOTHER) {
+        AERROR << "Smoother fail at " << i << "th trajectory";
+        AERROR << i << "th trajectory size is " << xWS_vec[i].cols();
+        return Status(ErrorCode::PLANNING_ERROR,
+                      "iterative anchoring smoothing problem failed to solve");
+      }
+      AERROR << "Smoother fail at " << i
+             << "th trajectory with index starts from 0";
+      AERROR << i << "th trajectory size is " << xWS_vec[i].cols();
+      AERROR << "State matrix: " << xWS_vec[i];
+      AERROR << "Control matrix: " << uWS_vec[i];
+      return Status(ErrorCode::PLANNING_ERROR,
+                    "distance approach smoothing problem failed to solve");
     }
 
     // Retrive the trajectory in one piece
@@ -852,13 +921,17 @@ void OpenSpaceTrajectoryOptimizer::CombineTrajectories(
 }
 
 bool OpenSpaceTrajectoryOptimizer::GenerateDecoupledTraj(
-    const Eigen::MatrixXd& xWS, const double init_a, const double init_v,
+    IterativeAnchoringSmoother* smoother, const Eigen::MatrixXd& xWS,
+    const double init_a, const double init_v,
     const std::vector<std::vector<Vec2d>>& obstacles_vertices_vec,
     Eigen::MatrixXd* state_result_dc, Eigen::MatrixXd* control_result_dc,
     Eigen::MatrixXd* time_result_dc) {
   DiscretizedTrajectory smoothed_trajectory;
-  if (!iterative_anchoring_smoother_->Smooth(
-          xWS, init_a, init_v, obstacles_vertices_vec, &smoothed_trajectory)) {
+  // the obstacle distance field of the warm start is built on the same
+  // obstacles in the same frame
+  const auto obstacle_distance_field = warm_start_->GetObstacleDistanceField();
+  if (!smoother->Smooth(xWS, init_a, init_v, obstacles_vertices_vec,
+                        obstacle_distance_field.get(), &smoothed_trajectory)) {
     return false;
   }
 
@@ -132,7 +132,8 @@ class OpenSpaceTrajectoryOptimizer {
       Eigen::MatrixXd* dual_n_result_ds);
 
   bool GenerateDecoupledTraj(
-      const Eigen::MatrixXd& xWS, const double init_a, const double init_v,
+      IterativeAnchoringSmoother* smoother, const Eigen::MatrixXd& xWS,
+      const double init_a, const double init_v,
       const std::vector<std::vector<common::math::Vec2d>>&
           obstacles_vertices_vec,
       Eigen::MatrixXd* state_result_dc, Eigen::MatrixXd* control_result_dc,
@@ -165,7 +166,10 @@ class OpenSpaceTrajectoryOptimizer {
   std::unique_ptr<HybridAStar> warm_start_;
   std::unique_ptr<DistanceApproachProblem> distance_approach_;
   std::unique_ptr<DualVariableWarmStartProblem> dual_variable_warm_start_;
-  std::unique_ptr<IterativeAnchoringSmoother> iterative_anchoring_smoother_;
+  // one smoother per trajectory partition, as the partitions are smoothed in
+  // parallel
+  std::vector<std::unique_ptr<IterativeAnchoringSmoother>>
+      iterative_anchoring_smoothers_;
 
   std::vector<common::TrajectoryPoint> stitching_trajectory_;
   DiscretizedTrajectory optimized_trajectory_;
@@ -31,7 +31,11 @@ namespace apollo {
 namespace planning {
 namespace {
 constexpr double kInf = std::numeric_limits<double>::infinity();
-}
+// the accel and jerk costs are tabulated by bins of kCostBinSize
+constexpr double kCostBinSize = 0.1;
+constexpr size_t kAccelCostShift = 100;
+constexpr size_t kJerkCostShift = 200;
+}  // namespace
 
 DpStCost::DpStCost(const DpStSpeedOptimizerConfig& config, const double total_t,
                    const double total_s,
@@ -58,8 +62,31 @@ DpStCost::DpStCost(const DpStSpeedOptimizerConfig& config, const double total_t,
   for (auto& vec : boundary_cost_) {
     vec.resize(dimension_t, std::make_pair(-1.0, -1.0));
   }
-  accel_cost_.fill(-1.0);
-  jerk_cost_.fill(-1.0);
+  // tabulated at the bin centers up front, so that concurrent callers only
+  // read them
+  for (size_t i = 0; i < accel_cost_.size(); ++i) {
+    accel_cost_[i] = ComputeAccelCost(
+        (static_cast<double>(i) - static_cast<double>(kAccelCostShift)) *
+        kCostBinSize);
+  }
+  for (size_t i = 0; i < jerk_cost_.size(); ++i) {
+    jerk_cost_[i] = ComputeJerkCost(
+        (static_cast<double>(i) - static_cast<double>(kJerkCostShift)) *
+        kCostBinSize);
+  }
+}
+
+void DpStCost::CacheBoundarySRanges(const uint32_t index_t, const double t) {
+  for (const auto* obstacle : obstacles_) {
+    const auto& boundary = obstacle->path_st_boundary();
+    if (t < boundary.min_t() || t > boundary.max_t()) {
+      continue;
+    }
+    auto& s_range = boundary_cost_[boundary_map_.at(boundary.id())][index_t];
+    if (s_range.first < 0.0) {
+      boundary.GetBoundarySRange(t, &s_range.first, &s_range.second);
+    }
+  }
 }
 
 void DpStCost::AddToKeepClearRange(
@@ -144,7 +171,7 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
       continue;
     }
 
-    auto boundary = obstacle->path_st_boundary();
+    const auto& boundary = obstacle->path_st_boundary();
 
     if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
       continue;
@@ -158,14 +185,15 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
     double s_upper = 0.0;
     double s_lower = 0.0;
 
-    int boundary_index = boundary_map_[boundary.id()];
-    if (boundary_cost_[boundary_index][st_graph_point.index_t()].first < 0.0) {
+    // read only, CacheBoundarySRanges() fills the cache
+    const auto& s_range =
+        boundary_cost_[boundary_map_.at(boundary.id())]
+                      [st_graph_point.index_t()];
+    if (s_range.first < 0.0) {
       boundary.GetBoundarySRange(t, &s_upper, &s_lower);
-      boundary_cost_[boundary_index][st_graph_point.index_t()] =
-          std::make_pair(s_upper, s_lower);
     } else {
-      s_upper = boundary_cost_[boundary_index][st_graph_point.index_t()].first;
-      s_lower = boundary_cost_[boundary_index][st_graph_point.index_t()].second;
+      s_upper = s_range.first;
+      s_lower = s_range.second;
     }
     if (s < s_lower) {
       const double follow_distance_s = config_.safe_distance();
@@ -238,37 +266,34 @@ double DpStCost::GetSpeedCost(const STPoint& first, const STPoint& second,
   return cost;
 }
 
-double DpStCost::GetAccelCost(const double accel) {
+double DpStCost::ComputeAccelCost(const double accel) const {
   double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 100;
-  const size_t accel_key = static_cast<size_t>(accel / kEpsilon + 0.5 + kShift);
+  const double accel_sq = accel * accel;
+  double max_acc = config_.max_acceleration();
+  double max_dec = config_.max_deceleration();
+  double accel_penalty = config_.accel_penalty();
+  double decel_penalty = config_.decel_penalty();
+
+  if (accel > 0.0) {
+    cost = accel_penalty * accel_sq;
+  } else {
+    cost = decel_penalty * accel_sq;
+  }
+  cost += accel_sq * decel_penalty * decel_penalty /
+              (1 + std::exp(1.0 * (accel - max_dec))) +
+          accel_sq * accel_penalty * accel_penalty /
+              (1 + std::exp(-1.0 * (accel - max_acc)));
+  return cost;
+}
+
+double DpStCost::GetAccelCost(const double accel) const {
+  const size_t accel_key =
+      static_cast<size_t>(accel / kCostBinSize + 0.5 + kAccelCostShift);
   DCHECK_LT(accel_key, accel_cost_.size());
   if (accel_key >= accel_cost_.size()) {
     return kInf;
   }
-
-  if (accel_cost_.at(accel_key) < 0.0) {
-    const double accel_sq = accel * accel;
-    double max_acc = config_.max_acceleration();
-    double max_dec = config_.max_deceleration();
-    double accel_penalty = config_.accel_penalty();
-    double decel_penalty = config_.decel_penalty();
-
-    if (accel > 0.0) {
-      cost = accel_penalty * accel_sq;
-    } else {
-      cost = decel_penalty * accel_sq;
-    }
-    cost += accel_sq * decel_penalty * decel_penalty /
-                (1 + std::exp(1.0 * (accel - max_dec))) +
-            accel_sq * accel_penalty * accel_penalty /
-                (1 + std::exp(-1.0 * (accel - max_acc)));
-    accel_cost_.at(accel_key) = cost;
-  } else {
-    cost = accel_cost_.at(accel_key);
-  }
-  return cost * unit_t_;
+  return accel_cost_[accel_key] * unit_t_;
 }
 
 double DpStCost::GetAccelCostByThreePoints(const STPoint& first,
@@ -286,29 +311,22 @@ double DpStCost::GetAccelCostByTwoPoints(const double pre_speed,
   return GetAccelCost(accel);
 }
 
-double DpStCost::JerkCost(const double jerk) {
-  double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 200;
-  const size_t jerk_key = static_cast<size_t>(jerk / kEpsilon + 0.5 + kShift);
-  if (jerk_key >= jerk_cost_.size()) {
-    return kInf;
+double DpStCost::ComputeJerkCost(const double jerk) const {
+  const double jerk_sq = jerk * jerk;
+  if (jerk > 0) {
+    return config_.positive_jerk_coeff() * jerk_sq * unit_t_;
   }
+  return config_.negative_jerk_coeff() * jerk_sq * unit_t_;
+}
 
-  if (jerk_cost_.at(jerk_key) < 0.0) {
-    double jerk_sq = jerk * jerk;
-    if (jerk > 0) {
-      cost = config_.positive_jerk_coeff() * jerk_sq * unit_t_;
-    } else {
-      cost = config_.negative_jerk_coeff() * jerk_sq * unit_t_;
-    }
-    jerk_cost_.at(jerk_key) = cost;
-  } else {
-    cost = jerk_cost_.at(jerk_key);
+double DpStCost::JerkCost(const double jerk) const {
+  const size_t jerk_key =
+      static_cast<size_t>(jerk / kCostBinSize + 0.5 + kJerkCostShift);
+  if (jerk_key >= jerk_cost_.size()) {
+    return kInf;
   }
-
   // TODO(All): normalize to unit_t_
-  return cost;
+  return jerk_cost_[jerk_key];
 }
 
 double DpStCost::GetJerkCostByFourPoints(const STPoint& first,
@@ -43,6 +43,11 @@ class DpStCost {
            const STDrivableBoundary& st_drivable_boundary,
            const common::TrajectoryPoint& init_point);
 
+  // Fills the s ranges of the obstacle boundaries at time t, the index_t-th
+  // column of the graph, which GetObstacleCost() then only reads. Call it on
+  // a column before its points are evaluated concurrently.
+  void CacheBoundarySRanges(const uint32_t index_t, const double t);
+
   double GetObstacleCost(const StGraphPoint& point);
 
   double GetSpatialPotentialCost(const StGraphPoint& point);
@@ -71,8 +76,10 @@ class DpStCost {
                                  const STPoint& third, const STPoint& fourth);
 
  private:
-  double GetAccelCost(const double accel);
-  double JerkCost(const double jerk);
+  double ComputeAccelCost(const double accel) const;
+  double GetAccelCost(const double accel) const;
+  double ComputeJerkCost(const double jerk) const;
+  double JerkCost(const double jerk) const;
 
   void AddToKeepClearRange(const std::vector<const Obstacle*>& obstacles);
   static void SortAndMergeRange(
@@ -94,6 +101,7 @@ class DpStCost {
 
   std::vector<std::pair<double, double>> keep_clear_range_;
 
+  // costs at the centers of the accel and jerk bins
   std::array<double, 200> accel_cost_;
   std::array<double, 400> jerk_cost_;
 };
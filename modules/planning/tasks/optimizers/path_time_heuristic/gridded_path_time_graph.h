@@ -20,9 +20,10 @@
 
 #pragma once
 
-#include <memory>
+#include <cstdint>
 #include <vector>
 
+#include "cyber/base/thread_pool.h"
 #include "modules/common_msgs/config_msgs/vehicle_config.pb.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/status/status.h"
@@ -49,6 +50,15 @@ class GriddedPathTimeGraph {
 
   common::Status Search(SpeedData* const speed_data);
 
+  /**
+   * @brief Share the rows of each column among num_threads threads, the
+   *        calling thread and the workers of thread_pool. By default a
+   *        thread pool of FLAGS_dp_graph_thread_num threads is used when
+   *        FLAGS_enable_multi_thread_in_dp_st_graph is set.
+   */
+  void SetThreadPool(cyber::base::ThreadPool* thread_pool,
+                     const size_t num_threads);
+
  private:
   common::Status InitCostTable();
 
@@ -58,13 +68,7 @@ class GriddedPathTimeGraph {
 
   common::Status CalculateTotalCost();
 
-  // defined for cyber task
-  struct StGraphMessage {
-    StGraphMessage(const uint32_t c_, const int32_t r_) : c(c_), r(r_) {}
-    uint32_t c;
-    uint32_t r;
-  };
-  void CalculateCostAt(const std::shared_ptr<StGraphMessage>& msg);
+  void CalculateCostAt(const uint32_t c, const uint32_t r);
 
   double CalculateEdgeCost(const STPoint& first, const STPoint& second,
                            const STPoint& third, const STPoint& forth,
@@ -78,8 +82,16 @@ class GriddedPathTimeGraph {
                                       const double cruise_speed);
 
   // get the row-range of next time step
-  void GetRowRange(const StGraphPoint& point, size_t* next_highest_row,
-                   size_t* next_lowest_row);
+  void GetRowRange(const uint32_t c, const uint32_t r,
+                   size_t* next_highest_row, size_t* next_lowest_row);
+
+  STPoint PointAt(const uint32_t c, const uint32_t r) const {
+    return STPoint(spatial_distance_by_index_[r], time_by_index_[c]);
+  }
+
+  size_t Index(const uint32_t c, const uint32_t r) const {
+    return static_cast<size_t>(c) * dimension_s_ + r;
+  }
 
  private:
   const StGraphData& st_graph_data_;
@@ -88,6 +100,8 @@ class GriddedPathTimeGraph {
 
   std::vector<double> spatial_distance_by_index_;
 
+  std::vector<double> time_by_index_;
+
   // dp st configuration
   DpStSpeedOptimizerConfig gridded_path_time_graph_config_;
 
@@ -118,9 +132,16 @@ class GriddedPathTimeGraph {
   double max_acceleration_ = 0.0;
   double max_deceleration_ = 0.0;
 
-  // cost_table_[t][s]
-  // row: s, col: t --- NOTICE: Please do NOT change.
-  std::vector<std::vector<StGraphPoint>> cost_table_;
+  // The cost table is laid out column by column, one array per field, so
+  // that the node of column c (t) and row r (s) is at Index(c, r) and the
+  // rows of a column, shared among the threads, are contiguous.
+  std::vector<double> total_cost_;
+  std::vector<double> optimal_speed_;
+  // row of the previous node on the min cost path, -1 if there is none
+  std::vector<int32_t> pre_row_;
+
+  cyber::base::ThreadPool* thread_pool_ = nullptr;
+  size_t num_threads_ = 1;
 };
 
 }  // namespace planning
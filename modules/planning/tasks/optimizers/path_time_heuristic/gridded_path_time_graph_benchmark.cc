@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * @brief Measures GriddedPathTimeGraph::Search with the rows of each column
+ *        shared among 1 to 8 threads (the argument) on the speed heuristic
+ *        grid of the lane follow configuration, and on a grid twice as fine
+ *        in both dimensions. Run with
+ *        bazel run -c opt //modules/planning/tasks/optimizers/path_time_heuristic:gridded_path_time_graph_benchmark
+ */
+
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/base/thread_pool.h"
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/tasks/optimizers/path_time_heuristic/gridded_path_time_graph.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+constexpr size_t kMaxNumThreads = 8;
+constexpr double kInitSpeed = 10.0;
+constexpr double kPathLength = 120.0;
+constexpr double kTotalTime = 7.0;
+
+cyber::base::ThreadPool* BenchmarkThreadPool() {
+  static cyber::base::ThreadPool thread_pool(kMaxNumThreads - 1);
+  return &thread_pool;
+}
+
+DpStSpeedOptimizerConfig MakeConfig(const double scale) {
+  DpStSpeedOptimizerConfig config;
+  config.set_unit_t(1.0 / scale);
+  config.set_dense_dimension_s(static_cast<int>(100 * scale) + 1);
+  config.set_dense_unit_s(0.1 / scale);
+  config.set_sparse_unit_s(1.0 / scale);
+  config.set_default_obstacle_cost(1.0e4);
+  config.set_default_speed_cost(1.0e3);
+  config.set_exceed_speed_penalty(1.0e3);
+  config.set_low_speed_penalty(10.0);
+  config.set_reference_speed_penalty(10.0);
+  config.set_accel_penalty(1.0);
+  config.set_decel_penalty(1.0);
+  config.set_max_acceleration(2.0);
+  config.set_max_deceleration(-4.0);
+  config.set_spatial_potential_penalty(1.0e2);
+  return config;
+}
+
+// a vehicle cutting in ahead, a slower leading vehicle and a crossing one
+std::list<Obstacle> MakeObstacles() {
+  std::list<Obstacle> obstacles;
+  const auto add_obstacle =
+      [&obstacles](const std::string& id,
+                   const std::vector<std::pair<STPoint, STPoint>>& pairs) {
+        STBoundary boundary(pairs);
+        boundary.set_id(id);
+        obstacles.emplace_back();
+        obstacles.back().SetId(id);
+        obstacles.back().set_path_st_boundary(boundary);
+      };
+  add_obstacle("cut_in", {{STPoint(30.0, 4.0), STPoint(45.0, 4.0)},
+                          {STPoint(30.0, 6.0), STPoint(45.0, 6.0)}});
+  add_obstacle("leading", {{STPoint(60.0, 0.0), STPoint(65.0, 0.0)},
+                           {STPoint(109.0, 7.0), STPoint(114.0, 7.0)}});
+  add_obstacle("crossing", {{STPoint(15.0, 1.0), STPoint(18.0, 1.0)},
+                            {STPoint(15.0, 2.0), STPoint(18.0, 2.0)}});
+  return obstacles;
+}
+
+void BM_Search(benchmark::State& state, const double scale) {
+  common::VehicleConfig vehicle_config;
+  vehicle_config.mutable_vehicle_param()->set_max_acceleration(2.0);
+  vehicle_config.mutable_vehicle_param()->set_max_deceleration(-6.0);
+  common::VehicleConfigHelper::Init(vehicle_config);
+
+  const auto obstacle_list = MakeObstacles();
+  std::vector<const Obstacle*> obstacles;
+  std::vector<const STBoundary*> boundaries;
+  for (const auto& obstacle : obstacle_list) {
+    obstacles.push_back(&obstacle);
+    boundaries.push_back(&obstacle.path_st_boundary());
+  }
+
+  common::TrajectoryPoint init_point;
+  init_point.set_v(kInitSpeed);
+  init_point.set_a(0.0);
+  SpeedLimit speed_limit;
+  for (double s = 0.0; s < kPathLength + 80.0; s += 1.0) {
+    speed_limit.AppendSpeedLimit(s, 15.0);
+  }
+  planning_internal::STGraphDebug st_graph_debug;
+  StGraphData st_graph_data;
+  st_graph_data.LoadData(boundaries, 15.0, init_point, speed_limit, 15.0,
+                         kPathLength, kTotalTime, &st_graph_debug);
+
+  const DpStSpeedOptimizerConfig config = MakeConfig(scale);
+  const size_t num_threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    GriddedPathTimeGraph graph(st_graph_data, config, obstacles, init_point);
+    graph.SetThreadPool(BenchmarkThreadPool(), num_threads);
+    SpeedData speed_data;
+    if (!graph.Search(&speed_data).ok()) {
+      state.SkipWithError("Search failed");
+      break;
+    }
+    benchmark::DoNotOptimize(speed_data);
+  }
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Search, lane_follow_grid, 1.0)
+    ->DenseRange(1, kMaxNumThreads)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Search, fine_grid, 2.0)
+    ->DenseRange(1, kMaxNumThreads)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -19,9 +19,17 @@
  **/
 #include "modules/planning/tasks/optimizers/path_time_heuristic/gridded_path_time_graph.h"
 
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+#include "cyber/base/thread_pool.h"
 #include "cyber/common/file.h"
 #include "cyber/common/log.h"
 #include "gtest/gtest.h"
+#include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
 #include "modules/common_msgs/perception_msgs/perception_obstacle.pb.h"
 #include "modules/planning/common/planning_gflags.h"
@@ -134,5 +142,86 @@ TEST_F(DpStGraphTest, simple) {
   EXPECT_TRUE(ret.ok());
 }
 
+// the rows of the columns shared among threads give the same speed profile
+// as on the calling thread alone
+TEST(GriddedPathTimeGraphTest, concurrent_rows) {
+  common::VehicleConfig vehicle_config;
+  vehicle_config.mutable_vehicle_param()->set_max_acceleration(2.0);
+  vehicle_config.mutable_vehicle_param()->set_max_deceleration(-6.0);
+  common::VehicleConfigHelper::Init(vehicle_config);
+
+  // a vehicle cutting in ahead and a slower leading vehicle
+  std::list<Obstacle> obstacle_list;
+  std::vector<const Obstacle*> obstacles;
+  std::vector<const STBoundary*> boundaries;
+  for (const auto& id_pairs :
+       std::vector<std::pair<std::string,
+                             std::vector<std::pair<STPoint, STPoint>>>>{
+           {"cut_in",
+            {{STPoint(30.0, 4.0), STPoint(45.0, 4.0)},
+             {STPoint(30.0, 6.0), STPoint(45.0, 6.0)}}},
+           {"leading",
+            {{STPoint(60.0, 0.0), STPoint(65.0, 0.0)},
+             {STPoint(109.0, 7.0), STPoint(114.0, 7.0)}}}}) {
+    STBoundary boundary(id_pairs.second);
+    boundary.set_id(id_pairs.first);
+    obstacle_list.emplace_back();
+    obstacle_list.back().SetId(id_pairs.first);
+    obstacle_list.back().set_path_st_boundary(boundary);
+    obstacles.push_back(&obstacle_list.back());
+    boundaries.push_back(&obstacle_list.back().path_st_boundary());
+  }
+
+  common::TrajectoryPoint init_point;
+  init_point.set_v(10.0);
+  init_point.set_a(0.0);
+  SpeedLimit speed_limit;
+  for (double s = 0.0; s < 200.0; s += 1.0) {
+    speed_limit.AppendSpeedLimit(s, 15.0);
+  }
+  planning_internal::STGraphDebug st_graph_debug;
+  StGraphData st_graph_data;
+  st_graph_data.LoadData(boundaries, 15.0, init_point, speed_limit, 15.0,
+                         120.0, 7.0, &st_graph_debug);
+
+  DpStSpeedOptimizerConfig config;
+  config.set_unit_t(0.5);
+  config.set_dense_dimension_s(201);
+  config.set_dense_unit_s(0.05);
+  config.set_sparse_unit_s(0.5);
+  config.set_default_obstacle_cost(1.0e4);
+  config.set_default_speed_cost(1.0e3);
+  config.set_exceed_speed_penalty(1.0e3);
+  config.set_low_speed_penalty(10.0);
+  config.set_reference_speed_penalty(10.0);
+  config.set_accel_penalty(1.0);
+  config.set_decel_penalty(1.0);
+  config.set_max_acceleration(2.0);
+  config.set_max_deceleration(-4.0);
+  config.set_spatial_potential_penalty(1.0e2);
+  config.set_safe_distance(20.0);
+
+  cyber::base::ThreadPool thread_pool(3);
+  SpeedData expected_speed_data;
+  {
+    GriddedPathTimeGraph graph(st_graph_data, config, obstacles, init_point);
+    graph.SetThreadPool(nullptr, 1);
+    ASSERT_TRUE(graph.Search(&expected_speed_data).ok());
+  }
+  ASSERT_FALSE(expected_speed_data.empty());
+  for (int i = 0; i < 20; ++i) {
+    GriddedPathTimeGraph graph(st_graph_data, config, obstacles, init_point);
+    graph.SetThreadPool(&thread_pool, 4);
+    SpeedData speed_data;
+    ASSERT_TRUE(graph.Search(&speed_data).ok());
+    ASSERT_EQ(expected_speed_data.size(), speed_data.size());
+    for (size_t j = 0; j < speed_data.size(); ++j) {
+      EXPECT_EQ(expected_speed_data[j].s(), speed_data[j].s());
+      EXPECT_EQ(expected_speed_data[j].t(), speed_data[j].t());
+      EXPECT_EQ(expected_speed_data[j].v(), speed_data[j].v());
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -20,16 +20,21 @@
 
 #include "modules/planning/tasks/optimizers/piecewise_jerk_path/piecewise_jerk_path_optimizer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_set>
 
+#include "cyber/time/clock.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/util/point_factory.h"
 #include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/common/speed/speed_data.h"
 #include "modules/planning/common/trajectory1d/piecewise_jerk_trajectory1d.h"
+#include "modules/planning/common/util/parallel_for.h"
 #include "modules/planning/math/piecewise_jerk/piecewise_jerk_path_problem.h"
+#include "modules/planning/tasks/utils/path_candidate_thread_pool.h"
 
 namespace apollo {
 namespace planning {
@@ -38,6 +43,7 @@ using apollo::common::ErrorCode;
 using apollo::common::Status;
 using apollo::common::VehicleConfigHelper;
 using apollo::common::math::Gaussian;
+using apollo::cyber::Clock;
 
 PiecewiseJerkPathOptimizer::PiecewiseJerkPathOptimizer(
     const TaskConfig& config,
@@ -83,9 +89,23 @@ common::Status PiecewiseJerkPathOptimizer::Process(
   const auto& path_boundaries =
       reference_line_info_->GetCandidatePathBoundaries();
   ADEBUG << "There are " << path_boundaries.size() << " path boundaries.";
-  const auto& reference_path_data = reference_line_info_->path_data();
 
-  std::vector<PathData> candidate_path_data;
+  // read on the planning thread, as the path boundaries may be optimized on
+  // other threads
+  const PullOverStatus pull_over_status =
+      injector_->planning_context()->planning_status().pull_over();
+
+  // The workspaces are looked up before the path boundaries are optimized,
+  // maybe concurrently, as the lookup adds workspaces.
+  struct PathCandidate {
+    const PathBoundary* path_boundary = nullptr;
+    PiecewiseJerkWorkspace* workspace = nullptr;
+    size_t warm_start_shift = 0;
+    PathData path_data;
+    bool is_optimized = false;
+    double time = 0.0;
+  };
+  std::vector<PathCandidate> candidates;
   for (const auto& path_boundary : path_boundaries) {
     size_t path_boundary_size = path_boundary.boundary().size();
 
@@ -96,100 +116,63 @@ common::Status PiecewiseJerkPathOptimizer::Process(
       continue;
     }
 
-    int max_iter = 4000;
-    // lower max_iter for regular/self/
-    if (path_boundary.label().find("self") != std::string::npos) {
-      max_iter = 4000;
-    }
-
     CHECK_GT(path_boundary_size, 1U);
 
-    std::vector<double> opt_l;
-    std::vector<double> opt_dl;
-    std::vector<double> opt_ddl;
-
-    std::array<double, 3> end_state = {0.0, 0.0, 0.0};
-
-    if (!FLAGS_enable_force_pull_over_open_space_parking_test) {
-      // pull over scenario
-      // set end lateral to be at the desired pull over destination
-      const auto& pull_over_status =
-          injector_->planning_context()->planning_status().pull_over();
-      if (pull_over_status.has_position() &&
-          pull_over_status.position().has_x() &&
-          pull_over_status.position().has_y() &&
-          path_boundary.label().find("pullover") != std::string::npos) {
-        common::SLPoint pull_over_sl;
-        reference_line.XYToSL(pull_over_status.position(), &pull_over_sl);
-        end_state[0] = pull_over_sl.l();
-      }
-    }
-
+    candidates.emplace_back();
+    auto& candidate = candidates.back();
+    candidate.path_boundary = &path_boundary;
     // TODO(all): double-check this;
     // final_path_data might carry info from upper stream
-    PathData path_data = *final_path_data;
-
-    // updated cost function for path reference
-    std::vector<double> path_reference_l(path_boundary_size, 0.0);
-    bool is_valid_path_reference = false;
-    size_t path_reference_size = reference_path_data.path_reference().size();
+    candidate.path_data = *final_path_data;
+  }
 
-    if (path_boundary.label().find("regular") != std::string::npos &&
-        reference_path_data.is_valid_path_reference()) {
-      ADEBUG << "path label is: " << path_boundary.label();
-      // when path reference is ready
-      for (size_t i = 0; i < path_reference_size; ++i) {
-        common::SLPoint path_reference_sl;
-        reference_line.XYToSL(
-            common::util::PointFactory::ToPointENU(
-                reference_path_data.path_reference().at(i).x(),
-                reference_path_data.path_reference().at(i).y()),
-            &path_reference_sl);
-        path_reference_l[i] = path_reference_sl.l();
-      }
-      end_state[0] = path_reference_l.back();
-      path_data.set_is_optimized_towards_trajectory_reference(true);
-      is_valid_path_reference = true;
+  if (FLAGS_enable_piecewise_jerk_workspace_reuse) {
+    std::unordered_set<std::string> path_labels;
+    for (const auto& candidate : candidates) {
+      path_labels.insert(candidate.path_boundary->label());
     }
-
-    const auto& veh_param =
-        common::VehicleConfigHelper::GetConfig().vehicle_param();
-    const double lat_acc_bound =
-        std::tan(veh_param.max_steer_angle() / veh_param.steer_ratio()) /
-        veh_param.wheel_base();
-    std::vector<std::pair<double, double>> ddl_bounds;
-    for (size_t i = 0; i < path_boundary_size; ++i) {
-      double s = static_cast<double>(i) * path_boundary.delta_s() +
-                 path_boundary.start_s();
-      double kappa = reference_line.GetNearestReferencePoint(s).kappa();
-      ddl_bounds.emplace_back(-lat_acc_bound - kappa, lat_acc_bound - kappa);
+    // no workspace is dropped once the candidates hold workspaces
+    EvictWorkspaces(path_labels);
+    path_labels.clear();
+    for (auto& candidate : candidates) {
+      const auto& path_boundary = *candidate.path_boundary;
+      // the path boundaries of a label after the first one are solved
+      // without a workspace, not to share it
+      if (path_labels.insert(path_boundary.label()).second) {
+        candidate.workspace =
+            GetWorkspace(path_boundary.label(), planning_start_point,
+                         path_boundary.delta_s(), &candidate.warm_start_shift);
+      }
     }
+  }
 
-    bool res_opt = OptimizePath(
-        init_frenet_state, end_state, std::move(path_reference_l),
-        path_reference_size, path_boundary.delta_s(), is_valid_path_reference,
-        path_boundary.boundary(), ddl_bounds, w, max_iter, &opt_l, &opt_dl,
-        &opt_ddl);
+  const bool is_concurrent =
+      FLAGS_enable_parallel_path_candidates && candidates.size() > 1;
+  const size_t num_threads =
+      is_concurrent
+          ? static_cast<size_t>(std::max(1, FLAGS_path_candidate_thread_num))
+          : 1;
+  util::ParallelFor(
+      0, candidates.size(), num_threads, 1,
+      [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          auto& candidate = candidates[i];
+          const double start_time = Clock::NowInSeconds();
+          candidate.is_optimized = OptimizePathBoundary(
+              *candidate.path_boundary, reference_line, init_frenet_state, w,
+              pull_over_status, candidate.workspace,
+              candidate.warm_start_shift, &candidate.path_data);
+          candidate.time = Clock::NowInSeconds() - start_time;
+        }
+      },
+      is_concurrent ? PathCandidateThreadPool() : nullptr);
 
-    if (res_opt) {
-      for (size_t i = 0; i < path_boundary_size; i += 4) {
-        ADEBUG << "for s[" << static_cast<double>(i) * path_boundary.delta_s()
-               << "], l = " << opt_l[i] << ", dl = " << opt_dl[i];
-      }
-      auto frenet_frame_path =
-          ToPiecewiseJerkPath(opt_l, opt_dl, opt_ddl, path_boundary.delta_s(),
-                              path_boundary.start_s());
-
-      path_data.SetReferenceLine(&reference_line);
-      path_data.SetFrenetPath(std::move(frenet_frame_path));
-      if (FLAGS_use_front_axe_center_in_path_planning) {
-        auto discretized_path = DiscretizedPath(
-            ConvertPathPointRefFromFrontAxeToRearAxe(path_data));
-        path_data.SetDiscretizedPath(discretized_path);
-      }
-      path_data.set_path_label(path_boundary.label());
-      path_data.set_blocking_obstacle_id(path_boundary.blocking_obstacle_id());
-      candidate_path_data.push_back(std::move(path_data));
+  std::vector<PathData> candidate_path_data;
+  for (auto& candidate : candidates) {
+    RecordDebugInfo(candidate.path_boundary->label(), candidate.time,
+                    candidate.is_optimized, is_concurrent);
+    if (candidate.is_optimized) {
+      candidate_path_data.push_back(std::move(candidate.path_data));
     }
   }
   if (candidate_path_data.empty()) {
@@ -200,6 +183,194 @@ common::Status PiecewiseJerkPathOptimizer::Process(
   return Status::OK();
 }
 
+bool PiecewiseJerkPathOptimizer::OptimizePathBoundary(
+    const PathBoundary& path_boundary, const ReferenceLine& reference_line,
+    const std::pair<std::array<double, 3>, std::array<double, 3>>&
+        init_frenet_state,
+    const std::array<double, 5>& w, const PullOverStatus& pull_over_status,
+    PiecewiseJerkWorkspace* workspace, const size_t warm_start_shift,
+    PathData* const path_data) {
+  const size_t path_boundary_size = path_boundary.boundary().size();
+  const auto& reference_path_data = reference_line_info_->path_data();
+
+  int max_iter = 4000;
+  // lower max_iter for regular/self/
+  if (path_boundary.label().find("self") != std::string::npos) {
+    max_iter = 4000;
+  }
+
+  std::vector<double> opt_l;
+  std::vector<double> opt_dl;
+  std::vector<double> opt_ddl;
+
+  std::array<double, 3> end_state = {0.0, 0.0, 0.0};
+
+  if (!FLAGS_enable_force_pull_over_open_space_parking_test) {
+    // pull over scenario
+    // set end lateral to be at the desired pull over destination
+    if (pull_over_status.has_position() &&
+        pull_over_status.position().has_x() &&
+        pull_over_status.position().has_y() &&
+        path_boundary.label().find("pullover") != std::string::npos) {
+      common::SLPoint pull_over_sl;
+      reference_line.XYToSL(pull_over_status.position(), &pull_over_sl);
+      end_state[0] = pull_over_sl.l();
+    }
+  }
+
+  // updated cost function for path reference
+  std::vector<double> path_reference_l(path_boundary_size, 0.0);
+  bool is_valid_path_reference = false;
+  size_t path_reference_size = reference_path_data.path_reference().size();
+
+  if (path_boundary.label().find("regular") != std::string::npos &&
+      reference_path_data.is_valid_path_reference()) {
+    ADEBUG << "path label is: " << path_boundary.label();
+    // when path reference is ready
+    for (size_t i = 0; i < path_reference_size; ++i) {
+      common::SLPoint path_reference_sl;
+      reference_line.XYToSL(
+          common::util::PointFactory::ToPointENU(
+              reference_path_data.path_reference().at(i).x(),
+              reference_path_data.path_reference().at(i).y()),
+          &path_reference_sl);
+      path_reference_l[i] = path_reference_sl.l();
+    }
+    end_state[0] = path_reference_l.back();
+    path_data->set_is_optimized_towards_trajectory_reference(true);
+    is_valid_path_reference = true;
+  }
+
+  const auto& veh_param =
+      common::VehicleConfigHelper::GetConfig().vehicle_param();
+  const double lat_acc_bound =
+      std::tan(veh_param.max_steer_angle() / veh_param.steer_ratio()) /
+      veh_param.wheel_base();
+  std::vector<std::pair<double, double>> ddl_bounds;
+  for (size_t i = 0; i < path_boundary_size; ++i) {
+    double s = static_cast<double>(i) * path_boundary.delta_s() +
+               path_boundary.start_s();
+    double kappa = reference_line.GetNearestReferencePoint(s).kappa();
+    ddl_bounds.emplace_back(-lat_acc_bound - kappa, lat_acc_bound - kappa);
+  }
+
+  bool res_opt = OptimizePath(
+      init_frenet_state, end_state, std::move(path_reference_l),
+      path_reference_size, path_boundary.delta_s(), is_valid_path_reference,
+      path_boundary.boundary(), ddl_bounds, w, max_iter,
+      pull_over_status.pull_over_type(), workspace, warm_start_shift, &opt_l,
+      &opt_dl, &opt_ddl);
+  if (!res_opt) {
+    return false;
+  }
+
+  for (size_t i = 0; i < path_boundary_size; i += 4) {
+    ADEBUG << "for s[" << static_cast<double>(i) * path_boundary.delta_s()
+           << "], l = " << opt_l[i] << ", dl = " << opt_dl[i];
+  }
+  auto frenet_frame_path =
+      ToPiecewiseJerkPath(opt_l, opt_dl, opt_ddl, path_boundary.delta_s(),
+                          path_boundary.start_s());
+
+  path_data->SetReferenceLine(&reference_line);
+  path_data->SetFrenetPath(std::move(frenet_frame_path));
+  if (FLAGS_use_front_axe_center_in_path_planning) {
+    auto discretized_path =
+        DiscretizedPath(ConvertPathPointRefFromFrontAxeToRearAxe(*path_data));
+    path_data->SetDiscretizedPath(discretized_path);
+  }
+  path_data->set_path_label(path_boundary.label());
+  path_data->set_blocking_obstacle_id(path_boundary.blocking_obstacle_id());
+  return true;
+}
+
+void PiecewiseJerkPathOptimizer::RecordDebugInfo(const std::string& path_label,
+                                                 const double time,
+                                                 const bool is_optimized,
+                                                 const bool is_concurrent) {
+  auto* planning_data =
+      reference_line_info_->mutable_debug()->mutable_planning_data();
+  // the path boundary may have been timed by the PathBoundsDecider
+  planning_internal::PathCandidateDebug* path_candidate = nullptr;
+  for (auto& candidate : *planning_data->mutable_path_candidate()) {
+    if (candidate.label() == path_label && !candidate.has_optimize_time_ms()) {
+      path_candidate = &candidate;
+      break;
+    }
+  }
+  if (path_candidate == nullptr) {
+    path_candidate = planning_data->add_path_candidate();
+    path_candidate->set_label(path_label);
+  }
+  path_candidate->set_optimize_time_ms(time * 1000.0);
+  path_candidate->set_is_optimized(is_optimized);
+  path_candidate->set_is_optimize_concurrent(is_concurrent);
+}
+
+std::string PiecewiseJerkPathOptimizer::WorkspaceKey(
+    const std::string& path_label) const {
+  return reference_line_info_->Lanes().Id() + "/" + path_label;
+}
+
+void PiecewiseJerkPathOptimizer::EvictWorkspaces(
+    const std::unordered_set<std::string>& path_labels) {
+  static constexpr size_t kMaxNumWorkspaces = 16;
+  // drop the workspaces of the reference lines which are gone
+  std::unordered_set<std::string> reference_line_ids = {
+      reference_line_info_->Lanes().Id()};
+  if (frame_ != nullptr) {
+    for (const auto& reference_line_info : frame_->reference_line_info()) {
+      reference_line_ids.insert(reference_line_info.Lanes().Id());
+    }
+  }
+  for (auto iter = workspaces_.begin(); iter != workspaces_.end();) {
+    if (reference_line_ids.count(iter->second.reference_line_id) == 0) {
+      iter = workspaces_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  // then the workspaces of the other path labels, if still too many
+  std::unordered_set<std::string> keys;
+  size_t num_workspaces = workspaces_.size();
+  for (const auto& path_label : path_labels) {
+    const std::string key = WorkspaceKey(path_label);
+    if (workspaces_.count(key) == 0) {
+      ++num_workspaces;
+    }
+    keys.insert(key);
+  }
+  if (num_workspaces <= kMaxNumWorkspaces) {
+    return;
+  }
+  for (auto iter = workspaces_.begin(); iter != workspaces_.end();) {
+    if (keys.count(iter->first) == 0) {
+      iter = workspaces_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+PiecewiseJerkWorkspace* PiecewiseJerkPathOptimizer::GetWorkspace(
+    const std::string& path_label, const common::TrajectoryPoint& init_point,
+    const double delta_s, size_t* warm_start_shift) {
+  // only adds workspaces, whose addresses the rehash keeps
+  auto& path_workspace = workspaces_[WorkspaceKey(path_label)];
+  path_workspace.reference_line_id = reference_line_info_->Lanes().Id();
+  const common::math::Vec2d start_point(init_point.path_point().x(),
+                                        init_point.path_point().y());
+  *warm_start_shift =
+      path_workspace.workspace.IsSetUp()
+          ? static_cast<size_t>(
+                start_point.DistanceTo(path_workspace.start_point) / delta_s +
+                0.5)
+          : 0;
+  path_workspace.start_point = start_point;
+  return &path_workspace.workspace;
+}
+
 common::TrajectoryPoint
 PiecewiseJerkPathOptimizer::InferFrontAxeCenterFromRearAxeCenter(
     const common::TrajectoryPoint& traj_point) {
@@ -239,12 +410,15 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
     const double delta_s, const bool is_valid_path_reference,
     const std::vector<std::pair<double, double>>& lat_boundaries,
     const std::vector<std::pair<double, double>>& ddl_bounds,
-    const std::array<double, 5>& w, const int max_iter, std::vector<double>* x,
-    std::vector<double>* dx, std::vector<double>* ddx) {
+    const std::array<double, 5>& w, const int max_iter,
+    const PullOverStatus::PullOverType pull_over_type,
+    PiecewiseJerkWorkspace* workspace, const size_t warm_start_shift,
+    std::vector<double>* x, std::vector<double>* dx, std::vector<double>* ddx) {
   // num of knots
   const size_t kNumKnots = lat_boundaries.size();
   PiecewiseJerkPathProblem piecewise_jerk_problem(kNumKnots, delta_s,
                                                   init_state.second);
+  piecewise_jerk_problem.set_workspace(workspace, warm_start_shift);
 
   // TODO(Hongyi): update end_state settings
   piecewise_jerk_problem.set_end_state_ref({1000.0, 0.0, 0.0}, end_state);
@@ -253,10 +427,6 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
   // we have to exclude this condition here
   if (end_state[0] != 0 && !is_valid_path_reference) {
     std::vector<double> x_ref(kNumKnots, end_state[0]);
-    const auto& pull_over_type = injector_->planning_context()
-                                     ->planning_status()
-                                     .pull_over()
-                                     .pull_over_type();
     const double weight_x_ref =
         pull_over_type == PullOverStatus::EMERGENCY_PULL_OVER ? 200.0 : 10.0;
     piecewise_jerk_problem.set_x_ref(weight_x_ref, std::move(x_ref));
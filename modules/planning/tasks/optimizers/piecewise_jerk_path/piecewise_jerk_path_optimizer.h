@@ -21,9 +21,16 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/common/path_boundary.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
+#include "modules/planning/proto/planning_status.pb.h"
 #include "modules/planning/tasks/optimizers/path_optimizer.h"
 
 namespace apollo {
@@ -63,6 +70,10 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
    * @param ddl_bounds: constains
    * @param w: weighting scales
    * @param max_iter: optimization max interations
+   * @param pull_over_type: pull over type of the planning status
+   * @param workspace: OSQP workspace kept across planning cycles, or nullptr
+   * @param warm_start_shift: knots the path start moved since the last
+   * problem solved in workspace
    * @param ptr_x: optimization result of x
    * @param ptr_dx: optimization result of dx
    * @param ptr_ddx: optimization result of ddx
@@ -78,9 +89,49 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
       const std::vector<std::pair<double, double>>& lat_boundaries,
       const std::vector<std::pair<double, double>>& ddl_bounds,
       const std::array<double, 5>& w, const int max_iter,
+      const PullOverStatus::PullOverType pull_over_type,
+      PiecewiseJerkWorkspace* workspace, const size_t warm_start_shift,
       std::vector<double>* ptr_x, std::vector<double>* ptr_dx,
       std::vector<double>* ptr_ddx);
 
+  /**
+   * @brief Optimize the path on a candidate path boundary into path_data. It
+   * only reads the state of the optimizer, and not the planning context, so
+   * that the candidates may be optimized concurrently.
+   */
+  bool OptimizePathBoundary(
+      const PathBoundary& path_boundary, const ReferenceLine& reference_line,
+      const std::pair<std::array<double, 3>, std::array<double, 3>>&
+          init_frenet_state,
+      const std::array<double, 5>& w, const PullOverStatus& pull_over_status,
+      PiecewiseJerkWorkspace* workspace, const size_t warm_start_shift,
+      PathData* const path_data);
+
+  /**
+   * @brief Record the time spent optimizing a candidate path boundary into
+   * the planning debug.
+   */
+  void RecordDebugInfo(const std::string& path_label, const double time,
+                       const bool is_optimized, const bool is_concurrent);
+
+  /**
+   * @brief Drop the OSQP workspaces of the reference lines which are gone,
+   * then those of the path labels not in path_labels if there would be too
+   * many. Called before any workspace is handed out in a cycle.
+   */
+  void EvictWorkspaces(const std::unordered_set<std::string>& path_labels);
+
+  /**
+   * @brief Get the OSQP workspace of the path boundary on the current
+   * reference line, and the number of knots to shift its last solution by.
+   * Never drops a workspace.
+   */
+  PiecewiseJerkWorkspace* GetWorkspace(
+      const std::string& path_label, const common::TrajectoryPoint& init_point,
+      const double delta_s, size_t* warm_start_shift);
+
+  std::string WorkspaceKey(const std::string& path_label) const;
+
   FrenetFramePath ToPiecewiseJerkPath(const std::vector<double>& l,
                                       const std::vector<double>& dl,
                                       const std::vector<double>& ddl,
@@ -93,6 +144,16 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
 
   double GaussianWeighting(const double x, const double peak_weighting,
                            const double peak_weighting_x) const;
+
+ private:
+  struct PathWorkspace {
+    PiecewiseJerkWorkspace workspace;
+    std::string reference_line_id;
+    // planning start point of the last problem solved in workspace
+    common::math::Vec2d start_point;
+  };
+  // keyed by the route segments of the reference line and the path label
+  std::unordered_map<std::string, PathWorkspace> workspaces_;
 };
 
 }  // namespace planning
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/optimizers/piecewise_jerk_path/piecewise_jerk_path_optimizer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::hdmap::LaneInfo;
+
+class PiecewiseJerkPathOptimizerTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    common::VehicleConfig vehicle_config;
+    auto* vehicle_param = vehicle_config.mutable_vehicle_param();
+    vehicle_param->set_max_steer_angle(8.20);
+    vehicle_param->set_max_steer_angle_rate(6.98);
+    vehicle_param->set_steer_ratio(16.0);
+    vehicle_param->set_wheel_base(2.8448);
+    common::VehicleConfigHelper::Init(vehicle_config);
+
+    config_.set_task_type(TaskConfig::PIECEWISE_JERK_PATH_OPTIMIZER);
+    auto* optimizer_config =
+        config_.mutable_piecewise_jerk_path_optimizer_config();
+    auto* path_config = optimizer_config->mutable_default_path_config();
+    path_config->set_l_weight(1.0);
+    path_config->set_dl_weight(20.0);
+    path_config->set_ddl_weight(1000.0);
+    path_config->set_dddl_weight(50000.0);
+    *optimizer_config->mutable_lane_change_path_config() = *path_config;
+
+    // a straight lane of 100m along x
+    lane_.mutable_id()->set_id("a");
+    auto* line_segment =
+        lane_.mutable_central_curve()->add_segment()->mutable_line_segment();
+    for (int i = 0; i <= 10; ++i) {
+      auto* point = line_segment->add_point();
+      point->set_x(10.0 * i);
+      point->set_y(0.0);
+    }
+    lane_.set_length(100.0);
+    auto* left_sample = lane_.add_left_sample();
+    left_sample->set_s(0.0);
+    left_sample->set_width(1.75);
+    auto* right_sample = lane_.add_right_sample();
+    right_sample->set_s(0.0);
+    right_sample->set_width(1.75);
+    lane_info_.reset(new LaneInfo(lane_));
+    segments_.emplace_back(lane_info_, 0.0, 100.0);
+    segments_.SetIsOnSegment(true);
+  }
+
+ protected:
+  // bounds of 60m from the vehicle, narrowed to l_min around an obstacle
+  // between s 20m and 30m
+  static PathBoundary MakePathBoundary(const std::string& label,
+                                       const double l_min, const double l_max,
+                                       const double obstacle_l_min) {
+    std::vector<std::pair<double, double>> boundary;
+    for (int i = 0; i < 120; ++i) {
+      const double s = 0.5 * i;
+      boundary.emplace_back(s > 20.0 && s < 30.0 ? obstacle_l_min : l_min,
+                            l_max);
+    }
+    PathBoundary path_boundary(0.0, 0.5, std::move(boundary));
+    path_boundary.set_label(label);
+    return path_boundary;
+  }
+
+  // the candidate paths of the path boundaries, optimized concurrently or
+  // not, by optimizer
+  std::vector<PathData> Optimize(const bool is_concurrent,
+                                 std::vector<PathBoundary> path_boundaries,
+                                 PiecewiseJerkPathOptimizer* optimizer) {
+    FLAGS_enable_parallel_path_candidates = is_concurrent;
+    const hdmap::Path path(segments_);
+    const ReferenceLine reference_line(path);
+    ReferenceLineInfo reference_line_info(common::VehicleState(),
+                                          common::TrajectoryPoint(),
+                                          reference_line, segments_);
+    reference_line_info.SetCandidatePathBoundaries(std::move(path_boundaries));
+
+    Frame frame(1);
+    EXPECT_TRUE(optimizer->Execute(&frame, &reference_line_info).ok());
+    return reference_line_info.GetCandidatePathData();
+  }
+
+  // the candidate paths of the path boundaries, optimized concurrently or
+  // not, by a new optimizer
+  std::vector<PathData> Optimize(const bool is_concurrent) {
+    auto injector = std::make_shared<DependencyInjector>();
+    auto* pull_over_status = injector->planning_context()
+                                 ->mutable_planning_status()
+                                 ->mutable_pull_over();
+    pull_over_status->set_pull_over_type(PullOverStatus::PULL_OVER);
+    pull_over_status->mutable_position()->set_x(50.0);
+    pull_over_status->mutable_position()->set_y(-2.0);
+
+    std::vector<PathBoundary> path_boundaries;
+    path_boundaries.push_back(MakePathBoundary("fallback", -3.0, 3.0, -3.0));
+    path_boundaries.push_back(
+        MakePathBoundary("regular/self", -1.75, 1.75, 0.5));
+    path_boundaries.push_back(
+        MakePathBoundary("regular/left/forward", -1.75, 5.25, 1.0));
+    path_boundaries.push_back(
+        MakePathBoundary("regular/pullover", -3.0, 1.75, -3.0));
+    PiecewiseJerkPathOptimizer optimizer(config_, injector);
+    return Optimize(is_concurrent, std::move(path_boundaries), &optimizer);
+  }
+
+  static void ExpectSamePaths(const std::vector<PathData>& expected_paths,
+                              const std::vector<PathData>& paths) {
+    ASSERT_EQ(expected_paths.size(), paths.size());
+    for (size_t i = 0; i < expected_paths.size(); ++i) {
+      EXPECT_EQ(expected_paths[i].path_label(), paths[i].path_label());
+      const auto& expected_path = expected_paths[i].frenet_frame_path();
+      const auto& path = paths[i].frenet_frame_path();
+      ASSERT_EQ(expected_path.size(), path.size());
+      for (size_t j = 0; j < expected_path.size(); ++j) {
+        EXPECT_NEAR(expected_path[j].s(), path[j].s(), 1e-6);
+        EXPECT_NEAR(expected_path[j].l(), path[j].l(), 1e-3);
+        EXPECT_NEAR(expected_path[j].dl(), path[j].dl(), 1e-3);
+      }
+    }
+  }
+
+  TaskConfig config_;
+  // referred to by lane_info_
+  hdmap::Lane lane_;
+  std::shared_ptr<LaneInfo> lane_info_;
+  hdmap::RouteSegments segments_;
+};
+
+TEST_F(PiecewiseJerkPathOptimizerTest, ConcurrentCandidates) {
+  FLAGS_enable_piecewise_jerk_workspace_reuse = false;
+  FLAGS_path_candidate_thread_num = 4;
+  const std::vector<PathData> serial_paths = Optimize(false);
+  const std::vector<PathData> concurrent_paths = Optimize(true);
+  ASSERT_EQ(4, serial_paths.size());
+  ASSERT_EQ(serial_paths.size(), concurrent_paths.size());
+  for (size_t i = 0; i < serial_paths.size(); ++i) {
+    EXPECT_EQ(serial_paths[i].path_label(), concurrent_paths[i].path_label());
+    const auto& serial_path = serial_paths[i].frenet_frame_path();
+    const auto& concurrent_path = concurrent_paths[i].frenet_frame_path();
+    ASSERT_EQ(serial_path.size(), concurrent_path.size());
+    for (size_t j = 0; j < serial_path.size(); ++j) {
+      EXPECT_DOUBLE_EQ(serial_path[j].s(), concurrent_path[j].s());
+      EXPECT_DOUBLE_EQ(serial_path[j].l(), concurrent_path[j].l());
+      EXPECT_DOUBLE_EQ(serial_path[j].dl(), concurrent_path[j].dl());
+    }
+  }
+  // the pull over path heads to the pull over position
+  EXPECT_EQ("regular/pullover", concurrent_paths[3].path_label());
+  EXPECT_GT(-1.0, concurrent_paths[3].frenet_frame_path().back().l());
+  EXPECT_LT(-1.0, concurrent_paths[1].frenet_frame_path().back().l());
+}
+
+TEST_F(PiecewiseJerkPathOptimizerTest, ConcurrentWorkspaceReuse) {
+  FLAGS_path_candidate_thread_num = 4;
+  auto injector = std::make_shared<DependencyInjector>();
+  PiecewiseJerkPathOptimizer optimizer(config_, injector);
+  // more path labels than workspaces kept, over two cycles, and a label
+  // repeated within a cycle
+  for (int cycle = 0; cycle < 2; ++cycle) {
+    std::vector<PathBoundary> path_boundaries;
+    for (int i = 0; i < 12; ++i) {
+      const double obstacle_l_min = 0.05 * i - 0.5;
+      path_boundaries.push_back(MakePathBoundary(
+          "regular/" + std::to_string(12 * cycle + i), -1.75, 1.75,
+          obstacle_l_min));
+    }
+    path_boundaries.push_back(
+        MakePathBoundary("regular/" + std::to_string(12 * cycle), -1.75,
+                         1.75, 1.0));
+
+    FLAGS_enable_piecewise_jerk_workspace_reuse = false;
+    PiecewiseJerkPathOptimizer cold_optimizer(config_, injector);
+    const std::vector<PathData> expected_paths =
+        Optimize(false, path_boundaries, &cold_optimizer);
+    ASSERT_EQ(13, expected_paths.size());
+    FLAGS_enable_piecewise_jerk_workspace_reuse = true;
+    ExpectSamePaths(expected_paths,
+                    Optimize(true, path_boundaries, &optimizer));
+  }
+  FLAGS_enable_piecewise_jerk_workspace_reuse = false;
+}
+
+}  // namespace planning
+}  // namespace apollo
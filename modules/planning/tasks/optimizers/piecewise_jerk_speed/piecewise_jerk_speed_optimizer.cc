@@ -75,6 +75,12 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
 
   PiecewiseJerkSpeedProblem piecewise_jerk_problem(num_of_knots, delta_t,
                                                    init_s);
+  if (FLAGS_enable_piecewise_jerk_workspace_reuse) {
+    size_t warm_start_shift = 0;
+    PiecewiseJerkWorkspace* workspace =
+        GetWorkspace(delta_t, &warm_start_shift);
+    piecewise_jerk_problem.set_workspace(workspace, warm_start_shift);
+  }
 
   const auto& config = config_.piecewise_jerk_speed_optimizer_config();
   piecewise_jerk_problem.set_weight_ddx(config.acc_weight());
@@ -188,5 +194,25 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   return Status::OK();
 }
 
+PiecewiseJerkWorkspace* PiecewiseJerkSpeedOptimizer::GetWorkspace(
+    const double delta_t, size_t* warm_start_shift) {
+  // drop the workspaces of reference lines which are gone
+  static constexpr size_t kMaxNumWorkspaces = 4;
+  const std::string& key = reference_line_info_->Lanes().Id();
+  if (workspaces_.size() >= kMaxNumWorkspaces && workspaces_.count(key) == 0) {
+    workspaces_.clear();
+  }
+  auto& speed_workspace = workspaces_[key];
+  const double timestamp = frame_->vehicle_state().timestamp();
+  *warm_start_shift =
+      speed_workspace.workspace.IsSetUp() &&
+              timestamp > speed_workspace.timestamp
+          ? static_cast<size_t>(
+                (timestamp - speed_workspace.timestamp) / delta_t + 0.5)
+          : 0;
+  speed_workspace.timestamp = timestamp;
+  return &speed_workspace.workspace;
+}
+
 }  // namespace planning
 }  // namespace apollo
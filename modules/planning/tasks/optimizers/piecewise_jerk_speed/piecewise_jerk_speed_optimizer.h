@@ -20,6 +20,10 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
 #include "modules/planning/tasks/optimizers/speed_optimizer.h"
 
 namespace apollo {
@@ -35,6 +39,22 @@ class PiecewiseJerkSpeedOptimizer : public SpeedOptimizer {
   common::Status Process(const PathData& path_data,
                          const common::TrajectoryPoint& init_point,
                          SpeedData* const speed_data) override;
+
+  /**
+   * @brief Get the OSQP workspace of the current reference line, and the
+   * number of knots to shift its last solution by.
+   */
+  PiecewiseJerkWorkspace* GetWorkspace(const double delta_t,
+                                       size_t* warm_start_shift);
+
+ private:
+  struct SpeedWorkspace {
+    PiecewiseJerkWorkspace workspace;
+    // timestamp of the last problem solved in workspace
+    double timestamp = 0.0;
+  };
+  // keyed by the route segments of the reference line
+  std::unordered_map<std::string, SpeedWorkspace> workspaces_;
 };
 
 }  // namespace planning
@@ -0,0 +1,37 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/utils/path_candidate_thread_pool.h"
+
+#include <algorithm>
+
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+cyber::base::ThreadPool* PathCandidateThreadPool() {
+  static cyber::base::ThreadPool thread_pool(
+      std::max(1, FLAGS_path_candidate_thread_num - 1));
+  return &thread_pool;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,37 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include "cyber/base/thread_pool.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @brief The thread pool shared by the tasks which process the candidate
+ * path boundaries of a reference line concurrently. It has
+ * FLAGS_path_candidate_thread_num - 1 threads, as the calling thread takes
+ * a share of the candidates too.
+ */
+cyber::base::ThreadPool* PathCandidateThreadPool();
+
+}  // namespace planning
+}  // namespace apollo